@@ -0,0 +1,53 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "allocations.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// === HELPERS ===
+
+namespace {
+std::atomic<size_t> COUNTER;
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+namespace roq {
+namespace fix_proxy {
+
+size_t Allocations::count() {
+  return COUNTER.load(std::memory_order_relaxed);
+}
+
+}  // namespace fix_proxy
+}  // namespace roq
+
+void *operator new(std::size_t size) {
+  COUNTER.fetch_add(1, std::memory_order_relaxed);
+  if (auto result = std::malloc(size); result != nullptr) {
+    return result;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
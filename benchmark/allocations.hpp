@@ -0,0 +1,17 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstddef>
+
+namespace roq {
+namespace fix_proxy {
+
+// note! counts calls to the global operator new (replaced for the benchmark binary)
+
+struct Allocations final {
+  static size_t count();
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,105 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+#include "roq/fix_proxy/auth/parser.hpp"
+
+#include "allocations.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+// === HELPERS ===
+
+namespace {
+auto create_payload(size_t count) {
+  std::string result = R"({"jsonrpc":"2.0","id":"test","result":[)";
+  for (size_t i = 0; i < count; ++i) {
+    if (i != 0) {
+      result += ',';
+    }
+    auto index = std::to_string(i);
+    if ((i % 10) == 9) {
+      result += R"({"action":"remove","component":"test","username":"user_)" + index + R"("})";
+    } else {
+      result += R"({"action":"insert","component":"test","username":"user_)" + index + R"(","password":"secret_)" + index +
+                R"(","strategy_id":)" + index + "}";
+    }
+  }
+  result += "]}";
+  return result;
+}
+
+// note! this is the previous implementation (DOM)
+void parse_nlohmann(std::string_view const &payload, auto &handler) {
+  auto json = nlohmann::json::parse(payload);
+  auto result = json.at("result"sv);
+  for (auto &obj : result) {
+    auto action = obj.at("action"sv).template get<std::string_view>();
+    auto component = obj.at("component"sv).template get<std::string_view>();
+    auto username = obj.at("username"sv).template get<std::string_view>();
+    if (action == "insert"sv) {
+      auto password = obj.at("password"sv).template get<std::string_view>();
+      auto strategy_id = obj.at("strategy_id"sv).template get<uint32_t>();
+      auto insert = auth::Parser::Insert{
+          .component = component,
+          .username = username,
+          .password = password,
+          .strategy_id = strategy_id,
+      };
+      handler(insert);
+    } else if (action == "remove"sv) {
+      auto remove = auth::Parser::Remove{
+          .component = component,
+          .username = username,
+      };
+      handler(remove);
+    }
+  }
+}
+
+struct Handler final {
+  void operator()(auth::Parser::Insert const &insert) { benchmark::DoNotOptimize(insert); }
+  void operator()(auth::Parser::Remove const &remove) { benchmark::DoNotOptimize(remove); }
+  void operator()(auth::Parser::Error const &error) { benchmark::DoNotOptimize(error); }
+};
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+void BM_auth_parser_nlohmann(benchmark::State &state) {
+  auto payload = create_payload(state.range(0));
+  Handler handler;
+  auto allocations = Allocations::count();
+  for (auto _ : state) {
+    parse_nlohmann(payload, handler);
+  }
+  state.counters["allocs/payload"] =
+      benchmark::Counter(static_cast<double>(Allocations::count() - allocations) / static_cast<double>(state.iterations()));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * std::size(payload));
+}
+
+BENCHMARK(BM_auth_parser_nlohmann)->RangeMultiplier(10)->Range(1, 10000);
+
+void BM_auth_parser_streaming(benchmark::State &state) {
+  auto payload = create_payload(state.range(0));
+  auth::Parser parser;
+  Handler handler;
+  auto allocations = Allocations::count();
+  for (auto _ : state) {
+    auto result = parser.dispatch(payload, handler);
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["allocs/payload"] =
+      benchmark::Counter(static_cast<double>(Allocations::count() - allocations) / static_cast<double>(state.iterations()));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * std::size(payload));
+}
+
+BENCHMARK(BM_auth_parser_streaming)->RangeMultiplier(10)->Range(1, 10000);
@@ -0,0 +1,379 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <fmt/format.h>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "roq/fix/reader.hpp"
+
+#include "roq/fix_proxy/metrics.hpp"
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+#include "roq/fix_proxy/tools/wakeup.hpp"
+
+#include "roq/fix_proxy/client/shard.hpp"
+
+#include "roq/fix_proxy/server/decoder.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+// note!
+// round trips through client::Shard (sockets, framing, decoding, ring buffers) using an increasing number of shards
+// the benchmark thread is the event loop thread (polling the shards and encoding the responses) and also all the clients
+// each iteration sends one message on every connection, responds to every decoded message and reads all the responses
+// the latency benchmark uses a single shard with many connections, one round trip per iteration (each connection in turn)
+// all benchmarks are repeated using io_uring (--client_io_uring) and report the system calls made by the shards per message
+
+// === CONSTANTS ===
+
+namespace {
+auto const FIX_VERSION = fix::Version::FIX_44;
+
+size_t const DECODE_BUFFER_SIZE = 64 * 1024;
+size_t const ENCODE_BUFFER_SIZE = 64 * 1024;
+
+size_t const PIPELINE_DEPTH = 64;  // note! slots per shard
+size_t const CONNECTIONS = 64;     // note! distributed by the kernel (SO_REUSEPORT)
+
+uint16_t const PORT = 23457;
+
+double const PERCENTILES[] = {0.50, 0.99};
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_message(std::string_view const &body) {
+  auto result = fmt::format(
+      "8=FIX.4.4\x01"
+      "9={}\x01"
+      "{}"sv,
+      std::size(body),
+      body);
+  uint32_t sum = {};
+  for (auto c : result) {
+    sum += static_cast<uint8_t>(c);
+  }
+  return fmt::format("{}10={:03}\x01"sv, result, sum % 256);
+}
+
+auto const NEW_ORDER_SINGLE = create_message(
+    "35=D\x01"
+    "49=client\x01"
+    "56=proxy\x01"
+    "34=2\x01"
+    "52=20260101-00:00:00.000\x01"
+    "11=123456789\x01"
+    "1=A1\x01"
+    "55=BTC-PERPETUAL\x01"
+    "207=deribit\x01"
+    "54=1\x01"
+    "60=20260101-00:00:00.000\x01"
+    "38=1\x01"
+    "40=2\x01"
+    "44=100000\x01"
+    "59=1\x01"sv);
+
+auto const EXECUTION_REPORT = create_message(
+    "35=8\x01"
+    "49=server\x01"
+    "56=proxy\x01"
+    "34=2\x01"
+    "52=20260101-00:00:00.000\x01"
+    "37=abcdef0123456789\x01"
+    "11=123456789\x01"
+    "17=fedcba9876543210\x01"
+    "150=0\x01"
+    "39=0\x01"
+    "55=BTC-PERPETUAL\x01"
+    "207=deribit\x01"
+    "54=1\x01"
+    "151=1\x01"
+    "14=0\x01"
+    "6=0\x01"
+    "60=20260101-00:00:00.000\x01"sv);
+
+auto to_span(std::string const &value) {
+  return std::span{reinterpret_cast<std::byte const *>(std::data(value)), std::size(value)};
+}
+
+auto create_settings(bool io_uring) {
+  Settings result = {};
+  result.loop.busy_poll = false;  // note! shards block in the kernel (the cores are shared with the clients)
+  result.client.io_pipeline_depth = PIPELINE_DEPTH;
+  result.client.decode_buffer_size = DECODE_BUFFER_SIZE;
+  result.client.encode_buffer_size = ENCODE_BUFFER_SIZE;
+  result.client.io_uring = io_uring;
+  return result;
+}
+
+int create_connection() {
+  auto result = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  struct sockaddr_in sockaddr = {};
+  sockaddr.sin_family = AF_INET;
+  sockaddr.sin_port = htons(PORT);
+  sockaddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (result < 0 || ::connect(result, reinterpret_cast<struct sockaddr const *>(&sockaddr), sizeof(sockaddr)) < 0) {
+    throw std::runtime_error{fmt::format("Unable to connect (error={})"sv, std::strerror(errno))};
+  }
+  int flag = 1;
+  ::setsockopt(result, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+  return result;
+}
+
+// note! returns false if disconnected
+bool read_response(int fd, std::vector<std::byte> &buffer, std::vector<std::span<std::byte const>> &frames, tools::FrameScanner const &frame_scanner) {
+  size_t length = {};
+  while (true) {
+    auto result = ::recv(fd, std::data(buffer) + length, std::size(buffer) - length, 0);
+    if (result <= 0) {
+      return false;
+    }
+    length += result;
+    frames.clear();
+    frame_scanner.scan(std::span{buffer}.subspan(0, length), frames);
+    if (!std::empty(frames)) {
+      return true;  // note! one response per request
+    }
+  }
+}
+
+// note! the response is decoded once (as if received from upstream), the value references the decode buffers
+struct Response final {
+  Response() {
+    auto parser = [&](auto &message) {
+      server::Decoder::dispatch(message, decode_buffer, decode_buffer_2, [&](auto &value_2) { value = value_2; });
+    };
+    auto logger = []([[maybe_unused]] auto &message) {};
+    fix::Reader<FIX_VERSION>::dispatch(to_span(EXECUTION_REPORT), parser, logger);
+  }
+
+  Response(Response const &) = delete;
+
+  std::vector<std::byte> decode_buffer = std::vector<std::byte>(DECODE_BUFFER_SIZE);
+  std::vector<std::byte> decode_buffer_2 = std::vector<std::byte>(DECODE_BUFFER_SIZE);
+  server::Decoder::Value value;
+};
+
+// note! stands in for the event loop thread (client::Manager and client::Session)
+struct EventLoop final : public client::Shard::Handler {
+  explicit EventLoop(server::Decoder::Value const &response) : response_{response} {}
+
+  std::vector<std::unique_ptr<client::Shard>> shards;
+  size_t connections = {};
+  size_t messages = {};
+  size_t send_failures = {};
+
+  void poll() {
+    for (auto &shard : shards) {
+      (*shard).poll(*this);
+    }
+  }
+
+  // note! the kernel does not guarantee an even distribution
+  size_t max_connections_per_shard() const {
+    std::vector<size_t> result(std::size(shards));
+    for (auto &[_, shard] : links_) {
+      ++result[(*shard).index()];
+    }
+    return std::ranges::max(result);
+  }
+
+ protected:
+  // client::Shard::Handler
+  void operator()(client::Shard::Connected const &connected) override {
+    links_.emplace(connected.link_id, &connected.shard);
+    ++connections;
+  }
+
+  void operator()(client::Shard::Decoded const &decoded) override {
+    benchmark::DoNotOptimize(decoded.value);
+    ++messages;
+    auto &shard = *links_.at(decoded.link_id);
+    auto encode = [&]<typename T>(T const &value) {
+      if constexpr (!std::is_same_v<T, std::monostate>) {
+        header_.msg_type = T::MSG_TYPE;
+        ++header_.msg_seq_num;
+        auto success = shard.send(decoded.link_id, [&](auto &buffer) { return std::size(value.encode(header_, buffer)); });
+        if (!success) [[unlikely]] {
+          ++send_failures;
+        }
+      }
+    };
+    std::visit(encode, response_);
+  }
+
+  void operator()(client::Shard::Disconnected const &) override {}
+
+ private:
+  server::Decoder::Value const &response_;
+  std::unordered_map<uint64_t, client::Shard *> links_;
+  fix::Header header_ = {
+      .version = FIX_VERSION,
+      .msg_type = {},
+      .sender_comp_id = "proxy"sv,
+      .target_comp_id = "client"sv,
+      .msg_seq_num = {},
+      .sending_time = 1767225600000ms,
+  };
+};
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+// note! throughput (round trips) for an increasing number of shards, the clients and the event loop thread share a single thread
+void BM_client_shard_threads(benchmark::State &state) {
+  auto threads = static_cast<uint32_t>(state.range(0));
+  Response response;
+  if (std::holds_alternative<std::monostate>(response.value)) {
+    state.SkipWithError("Unable to decode the response"s);
+    return;
+  }
+  auto settings = create_settings(state.range(1) != 0);
+  std::vector<Metrics::Slot> metrics(threads);  // note! one per shard (single writer)
+  tools::Wakeup wakeup;                         // note! never waiting (the event loop thread is polling)
+  EventLoop event_loop{response.value};
+  auto listeners = client::Shard::create_listeners(fmt::format("127.0.0.1:{}"sv, PORT), threads);
+  for (uint32_t i = 0; i < threads; ++i) {
+    event_loop.shards.emplace_back(std::make_unique<client::Shard>(settings, i, threads, listeners[i], false, metrics[i], wakeup));
+  }
+  std::vector<int> clients;
+  for (size_t i = 0; i < CONNECTIONS; ++i) {
+    clients.emplace_back(create_connection());
+  }
+  while (event_loop.connections < CONNECTIONS) {
+    event_loop.poll();
+  }
+  std::vector<std::span<std::byte const>> frames;
+  std::vector<std::byte> buffer(ENCODE_BUFFER_SIZE);
+  tools::FrameScanner const frame_scanner{false};
+  auto request = to_span(NEW_ORDER_SINGLE);
+  auto system_calls = [&]() {
+    uint64_t result = {};
+    for (auto &item : metrics) {
+      result += item.get(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+    }
+    return result;
+  };
+  auto system_calls_begin = system_calls();
+  auto messages_begin = event_loop.messages;
+  for (auto _ : state) {
+    for (auto fd : clients) {
+      [[maybe_unused]] auto result = ::send(fd, std::data(request), std::size(request), MSG_NOSIGNAL);
+    }
+    auto expected = event_loop.messages + CONNECTIONS;
+    while (event_loop.messages < expected) {
+      event_loop.poll();
+    }
+    for (auto fd : clients) {
+      if (!read_response(fd, buffer, frames, frame_scanner)) {
+        state.SkipWithError("Disconnected"s);
+        break;
+      }
+    }
+  }
+  auto messages = event_loop.messages - messages_begin;
+  for (auto fd : clients) {
+    ::close(fd);
+  }
+  state.counters["max_connections_per_shard"] = static_cast<double>(event_loop.max_connections_per_shard());
+  state.counters["send_failures"] = static_cast<double>(event_loop.send_failures);
+  state.counters["syscalls_per_message"] = static_cast<double>(system_calls() - system_calls_begin) / static_cast<double>(std::max<size_t>(messages, 1));
+  state.SetItemsProcessed(state.iterations() * CONNECTIONS);
+}
+
+BENCHMARK(BM_client_shard_threads)->ArgsProduct({{1, 2, 4, 8}, {0, 1}})->ArgNames({"threads", "io_uring"})->UseRealTime();
+
+// note! round trip latency (one connection at a time) while all other connections are idle
+// requires an open file limit of at least twice the number of connections (ulimit -n)
+void BM_client_shard_latency(benchmark::State &state) {
+  auto connections = static_cast<size_t>(state.range(0));
+  Response response;
+  if (std::holds_alternative<std::monostate>(response.value)) {
+    state.SkipWithError("Unable to decode the response"s);
+    return;
+  }
+  auto settings = create_settings(state.range(1) != 0);
+  Metrics::Slot metrics;
+  tools::Wakeup wakeup;  // note! never waiting (the event loop thread is polling)
+  EventLoop event_loop{response.value};
+  auto listeners = client::Shard::create_listeners(fmt::format("127.0.0.1:{}"sv, PORT), 1);
+  event_loop.shards.emplace_back(std::make_unique<client::Shard>(settings, 0, 1, listeners[0], false, metrics, wakeup));
+  std::vector<int> clients;
+  try {
+    for (size_t i = 0; i < connections; ++i) {
+      clients.emplace_back(create_connection());
+    }
+  } catch (std::runtime_error &e) {
+    for (auto fd : clients) {
+      ::close(fd);
+    }
+    state.SkipWithError(e.what());
+    return;
+  }
+  while (event_loop.connections < connections) {
+    event_loop.poll();
+  }
+  std::vector<std::span<std::byte const>> frames;
+  std::vector<std::byte> buffer(ENCODE_BUFFER_SIZE);
+  tools::FrameScanner const frame_scanner{false};
+  auto request = to_span(NEW_ORDER_SINGLE);
+  std::vector<std::chrono::nanoseconds> samples;
+  auto system_calls_begin = metrics.get(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+  size_t index = {};
+  for (auto _ : state) {
+    auto fd = clients[index++ % connections];
+    auto start = std::chrono::steady_clock::now();
+    [[maybe_unused]] auto result = ::send(fd, std::data(request), std::size(request), MSG_NOSIGNAL);
+    auto expected = event_loop.messages + 1;
+    while (event_loop.messages < expected) {
+      event_loop.poll();
+    }
+    if (!read_response(fd, buffer, frames, frame_scanner)) {
+      state.SkipWithError("Disconnected"s);
+      break;
+    }
+    samples.emplace_back(std::chrono::steady_clock::now() - start);
+  }
+  auto system_calls = metrics.get(Metrics::Counter::CLIENT_SYSTEM_CALLS) - system_calls_begin;
+  for (auto fd : clients) {
+    ::close(fd);
+  }
+  if (std::empty(samples)) {
+    return;
+  }
+  std::ranges::sort(samples);
+  for (auto percentile : PERCENTILES) {
+    auto position = std::min(static_cast<size_t>(percentile * std::size(samples)), std::size(samples) - 1);
+    auto name = fmt::format("p{:.0f}_us"sv, 100.0 * percentile);
+    state.counters[name] = std::chrono::duration<double, std::micro>(samples[position]).count();
+  }
+  state.counters["syscalls_per_message"] = static_cast<double>(system_calls) / static_cast<double>(std::size(samples));
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_client_shard_latency)->ArgsProduct({{1000, 10000}, {0, 1}})->ArgNames({"connections", "io_uring"})->UseRealTime();
@@ -0,0 +1,794 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "roq/trace.hpp"
+
+#include "roq/utils/safe_cast.hpp"
+
+#include "roq/fix/reader.hpp"
+
+#include "roq/fix/proxy/manager.hpp"
+
+#include "roq/fix_proxy/router.hpp"
+
+#include "roq/fix_proxy/tools/slot_map.hpp"
+
+#include "roq/fix_proxy/client/decoder.hpp"
+#include "roq/fix_proxy/server/decoder.hpp"
+
+#include "allocations.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+// note!
+// frame => decode => dispatch (decoders are the ones used by client::Session and server::Session)
+// encode (re-encoding the decoded value, i.e. what the opposite session would send)
+// route (frame => decode => fix::proxy::Manager => session lookup => mock session, i.e. what Controller::dispatch_to_client does)
+
+// === CONSTANTS ===
+
+namespace {
+auto const FIX_VERSION = fix::Version::FIX_44;
+
+size_t const DECODE_BUFFER_SIZE = 1024 * 1024;
+size_t const ENCODE_BUFFER_SIZE = 1024 * 1024;
+
+size_t const SESSIONS = 1000;
+
+uint32_t const STRATEGY_ID = 1;
+
+std::chrono::nanoseconds const PING_FREQ = 30s;
+std::chrono::nanoseconds const REQUEST_TIMEOUT = 5s;
+std::chrono::nanoseconds const AUTH_TIMESTAMP_TOLERANCE = 5s;
+std::chrono::nanoseconds const LOGON_HEARTBEAT_MIN = 5s;
+std::chrono::nanoseconds const LOGON_HEARTBEAT_MAX = 60s;
+std::chrono::nanoseconds const HEARTBEAT_FREQ = 30s;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+struct Message final {
+  std::string_view msg_type;
+  std::string_view body;
+};
+
+auto create_message(std::string_view const &msg_type, std::string_view const &body) {
+  auto tmp = fmt::format(
+      "35={}\x01"
+      "49=sender\x01"
+      "56=target\x01"
+      "34=1\x01"
+      "52=20260101-00:00:00.000\x01"
+      "{}"sv,
+      msg_type,
+      body);
+  auto result = fmt::format(
+      "8=FIX.4.4\x01"
+      "9={}\x01"
+      "{}"sv,
+      std::size(tmp),
+      tmp);
+  uint32_t sum = {};
+  for (auto c : result) {
+    sum += static_cast<uint8_t>(c);
+  }
+  return fmt::format("{}10={:03}\x01"sv, result, sum % 256);
+}
+
+auto to_span(std::string const &value) {
+  return std::span{reinterpret_cast<std::byte const *>(std::data(value)), std::size(value)};
+}
+
+// note! returns an error message if the message can't be decoded (the callback may also take the header)
+template <typename Decoder, typename Callback>
+std::string decode(std::span<std::byte const> const &buffer, auto &decode_buffer, auto &decode_buffer_2, Callback callback) {
+  auto logger = []([[maybe_unused]] auto &message) {};
+  auto success = false;
+  try {
+    auto parser = [&](auto &message) {
+      auto helper = [&](auto &value) {
+        if constexpr (std::is_invocable_v<Callback, decltype(value), fix::Header const &>) {
+          callback(value, message.header);
+        } else {
+          callback(value);
+        }
+      };
+      success = Decoder::dispatch(message, decode_buffer, decode_buffer_2, helper);
+    };
+    if (fix::Reader<FIX_VERSION>::dispatch(buffer, parser, logger) != std::size(buffer)) {
+      return "Unable to frame message"s;
+    }
+  } catch (std::exception &e) {
+    return e.what();
+  }
+  return success ? std::string{} : "Unsupported msg_type"s;
+}
+
+void set_counters(benchmark::State &state, size_t allocations, size_t bytes) {
+  state.counters["allocs/msg"] =
+      benchmark::Counter(static_cast<double>(Allocations::count() - allocations) / static_cast<double>(state.iterations()));
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// note! stands in for a client session
+struct Session final {
+  explicit Session(uint64_t session_id) : session_id{session_id} {}
+
+  Session(Session const &) = delete;
+
+  void operator()(auto const &value) {
+    benchmark::DoNotOptimize(value);
+    ++count;
+  }
+
+  uint64_t const session_id;
+  size_t count = {};
+};
+
+// note! stands in for the controller, i.e. the same overrides (Router) and the same session lookup (dispatch_to_client)
+struct Controller final : public Router<Controller> {
+  using Router<Controller>::operator();
+
+  tools::SlotMap<Session> sessions;
+  std::string request_id;  // note! as forwarded to the server by the proxy manager
+  bool ready = {};
+  size_t routed = {};
+
+  template <typename T>
+  void dispatch_to_server(Trace<T> const &event) {
+    auto &[trace_info, value] = event;
+    if constexpr (requires { value.cl_ord_id; }) {
+      request_id = fmt::format("{}"sv, value.cl_ord_id);
+    } else if constexpr (requires { value.md_req_id; }) {
+      request_id = fmt::format("{}"sv, value.md_req_id);
+    } else if constexpr (requires { value.security_req_id; }) {
+      request_id = fmt::format("{}"sv, value.security_req_id);
+    } else if constexpr (requires { value.security_status_req_id; }) {
+      request_id = fmt::format("{}"sv, value.security_status_req_id);
+    } else if constexpr (requires { value.trad_ses_req_id; }) {
+      request_id = fmt::format("{}"sv, value.trad_ses_req_id);
+    } else if constexpr (requires { value.pos_req_id; }) {
+      request_id = fmt::format("{}"sv, value.pos_req_id);
+    } else if constexpr (requires { value.trade_request_id; }) {
+      request_id = fmt::format("{}"sv, value.trade_request_id);
+    } else if constexpr (requires { value.quote_id; }) {
+      request_id = fmt::format("{}"sv, value.quote_id);
+    }
+  }
+
+  template <typename T>
+  bool dispatch_to_client(Trace<T> const &event, uint64_t session_id) {
+    auto &[trace_info, value] = event;
+    auto session = sessions.find(session_id);
+    if (session == nullptr) [[unlikely]] {
+      return false;
+    }
+    (*session)(value);
+    ++routed;
+    return true;
+  }
+
+ protected:
+  // fix::proxy::Manager::Handler
+
+  std::pair<fix::codec::Error, uint32_t> operator()(fix::proxy::Manager::Credentials const &, uint64_t) override { return {{}, STRATEGY_ID}; }
+
+  void operator()(Trace<fix::proxy::Manager::Disconnected> const &) override { ready = false; }
+  void operator()(Trace<fix::proxy::Manager::Ready> const &) override { ready = true; }
+
+  void operator()(Trace<fix::proxy::Manager::Disconnect> const &, uint64_t) override {}
+};
+
+auto create_proxy(auto &handler) {
+  auto options = fix::proxy::Manager::Options{
+      .server{
+          .username = "proxy"sv,
+          .password = {},
+          .ping_freq = utils::safe_cast(PING_FREQ),
+          .request_timeout = REQUEST_TIMEOUT,
+      },
+      .client{
+          .auth_method = {},
+          .auth_timestamp_tolerance = AUTH_TIMESTAMP_TOLERANCE,
+          .logon_heartbeat_min = utils::safe_cast(LOGON_HEARTBEAT_MIN),
+          .logon_heartbeat_max = utils::safe_cast(LOGON_HEARTBEAT_MAX),
+          .request_timeout = REQUEST_TIMEOUT,
+          .heartbeat_freq = utils::safe_cast(HEARTBEAT_FREQ),
+      },
+      .test{
+          .disable_remove_cl_ord_id = false,
+      }};
+  return fix::proxy::Manager::create(handler, options);
+}
+
+// note! request ids are rewritten by the proxy manager
+auto replace_request_id(std::string_view const &body, std::string_view const &from, std::string_view const &to) {
+  auto pattern = fmt::format("={}\x01"sv, from);
+  auto replacement = fmt::format("={}\x01"sv, to);
+  std::string result{body};
+  for (auto pos = result.find(pattern); pos != result.npos; pos = result.find(pattern, pos + std::size(replacement))) {
+    result.replace(pos, std::size(pattern), replacement);
+  }
+  return result;
+}
+}  // namespace
+
+// === MESSAGES ===
+
+namespace {
+auto const REJECT = Message{
+    .msg_type = "3"sv,
+    .body = "45=1\x01"
+            "373=1\x01"
+            "58=test\x01"sv,
+};
+auto const LOGON = Message{
+    .msg_type = "A"sv,
+    .body = "98=0\x01"
+            "108=30\x01"
+            "553=trader\x01"
+            "554=secret\x01"sv,
+};
+auto const LOGOUT = Message{
+    .msg_type = "5"sv,
+    .body = "58=bye\x01"sv,
+};
+auto const HEARTBEAT = Message{
+    .msg_type = "0"sv,
+    .body = ""sv,
+};
+auto const TEST_REQUEST = Message{
+    .msg_type = "1"sv,
+    .body = "112=123\x01"sv,
+};
+auto const RESEND_REQUEST = Message{
+    .msg_type = "2"sv,
+    .body = "7=1\x01"
+            "16=0\x01"sv,
+};
+auto const BUSINESS_MESSAGE_REJECT = Message{
+    .msg_type = "j"sv,
+    .body = "45=1\x01"
+            "372=D\x01"
+            "380=0\x01"
+            "58=test\x01"sv,
+};
+auto const TRADING_SESSION_STATUS_REQUEST = Message{
+    .msg_type = "g"sv,
+    .body = "335=req1\x01"
+            "263=1\x01"sv,
+};
+auto const SECURITY_LIST_REQUEST = Message{
+    .msg_type = "x"sv,
+    .body = "320=req1\x01"
+            "559=4\x01"
+            "207=deribit\x01"
+            "263=1\x01"sv,
+};
+auto const SECURITY_DEFINITION_REQUEST = Message{
+    .msg_type = "c"sv,
+    .body = "320=req1\x01"
+            "321=0\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"sv,
+};
+auto const SECURITY_STATUS_REQUEST = Message{
+    .msg_type = "e"sv,
+    .body = "324=req1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "263=1\x01"sv,
+};
+auto const MARKET_DATA_REQUEST = Message{
+    .msg_type = "V"sv,
+    .body = "262=req1\x01"
+            "263=1\x01"
+            "264=10\x01"
+            "267=2\x01"
+            "269=0\x01"
+            "269=1\x01"
+            "146=1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"sv,
+};
+auto const NEW_ORDER_SINGLE = Message{
+    .msg_type = "D"sv,
+    .body = "11=123456789\x01"
+            "1=A1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "54=1\x01"
+            "60=20260101-00:00:00.000\x01"
+            "38=1\x01"
+            "40=2\x01"
+            "44=100000\x01"
+            "59=1\x01"sv,
+};
+auto const ORDER_CANCEL_REPLACE_REQUEST = Message{
+    .msg_type = "G"sv,
+    .body = "41=123456789\x01"
+            "11=123456790\x01"
+            "1=A1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "54=1\x01"
+            "60=20260101-00:00:00.000\x01"
+            "38=2\x01"
+            "40=2\x01"
+            "44=100001\x01"sv,
+};
+auto const ORDER_CANCEL_REQUEST = Message{
+    .msg_type = "F"sv,
+    .body = "41=123456790\x01"
+            "11=123456791\x01"
+            "1=A1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "54=1\x01"
+            "60=20260101-00:00:00.000\x01"sv,
+};
+auto const ORDER_MASS_CANCEL_REQUEST = Message{
+    .msg_type = "q"sv,
+    .body = "11=123456792\x01"
+            "530=7\x01"
+            "60=20260101-00:00:00.000\x01"sv,
+};
+auto const ORDER_STATUS_REQUEST = Message{
+    .msg_type = "H"sv,
+    .body = "37=abcdef\x01"
+            "11=123456789\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "54=1\x01"sv,
+};
+auto const ORDER_MASS_STATUS_REQUEST = Message{
+    .msg_type = "AF"sv,
+    .body = "584=req1\x01"
+            "585=7\x01"sv,
+};
+auto const TRADE_CAPTURE_REPORT_REQUEST = Message{
+    .msg_type = "AD"sv,
+    .body = "568=req1\x01"
+            "569=0\x01"
+            "263=1\x01"sv,
+};
+auto const REQUEST_FOR_POSITIONS = Message{
+    .msg_type = "AN"sv,
+    .body = "710=req1\x01"
+            "724=0\x01"
+            "1=A1\x01"
+            "581=1\x01"
+            "715=20260101\x01"
+            "263=1\x01"
+            "60=20260101-00:00:00.000\x01"sv,
+};
+auto const MASS_QUOTE = Message{
+    .msg_type = "i"sv,
+    .body = "117=quote1\x01"
+            "296=1\x01"
+            "302=set1\x01"
+            "295=1\x01"
+            "299=entry1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "132=99999\x01"
+            "133=100001\x01"
+            "134=1\x01"
+            "135=1\x01"sv,
+};
+auto const QUOTE_CANCEL = Message{
+    .msg_type = "Z"sv,
+    .body = "117=quote1\x01"
+            "298=1\x01"sv,
+};
+auto const TRADING_SESSION_STATUS = Message{
+    .msg_type = "h"sv,
+    .body = "335=req1\x01"
+            "336=1\x01"
+            "340=2\x01"sv,
+};
+auto const SECURITY_LIST = Message{
+    .msg_type = "y"sv,
+    .body = "320=req1\x01"
+            "322=resp1\x01"
+            "560=0\x01"
+            "146=1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"sv,
+};
+auto const SECURITY_DEFINITION = Message{
+    .msg_type = "d"sv,
+    .body = "320=req1\x01"
+            "322=resp1\x01"
+            "323=1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "969=0.5\x01"sv,
+};
+auto const SECURITY_STATUS = Message{
+    .msg_type = "f"sv,
+    .body = "324=req1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "326=17\x01"sv,
+};
+auto const MARKET_DATA_REQUEST_REJECT = Message{
+    .msg_type = "Y"sv,
+    .body = "262=req1\x01"
+            "281=0\x01"
+            "58=test\x01"sv,
+};
+auto const MARKET_DATA_SNAPSHOT_FULL_REFRESH = Message{
+    .msg_type = "W"sv,
+    .body = "262=req1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "268=4\x01"
+            "269=0\x01"
+            "270=99999\x01"
+            "271=1\x01"
+            "269=0\x01"
+            "270=99998\x01"
+            "271=2\x01"
+            "269=1\x01"
+            "270=100001\x01"
+            "271=1\x01"
+            "269=1\x01"
+            "270=100002\x01"
+            "271=2\x01"sv,
+};
+auto const MARKET_DATA_INCREMENTAL_REFRESH = Message{
+    .msg_type = "X"sv,
+    .body = "262=req1\x01"
+            "268=2\x01"
+            "279=1\x01"
+            "269=0\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "270=99999\x01"
+            "271=3\x01"
+            "279=1\x01"
+            "269=1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "270=100001\x01"
+            "271=3\x01"sv,
+};
+auto const EXECUTION_REPORT = Message{
+    .msg_type = "8"sv,
+    .body = "37=abcdef\x01"
+            "11=123456789\x01"
+            "17=exec1\x01"
+            "150=F\x01"
+            "39=1\x01"
+            "1=A1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "54=1\x01"
+            "38=10\x01"
+            "40=2\x01"
+            "44=100000\x01"
+            "32=1\x01"
+            "31=100000\x01"
+            "151=9\x01"
+            "14=1\x01"
+            "6=100000\x01"
+            "60=20260101-00:00:00.000\x01"sv,
+};
+auto const ORDER_CANCEL_REJECT = Message{
+    .msg_type = "9"sv,
+    .body = "37=abcdef\x01"
+            "11=123456791\x01"
+            "41=123456790\x01"
+            "39=0\x01"
+            "434=1\x01"
+            "102=1\x01"
+            "58=test\x01"sv,
+};
+auto const ORDER_MASS_CANCEL_REPORT = Message{
+    .msg_type = "r"sv,
+    .body = "11=123456792\x01"
+            "37=abcdef\x01"
+            "530=7\x01"
+            "531=7\x01"sv,
+};
+auto const TRADE_CAPTURE_REPORT_REQUEST_ACK = Message{
+    .msg_type = "AQ"sv,
+    .body = "568=req1\x01"
+            "569=0\x01"
+            "749=0\x01"
+            "750=0\x01"sv,
+};
+auto const TRADE_CAPTURE_REPORT = Message{
+    .msg_type = "AE"sv,
+    .body = "571=report1\x01"
+            "17=exec1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "32=1\x01"
+            "31=100000\x01"
+            "75=20260101\x01"
+            "60=20260101-00:00:00.000\x01"
+            "552=1\x01"
+            "54=1\x01"
+            "37=abcdef\x01"
+            "11=123456789\x01"
+            "1=A1\x01"sv,
+};
+auto const REQUEST_FOR_POSITIONS_ACK = Message{
+    .msg_type = "AO"sv,
+    .body = "721=pos1\x01"
+            "710=req1\x01"
+            "727=1\x01"
+            "728=0\x01"
+            "729=0\x01"
+            "1=A1\x01"
+            "581=1\x01"sv,
+};
+auto const POSITION_REPORT = Message{
+    .msg_type = "AP"sv,
+    .body = "721=pos1\x01"
+            "710=req1\x01"
+            "715=20260101\x01"
+            "728=0\x01"
+            "1=A1\x01"
+            "581=1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "702=1\x01"
+            "703=TQ\x01"
+            "704=10\x01"
+            "705=0\x01"sv,
+};
+auto const MASS_QUOTE_ACK = Message{
+    .msg_type = "b"sv,
+    .body = "117=quote1\x01"
+            "297=0\x01"sv,
+};
+auto const QUOTE_STATUS_REPORT = Message{
+    .msg_type = "AI"sv,
+    .body = "117=quote1\x01"
+            "55=BTC-PERPETUAL\x01"
+            "207=deribit\x01"
+            "297=0\x01"sv,
+};
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+template <typename Decoder>
+void BM_decode(benchmark::State &state, Message const &value) {
+  auto message = create_message(value.msg_type, value.body);
+  auto buffer = to_span(message);
+  std::vector<std::byte> decode_buffer(DECODE_BUFFER_SIZE), decode_buffer_2(DECODE_BUFFER_SIZE);
+  auto callback = [](auto &value) { benchmark::DoNotOptimize(value); };
+  if (auto error = decode<Decoder>(buffer, decode_buffer, decode_buffer_2, callback); !std::empty(error)) {
+    state.SkipWithError(error);
+    return;
+  }
+  auto allocations = Allocations::count();
+  for (auto _ : state) {
+    decode<Decoder>(buffer, decode_buffer, decode_buffer_2, callback);
+  }
+  set_counters(state, allocations, std::size(buffer));
+}
+
+template <typename Decoder>
+void BM_encode(benchmark::State &state, Message const &value) {
+  auto message = create_message(value.msg_type, value.body);
+  auto buffer = to_span(message);
+  std::vector<std::byte> decode_buffer(DECODE_BUFFER_SIZE), decode_buffer_2(DECODE_BUFFER_SIZE);
+  std::vector<std::byte> encode_buffer(ENCODE_BUFFER_SIZE);
+  size_t allocations = {}, bytes = {};
+  auto callback = [&]<typename T>(T const &value) {
+    auto header = fix::Header{
+        .version = FIX_VERSION,
+        .msg_type = T::MSG_TYPE,
+        .sender_comp_id = "proxy"sv,
+        .target_comp_id = "client"sv,
+        .msg_seq_num = 1,
+        .sending_time = 1767225600000ms,
+    };
+    allocations = Allocations::count();
+    for (auto _ : state) {
+      auto message = value.encode(header, encode_buffer);
+      benchmark::DoNotOptimize(message);
+      bytes = std::size(message);
+      ++header.msg_seq_num;
+    }
+  };
+  // note! the benchmark loop runs while the decoded value is still valid
+  if (auto error = decode<Decoder>(buffer, decode_buffer, decode_buffer_2, callback); !std::empty(error)) {
+    state.SkipWithError(error);
+    return;
+  }
+  set_counters(state, allocations, bytes);
+}
+
+// note!
+// frame => decode => fix::proxy::Manager => Controller::dispatch_to_client => session
+// a number of client sessions have logged on and one of them has sent the request (the response is routed back to it)
+template <typename Decoder>
+void BM_route(benchmark::State &state, Message const &request, Message const &response, std::string_view const &request_id) {
+  std::vector<std::byte> decode_buffer(DECODE_BUFFER_SIZE), decode_buffer_2(DECODE_BUFFER_SIZE);
+  Controller controller;
+  auto proxy = create_proxy(controller);
+  TraceInfo trace_info;
+  auto to_server = [&](auto &value) { create_trace_and_dispatch(*proxy, trace_info, value); };
+  // server
+  create_trace_and_dispatch(*proxy, trace_info, fix::proxy::Manager::Connected{});
+  if (auto error = decode<Decoder>(to_span(create_message(LOGON.msg_type, LOGON.body)), decode_buffer, decode_buffer_2, to_server); !std::empty(error)) {
+    state.SkipWithError(error);
+    return;
+  }
+  if (!controller.ready) {
+    state.SkipWithError("Proxy manager is not ready"s);
+    return;
+  }
+  // clients
+  std::vector<uint64_t> session_ids;
+  for (size_t i = 0; i < SESSIONS; ++i) {
+    session_ids.emplace_back(controller.sessions.emplace([](auto session_id) { return Session{session_id}; }).session_id);
+  }
+  std::shuffle(std::begin(session_ids), std::end(session_ids), std::mt19937_64{42});
+  auto from_client = [&](auto &message, auto session_id) {
+    auto helper = [&](auto &value, auto &header) { create_trace_and_dispatch(*proxy, trace_info, value, header, session_id); };
+    return decode<client::Decoder>(to_span(create_message(message.msg_type, message.body)), decode_buffer, decode_buffer_2, helper);
+  };
+  for (auto session_id : session_ids) {
+    if (auto error = from_client(LOGON, session_id); !std::empty(error)) {
+      state.SkipWithError(error);
+      return;
+    }
+  }
+  controller.request_id.clear();
+  if (auto error = from_client(request, session_ids[0]); !std::empty(error) || std::empty(controller.request_id)) {
+    state.SkipWithError(std::empty(error) ? "Request was not forwarded"s : error);
+    return;
+  }
+  // response
+  auto message = create_message(response.msg_type, replace_request_id(response.body, request_id, controller.request_id));
+  auto buffer = to_span(message);
+  controller.routed = {};
+  if (auto error = decode<Decoder>(buffer, decode_buffer, decode_buffer_2, to_server); !std::empty(error) || controller.routed == 0) {
+    state.SkipWithError(std::empty(error) ? "Response was not routed"s : error);
+    return;
+  }
+  controller.routed = {};
+  auto allocations = Allocations::count();
+  for (auto _ : state) {
+    decode<Decoder>(buffer, decode_buffer, decode_buffer_2, to_server);
+  }
+  set_counters(state, allocations, std::size(buffer));
+  state.counters["routed/msg"] = benchmark::Counter(static_cast<double>(controller.routed) / static_cast<double>(state.iterations()));
+}
+
+// note! decoded by client::Session, encoded by server::Session
+
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_reject, REJECT);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_reject, REJECT);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_logon, LOGON);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_logon, LOGON);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_logout, LOGOUT);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_logout, LOGOUT);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_heartbeat, HEARTBEAT);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_heartbeat, HEARTBEAT);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_test_request, TEST_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_test_request, TEST_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_resend_request, RESEND_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_resend_request, RESEND_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_business_message_reject, BUSINESS_MESSAGE_REJECT);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_business_message_reject, BUSINESS_MESSAGE_REJECT);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_trading_session_status_request, TRADING_SESSION_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_trading_session_status_request, TRADING_SESSION_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_security_list_request, SECURITY_LIST_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_security_list_request, SECURITY_LIST_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_security_definition_request, SECURITY_DEFINITION_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_security_definition_request, SECURITY_DEFINITION_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_security_status_request, SECURITY_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_security_status_request, SECURITY_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_market_data_request, MARKET_DATA_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_market_data_request, MARKET_DATA_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_new_order_single, NEW_ORDER_SINGLE);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_new_order_single, NEW_ORDER_SINGLE);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_order_cancel_replace_request, ORDER_CANCEL_REPLACE_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_order_cancel_replace_request, ORDER_CANCEL_REPLACE_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_order_cancel_request, ORDER_CANCEL_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_order_cancel_request, ORDER_CANCEL_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_order_mass_cancel_request, ORDER_MASS_CANCEL_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_order_mass_cancel_request, ORDER_MASS_CANCEL_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_order_status_request, ORDER_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_order_status_request, ORDER_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_order_mass_status_request, ORDER_MASS_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_order_mass_status_request, ORDER_MASS_STATUS_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_trade_capture_report_request, TRADE_CAPTURE_REPORT_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_trade_capture_report_request, TRADE_CAPTURE_REPORT_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_request_for_positions, REQUEST_FOR_POSITIONS);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_request_for_positions, REQUEST_FOR_POSITIONS);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_mass_quote, MASS_QUOTE);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_mass_quote, MASS_QUOTE);
+BENCHMARK_CAPTURE(BM_decode<client::Decoder>, client_quote_cancel, QUOTE_CANCEL);
+BENCHMARK_CAPTURE(BM_encode<client::Decoder>, server_quote_cancel, QUOTE_CANCEL);
+
+// note! decoded by server::Session, encoded by client::Session
+
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_reject, REJECT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_reject, REJECT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_logon, LOGON);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_logon, LOGON);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_logout, LOGOUT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_logout, LOGOUT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_heartbeat, HEARTBEAT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_heartbeat, HEARTBEAT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_test_request, TEST_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_test_request, TEST_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_resend_request, RESEND_REQUEST);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_resend_request, RESEND_REQUEST);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_business_message_reject, BUSINESS_MESSAGE_REJECT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_business_message_reject, BUSINESS_MESSAGE_REJECT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_trading_session_status, TRADING_SESSION_STATUS);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_trading_session_status, TRADING_SESSION_STATUS);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_security_list, SECURITY_LIST);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_security_list, SECURITY_LIST);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_security_definition, SECURITY_DEFINITION);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_security_definition, SECURITY_DEFINITION);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_security_status, SECURITY_STATUS);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_security_status, SECURITY_STATUS);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_market_data_request_reject, MARKET_DATA_REQUEST_REJECT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_market_data_request_reject, MARKET_DATA_REQUEST_REJECT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_market_data_snapshot_full_refresh, MARKET_DATA_SNAPSHOT_FULL_REFRESH);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_market_data_snapshot_full_refresh, MARKET_DATA_SNAPSHOT_FULL_REFRESH);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_market_data_incremental_refresh, MARKET_DATA_INCREMENTAL_REFRESH);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_market_data_incremental_refresh, MARKET_DATA_INCREMENTAL_REFRESH);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_execution_report, EXECUTION_REPORT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_execution_report, EXECUTION_REPORT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_order_cancel_reject, ORDER_CANCEL_REJECT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_order_cancel_reject, ORDER_CANCEL_REJECT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_order_mass_cancel_report, ORDER_MASS_CANCEL_REPORT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_order_mass_cancel_report, ORDER_MASS_CANCEL_REPORT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_trade_capture_report_request_ack, TRADE_CAPTURE_REPORT_REQUEST_ACK);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_trade_capture_report_request_ack, TRADE_CAPTURE_REPORT_REQUEST_ACK);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_trade_capture_report, TRADE_CAPTURE_REPORT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_trade_capture_report, TRADE_CAPTURE_REPORT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_request_for_positions_ack, REQUEST_FOR_POSITIONS_ACK);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_request_for_positions_ack, REQUEST_FOR_POSITIONS_ACK);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_position_report, POSITION_REPORT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_position_report, POSITION_REPORT);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_mass_quote_ack, MASS_QUOTE_ACK);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_mass_quote_ack, MASS_QUOTE_ACK);
+BENCHMARK_CAPTURE(BM_decode<server::Decoder>, server_quote_status_report, QUOTE_STATUS_REPORT);
+BENCHMARK_CAPTURE(BM_encode<server::Decoder>, client_quote_status_report, QUOTE_STATUS_REPORT);
+
+// note! responses routed back to the client session having sent the request (session-level messages are not routed)
+
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_trading_session_status, TRADING_SESSION_STATUS_REQUEST, TRADING_SESSION_STATUS, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_security_list, SECURITY_LIST_REQUEST, SECURITY_LIST, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_security_definition, SECURITY_DEFINITION_REQUEST, SECURITY_DEFINITION, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_security_status, SECURITY_STATUS_REQUEST, SECURITY_STATUS, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_market_data_request_reject, MARKET_DATA_REQUEST, MARKET_DATA_REQUEST_REJECT, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_market_data_snapshot_full_refresh, MARKET_DATA_REQUEST, MARKET_DATA_SNAPSHOT_FULL_REFRESH, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_market_data_incremental_refresh, MARKET_DATA_REQUEST, MARKET_DATA_INCREMENTAL_REFRESH, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_execution_report, NEW_ORDER_SINGLE, EXECUTION_REPORT, "123456789"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_trade_capture_report_request_ack, TRADE_CAPTURE_REPORT_REQUEST, TRADE_CAPTURE_REPORT_REQUEST_ACK, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_request_for_positions_ack, REQUEST_FOR_POSITIONS, REQUEST_FOR_POSITIONS_ACK, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_position_report, REQUEST_FOR_POSITIONS, POSITION_REPORT, "req1"sv);
+BENCHMARK_CAPTURE(BM_route<server::Decoder>, client_mass_quote_ack, MASS_QUOTE, MASS_QUOTE_ACK, "quote1"sv);
@@ -0,0 +1,108 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "roq/utils/codec/base64.hpp"
+
+#include "roq/utils/hash/sha256.hpp"
+
+#include "roq/utils/mac/hmac.hpp"
+
+#include "roq/fix_proxy/tools/crypto.hpp"
+
+#include "allocations.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+// === HELPERS ===
+
+namespace {
+struct User final {
+  std::string secret;
+  tools::Crypto::Key key;
+  std::string raw_data;
+  std::string password;
+};
+
+// note! logon storm: every user logs on with a distinct nonce
+auto create_users(size_t count) {
+  std::vector<User> result;
+  for (size_t i = 0; i < count; ++i) {
+    auto secret = "secret_"s + std::to_string(i);
+    auto key = tools::Crypto::create_key(secret);
+    auto raw_data = "nonce_"s + std::to_string(i * 7919);
+    tools::HMAC::Digest digest;
+    tools::HMAC::sign(digest, key, raw_data);
+    std::string password;
+    utils::codec::Base64::encode(password, digest, false, false);
+    result.push_back({
+        .secret = std::move(secret),
+        .key = key,
+        .raw_data = std::move(raw_data),
+        .password = std::move(password),
+    });
+  }
+  return result;
+}
+
+// note! this is the previous implementation
+bool validate_legacy(std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data) {
+  using MAC = utils::mac::HMAC<utils::hash::SHA256>;
+  std::array<std::byte, MAC::DIGEST_LENGTH> digest;
+  MAC mac{secret};
+  mac.update(raw_data);
+  auto result = mac.final(digest);
+  std::string signature;
+  utils::codec::Base64::encode(signature, result, false, false);
+  return signature == password;
+}
+
+template <typename Callback>
+void run(benchmark::State &state, Callback callback) {
+  auto users = create_users(state.range(0));
+  size_t index = {}, failures = {};
+  auto allocations = fix_proxy::Allocations::count();
+  for (auto _ : state) {
+    auto &user = users[index];
+    if (!callback(user)) [[unlikely]] {
+      ++failures;
+    }
+    if (++index == std::size(users)) {
+      index = {};
+    }
+  }
+  auto total = fix_proxy::Allocations::count() - allocations;
+  state.counters["allocs/logon"] = benchmark::Counter(static_cast<double>(total) / static_cast<double>(state.iterations()));
+  state.counters["failures"] = static_cast<double>(failures);
+  state.SetItemsProcessed(state.iterations());
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+void BM_crypto_validate_hmac_sha256_legacy(benchmark::State &state) {
+  run(state, [](auto &user) { return validate_legacy(user.password, user.secret, user.raw_data); });
+}
+
+BENCHMARK(BM_crypto_validate_hmac_sha256_legacy)->Arg(1)->Arg(10000);
+
+void BM_crypto_validate_hmac_sha256_create_key(benchmark::State &state) {
+  tools::Crypto crypto{"hmac_sha256"sv, 5s};
+  run(state, [&](auto &user) { return crypto.validate(user.password, user.secret, user.raw_data); });
+}
+
+BENCHMARK(BM_crypto_validate_hmac_sha256_create_key)->Arg(1)->Arg(10000);
+
+void BM_crypto_validate_hmac_sha256(benchmark::State &state) {
+  tools::Crypto crypto{"hmac_sha256"sv, 5s};
+  run(state, [&](auto &user) { return crypto.validate(user.password, user.secret, user.key, user.raw_data); });
+}
+
+BENCHMARK(BM_crypto_validate_hmac_sha256)->Arg(1)->Arg(10000);
@@ -0,0 +1,91 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "roq/fix_proxy/tools/encode_buffer.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+// === CONSTANTS ===
+
+namespace {
+size_t const PIPELINES = 3;                     // note! one per traffic class (order entry, market data, reference data)
+size_t const ENCODE_BUFFER_SIZE = 1024 * 1024;  // note! default --server_encode_buffer_size
+size_t const MESSAGE_LENGTH = 256;
+size_t const MESSAGES = 1000;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+size_t get_resident_memory() {
+  auto file = std::fopen("/proc/self/statm", "r");
+  if (file == nullptr) {
+    return 0;
+  }
+  size_t size = {}, resident = {};
+  [[maybe_unused]] auto result = std::fscanf(file, "%zu %zu", &size, &resident);
+  std::fclose(file);
+  return resident * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+// note! order entry, i.e. small messages
+template <typename T>
+void encode(T &encode_buffer) {
+  auto encoder = [](auto &buffer) {
+    std::memset(std::data(buffer), 'x', MESSAGE_LENGTH);
+    return MESSAGE_LENGTH;
+  };
+  for (size_t i = 0; i < MESSAGES; ++i) {
+    if constexpr (std::is_same_v<T, tools::EncodeBuffer>) {
+      benchmark::DoNotOptimize(encode_buffer.encode(encoder));
+    } else {
+      std::span<std::byte> buffer{encode_buffer};
+      benchmark::DoNotOptimize(encoder(buffer));
+    }
+  }
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+// note!
+// resident memory of the encode buffer owned by each pipeline (--server_pipeline_depth)
+// 0 = fixed size encode buffer (the pipeline before adaptive encode buffers), 1 = adaptive encode buffer
+void BM_encode_buffer_resident_memory(benchmark::State &state) {
+  auto adaptive = state.range(0) != 0;
+  size_t resident_memory = {};
+  for (auto _ : state) {
+    auto before = get_resident_memory();
+    if (adaptive) {
+      std::vector<std::unique_ptr<tools::EncodeBuffer>> pipelines;
+      for (size_t i = 0; i < PIPELINES; ++i) {
+        auto &encode_buffer = *pipelines.emplace_back(std::make_unique<tools::EncodeBuffer>(ENCODE_BUFFER_SIZE, 60s));
+        encode(encode_buffer);
+      }
+      resident_memory = get_resident_memory() - before;
+    } else {
+      std::vector<std::vector<std::byte>> pipelines;
+      for (size_t i = 0; i < PIPELINES; ++i) {
+        auto &encode_buffer = pipelines.emplace_back(ENCODE_BUFFER_SIZE);
+        encode(encode_buffer);
+      }
+      resident_memory = get_resident_memory() - before;
+    }
+  }
+  state.counters["rss_per_pipeline"] =
+      benchmark::Counter(static_cast<double>(resident_memory) / PIPELINES, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+BENCHMARK(BM_encode_buffer_resident_memory)->Arg(0)->Arg(1)->Iterations(1);
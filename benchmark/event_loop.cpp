@@ -0,0 +1,179 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <fmt/format.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "roq/io/buffer.hpp"
+#include "roq/io/context.hpp"
+
+#include "roq/io/engine/context_factory.hpp"
+
+#include "roq/fix_proxy/tools/context_wakeup.hpp"
+#include "roq/fix_proxy/tools/wakeup.hpp"
+
+using namespace std::literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+// === CONSTANTS ===
+
+namespace {
+std::byte const PING{'1'};
+std::byte const QUIT{'q'};
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+// note! the same modes as Controller::run
+enum class Mode {
+  BLOCKING,  // context.dispatch()
+  SHARDS,    // context.dispatch(), woken up by another thread through tools::ContextWakeup (--client_io_threads)
+  SPINNING,  // context.drain() (--loop_busy_poll)
+};
+
+// note! stands in for the event loop thread, a socket owned by the proxy's io::Context acknowledges every wake-up through a shared counter
+// the shards mode is instead woken up the same way as by a shard (tools::Wakeup::notify)
+struct Loop final : public io::net::tcp::Listener::Handler, public io::net::tcp::Connection::Handler, public tools::ContextWakeup::Handler {
+  explicit Loop(Mode mode)
+      : mode_{mode}, path_{fmt::format("/tmp/roq-fix-proxy-benchmark-{}.sock"sv, ::getpid())}, context_{io::engine::ContextFactory::create()} {
+    ::unlink(path_.c_str());
+    listener_ = (*context_).create_tcp_listener(*this, io::NetworkAddress{path_});
+    if (mode_ == Mode::SHARDS) {
+      context_wakeup_ = std::make_unique<tools::ContextWakeup>(*this, *context_, wakeup_);
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct sockaddr_un sockaddr = {};
+    sockaddr.sun_family = AF_UNIX;
+    std::strncpy(sockaddr.sun_path, path_.c_str(), sizeof(sockaddr.sun_path) - 1);
+    if (::connect(fd_, reinterpret_cast<struct sockaddr const *>(&sockaddr), sizeof(sockaddr)) < 0) {
+      throw std::runtime_error{fmt::format("Unable to connect (error={})"sv, std::strerror(errno))};
+    }
+    thread_ = std::thread{[this]() { run(); }};
+    while (!connected_.load(std::memory_order_acquire)) {
+    }
+  }
+
+  ~Loop() {
+    send(QUIT);
+    thread_.join();
+    ::close(fd_);
+    ::unlink(path_.c_str());
+  }
+
+  void wake_up() {
+    if (mode_ == Mode::SHARDS) {
+      wakeup_.notify();
+    } else {
+      send(PING);
+    }
+  }
+
+  std::atomic<uint64_t> dispatched = {};
+
+ protected:
+  // io::net::tcp::Listener::Handler
+  void operator()(io::net::tcp::Connection::Factory &factory) override { accept(factory); }
+  void operator()(io::net::tcp::Connection::Factory &factory, io::NetworkAddress const &) override { accept(factory); }
+
+  // io::net::tcp::Connection::Handler
+  void operator()(io::net::tcp::Connection::Read const &) override {
+    buffer_.append(*connection_);
+    auto data = buffer_.data();
+    for (auto value : data) {
+      if (value == QUIT) {
+        stop_ = true;
+        (*context_).stop();
+      } else {
+        dispatched.fetch_add(1, std::memory_order_release);
+      }
+    }
+    buffer_.drain(std::size(data));
+  }
+
+  void operator()(io::net::tcp::Connection::Disconnected const &) override {}
+
+  // tools::ContextWakeup::Handler
+  void operator()(tools::ContextWakeup::Notified const &) override {
+    wakeup_.prepare();  // note! before acknowledging (the next notification must not be missed)
+    dispatched.fetch_add(1, std::memory_order_release);
+  }
+
+  void accept(io::net::tcp::Connection::Factory &factory) {
+    connection_ = factory.create(*this);
+    connected_.store(true, std::memory_order_release);
+  }
+
+  void send(std::byte value) { [[maybe_unused]] auto result = ::write(fd_, &value, sizeof(value)); }
+
+  void run() {
+    switch (mode_) {
+      using enum Mode;
+      case BLOCKING:
+        (*context_).dispatch();
+        break;
+      case SHARDS:
+        wakeup_.prepare();
+        (*context_).dispatch();
+        break;
+      case SPINNING:
+        while (!stop_) {
+          (*context_).drain();
+        }
+        break;
+    }
+    connection_.reset();
+    listener_.reset();
+    context_wakeup_.reset();
+  }
+
+ private:
+  Mode const mode_;
+  std::string const path_;
+  std::unique_ptr<io::Context> const context_;
+  std::unique_ptr<io::net::tcp::Listener> listener_;
+  std::unique_ptr<io::net::tcp::Connection> connection_;
+  io::Buffer buffer_;
+  tools::Wakeup wakeup_;
+  std::unique_ptr<tools::ContextWakeup> context_wakeup_;
+  bool stop_ = {};  // note! only accessed by the loop thread
+  std::atomic<bool> connected_;
+  int fd_ = -1;
+  std::thread thread_;
+};
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+// note! latency from a socket becoming readable (or a shard notifying) until it has been dispatched (0 = blocking, 1 = shards, 2 = busy polling)
+void BM_event_loop_wake_up(benchmark::State &state) {
+  Loop loop{static_cast<Mode>(state.range(0))};
+  uint64_t expected = {};
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    loop.wake_up();
+    ++expected;
+    while (loop.dispatched.load(std::memory_order_acquire) != expected) {
+    }
+    auto stop = std::chrono::steady_clock::now();
+    state.SetIterationTime(std::chrono::duration<double>(stop - start).count());
+  }
+}
+
+BENCHMARK(BM_event_loop_wake_up)->Arg(0)->Arg(1)->Arg(2)->UseManualTime();
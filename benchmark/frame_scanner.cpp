@@ -0,0 +1,144 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <fmt/format.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+// === CONSTANTS ===
+
+namespace {
+size_t const BUFFER_SIZE = 1024 * 1024;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_message(std::string_view const &body) {
+  auto result = fmt::format("8=FIX.4.4\x01"
+                            "9={}\x01"
+                            "{}"sv,
+                            std::size(body),
+                            body);
+  uint32_t sum = {};
+  for (auto c : result) {
+    sum += static_cast<uint8_t>(c);
+  }
+  return fmt::format("{}10={:03}\x01"sv, result, sum % 256);
+}
+
+// note! resembles upstream traffic: mostly execution reports and market data, some heartbeats
+auto create_traffic() {
+  auto heartbeat = create_message(
+      "35=0\x01"
+      "49=server\x01"
+      "56=proxy\x01"
+      "34=1\x01"
+      "52=20260101-00:00:00.000\x01"sv);
+  auto execution_report = create_message(
+      "35=8\x01"
+      "49=server\x01"
+      "56=proxy\x01"
+      "34=2\x01"
+      "52=20260101-00:00:00.000\x01"
+      "37=abcdef0123456789\x01"
+      "11=123456789\x01"
+      "17=fedcba9876543210\x01"
+      "150=F\x01"
+      "39=1\x01"
+      "55=BTC-PERPETUAL\x01"
+      "207=deribit\x01"
+      "54=1\x01"
+      "38=10\x01"
+      "44=100000\x01"
+      "32=1\x01"
+      "31=100000\x01"
+      "151=9\x01"
+      "14=1\x01"
+      "6=100000\x01"
+      "60=20260101-00:00:00.000\x01"sv);
+  std::string entries;
+  for (size_t i = 0; i < 40; ++i) {
+    entries += fmt::format("269={}\x01"
+                           "270={}.5\x01"
+                           "271={}\x01"sv,
+                           i % 2,
+                           100000 + i,
+                           i + 1);
+  }
+  auto market_data = create_message(fmt::format(
+      "35=W\x01"
+      "49=server\x01"
+      "56=proxy\x01"
+      "34=3\x01"
+      "52=20260101-00:00:00.000\x01"
+      "55=BTC-PERPETUAL\x01"
+      "207=deribit\x01"
+      "268=40\x01"
+      "{}"sv,
+      entries));
+  std::string result;
+  std::mt19937 engine{42};
+  while (std::size(result) < BUFFER_SIZE) {
+    auto choice = engine() % 10;
+    if (choice == 0) {
+      result += heartbeat;
+    } else if (choice < 6) {
+      result += execution_report;
+    } else {
+      result += market_data;
+    }
+  }
+  return result;
+}
+
+auto to_span(std::string const &value) {
+  return std::span{reinterpret_cast<std::byte const *>(std::data(value)), std::size(value)};
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+// note! 0 = skip checksum validation, 1 = validate checksum
+void BM_frame_scanner_scan(benchmark::State &state) {
+  tools::FrameScanner scanner{state.range(0) != 0};
+  auto traffic = create_traffic();
+  auto buffer = to_span(traffic);
+  std::vector<std::span<std::byte const>> frames;
+  for (auto _ : state) {
+    frames.clear();
+    auto result = scanner.scan(buffer, frames);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * std::size(buffer));
+  state.counters["frames"] = static_cast<double>(std::size(frames));
+}
+
+BENCHMARK(BM_frame_scanner_scan)->Arg(0)->Arg(1);
+
+// note! 0 = scalar, 1 = avx2
+void BM_frame_scanner_checksum(benchmark::State &state) {
+  if (state.range(0) != 0 && !tools::FrameScanner::has_avx2()) {
+    state.SkipWithError("AVX2 is not supported");
+    return;
+  }
+  auto checksum = state.range(0) != 0 ? tools::FrameScanner::checksum_avx2 : tools::FrameScanner::checksum_scalar;
+  auto traffic = create_traffic();
+  auto buffer = to_span(traffic);
+  for (auto _ : state) {
+    auto result = (*checksum)(buffer);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * std::size(buffer));
+}
+
+BENCHMARK(BM_frame_scanner_checksum)->Arg(0)->Arg(1);
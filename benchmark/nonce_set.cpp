@@ -0,0 +1,37 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include "roq/fix_proxy/tools/nonce_set.hpp"
+
+#include "allocations.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq::fix_proxy;
+
+// === IMPLEMENTATION ===
+
+// note! logon rate is given as logons per millisecond, the clock advances by 1ms per batch
+void BM_nonce_set_insert(benchmark::State &state) {
+  tools::NonceSet nonce_set{5s};
+  auto rate = static_cast<uint64_t>(state.range(0));
+  auto now = 1700000000000ms;
+  uint64_t fingerprint = {}, counter = {};
+  auto allocations = Allocations::count();
+  for (auto _ : state) {
+    auto result = nonce_set.insert(now, ++fingerprint * 0x9e3779b97f4a7c15);
+    benchmark::DoNotOptimize(result);
+    if (++counter == rate) {
+      counter = {};
+      now += 1ms;
+    }
+  }
+  state.counters["allocs/insert"] =
+      benchmark::Counter(static_cast<double>(Allocations::count() - allocations) / static_cast<double>(state.iterations()));
+  state.counters["size"] = static_cast<double>(nonce_set.size());
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_nonce_set_insert)->Arg(1)->Arg(10)->Arg(100);
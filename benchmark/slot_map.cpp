@@ -0,0 +1,119 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "roq/utils/container.hpp"
+
+#include "roq/fix_proxy/tools/slot_map.hpp"
+
+using namespace std::literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+// === HELPERS ===
+
+namespace {
+// note! stands in for a session
+struct Value final {
+  explicit Value(uint64_t key) : key{key} {}
+
+  Value(Value const &) = delete;
+
+  uint64_t const key;
+  std::array<std::byte, 512> payload = {};
+};
+
+// note! random access pattern (sessions are looked up for each message)
+auto create_order(auto &keys) {
+  std::vector<uint64_t> result{std::begin(keys), std::end(keys)};
+  std::mt19937_64 engine{42};
+  std::shuffle(std::begin(result), std::end(result), engine);
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+void BM_slot_map_find(benchmark::State &state) {
+  tools::SlotMap<Value> slot_map;
+  std::vector<uint64_t> keys;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    keys.emplace_back(slot_map.emplace([](auto key) { return Value{key}; }).key);
+  }
+  auto order = create_order(keys);
+  size_t index = {};
+  for (auto _ : state) {
+    auto value = slot_map.find(order[index]);
+    benchmark::DoNotOptimize(value);
+    if (++index == std::size(order)) {
+      index = {};
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_slot_map_find)->Arg(100)->Arg(10000);
+
+// note! previous implementation
+void BM_unordered_map_find(benchmark::State &state) {
+  utils::unordered_map<uint64_t, std::unique_ptr<Value>> map;
+  std::vector<uint64_t> keys;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    auto key = static_cast<uint64_t>(i + 1);
+    map.try_emplace(key, std::make_unique<Value>(key));
+    keys.emplace_back(key);
+  }
+  auto order = create_order(keys);
+  size_t index = {};
+  for (auto _ : state) {
+    auto iter = map.find(order[index]);
+    auto value = (*iter).second.get();
+    benchmark::DoNotOptimize(value);
+    if (++index == std::size(order)) {
+      index = {};
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_unordered_map_find)->Arg(100)->Arg(10000);
+
+void BM_slot_map_iterate(benchmark::State &state) {
+  tools::SlotMap<Value> slot_map;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    slot_map.emplace([](auto key) { return Value{key}; });
+  }
+  for (auto _ : state) {
+    uint64_t sum = {};
+    slot_map.for_each([&](auto &value) { sum += value.key; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_slot_map_iterate)->Arg(10000);
+
+void BM_unordered_map_iterate(benchmark::State &state) {
+  utils::unordered_map<uint64_t, std::unique_ptr<Value>> map;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    auto key = static_cast<uint64_t>(i + 1);
+    map.try_emplace(key, std::make_unique<Value>(key));
+  }
+  for (auto _ : state) {
+    uint64_t sum = {};
+    for (auto &[_, value] : map) {
+      sum += (*value).key;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_unordered_map_iterate)->Arg(10000);
@@ -0,0 +1,20 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <absl/flags/parse.h>
+#include <absl/flags/usage.h>
+
+#include <string_view>
+#include <vector>
+
+#include "printer.hpp"
+#include "settings.hpp"
+
+// === IMPLEMENTATION ===
+
+int main(int argc, char **argv) {
+  absl::SetProgramUsageMessage("Pretty-print journal segments captured by roq-fix-proxy (--journal_path)\n\nUsage: roq-fix-proxy-journal [flags] <segment>...");
+  auto args = absl::ParseCommandLine(argc, argv);
+  std::vector<std::string_view> paths(std::begin(args) + 1, std::end(args));
+  auto settings = roq::fix_proxy::journal::Settings::create();
+  return roq::fix_proxy::journal::Printer{settings}.run(paths);
+}
@@ -0,0 +1,173 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "printer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <magic_enum/magic_enum_format.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include "roq/logging.hpp"
+
+#include "roq/utils/debug/fix/message.hpp"
+#include "roq/utils/debug/hex/message.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace journal {
+
+// === HELPERS ===
+
+namespace {
+auto get_name(tools::Journal::Peer peer) {
+  switch (peer) {
+    using enum tools::Journal::Peer;
+    case CLIENT:
+      return "client"sv;
+    case SERVER:
+      return "server"sv;
+  }
+  assert(false);
+  return "?"sv;
+}
+
+// note! from the perspective of the proxy
+auto get_name(tools::Journal::Direction direction) {
+  switch (direction) {
+    using enum tools::Journal::Direction;
+    case INBOUND:
+      return "<="sv;
+    case OUTBOUND:
+      return "=>"sv;
+  }
+  assert(false);
+  return "?"sv;
+}
+
+// note! read-only mapping of a segment (released when the callback returns)
+template <typename Callback>
+bool map_file(std::string_view const &path, Callback callback) {
+  auto path_2 = std::string{path};
+  auto fd = ::open(path_2.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    log::error(R"(Unable to open (path="{}", errno={}))"sv, path, errno);
+    return false;
+  }
+  struct stat stat = {};
+  if (::fstat(fd, &stat) < 0) {
+    log::error(R"(Unable to stat (path="{}", errno={}))"sv, path, errno);
+    ::close(fd);
+    return false;
+  }
+  auto length = static_cast<size_t>(stat.st_size);
+  if (length == 0) {
+    ::close(fd);
+    return callback(std::span<std::byte const>{});
+  }
+  auto address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    log::error(R"(Unable to map (path="{}", errno={}))"sv, path, errno);
+    return false;
+  }
+  auto result = callback(std::span<std::byte const>{static_cast<std::byte const *>(address), length});
+  ::munmap(address, length);
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Printer::Printer(Settings const &settings) : settings_{settings} {
+}
+
+int Printer::run(std::span<std::string_view const> const &paths) {
+  if (std::empty(paths)) {
+    log::fatal("Unexpected: no segments (see --help)"sv);
+  }
+  auto result = EXIT_SUCCESS;
+  for (auto &path : paths) {
+    if (!process(path)) {
+      result = EXIT_FAILURE;
+    }
+  }
+  return result;
+}
+
+bool Printer::process(std::string_view const &path) {
+  return map_file(path, [&](auto const &data) {
+    records_.clear();
+    auto callback = [&](auto &record) {
+      if (!filter(record)) {
+        return;
+      }
+      if (settings_.sort) {
+        records_.emplace_back(record);  // note! message references the mapping
+      } else {
+        print(record);
+      }
+    };
+    auto status = tools::JournalReader{data}.dispatch(callback);
+    if (settings_.sort) {
+      std::stable_sort(std::begin(records_), std::end(records_), [](auto &lhs, auto &rhs) { return lhs.timestamp < rhs.timestamp; });
+      for (auto &record : records_) {
+        print(record);
+      }
+    }
+    switch (status) {
+      using enum tools::JournalReader::Status;
+      case OK:
+        return true;
+      case TRUNCATED:
+        log::warn(R"(Segment is truncated (path="{}"))"sv, path);  // note! expected if the proxy did not terminate cleanly
+        return true;
+      case INVALID_HEADER:
+      case UNSUPPORTED_VERSION:
+        break;
+    }
+    log::error(R"(Unable to read segment (path="{}", status={}))"sv, path, status);
+    return false;
+  });
+}
+
+bool Printer::filter(tools::JournalReader::Record const &record) const {
+  if (settings_.peer.has_value() && record.peer != *settings_.peer) {
+    return false;
+  }
+  if (settings_.session_id != 0 && (record.peer != tools::Journal::Peer::CLIENT || record.session_id != settings_.session_id)) {
+    return false;
+  }
+  return true;
+}
+
+void Printer::print(tools::JournalReader::Record const &record) const {
+  auto realtime = std::chrono::sys_time<std::chrono::nanoseconds>{record.realtime};
+  fmt::print(
+      "{:%Y-%m-%dT%H:%M:%S}Z {} {} session_id={} {}\n"sv,
+      realtime,
+      get_name(record.peer),
+      get_name(record.direction),
+      record.session_id,
+      utils::debug::fix::Message{record.message});
+  if (settings_.hex) {
+    fmt::print("{}\n"sv, utils::debug::hex::Message{record.message});
+  }
+}
+
+}  // namespace journal
+}  // namespace fix_proxy
+}  // namespace roq
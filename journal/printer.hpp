@@ -0,0 +1,39 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "roq/fix_proxy/tools/journal_reader.hpp"
+
+#include "settings.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace journal {
+
+struct Printer final {
+  explicit Printer(Settings const &);
+
+  Printer(Printer const &) = delete;
+
+  // note! returns the exit code
+  int run(std::span<std::string_view const> const &paths);
+
+ protected:
+  bool process(std::string_view const &path);
+
+  bool filter(tools::JournalReader::Record const &) const;
+
+  void print(tools::JournalReader::Record const &) const;
+
+ private:
+  Settings const &settings_;
+  std::vector<tools::JournalReader::Record> records_;  // note! only used when sorting
+};
+
+}  // namespace journal
+}  // namespace fix_proxy
+}  // namespace roq
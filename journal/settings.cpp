@@ -0,0 +1,57 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "settings.hpp"
+
+#include <absl/flags/flag.h>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+// === FLAGS ===
+
+ABSL_FLAG(std::string, peer, {}, "Only print messages exchanged with this peer (client or server, empty means all)");
+ABSL_FLAG(uint64_t, session_id, 0, "Only print messages exchanged with this client session (0 means all)");
+
+ABSL_FLAG(bool, sort, false, "Sort the records of each segment by timestamp (records are otherwise ordered per capturing thread)");
+ABSL_FLAG(bool, hex, false, "Also print a hex dump of each message");
+
+namespace roq {
+namespace fix_proxy {
+namespace journal {
+
+// === HELPERS ===
+
+namespace {
+auto get_peer(auto const &value) -> std::optional<tools::Journal::Peer> {
+  if (std::empty(value)) {
+    return {};
+  }
+  if (value == "client"sv) {
+    return tools::Journal::Peer::CLIENT;
+  }
+  if (value != "server"sv) {
+    log::fatal(R"(Unexpected: peer="{}")"sv, value);
+  }
+  return tools::Journal::Peer::SERVER;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Settings Settings::create() {
+  auto result = Settings{
+      .peer = get_peer(absl::GetFlag(FLAGS_peer)),
+      .session_id = absl::GetFlag(FLAGS_session_id),
+      .sort = absl::GetFlag(FLAGS_sort),
+      .hex = absl::GetFlag(FLAGS_hex),
+  };
+  if (result.session_id != 0 && result.peer == tools::Journal::Peer::SERVER) {
+    log::fatal("Unexpected: session_id only applies to client sessions"sv);
+  }
+  return result;
+}
+
+}  // namespace journal
+}  // namespace fix_proxy
+}  // namespace roq
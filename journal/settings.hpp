@@ -0,0 +1,27 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "roq/fix_proxy/tools/journal.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace journal {
+
+struct Settings final {
+  static Settings create();
+
+  // filter
+  std::optional<tools::Journal::Peer> peer;
+  uint64_t session_id = {};
+  // output
+  bool sort = {};
+  bool hex = {};
+};
+
+}  // namespace journal
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,300 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "bridge.hpp"
+
+#include <sys/epoll.h>
+
+#include <algorithm>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+size_t const MARKET_DATA_HISTORY = 1 << 20;  // note! power of two
+
+size_t const MAX_BURST = 100;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto get_interval(auto rate) -> std::chrono::nanoseconds {
+  if (rate <= 0.0) {
+    return {};
+  }
+  return std::chrono::nanoseconds{static_cast<int64_t>(1.0e9 / rate)};
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Bridge::Bridge(
+    tools::Poller &poller,
+    Settings const &settings,
+    std::string_view const &sender_comp_id,
+    std::string_view const &target_comp_id,
+    Handler *handler,
+    std::optional<uint16_t> port)
+    : poller_{poller}, handler_{handler}, passive_{!std::empty(settings.replay)}, market_data_interval_{get_interval(settings.market_data_rate)},
+      market_data_burst_{settings.market_data_burst}, listener_{Connection::listen(port.value_or(settings.bridge_port))},
+      port_{Connection::get_port(listener_)}, acceptor_{*this}, encoder_{sender_comp_id, target_comp_id}, market_data_sent_(MARKET_DATA_HISTORY) {
+  poller_.add(listener_, acceptor_);
+  log::info("Bridge is listening on port={}"sv, port_);
+}
+
+std::chrono::nanoseconds Bridge::market_data_sent(uint64_t sequence) const {
+  if (sequence == 0 || sequence > sequence_ || (sequence_ - sequence) >= MARKET_DATA_HISTORY) {
+    return {};
+  }
+  return market_data_sent_[sequence & (MARKET_DATA_HISTORY - 1)];
+}
+
+void Bridge::refresh(std::chrono::nanoseconds now) {
+  if (closing_) {
+    close();
+  }
+  if (!ready_ || std::empty(subscriptions_) || market_data_interval_.count() == 0) {
+    return;
+  }
+  if (next_publish_.count() == 0) {
+    next_publish_ = now;
+  }
+  for (size_t i = 0; i < MAX_BURST && next_publish_ <= now; ++i) {
+    for (uint32_t j = 0; j < market_data_burst_; ++j) {
+      publish();
+    }
+    next_publish_ += market_data_interval_;
+  }
+  if (next_publish_ <= now) [[unlikely]] {
+    next_publish_ = now + market_data_interval_;  // note! falling behind, rate is not sustainable
+  }
+  if (closing_) {
+    close();
+  }
+}
+
+// tools::Poller::Handler
+
+void Bridge::operator()(uint32_t events) {
+  if (!connection_) {
+    return;
+  }
+  if (events & EPOLLOUT) {
+    closing_ |= !(*connection_).flush();
+  }
+  if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+    closing_ |= !(*connection_).read([&](auto &message) { parse(message); });
+  }
+  if (closing_) {
+    close();
+  }
+}
+
+void Bridge::accept() {
+  auto fd = Connection::accept(listener_);
+  if (fd < 0) {
+    return;
+  }
+  if (connection_) {
+    log::warn("Replacing the existing upstream connection"sv);
+    close();
+  }
+  log::info("Bridge has accepted the upstream connection"sv);
+  connection_ = std::make_unique<Connection>(poller_, *this, fd);
+}
+
+void Bridge::close() {
+  if (!connection_) {
+    return;
+  }
+  log::info("Bridge has lost the upstream connection"sv);
+  if (ready_) {
+    ++disconnects_;
+  }
+  connection_.reset();
+  closing_ = false;
+  ready_ = false;
+  subscriptions_.clear();
+  next_publish_ = {};
+  encoder_.reset();
+}
+
+void Bridge::parse(std::span<std::byte const> const &message) {
+  ++messages_;
+  auto msg_type = find(message, "35"sv);
+  if (msg_type == "0"sv) {
+    // note! heartbeat
+  } else if (msg_type == "1"sv) {
+    on_test_request(message);
+  } else if (msg_type == "A"sv) {
+    on_logon(message);
+  } else if (msg_type == "5"sv) {
+    on_logout(message);
+  } else if (msg_type == "BE"sv) {
+    on_user_request(message);
+  } else if (passive_) {
+    if (handler_ != nullptr) {
+      (*handler_)(message);  // note! the recorded responses are replayed
+    }
+  } else if (msg_type == "V"sv) {
+    on_market_data_request(message);
+  } else if (msg_type == "D"sv) {
+    on_new_order_single(message);
+  } else {
+    on_unsupported(message);
+  }
+}
+
+void Bridge::on_logon(std::span<std::byte const> const &message) {
+  send(
+      "A"sv,
+      "98=0\x01"
+      "108={}\x01"
+      "141=Y\x01",
+      find(message, "108"sv));
+  ready_ = true;
+  log::info("Bridge is ready"sv);
+}
+
+void Bridge::on_logout(std::span<std::byte const> const &) {
+  send("5"sv, "");
+  ready_ = false;
+}
+
+void Bridge::on_test_request(std::span<std::byte const> const &message) {
+  send("0"sv, "112={}\x01", find(message, "112"sv));
+}
+
+void Bridge::on_user_request(std::span<std::byte const> const &message) {
+  send(
+      "BF"sv,
+      "923={}\x01"
+      "553={}\x01"
+      "926=1\x01",  // note! logged in
+      find(message, "923"sv),
+      find(message, "553"sv));
+}
+
+void Bridge::on_market_data_request(std::span<std::byte const> const &message) {
+  auto md_req_id = find(message, "262"sv);
+  auto iter = std::find_if(std::begin(subscriptions_), std::end(subscriptions_), [&](auto &item) { return item.md_req_id == md_req_id; });
+  if (find(message, "263"sv) == "2"sv) {  // note! unsubscribe
+    if (iter != std::end(subscriptions_)) {
+      subscriptions_.erase(iter);
+    }
+    return;
+  }
+  auto symbol = find(message, "55"sv);
+  auto exchange = find(message, "207"sv);
+  if (iter == std::end(subscriptions_)) {
+    subscriptions_.emplace_back(Subscription{
+        .md_req_id = std::string{md_req_id},
+        .symbol = std::string{symbol},
+        .exchange = std::string{exchange},
+    });
+  }
+  send(
+      "W"sv,
+      "262={}\x01"
+      "55={}\x01"
+      "207={}\x01"
+      "268=2\x01"
+      "269=0\x01"
+      "270=100\x01"
+      "271=1\x01"
+      "269=1\x01"
+      "270=101\x01"
+      "271=1\x01",
+      md_req_id,
+      symbol,
+      exchange);
+}
+
+void Bridge::on_new_order_single(std::span<std::byte const> const &message) {
+  auto order_id = ++order_id_;
+  auto quantity = find(message, "38"sv);
+  send(
+      "8"sv,
+      "37={}\x01"
+      "11={}\x01"
+      "17={}\x01"
+      "150=0\x01"
+      "39=0\x01"
+      "1={}\x01"
+      "55={}\x01"
+      "207={}\x01"
+      "54={}\x01"
+      "40={}\x01"
+      "38={}\x01"
+      "44={}\x01"
+      "151={}\x01"
+      "14=0\x01"
+      "6=0\x01"
+      "60={}\x01",
+      order_id,
+      find(message, "11"sv),
+      order_id,
+      find(message, "1"sv),
+      find(message, "55"sv),
+      find(message, "207"sv),
+      find(message, "54"sv),
+      find(message, "40"sv),
+      quantity,
+      find(message, "44"sv),
+      quantity,
+      encoder_.timestamp());
+}
+
+void Bridge::on_unsupported(std::span<std::byte const> const &message) {
+  auto msg_type = find(message, "35"sv);
+  log::warn("Bridge does not support msg_type={}"sv, msg_type);
+  send(
+      "j"sv,
+      "45={}\x01"
+      "372={}\x01"
+      "380=3\x01",  // note! unsupported message type
+      find(message, "34"sv),
+      msg_type);
+}
+
+void Bridge::publish() {
+  if (!connection_) {
+    return;
+  }
+  for (auto &subscription : subscriptions_) {
+    auto sequence = ++sequence_;
+    auto message = encoder_.encode(
+        "X"sv,
+        "262={}\x01"
+        "268=1\x01"
+        "279=1\x01"
+        "269={}\x01"
+        "55={}\x01"
+        "207={}\x01"
+        "270={}\x01"
+        "271={}\x01",
+        subscription.md_req_id,
+        sequence & 1,
+        subscription.symbol,
+        subscription.exchange,
+        100 + (sequence % 10),
+        sequence);
+    market_data_sent_[sequence & (MARKET_DATA_HISTORY - 1)] = clock::get_system();
+    if (!(*connection_).write(message)) {
+      closing_ = true;
+      return;
+    }
+  }
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,135 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "roq/fix_proxy/tools/poller.hpp"
+
+#include "connection.hpp"
+#include "fix.hpp"
+#include "settings.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// stands in for the fix-bridge, i.e. the upstream connection of the proxy
+// logon and user requests are accepted, orders are acknowledged immediately and market data is streamed at a fixed rate (optionally in bursts)
+// the sequence number of each market data update is carried by MDEntrySize and the send time is remembered
+// when replaying, application messages are forwarded to the handler (the recorded responses are replayed instead)
+
+struct Bridge final : public tools::Poller::Handler {
+  struct Handler {
+    // note! replay: application message received from the proxy
+    virtual void operator()(std::span<std::byte const> const &message) = 0;
+  };
+
+  // note! port overrides settings.bridge_port (used by the dedicated market data session)
+  Bridge(
+      tools::Poller &,
+      Settings const &,
+      std::string_view const &sender_comp_id,
+      std::string_view const &target_comp_id,
+      Handler * = nullptr,
+      std::optional<uint16_t> port = std::nullopt);
+
+  Bridge(Bridge &&) = delete;
+  Bridge(Bridge const &) = delete;
+
+  uint16_t port() const { return port_; }
+
+  bool ready() const { return ready_; }
+
+  size_t subscriptions() const { return std::size(subscriptions_); }
+  size_t disconnects() const { return disconnects_; }
+  uint64_t messages() const { return messages_; }
+
+  // note! returns zero if unknown
+  std::chrono::nanoseconds market_data_sent(uint64_t sequence) const;
+
+  void refresh(std::chrono::nanoseconds now);
+
+  // note! one market data update per subscription (also used to publish on demand)
+  void publish();
+
+  // note! drops the upstream connection (the proxy is expected to reconnect)
+  void close();
+
+  // note! body excludes the standard header and trailer
+  void replay(std::string_view const &msg_type, std::string_view const &body) { send(msg_type, "{}", body); }
+
+ protected:
+  // tools::Poller::Handler
+  void operator()(uint32_t events) override;
+
+  void accept();
+
+  void parse(std::span<std::byte const> const &message);
+
+  void on_logon(std::span<std::byte const> const &message);
+  void on_logout(std::span<std::byte const> const &message);
+  void on_test_request(std::span<std::byte const> const &message);
+  void on_user_request(std::span<std::byte const> const &message);
+  void on_market_data_request(std::span<std::byte const> const &message);
+  void on_new_order_single(std::span<std::byte const> const &message);
+  void on_unsupported(std::span<std::byte const> const &message);
+
+  template <typename... Args>
+  void send(std::string_view const &msg_type, fmt::format_string<Args...> const &body, Args &&...args) {
+    if (!connection_) {
+      return;
+    }
+    auto message = encoder_.encode(msg_type, body, std::forward<Args>(args)...);
+    if (!(*connection_).write(message)) {
+      closing_ = true;  // note! closed by the caller (the inbound buffer may still be referenced)
+    }
+  }
+
+ private:
+  struct Acceptor final : public tools::Poller::Handler {
+    explicit Acceptor(Bridge &bridge) : bridge_{bridge} {}
+    void operator()(uint32_t) override { bridge_.accept(); }
+
+   private:
+    Bridge &bridge_;
+  };
+
+  struct Subscription final {
+    std::string md_req_id;
+    std::string symbol;
+    std::string exchange;
+  };
+
+  tools::Poller &poller_;
+  Handler *const handler_;
+  bool const passive_;
+  std::chrono::nanoseconds const market_data_interval_;
+  uint32_t const market_data_burst_;
+  int const listener_;
+  uint16_t const port_;
+  Acceptor acceptor_;
+  Encoder encoder_;
+  std::unique_ptr<Connection> connection_;
+  bool closing_ = {};
+  bool ready_ = {};
+  size_t disconnects_ = {};
+  uint64_t messages_ = {};
+  uint64_t order_id_ = {};
+  std::vector<Subscription> subscriptions_;
+  std::chrono::nanoseconds next_publish_ = {};
+  uint64_t sequence_ = {};
+  std::vector<std::chrono::nanoseconds> market_data_sent_;
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
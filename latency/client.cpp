@@ -0,0 +1,255 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "client.hpp"
+
+#include <sys/epoll.h>
+
+#include <algorithm>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+size_t const ORDER_HISTORY = 1 << 16;  // note! power of two
+
+size_t const MAX_BURST = 100;
+
+auto const RECONNECT_DELAY = 100ms;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto get_interval(auto rate) -> std::chrono::nanoseconds {
+  if (rate <= 0.0) {
+    return {};
+  }
+  return std::chrono::nanoseconds{static_cast<int64_t>(1.0e9 / rate)};
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Client::Client(
+    tools::Poller &poller,
+    Settings const &settings,
+    Bridge const &bridge,
+    Histograms const &histograms,
+    uint16_t port,
+    std::string_view const &sender_comp_id,
+    std::string_view const &target_comp_id,
+    std::string_view const &username,
+    std::string_view const &password,
+    bool market_data,
+    uint32_t source_address)
+    : poller_{poller}, bridge_{bridge}, histograms_{histograms}, port_{port}, source_address_{source_address}, username_{username}, password_{password},
+      account_{settings.account}, exchange_{settings.exchange}, symbol_{settings.symbol}, market_data_{market_data},
+      kernel_timestamps_{settings.kernel_timestamps}, order_interval_{get_interval(settings.order_rate)}, encoder_{sender_comp_id, target_comp_id} {
+  if (order_interval_.count() != 0) {
+    order_sent_.resize(ORDER_HISTORY);  // note! only when orders are sent (many clients may be created)
+  }
+}
+
+void Client::refresh(std::chrono::nanoseconds now) {
+  switch (state_) {
+    using enum State;
+    case DISCONNECTED:
+      if (next_connect_ <= now) {
+        connect(now);
+      }
+      break;
+    case LOGON_SENT:
+      break;
+    case READY:
+      if (order_interval_.count() == 0) {
+        break;
+      }
+      if (next_order_.count() == 0) {
+        next_order_ = now;
+      }
+      for (size_t i = 0; i < MAX_BURST && next_order_ <= now && !closing_; ++i) {
+        send_new_order_single();
+        next_order_ += order_interval_;
+      }
+      if (next_order_ <= now) [[unlikely]] {
+        next_order_ = now + order_interval_;  // note! falling behind, rate is not sustainable
+      }
+      break;
+  }
+  if (closing_) {
+    close();
+  }
+}
+
+// tools::Poller::Handler
+
+void Client::operator()(uint32_t events) {
+  if (!connection_) {
+    return;
+  }
+  if (events & EPOLLOUT) {
+    closing_ |= !(*connection_).flush();
+  }
+  if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+    closing_ |= !(*connection_).read([&](auto &message) { parse(message); });
+  }
+  if (closing_) {
+    close();
+  }
+}
+
+void Client::connect(std::chrono::nanoseconds now) {
+  auto fd = Connection::connect(port_, source_address_);
+  if (fd < 0) {
+    next_connect_ = now + RECONNECT_DELAY;  // note! proxy may not yet be listening
+    return;
+  }
+  connection_ = std::make_unique<Connection>(poller_, *this, fd, kernel_timestamps_);
+  encoder_.reset();
+  state_ = State::LOGON_SENT;
+  send(
+      "A"sv,
+      "98=0\x01"
+      "108=30\x01"
+      "141=Y\x01"
+      "553={}\x01"
+      "554={}\x01",
+      username_,
+      password_);
+}
+
+void Client::close() {
+  if (!connection_) {
+    return;
+  }
+  log::info<1>(R"(Client has been disconnected (username="{}"))"sv, username_);  // note! reported by the statistics
+  if (state_ == State::READY) {
+    ++statistics_.disconnects;
+  }
+  connection_.reset();
+  closing_ = false;
+  state_ = State::DISCONNECTED;
+  next_connect_ = clock::get_system() + RECONNECT_DELAY;
+  next_order_ = {};
+}
+
+void Client::parse(std::span<std::byte const> const &message) {
+  ++statistics_.messages;
+  auto msg_type = find(message, "35"sv);
+  if (msg_type == "8"sv) {
+    on_execution_report(message);
+  } else if (msg_type == "X"sv) {
+    on_market_data(message);
+  } else if (msg_type == "W"sv || msg_type == "0"sv) {
+  } else if (msg_type == "1"sv) {
+    send("0"sv, "112={}\x01", find(message, "112"sv));
+  } else if (msg_type == "A"sv) {
+    on_logon(message);
+  } else if (msg_type == "5"sv) {
+    log::warn(R"(Client has been logged out (username="{}", text="{}"))"sv, username_, find(message, "58"sv));
+    closing_ = true;
+  } else if (msg_type == "3"sv || msg_type == "j"sv) {
+    log::warn(R"(Client has received msg_type={} (username="{}", text="{}"))"sv, msg_type, username_, find(message, "58"sv));
+    ++statistics_.rejects;
+  }
+}
+
+void Client::on_logon(std::span<std::byte const> const &) {
+  if (market_data_) {
+    send(
+        "V"sv,
+        "262={}\x01"
+        "263=1\x01"
+        "264=0\x01"
+        "265=1\x01"
+        "267=2\x01"
+        "269=0\x01"
+        "269=1\x01"
+        "146=1\x01"
+        "55={}\x01"
+        "207={}\x01",
+        username_,
+        symbol_,
+        exchange_);
+  }
+  state_ = State::READY;
+}
+
+void Client::on_execution_report(std::span<std::byte const> const &message) {
+  auto now = clock::get_system();
+  if (find(message, "150"sv) != "0"sv) {
+    return;
+  }
+  auto order_id = to_uint64(find(message, "11"sv));
+  if (order_id == 0 || order_id > order_id_ || (order_id_ - order_id) >= ORDER_HISTORY) {
+    return;
+  }
+  auto &sent = order_sent_[order_id & (ORDER_HISTORY - 1)];
+  if (sent.count() == 0) {
+    return;
+  }
+  record(histograms_.order_ack, histograms_.order_ack_kernel, sent, now);
+  sent = {};
+  ++statistics_.order_acks;
+}
+
+void Client::on_market_data(std::span<std::byte const> const &message) {
+  auto now = clock::get_system();
+  auto sequence = static_cast<uint64_t>(to_double(find(message, "271"sv)));
+  auto sent = bridge_.market_data_sent(sequence);
+  if (sent.count() == 0) {
+    return;
+  }
+  record(histograms_.market_data, histograms_.market_data_kernel, sent, now);
+  ++statistics_.market_data;
+}
+
+void Client::send_new_order_single() {
+  auto order_id = ++order_id_;
+  auto message = encoder_.encode(
+      "D"sv,
+      "11={}\x01"
+      "1={}\x01"
+      "55={}\x01"
+      "207={}\x01"
+      "54=1\x01"
+      "40=2\x01"
+      "38=1\x01"
+      "44=100\x01"
+      "59=1\x01"
+      "60={}\x01",
+      order_id,
+      account_,
+      symbol_,
+      exchange_,
+      encoder_.timestamp());
+  order_sent_[order_id & (ORDER_HISTORY - 1)] = clock::get_system();
+  ++statistics_.orders;
+  if (!(*connection_).write(message)) {
+    closing_ = true;
+  }
+}
+
+void Client::record(tools::Histogram &histogram, tools::Histogram *kernel, std::chrono::nanoseconds sent, std::chrono::nanoseconds now) {
+  histogram.record((now - sent).count());
+  auto receive_time = (*connection_).receive_time();
+  if (kernel == nullptr || receive_time.count() == 0) {
+    return;
+  }
+  // note! clamped (the clocks are converted)
+  (*kernel).record(std::max<int64_t>((receive_time - sent).count(), 0));
+  (*histograms_.receive_delay).record(std::max<int64_t>((now - receive_time).count(), 0));
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,138 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <netinet/in.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "roq/fix_proxy/tools/histogram.hpp"
+#include "roq/fix_proxy/tools/poller.hpp"
+
+#include "bridge.hpp"
+#include "connection.hpp"
+#include "fix.hpp"
+#include "settings.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// simulated FIX client connecting to the proxy
+// orders are sent at a fixed rate and the ack latency is measured by ClOrdID (a sequence number)
+// market data latency is measured from the time the bridge sent the update (identified by MDEntrySize)
+// with kernel timestamps, latency is also measured to when the kernel received the message (excluding the client itself)
+
+struct Client final : public tools::Poller::Handler {
+  struct Histograms final {
+    tools::Histogram &order_ack;
+    tools::Histogram &market_data;
+    // note! only used with kernel timestamps
+    tools::Histogram *order_ack_kernel = nullptr;
+    tools::Histogram *market_data_kernel = nullptr;
+    tools::Histogram *receive_delay = nullptr;  // note! kernel to user-space
+  };
+
+  struct Statistics final {
+    uint64_t orders = {};
+    uint64_t order_acks = {};
+    uint64_t market_data = {};
+    uint64_t rejects = {};
+    uint64_t disconnects = {};
+    uint64_t messages = {};  // note! all received
+  };
+
+  Client(
+      tools::Poller &,
+      Settings const &,
+      Bridge const &,
+      Histograms const &,
+      uint16_t port,
+      std::string_view const &sender_comp_id,
+      std::string_view const &target_comp_id,
+      std::string_view const &username,
+      std::string_view const &password,
+      bool market_data,
+      uint32_t source_address = INADDR_LOOPBACK);
+
+  Client(Client &&) = delete;
+  Client(Client const &) = delete;
+
+  bool ready() const { return state_ == State::READY; }
+
+  Statistics const &statistics() const { return statistics_; }
+
+  void refresh(std::chrono::nanoseconds now);
+
+  // note! body excludes the standard header and trailer
+  void replay(std::string_view const &msg_type, std::string_view const &body) { send(msg_type, "{}", body); }
+
+ protected:
+  // tools::Poller::Handler
+  void operator()(uint32_t events) override;
+
+  void connect(std::chrono::nanoseconds now);
+  void close();
+
+  void parse(std::span<std::byte const> const &message);
+
+  void on_logon(std::span<std::byte const> const &message);
+  void on_execution_report(std::span<std::byte const> const &message);
+  void on_market_data(std::span<std::byte const> const &message);
+
+  void send_new_order_single();
+
+  void record(tools::Histogram &histogram, tools::Histogram *kernel, std::chrono::nanoseconds sent, std::chrono::nanoseconds now);
+
+  template <typename... Args>
+  void send(std::string_view const &msg_type, fmt::format_string<Args...> const &body, Args &&...args) {
+    if (!connection_) {
+      return;
+    }
+    auto message = encoder_.encode(msg_type, body, std::forward<Args>(args)...);
+    if (!(*connection_).write(message)) {
+      closing_ = true;  // note! closed by the caller (the inbound buffer may still be referenced)
+    }
+  }
+
+ private:
+  enum class State {
+    DISCONNECTED,
+    LOGON_SENT,
+    READY,
+  };
+
+  tools::Poller &poller_;
+  Bridge const &bridge_;
+  Histograms const histograms_;
+  uint16_t const port_;
+  uint32_t const source_address_;
+  std::string const username_;
+  std::string const password_;
+  std::string const account_;
+  std::string const exchange_;
+  std::string const symbol_;
+  bool const market_data_;
+  bool const kernel_timestamps_;
+  std::chrono::nanoseconds const order_interval_;
+  Encoder encoder_;
+  std::unique_ptr<Connection> connection_;
+  State state_ = {};
+  bool closing_ = {};
+  std::chrono::nanoseconds next_connect_ = {};
+  std::chrono::nanoseconds next_order_ = {};
+  uint64_t order_id_ = {};
+  std::vector<std::chrono::nanoseconds> order_sent_;
+  Statistics statistics_;
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
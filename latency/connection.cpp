@@ -0,0 +1,184 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "connection.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+#include "roq/fix_proxy/tools/rx_timestamp.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+size_t const INITIAL_BUFFER_SIZE = 4096;  // note! grows on demand (kept small to support many concurrent connections)
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_address(uint16_t port, uint32_t host = INADDR_LOOPBACK) {
+  struct sockaddr_in result = {};
+  result.sin_family = AF_INET;
+  result.sin_port = htons(port);
+  result.sin_addr.s_addr = htonl(host);
+  return result;
+}
+
+void configure(int fd) {
+  int flag = 1;
+  ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+  ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Connection::Connection(tools::Poller &poller, tools::Poller::Handler &handler, int fd, bool timestamps)
+    : poller_{poller}, handler_{handler}, fd_{fd}, timestamps_{timestamps}, frame_scanner_{true}, inbound_(INITIAL_BUFFER_SIZE) {
+  if (timestamps_ && !tools::RxTimestamp::enable(fd_)) {
+    log::fatal("Unexpected: unable to enable kernel timestamps (error={})"sv, std::strerror(errno));
+  }
+  poller_.add(fd_, handler_);
+}
+
+Connection::~Connection() {
+  poller_.remove(fd_);
+  ::close(fd_);
+}
+
+bool Connection::write(std::span<std::byte const> const &message) {
+  if (!std::empty(outbound_)) {
+    outbound_.insert(std::end(outbound_), std::begin(message), std::end(message));
+    return flush();
+  }
+  auto result = ::send(fd_, std::data(message), std::size(message), MSG_NOSIGNAL);
+  if (result < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      return false;
+    }
+    result = 0;
+  }
+  if (static_cast<size_t>(result) < std::size(message)) {
+    outbound_.insert(std::end(outbound_), std::begin(message) + result, std::end(message));
+    poller_.modify(fd_, handler_, true);
+  }
+  return true;
+}
+
+bool Connection::flush() {
+  if (std::empty(outbound_)) {
+    return true;
+  }
+  auto result = ::send(fd_, std::data(outbound_), std::size(outbound_), MSG_NOSIGNAL);
+  if (result < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+  }
+  outbound_.erase(std::begin(outbound_), std::begin(outbound_) + result);
+  if (std::empty(outbound_)) {
+    poller_.modify(fd_, handler_, false);
+  }
+  return true;
+}
+
+int Connection::listen(uint16_t port) {
+  auto fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  int flag = 1;
+  ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+  auto address = create_address(port);
+  if (::bind(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0 || ::listen(fd, SOMAXCONN) < 0) {
+    log::fatal("Unexpected: unable to listen on port={} (error={})"sv, port, std::strerror(errno));
+  }
+  ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+int Connection::accept(int fd) {
+  auto result = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+  if (result >= 0) {
+    configure(result);
+  }
+  return result;
+}
+
+int Connection::connect(uint16_t port, uint32_t source_address) {
+  auto fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (source_address != INADDR_LOOPBACK) {
+    // note! the ephemeral port is chosen by connect (the 4-tuple must be unique, not the source port)
+    int flag = 1;
+    ::setsockopt(fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &flag, sizeof(flag));
+    auto source = create_address(0, source_address);
+    if (::bind(fd, reinterpret_cast<struct sockaddr *>(&source), sizeof(source)) < 0) {
+      ::close(fd);
+      return -1;
+    }
+  }
+  auto address = create_address(port);
+  // note! blocking connect, loopback either succeeds or is refused immediately
+  if (::connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0) {
+    ::close(fd);
+    return -1;
+  }
+  configure(fd);
+  return fd;
+}
+
+uint16_t Connection::get_port(int fd) {
+  struct sockaddr_in address = {};
+  socklen_t length = sizeof(address);
+  ::getsockname(fd, reinterpret_cast<struct sockaddr *>(&address), &length);
+  return ntohs(address.sin_port);
+}
+
+bool Connection::fill() {
+  receive_time_ = {};
+  while (true) {
+    if (length_ == std::size(inbound_)) {
+      inbound_.resize(2 * std::size(inbound_));
+    }
+    auto buffer = std::span{inbound_}.subspan(length_);
+    auto receive_time = std::chrono::nanoseconds{};
+    auto result = timestamps_ ? tools::RxTimestamp::receive(fd_, buffer, receive_time) : ::recv(fd_, std::data(buffer), std::size(buffer), 0);
+    if (result > 0) {
+      length_ += result;
+      if (receive_time_.count() == 0 && receive_time.count() != 0) {
+        receive_time_ = receive_time + (clock::get_system() - clock::get_realtime());  // note! realtime to system clock
+      }
+      continue;
+    }
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    }
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    return false;  // note! closed by peer or error
+  }
+}
+
+void Connection::consume(size_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  std::memmove(std::data(inbound_), std::data(inbound_) + bytes, length_ - bytes);
+  length_ -= bytes;
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
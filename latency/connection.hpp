@@ -0,0 +1,86 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <netinet/in.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+#include "roq/fix_proxy/tools/poller.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// non-blocking tcp socket exchanging FIX messages
+// inbound data is framed in place, outbound data is only buffered when the socket would block
+// the socket is registered with the poller for its lifetime (write interest only while outbound data is pending)
+// kernel receive timestamps are optional (software timestamps, converted to the system clock)
+
+struct Connection final {
+  Connection(tools::Poller &, tools::Poller::Handler &, int fd, bool timestamps = false);
+
+  Connection(Connection &&) = delete;
+  Connection(Connection const &) = delete;
+
+  ~Connection();
+
+  int fd() const { return fd_; }
+
+  bool pending() const { return !std::empty(outbound_); }
+
+  // note! when the kernel received the first bytes of the last read (zero if not available)
+  std::chrono::nanoseconds receive_time() const { return receive_time_; }
+
+  // note! returns false if the connection should be closed
+  template <typename Callback>
+  bool read(Callback callback) {
+    auto success = fill();
+    frames_.clear();
+    auto [bytes, status] = frame_scanner_.scan(std::span{inbound_}.subspan(0, length_), frames_);
+    for (auto &frame : frames_) {
+      callback(frame);
+    }
+    consume(bytes);
+    return success && status == tools::FrameScanner::Status::OK;
+  }
+
+  // note! returns false if the connection should be closed
+  bool write(std::span<std::byte const> const &message);
+  bool flush();
+
+  // note! listening socket (port zero means any port)
+  static int listen(uint16_t port);
+  // note! returns -1 if the connection is refused
+  static int accept(int fd);
+  // note! source address (host byte order) can be any 127.0.0.0/8 address, each providing its own range of ephemeral ports
+  static int connect(uint16_t port, uint32_t source_address = INADDR_LOOPBACK);
+
+  static uint16_t get_port(int fd);
+
+ protected:
+  bool fill();
+  void consume(size_t bytes);
+
+ private:
+  tools::Poller &poller_;
+  tools::Poller::Handler &handler_;
+  int const fd_;
+  bool const timestamps_;
+  tools::FrameScanner const frame_scanner_;
+  std::vector<std::byte> inbound_;
+  size_t length_ = {};
+  std::chrono::nanoseconds receive_time_ = {};
+  std::vector<std::span<std::byte const>> frames_;
+  std::vector<std::byte> outbound_;
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
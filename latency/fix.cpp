@@ -0,0 +1,110 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "fix.hpp"
+
+#include <fmt/chrono.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+auto const BEGIN_STRING = "FIX.4.4"sv;
+
+char const SOH = '\x01';
+
+// note! standard header and trailer (re-encoded when replayed)
+auto const HEADER_TAGS = {"8"sv, "9"sv, "35"sv, "49"sv, "56"sv, "34"sv, "52"sv, "43"sv, "97"sv, "122"sv, "50"sv, "57"sv, "115"sv, "128"sv, "10"sv};
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Encoder::Encoder(std::string_view const &sender_comp_id, std::string_view const &target_comp_id)
+    : sender_comp_id_{sender_comp_id}, target_comp_id_{target_comp_id} {
+}
+
+std::string_view Encoder::format_timestamp(std::string &buffer) {
+  auto now = std::chrono::system_clock::now();
+  auto seconds = std::chrono::floor<std::chrono::seconds>(now);
+  auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now - seconds).count();
+  buffer.clear();
+  fmt::format_to(std::back_inserter(buffer), "{:%Y%m%d-%H:%M:%S}.{:03}"sv, seconds, milliseconds);
+  return buffer;
+}
+
+std::span<std::byte const> Encoder::finalize() {
+  message_.clear();
+  fmt::format_to(
+      std::back_inserter(message_),
+      "8={}\x01"
+      "9={}\x01"
+      "{}"sv,
+      BEGIN_STRING,
+      std::size(body_),
+      body_);
+  uint32_t sum = {};
+  for (auto c : message_) {
+    sum += static_cast<uint8_t>(c);
+  }
+  fmt::format_to(std::back_inserter(message_), "10={:03}\x01"sv, sum % 256);
+  return {reinterpret_cast<std::byte const *>(std::data(message_)), std::size(message_)};
+}
+
+std::string_view find(std::span<std::byte const> const &message, std::string_view const &tag) {
+  std::string_view buffer{reinterpret_cast<char const *>(std::data(message)), std::size(message)};
+  while (!std::empty(buffer)) {
+    auto end = buffer.find(SOH);
+    auto field = buffer.substr(0, end);
+    if (std::size(field) > std::size(tag) && field[std::size(tag)] == '=' && field.starts_with(tag)) {
+      return field.substr(std::size(tag) + 1);
+    }
+    if (end == buffer.npos) {
+      break;
+    }
+    buffer.remove_prefix(end + 1);
+  }
+  return {};
+}
+
+std::string_view strip_header(std::span<std::byte const> const &message, std::string &buffer) {
+  buffer.clear();
+  std::string_view remaining{reinterpret_cast<char const *>(std::data(message)), std::size(message)};
+  while (!std::empty(remaining)) {
+    auto end = remaining.find(SOH);
+    auto field = remaining.substr(0, end);
+    auto tag = field.substr(0, field.find('='));
+    if (std::find(std::begin(HEADER_TAGS), std::end(HEADER_TAGS), tag) == std::end(HEADER_TAGS)) {
+      buffer.append(field);
+      buffer.push_back(SOH);
+    }
+    if (end == remaining.npos) {
+      break;
+    }
+    remaining.remove_prefix(end + 1);
+  }
+  return buffer;
+}
+
+uint64_t to_uint64(std::string_view const &value) {
+  uint64_t result = {};
+  auto [ptr, ec] = std::from_chars(std::data(value), std::data(value) + std::size(value), result);
+  return ec == std::errc{} ? result : 0;
+}
+
+double to_double(std::string_view const &value) {
+  double result = {};
+  auto [ptr, ec] = std::from_chars(std::data(value), std::data(value) + std::size(value), result);
+  return ec == std::errc{} ? result : 0.0;
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,81 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// minimal FIX 4.4 wire codec
+// the harness observes the proxy from the outside, i.e. only the wire protocol is shared with the proxy
+
+struct Encoder final {
+  Encoder(std::string_view const &sender_comp_id, std::string_view const &target_comp_id);
+
+  Encoder(Encoder &&) = delete;
+  Encoder(Encoder const &) = delete;
+
+  // note! the result is only valid until the next call
+  template <typename... Args>
+  std::span<std::byte const> encode(std::string_view const &msg_type, fmt::format_string<Args...> const &body, Args &&...args) {
+    body_.clear();
+    fmt::format_to(
+        std::back_inserter(body_),
+        "35={}\x01"
+        "49={}\x01"
+        "56={}\x01"
+        "34={}\x01"
+        "52={}\x01",
+        msg_type,
+        sender_comp_id_,
+        target_comp_id_,
+        ++msg_seq_num_,
+        format_timestamp(sending_time_));
+    fmt::format_to(std::back_inserter(body_), body, std::forward<Args>(args)...);
+    return finalize();
+  }
+
+  // note! UTCTimestamp (millisecond resolution), only valid until the next call
+  std::string_view timestamp() { return format_timestamp(timestamp_); }
+
+  void reset() { msg_seq_num_ = {}; }
+
+ protected:
+  static std::string_view format_timestamp(std::string &);
+
+  std::span<std::byte const> finalize();
+
+ private:
+  std::string const sender_comp_id_;
+  std::string const target_comp_id_;
+  uint64_t msg_seq_num_ = {};
+  std::string body_;
+  std::string message_;
+  std::string sending_time_;
+  std::string timestamp_;
+};
+
+// note! returns the value of the first occurrence of tag (empty if not found)
+std::string_view find(std::span<std::byte const> const &message, std::string_view const &tag);
+
+// note! returns the fields following the standard header (excluding the trailer), only valid until the next call
+std::string_view strip_header(std::span<std::byte const> const &message, std::string &buffer);
+
+// note! returns zero if the value can't be parsed
+uint64_t to_uint64(std::string_view const &value);
+double to_double(std::string_view const &value);
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,291 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "harness.hpp"
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <cstdlib>
+#include <filesystem>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+uint64_t const HIGHEST_TRACKABLE_VALUE = std::chrono::nanoseconds{1min}.count();
+uint32_t const SIGNIFICANT_FIGURES = 3;
+
+auto const PROXY_CHECK_FREQUENCY = 100ms;
+
+auto const PERCENTILES = {50.0, 90.0, 99.0, 99.9, 99.99};
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+void print_histogram(auto const &name, auto &histogram) {
+  auto to_us = [](auto value) { return static_cast<double>(value) / 1000.0; };
+  fmt::print("{:<24} {:>10} {:>10.1f}"sv, name, histogram.count(), to_us(histogram.min()));
+  for (auto percentile : PERCENTILES) {
+    fmt::print(" {:>10.1f}"sv, to_us(histogram.value_at_percentile(percentile)));
+  }
+  fmt::print(" {:>10.1f}\n"sv, to_us(histogram.max()));
+}
+
+// note! HdrHistogram percentile distribution format (values are in microseconds)
+void write_histogram(auto &directory, auto const &name, auto &histogram) {
+  auto path = std::filesystem::path{directory} / fmt::format("{}.hgrm"sv, name);
+  auto file = fmt::output_file(path.string());
+  file.print("{:>12} {:>14} {:>10} {:>14}\n\n"sv, "Value"sv, "Percentile"sv, "TotalCount"sv, "1/(1-Percentile)"sv);
+  uint64_t total = {};
+  histogram.for_each([&](auto value, auto count) {
+    total += count;
+    auto percentile = static_cast<double>(total) / static_cast<double>(histogram.count());
+    auto value_us = static_cast<double>(value) / 1000.0;
+    if (total < histogram.count()) {
+      file.print("{:12.3f} {:14.12f} {:10} {:14.2f}\n"sv, value_us, percentile, total, 1.0 / (1.0 - percentile));
+    } else {
+      file.print("{:12.3f} {:14.12f} {:10} {:>14}\n"sv, value_us, percentile, total, "inf"sv);
+    }
+  });
+  file.print(
+      "#[Mean    = {:12.3f}, Max         = {:12.3f}]\n"
+      "#[Total count    = {:12}]\n"sv,
+      histogram.mean() / 1000.0,
+      static_cast<double>(histogram.max()) / 1000.0,
+      histogram.count());
+  log::info(R"(Histogram has been written to path="{}")"sv, path.string());
+}
+
+auto create_market_data_bridge(auto &poller, auto &settings) -> std::unique_ptr<Bridge> {
+  if (!settings.market_data_session) {
+    return {};
+  }
+  auto port = settings.bridge_port != 0 ? static_cast<uint16_t>(settings.bridge_port + 1) : uint16_t{};
+  return std::make_unique<Bridge>(poller, settings, Proxy::BRIDGE_COMP_ID, Proxy::UPSTREAM_COMP_ID, nullptr, port);
+}
+
+uint16_t get_port(auto &bridge) {
+  return bridge ? (*bridge).port() : uint16_t{};
+}
+
+bool check_limit(auto const &name, auto &histogram, auto limit) {
+  if (limit.count() == 0) {
+    return true;
+  }
+  auto p99 = std::chrono::nanoseconds{histogram.value_at_percentile(99.0)};
+  if (p99 <= limit) {
+    return true;
+  }
+  log::error("{} p99={}us exceeds limit={}us"sv, name, p99.count() / 1000.0, limit.count() / 1000.0);
+  return false;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Harness::Harness(Settings const &settings)
+    : settings_{settings}, bridge_{poller_, settings, Proxy::BRIDGE_COMP_ID, Proxy::UPSTREAM_COMP_ID},
+      market_data_bridge_{create_market_data_bridge(poller_, settings)}, proxy_{settings, settings.clients, bridge_.port(), get_port(market_data_bridge_)},
+      order_ack_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES}, market_data_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES},
+      order_ack_kernel_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES}, market_data_kernel_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES},
+      receive_delay_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES} {
+}
+
+Harness::~Harness() {
+  clients_.clear();
+}
+
+int Harness::run() {
+  proxy_.start();
+  if (!wait([&]() { return bridge_.ready() && market_data_bridge().ready(); }, "upstream logon"sv)) {
+    return EXIT_FAILURE;
+  }
+  auto histograms = Client::Histograms{
+      .order_ack = order_ack_,
+      .market_data = market_data_,
+  };
+  if (settings_.kernel_timestamps) {
+    histograms.order_ack_kernel = &order_ack_kernel_;
+    histograms.market_data_kernel = &market_data_kernel_;
+    histograms.receive_delay = &receive_delay_;
+  }
+  for (uint32_t i = 0; i < settings_.clients; ++i) {
+    auto username = Proxy::get_username(i);
+    clients_.emplace_back(std::make_unique<Client>(
+        poller_,
+        settings_,
+        market_data_bridge(),
+        histograms,
+        proxy_.port(),
+        Proxy::CLIENT_COMP_ID,
+        Proxy::PROXY_COMP_ID,
+        username,
+        Proxy::PASSWORD,
+        settings_.market_data_rate > 0.0));
+  }
+  auto ready = [&]() {
+    for (auto &client : clients_) {
+      if (!(*client).ready()) {
+        return false;
+      }
+    }
+    return settings_.market_data_rate <= 0.0 || market_data_bridge().subscriptions() >= std::size(clients_);
+  };
+  if (!wait(ready, "client logon"sv)) {
+    return EXIT_FAILURE;
+  }
+  log::info("Warming up for {}"sv, std::chrono::duration<double>{settings_.warmup});
+  if (!run_for(settings_.warmup)) {
+    return EXIT_FAILURE;
+  }
+  for (auto histogram : {&order_ack_, &market_data_, &order_ack_kernel_, &market_data_kernel_, &receive_delay_}) {
+    (*histogram).reset();
+  }
+  log::info("Measuring for {}"sv, std::chrono::duration<double>{settings_.duration});
+  if (!run_for(settings_.duration)) {
+    return EXIT_FAILURE;
+  }
+  return report();
+}
+
+template <typename Predicate>
+bool Harness::wait(Predicate predicate, std::string_view const &description) {
+  auto deadline = clock::get_system() + settings_.startup_timeout;
+  auto next_check = std::chrono::nanoseconds{};
+  while (!predicate()) {
+    auto now = clock::get_system();
+    if (deadline < now) {
+      log::error("Timeout waiting for {}"sv, description);
+      return false;
+    }
+    if (next_check <= now) {
+      next_check = now + PROXY_CHECK_FREQUENCY;
+      if (!proxy_.alive()) {
+        return false;
+      }
+    }
+    dispatch();
+  }
+  log::info("Done waiting for {}"sv, description);
+  return true;
+}
+
+bool Harness::run_for(std::chrono::nanoseconds duration) {
+  auto deadline = clock::get_system() + duration;
+  auto next_check = std::chrono::nanoseconds{};
+  while (true) {
+    auto now = clock::get_system();
+    if (deadline <= now) {
+      return true;
+    }
+    if (next_check <= now) {
+      next_check = now + PROXY_CHECK_FREQUENCY;
+      if (!proxy_.alive()) {
+        return false;
+      }
+    }
+    dispatch();
+  }
+}
+
+void Harness::dispatch() {
+  poller_.dispatch(settings_.busy_poll ? 0ms : 1ms);
+  auto now = clock::get_system();
+  bridge_.refresh(now);
+  if (market_data_bridge_) {
+    (*market_data_bridge_).refresh(now);
+  }
+  for (auto &client : clients_) {
+    (*client).refresh(now);
+  }
+}
+
+int Harness::report() const {
+  Client::Statistics statistics;
+  for (auto &client : clients_) {
+    auto &tmp = (*client).statistics();
+    statistics.orders += tmp.orders;
+    statistics.order_acks += tmp.order_acks;
+    statistics.market_data += tmp.market_data;
+    statistics.rejects += tmp.rejects;
+    statistics.disconnects += tmp.disconnects;
+  }
+  fmt::print(
+      "\n"
+      "clients={} order_rate={} market_data_rate={} market_data_burst={} market_data_session={} duration={}\n"
+      "orders={} order_acks={} market_data={} rejects={} disconnects={} upstream_disconnects={}\n"
+      "\n"sv,
+      settings_.clients,
+      settings_.order_rate,
+      settings_.market_data_rate,
+      settings_.market_data_burst,
+      settings_.market_data_session,
+      std::chrono::duration<double>{settings_.duration},
+      statistics.orders,
+      statistics.order_acks,
+      statistics.market_data,
+      statistics.rejects,
+      statistics.disconnects,
+      upstream_disconnects());
+  fmt::print("{:<24} {:>10} {:>10}"sv, "latency (us)"sv, "count"sv, "min"sv);
+  for (auto percentile : PERCENTILES) {
+    fmt::print(" {:>10}"sv, fmt::format("p{}"sv, percentile));
+  }
+  fmt::print(" {:>10}\n"sv, "max"sv);
+  print_histogram("order_ack"sv, order_ack_);
+  print_histogram("market_data"sv, market_data_);
+  if (settings_.kernel_timestamps) {
+    print_histogram("order_ack_kernel"sv, order_ack_kernel_);
+    print_histogram("market_data_kernel"sv, market_data_kernel_);
+    print_histogram("receive_delay"sv, receive_delay_);
+  }
+  fmt::print("\n"sv);
+  if (!std::empty(settings_.output_directory)) {
+    write_histogram(settings_.output_directory, "order_ack"sv, order_ack_);
+    write_histogram(settings_.output_directory, "market_data"sv, market_data_);
+    if (settings_.kernel_timestamps) {
+      write_histogram(settings_.output_directory, "order_ack_kernel"sv, order_ack_kernel_);
+      write_histogram(settings_.output_directory, "market_data_kernel"sv, market_data_kernel_);
+      write_histogram(settings_.output_directory, "receive_delay"sv, receive_delay_);
+    }
+  }
+  auto success = true;
+  if (statistics.disconnects != 0 || upstream_disconnects() != 0) {
+    log::error("Connections were lost during the run"sv);
+    success = false;
+  }
+  if (settings_.order_rate > 0.0 && order_ack_.count() == 0) {
+    log::error("No order acks were received"sv);
+    success = false;
+  }
+  if (settings_.market_data_rate > 0.0 && market_data_.count() == 0) {
+    log::error("No market data was received"sv);
+    success = false;
+  }
+  success &= check_limit("order_ack"sv, order_ack_, settings_.order_ack_p99_limit);
+  success &= check_limit("market_data"sv, market_data_, settings_.market_data_p99_limit);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+size_t Harness::upstream_disconnects() const {
+  auto result = bridge_.disconnects();
+  if (market_data_bridge_) {
+    result += (*market_data_bridge_).disconnects();
+  }
+  return result;
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,72 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "roq/fix_proxy/tools/histogram.hpp"
+#include "roq/fix_proxy/tools/poller.hpp"
+
+#include "bridge.hpp"
+#include "client.hpp"
+#include "proxy.hpp"
+#include "settings.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// everything runs on loopback: the stand-in bridge, the proxy (a child process) and the simulated clients
+// the bridge and the clients share a single thread and a single clock, i.e. latencies are measured without clock skew
+// samples are discarded during warmup
+// market data can optionally be served by a second bridge (the proxy then uses a dedicated upstream session for market data)
+
+struct Harness final {
+  explicit Harness(Settings const &);
+
+  Harness(Harness &&) = delete;
+  Harness(Harness const &) = delete;
+
+  ~Harness();
+
+  // note! returns the process exit code
+  int run();
+
+ protected:
+  template <typename Predicate>
+  bool wait(Predicate predicate, std::string_view const &description);
+
+  bool run_for(std::chrono::nanoseconds duration);
+
+  void dispatch();
+
+  int report() const;
+
+  // note! the bridge used for order entry if there is no dedicated market data session
+  Bridge &market_data_bridge() { return market_data_bridge_ ? *market_data_bridge_ : bridge_; }
+  Bridge const &market_data_bridge() const { return market_data_bridge_ ? *market_data_bridge_ : bridge_; }
+
+  size_t upstream_disconnects() const;
+
+ private:
+  Settings const &settings_;
+  tools::Poller poller_;
+  Bridge bridge_;
+  std::unique_ptr<Bridge> const market_data_bridge_;
+  Proxy proxy_;
+  tools::Histogram order_ack_;
+  tools::Histogram market_data_;
+  tools::Histogram order_ack_kernel_;
+  tools::Histogram market_data_kernel_;
+  tools::Histogram receive_delay_;
+  std::vector<std::unique_ptr<Client>> clients_;
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,24 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <absl/flags/parse.h>
+#include <absl/flags/usage.h>
+
+#include "harness.hpp"
+#include "replay.hpp"
+#include "scale.hpp"
+#include "settings.hpp"
+
+// === IMPLEMENTATION ===
+
+int main(int argc, char **argv) {
+  absl::SetProgramUsageMessage("End-to-end latency harness for roq-fix-proxy (stand-in fix-bridge and simulated FIX clients on loopback)");
+  absl::ParseCommandLine(argc, argv);
+  auto settings = roq::fix_proxy::latency::Settings::create();
+  if (!std::empty(settings.replay)) {
+    return roq::fix_proxy::latency::Replay{settings}.run();
+  }
+  if (!std::empty(settings.scale_sessions)) {
+    return roq::fix_proxy::latency::Scale{settings}.run();
+  }
+  return roq::fix_proxy::latency::Harness{settings}.run();
+}
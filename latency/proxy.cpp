@@ -0,0 +1,208 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "proxy.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+#include <fmt/ranges.h>
+
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+#include "connection.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+auto const STOP_TIMEOUT = 5s;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+uint16_t get_port(auto &settings) {
+  if (settings.proxy_port != 0) {
+    return settings.proxy_port;
+  }
+  // note! any free port (the proxy is started shortly after)
+  auto fd = Connection::listen(0);
+  auto result = Connection::get_port(fd);
+  ::close(fd);
+  return result;
+}
+
+std::string create_config_file(auto &settings, auto users) {
+  if (std::empty(settings.proxy)) {
+    return {};
+  }
+  auto path = std::filesystem::temp_directory_path() / fmt::format("roq-fix-proxy-latency-{}.toml"sv, ::getpid());
+  auto file = fmt::output_file(path.string());
+  file.print(
+      "symbols = [\"^{}$\"]\n"
+      "\n"
+      "[users]\n"sv,
+      settings.symbol);
+  for (uint32_t i = 0; i < users; ++i) {
+    file.print(
+        "\n"
+        "[users.{0}]\n"
+        "component = \"{1}\"\n"
+        "username = \"{0}\"\n"
+        "password = \"{2}\"\n"
+        "accounts = \"{3}\"\n"
+        "strategy_id = {4}\n"sv,
+        Proxy::get_username(i),
+        Proxy::CLIENT_COMP_ID,
+        Proxy::PASSWORD,
+        settings.account,
+        i + 1);
+  }
+  return path.string();
+}
+
+auto create_args(auto &settings, auto &config_file, auto port, auto bridge_port, auto market_data_port) {
+  std::vector<std::string> result{
+      settings.proxy,
+      "--name=fix-proxy-latency"s,
+      fmt::format("--config_file={}"sv, config_file),
+      fmt::format("--server_target_comp_id={}"sv, Proxy::BRIDGE_COMP_ID),
+      fmt::format("--server_sender_comp_id={}"sv, Proxy::UPSTREAM_COMP_ID),
+      fmt::format("--server_username={}"sv, Proxy::USERNAME),
+      fmt::format("--client_listen_address={}"sv, port),
+      fmt::format("--client_comp_id={}"sv, Proxy::PROXY_COMP_ID),
+  };
+  std::string_view args{settings.proxy_args};
+  while (!std::empty(args)) {
+    auto begin = args.find_first_not_of(' ');
+    if (begin == args.npos) {
+      break;
+    }
+    args.remove_prefix(begin);
+    auto end = args.find(' ');
+    result.emplace_back(args.substr(0, end));
+    args.remove_prefix(end == args.npos ? std::size(args) : end);
+  }
+  result.emplace_back(fmt::format("tcp://127.0.0.1:{}"sv, bridge_port));
+  if (market_data_port != 0) {
+    result.emplace_back(fmt::format("tcp://127.0.0.1:{}"sv, market_data_port));  // note! the second connection is used for market data
+  }
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+std::string Proxy::get_username(uint32_t index) {
+  return fmt::format("user_{}"sv, index);
+}
+
+Proxy::Proxy(Settings const &settings, uint32_t users, uint16_t bridge_port, uint16_t market_data_port)
+    : settings_{settings}, bridge_port_{bridge_port}, market_data_port_{market_data_port}, port_{get_port(settings)},
+      config_file_{create_config_file(settings, users)} {
+}
+
+Proxy::~Proxy() {
+  stop();
+  if (!std::empty(config_file_)) {
+    std::filesystem::remove(config_file_);
+  }
+}
+
+void Proxy::start() {
+  if (std::empty(settings_.proxy)) {
+    return;
+  }
+  auto args = create_args(settings_, config_file_, port_, bridge_port_, market_data_port_);
+  log::info("Starting proxy: {}"sv, fmt::join(args, " "sv));
+  std::vector<char *> argv;
+  for (auto &item : args) {
+    argv.emplace_back(std::data(item));
+  }
+  argv.emplace_back(nullptr);
+  pid_ = ::fork();
+  if (pid_ < 0) {
+    log::fatal("Unexpected: fork failed"sv);
+  }
+  if (pid_ == 0) {
+    ::prctl(PR_SET_PDEATHSIG, SIGTERM);  // note! don't leave the proxy running if the harness dies
+    ::execv(argv[0], std::data(argv));
+    ::_exit(127);
+  }
+}
+
+void Proxy::stop() {
+  if (pid_ <= 0) {
+    return;
+  }
+  ::kill(pid_, SIGTERM);
+  auto deadline = clock::get_system() + STOP_TIMEOUT;
+  while (::waitpid(pid_, nullptr, WNOHANG) == 0) {
+    if (deadline < clock::get_system()) {
+      log::warn("Proxy did not terminate, killing it"sv);
+      ::kill(pid_, SIGKILL);
+      ::waitpid(pid_, nullptr, 0);
+      break;
+    }
+    std::this_thread::sleep_for(10ms);
+  }
+  pid_ = -1;
+}
+
+bool Proxy::alive() {
+  if (pid_ <= 0) {
+    return std::empty(settings_.proxy);
+  }
+  int status = {};
+  if (::waitpid(pid_, &status, WNOHANG) == 0) {
+    return true;
+  }
+  log::error("Proxy has terminated (status={})"sv, status);
+  pid_ = -1;
+  return false;
+}
+
+size_t Proxy::resident_memory() const {
+  if (pid_ <= 0) {
+    return {};
+  }
+  std::ifstream file{fmt::format("/proc/{}/status"sv, pid_)};
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.starts_with("VmRSS:"sv)) {
+      return std::stoull(line.substr(std::size("VmRSS:"sv))) * 1024;  // note! kB
+    }
+  }
+  return {};
+}
+
+std::chrono::nanoseconds Proxy::cpu_time() const {
+  if (pid_ <= 0) {
+    return {};
+  }
+  // note! the first field is the time spent on cpu (nanoseconds) by the thread group leader, i.e. the event loop thread
+  std::ifstream file{fmt::format("/proc/{}/schedstat"sv, pid_)};
+  int64_t result = {};
+  file >> result;
+  return std::chrono::nanoseconds{result};
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,69 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "settings.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// the proxy is started as a child process using a generated config file (one user per simulated client)
+// the proxy is terminated (and the config file removed) when this object is destroyed
+// the upstream connections are the bridge (order entry) and, optionally, a second bridge (dedicated market data session)
+
+struct Proxy final {
+  static constexpr std::string_view BRIDGE_COMP_ID = "roq-fix-bridge";
+  static constexpr std::string_view UPSTREAM_COMP_ID = "roq-fix-proxy-latency";  // note! proxy => bridge
+  static constexpr std::string_view PROXY_COMP_ID = "proxy";                     // note! client => proxy
+  static constexpr std::string_view CLIENT_COMP_ID = "latency";
+  static constexpr std::string_view USERNAME = "latency";  // note! proxy => bridge
+  static constexpr std::string_view PASSWORD = "secret";
+
+  static std::string get_username(uint32_t index);
+
+  // note! market_data_port is zero if there is no dedicated market data session
+  Proxy(Settings const &, uint32_t users, uint16_t bridge_port, uint16_t market_data_port = {});
+
+  Proxy(Proxy &&) = delete;
+  Proxy(Proxy const &) = delete;
+
+  ~Proxy();
+
+  // note! port used by the proxy to accept client connections
+  uint16_t port() const { return port_; }
+
+  // note! does nothing if the proxy has already been started (externally)
+  void start();
+  void stop();
+
+  bool alive();
+
+  // note! process statistics are only available when the proxy has been started by us (zero otherwise)
+
+  // resident set size (bytes)
+  size_t resident_memory() const;
+
+  // time spent on cpu by the main (event loop) thread
+  std::chrono::nanoseconds cpu_time() const;
+
+ private:
+  Settings const &settings_;
+  uint16_t const bridge_port_;
+  uint16_t const market_data_port_;
+  uint16_t const port_;
+  std::string const config_file_;
+  pid_t pid_ = -1;
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,480 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "replay.hpp"
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+#include "roq/fix_proxy/tools/journal_reader.hpp"
+
+#include "fix.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+uint64_t const HIGHEST_TRACKABLE_VALUE = std::chrono::nanoseconds{1min}.count();
+uint32_t const SIGNIFICANT_FIGURES = 3;
+
+auto const PROXY_CHECK_FREQUENCY = 100ms;
+
+auto const QUIET_PERIOD = 100ms;  // note! the replay has completed when nothing has been received for this long
+
+size_t const MAX_BURST = 64;  // note! messages sent between polls when running behind (or as fast as possible)
+
+// note! managed by the simulated sessions (logon, heartbeat, test request, resend request, reject, sequence reset, logout)
+auto const SESSION_MSG_TYPES = std::array{"A"sv, "0"sv, "1"sv, "2"sv, "3"sv, "4"sv, "5"sv};
+
+// note! user responses are generated by the bridge (users are logged on by the proxy when the clients log on)
+auto const UPSTREAM_SESSION_MSG_TYPES = std::array{"BF"sv};
+auto const DOWNSTREAM_SESSION_MSG_TYPES = std::array{"BE"sv};
+
+// note! assigned by the proxy (ClOrdID, OrigClOrdID, MDReqID, SecurityReqID, SecurityStatusReqID, TradSesReqID, TradeRequestID,
+// MassStatusReqID, PosReqID)
+auto const REQUEST_ID_TAGS = std::array{"11"sv, "41"sv, "262"sv, "320"sv, "324"sv, "335"sv, "568"sv, "584"sv, "710"sv};
+
+auto const RESOLVE_TIMEOUT = 1s;  // note! an upstream message is sent unmodified if the proxy has not sent the request by then
+
+char const SOH = '\x01';
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+// note! market data is only published on demand and no orders are sent
+auto create_settings(auto &settings) {
+  auto result = settings;
+  result.market_data_rate = 0.0;
+  result.order_rate = 0.0;
+  return result;
+}
+
+auto load_file(auto &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    log::fatal(R"(Unable to open journal segment (path="{}"))"sv, path);
+  }
+  std::vector<char> tmp{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  std::vector<std::byte> result(std::size(tmp));
+  std::transform(std::begin(tmp), std::end(tmp), std::begin(result), [](auto value) { return static_cast<std::byte>(value); });
+  return result;
+}
+
+bool contains(auto &values, auto &value) {
+  return std::find(std::begin(values), std::end(values), value) != std::end(values);
+}
+
+// note! callback(tag, value) for each field of a body (standard header already stripped)
+template <typename Callback>
+void for_each_field(std::string_view body, Callback callback) {
+  while (!std::empty(body)) {
+    auto end = body.find(SOH);
+    auto field = body.substr(0, end);
+    auto pos = field.find('=');
+    if (pos != field.npos) {
+      callback(field.substr(0, pos), field.substr(pos + 1));
+    }
+    if (end == body.npos) {
+      break;
+    }
+    body.remove_prefix(end + 1);
+  }
+}
+
+// note! identifies a request independent of the request ids assigned by the proxy
+std::string_view get_key(std::string_view const &msg_type, std::string_view const &body, std::string &buffer) {
+  buffer.assign(msg_type);
+  buffer.push_back(SOH);
+  for_each_field(body, [&](auto const &tag, auto const &value) {
+    if (contains(REQUEST_ID_TAGS, tag)) {
+      return;
+    }
+    fmt::format_to(std::back_inserter(buffer), "{}={}\x01"sv, tag, value);
+  });
+  return buffer;
+}
+
+// note! only messages received by the proxy are replayed, clients are numbered in order of first appearance
+// requests sent by the proxy are only used to map the request ids
+template <typename R>
+R create_recording(auto &settings) {
+  using event_type = typename decltype(R::events)::value_type;
+  using request_type = typename decltype(R::requests)::value_type;
+  R result;
+  auto &events = result.events;
+  auto &requests = result.requests;
+  std::unordered_map<uint64_t, uint32_t> clients;
+  std::string buffer, buffer_2;
+  for (auto &path : settings.replay) {
+    auto data = load_file(path);
+    auto status = tools::JournalReader{data}.dispatch([&](auto &record) {
+      auto upstream = record.peer == tools::Journal::Peer::SERVER;
+      auto msg_type = find(record.message, "35"sv);
+      if (contains(SESSION_MSG_TYPES, msg_type)) {
+        return;
+      }
+      if (record.direction != tools::Journal::Direction::INBOUND) {
+        if (!upstream || contains(DOWNSTREAM_SESSION_MSG_TYPES, msg_type)) {
+          return;
+        }
+        auto body = strip_header(record.message, buffer);
+        auto request = request_type{
+            .msg_type = std::string{msg_type},
+            .key = std::string{get_key(msg_type, body, buffer_2)},
+            .ids = {},
+        };
+        for_each_field(body, [&](auto const &tag, auto const &value) {
+          if (contains(REQUEST_ID_TAGS, tag)) {
+            request.ids.emplace_back(tag, value);
+            result.ids.emplace(value);
+          }
+        });
+        requests.emplace_back(std::move(request));
+        return;
+      }
+      if (upstream && contains(UPSTREAM_SESSION_MSG_TYPES, msg_type)) {
+        return;
+      }
+      uint32_t client = {};
+      if (!upstream) {
+        auto [iter, inserted] = clients.try_emplace(record.session_id, static_cast<uint32_t>(std::size(clients)));
+        client = (*iter).second;
+      }
+      events.emplace_back(event_type{
+          .timestamp = record.timestamp,
+          .upstream = upstream,
+          .client = client,
+          .msg_type = std::string{msg_type},
+          .body = std::string{strip_header(record.message, buffer)},
+      });
+    });
+    switch (status) {
+      using enum tools::JournalReader::Status;
+      case OK:
+        break;
+      case TRUNCATED:
+        log::warn(R"(Journal segment is truncated (path="{}"))"sv, path);
+        break;
+      default:
+        log::fatal(R"(Invalid journal segment (path="{}"))"sv, path);
+    }
+  }
+  // note! channels are written independently, i.e. segments are only ordered per channel
+  std::stable_sort(std::begin(events), std::end(events), [](auto &lhs, auto &rhs) { return lhs.timestamp < rhs.timestamp; });
+  if (std::empty(events)) {
+    log::fatal("Nothing to replay"sv);
+  }
+  for (auto &event : events) {
+    if (!event.upstream) {
+      continue;
+    }
+    for_each_field(event.body, [&](auto const &tag, auto const &value) { event.rewrite |= contains(REQUEST_ID_TAGS, tag) && result.ids.contains(value); });
+  }
+  log::info(
+      "Loaded {} message(s) from {} journal segment(s) (sessions={}, requests={})"sv,
+      std::size(events),
+      std::size(settings.replay),
+      std::size(clients),
+      std::size(requests));
+  return result;
+}
+
+auto get_sessions(auto &events) {
+  uint32_t result = {};
+  for (auto &event : events) {
+    if (!event.upstream) {
+      result = std::max(result, event.client + 1);
+    }
+  }
+  return std::max(result, 1u);  // note! the proxy requires at least one user
+}
+
+auto to_seconds(std::chrono::nanoseconds value) {
+  return std::chrono::duration<double>{value}.count();
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Replay::Replay(Settings const &settings)
+    : settings_{create_settings(settings)}, recording_{create_recording<Recording>(settings_)}, events_{recording_.events}, sessions_{get_sessions(events_)},
+      bridge_{poller_, settings_, Proxy::BRIDGE_COMP_ID, Proxy::UPSTREAM_COMP_ID, this}, proxy_{settings_, sessions_, bridge_.port()},
+      order_ack_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES}, market_data_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES} {
+}
+
+int Replay::run() {
+  proxy_.start();
+  if (!wait([&]() { return bridge_.ready(); }, "upstream logon"sv)) {
+    return EXIT_FAILURE;
+  }
+  auto histograms = Client::Histograms{
+      .order_ack = order_ack_,
+      .market_data = market_data_,
+  };
+  for (uint32_t i = 0; i < sessions_; ++i) {
+    clients_.emplace_back(std::make_unique<Client>(
+        poller_, settings_, bridge_, histograms, proxy_.port(), Proxy::CLIENT_COMP_ID, Proxy::PROXY_COMP_ID, Proxy::get_username(i), Proxy::PASSWORD, false));
+  }
+  auto ready = [&]() {
+    auto now = clock::get_system();
+    auto result = true;
+    for (auto &client : clients_) {
+      (*client).refresh(now);
+      result &= (*client).ready();
+    }
+    return result;
+  };
+  if (!wait(ready, "client logon"sv)) {
+    return EXIT_FAILURE;
+  }
+  log::info("Replaying {} message(s) (sessions={}, speed={})"sv, std::size(events_), sessions_, settings_.replay_speed);
+  if (!replay() || !drain()) {
+    return EXIT_FAILURE;
+  }
+  return report();
+}
+
+// note! always busy polling, a blocking poll would add to the lag
+bool Replay::replay() {
+  auto origin = events_.front().timestamp;
+  start_ = clock::get_system();
+  auto next_check = std::chrono::nanoseconds{};
+  std::chrono::nanoseconds blocked = {};  // note! since when waiting for the proxy to send a request
+  for (size_t i = 0; i < std::size(events_);) {
+    auto now = clock::get_system();
+    if (next_check <= now) {
+      next_check = now + PROXY_CHECK_FREQUENCY;
+      if (!proxy_.alive()) {
+        return false;
+      }
+    }
+    for (size_t burst = 0; i < std::size(events_) && burst < MAX_BURST; ++i, ++burst) {
+      auto &event = events_[i];
+      if (settings_.replay_speed > 0.0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>((event.timestamp - origin) / settings_.replay_speed);
+        auto due = start_ + elapsed;
+        if (now < due) {
+          break;
+        }
+        max_lag_ = std::max(max_lag_, now - due);
+      }
+      if (event.rewrite && !rewrite(event)) {
+        if (blocked.count() == 0) {
+          blocked = now;
+        }
+        if (now < (blocked + RESOLVE_TIMEOUT)) {
+          break;
+        }
+        log::warn(R"(Request ids could not be mapped (body="{}"))"sv, event.body);
+        ++unresolved_;
+        body_ = event.body;
+      }
+      blocked = {};
+      send(event);
+    }
+    dispatch(0ms);
+  }
+  return true;
+}
+
+// note! the end of the replay is the last time something was received
+bool Replay::drain() {
+  auto last = received();
+  end_ = clock::get_system();
+  auto deadline = end_ + settings_.startup_timeout;
+  auto next_check = std::chrono::nanoseconds{};
+  while (true) {
+    auto now = clock::get_system();
+    auto current = received();
+    if (current != last) {
+      last = current;
+      end_ = now;
+    } else if ((end_ + QUIET_PERIOD) <= now) {
+      return true;
+    }
+    if (deadline < now) {
+      log::error("Timeout waiting for the proxy to become quiet"sv);
+      return false;
+    }
+    if (next_check <= now) {
+      next_check = now + PROXY_CHECK_FREQUENCY;
+      if (!proxy_.alive()) {
+        return false;
+      }
+    }
+    dispatch(0ms);
+  }
+}
+
+// Bridge::Handler
+
+// note! the first unmatched request with the same content, otherwise the first unmatched request with the same message type
+void Replay::operator()(std::span<std::byte const> const &message) {
+  auto msg_type = find(message, "35"sv);
+  auto key = get_key(msg_type, strip_header(message, body_), key_);
+  auto &requests = recording_.requests;
+  auto match = std::size(requests);
+  for (auto i = next_request_; i < std::size(requests); ++i) {
+    auto &request = requests[i];
+    if (request.matched || request.msg_type != msg_type) {
+      continue;
+    }
+    if (request.key == key) {
+      match = i;
+      break;
+    }
+    if (match == std::size(requests)) {
+      match = i;
+    }
+  }
+  if (match == std::size(requests)) {
+    ++unmatched_;
+    return;
+  }
+  auto &request = requests[match];
+  request.matched = true;
+  for (auto &[tag, value] : request.ids) {
+    auto replayed = find(message, tag);
+    if (!std::empty(replayed)) {
+      ids_.insert_or_assign(value, std::string{replayed});
+    }
+  }
+  while (next_request_ < std::size(requests) && requests[next_request_].matched) {
+    ++next_request_;
+  }
+}
+
+bool Replay::rewrite(Event const &event) {
+  body_.clear();
+  auto result = true;
+  for_each_field(event.body, [&](auto const &tag, auto const &value) {
+    if (contains(REQUEST_ID_TAGS, tag)) {
+      auto iter = ids_.find(value);
+      if (iter != std::end(ids_)) {
+        fmt::format_to(std::back_inserter(body_), "{}={}\x01"sv, tag, (*iter).second);
+        return;
+      }
+      result &= !recording_.ids.contains(value);  // note! otherwise not (yet) sent by the proxy
+    }
+    fmt::format_to(std::back_inserter(body_), "{}={}\x01"sv, tag, value);
+  });
+  return result;
+}
+
+void Replay::send(Event const &event) {
+  if (event.upstream) {
+    bridge_.replay(event.msg_type, event.rewrite ? body_ : event.body);  // note! rewritten body
+    ++sent_.upstream;
+  } else {
+    (*clients_[event.client]).replay(event.msg_type, event.body);
+    ++sent_.client;
+  }
+}
+
+template <typename Predicate>
+bool Replay::wait(Predicate predicate, std::string_view const &description) {
+  auto deadline = clock::get_system() + settings_.startup_timeout;
+  auto next_check = std::chrono::nanoseconds{};
+  while (!predicate()) {
+    auto now = clock::get_system();
+    if (deadline < now) {
+      log::error("Timeout waiting for {}"sv, description);
+      return false;
+    }
+    if (next_check <= now) {
+      next_check = now + PROXY_CHECK_FREQUENCY;
+      if (!proxy_.alive()) {
+        return false;
+      }
+    }
+    dispatch(settings_.busy_poll ? 0ms : 1ms);
+  }
+  return true;
+}
+
+void Replay::dispatch(std::chrono::milliseconds timeout) {
+  poller_.dispatch(timeout);
+  bridge_.refresh(clock::get_system());
+}
+
+uint64_t Replay::received() const {
+  auto result = bridge_.messages();
+  for (auto &client : clients_) {
+    result += (*client).statistics().messages;
+  }
+  return result;
+}
+
+int Replay::report() const {
+  uint64_t client = {}, rejects = {}, disconnects = bridge_.disconnects();
+  for (auto &item : clients_) {
+    auto &statistics = (*item).statistics();
+    client += statistics.messages;
+    rejects += statistics.rejects;
+    disconnects += statistics.disconnects;
+  }
+  auto duration = end_ - start_;
+  auto sent = sent_.upstream + sent_.client;
+  auto received = bridge_.messages() + client;
+  auto throughput = [&](auto value) { return duration.count() > 0 ? static_cast<double>(value) / to_seconds(duration) : 0.0; };
+  fmt::print(
+      "\n"
+      "{:>10} {:>12} {:>12} {:>12} {:>12}\n"
+      "{:>10} {:>12} {:>12} {:>12} {:>12.0f}\n"
+      "{:>10} {:>12} {:>12} {:>12} {:>12.0f}\n"
+      "\n"
+      "upstream = bridge side, client = all simulated sessions\n"
+      "sessions={} duration={:.3f}s max_lag={} rejects={} disconnects={}\n"
+      "requests: unmatched={} unresolved={}\n"
+      "\n"sv,
+      ""sv,
+      "upstream"sv,
+      "client"sv,
+      "total"sv,
+      "msgs/s"sv,
+      "sent"sv,
+      sent_.upstream,
+      sent_.client,
+      sent,
+      throughput(sent),
+      "received"sv,
+      bridge_.messages(),
+      client,
+      received,
+      throughput(received),
+      sessions_,
+      to_seconds(duration),
+      max_lag_,
+      rejects,
+      disconnects,
+      unmatched_,
+      unresolved_);
+  if (unresolved_ != 0) {
+    log::warn("Upstream messages were sent without mapping the request ids (unresolved={})"sv, unresolved_);
+  }
+  if (disconnects != 0) {
+    log::error("Sessions were lost during the replay (disconnects={})"sv, disconnects);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,131 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "roq/fix_proxy/tools/histogram.hpp"
+#include "roq/fix_proxy/tools/poller.hpp"
+
+#include "bridge.hpp"
+#include "client.hpp"
+#include "proxy.hpp"
+#include "settings.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// replay mode: journal segments captured by the proxy are replayed through the proxy, as fast as possible or at the recorded pace
+// upstream messages are sent by the stand-in bridge, client messages by one simulated client per recorded session
+// session-level messages are not replayed and the standard header is re-encoded (comp ids, sequence numbers, sending time)
+// all clients log on before the replay starts, i.e. recorded logons and logouts are collapsed
+// request ids (e.g. ClOrdID) are assigned by the proxy: each request received by the bridge is matched with a request recorded as sent by
+// the proxy (same content, otherwise the first of the same message type), recorded upstream messages then have these ids rewritten
+// an upstream message is held back until the requests it refers to have been received, i.e. a response never overtakes its request
+// client messages are sent in recorded order but each client has its own connection (the proxy may observe another interleaving)
+// the replay ends once the proxy has been quiet for a short period (which is not included in the measurement)
+
+struct Replay final : public Bridge::Handler {
+  explicit Replay(Settings const &);
+
+  Replay(Replay &&) = delete;
+  Replay(Replay const &) = delete;
+
+  // note! returns the process exit code
+  int run();
+
+ protected:
+  // Bridge::Handler
+  void operator()(std::span<std::byte const> const &message) override;
+
+  using Fields = std::vector<std::pair<std::string, std::string>>;  // note! tag, value
+
+  // note! allows lookup by std::string_view
+  struct Hash final {
+    using is_transparent = void;
+    size_t operator()(std::string_view const &value) const { return std::hash<std::string_view>{}(value); }
+  };
+
+  using Ids = std::unordered_set<std::string, Hash, std::equal_to<>>;
+  using IdMap = std::unordered_map<std::string, std::string, Hash, std::equal_to<>>;
+
+  struct Event final {
+    std::chrono::nanoseconds timestamp = {};
+    bool upstream = {};    // note! bridge => proxy
+    uint32_t client = {};  // note! index (only for client => proxy)
+    std::string msg_type;
+    std::string body;
+    bool rewrite = {};  // note! upstream message referring to a recorded request id
+  };
+
+  struct Request final {
+    std::string msg_type;
+    std::string key;  // note! body excluding request ids
+    Fields ids;       // note! recorded request ids
+    bool matched = {};
+  };
+
+  struct Recording final {
+    std::vector<Event> events;
+    std::vector<Request> requests;        // note! sent by the proxy (recorded order)
+    Ids ids;                              // note! all recorded request ids
+  };
+
+  // note! returns false if a request id has not yet been mapped
+  bool rewrite(Event const &);
+
+  bool replay();
+  bool drain();
+
+  void send(Event const &);
+
+  template <typename Predicate>
+  bool wait(Predicate predicate, std::string_view const &description);
+
+  void dispatch(std::chrono::milliseconds timeout);
+
+  uint64_t received() const;
+
+  int report() const;
+
+ private:
+  Settings const settings_;  // note! orders and streaming are disabled
+  Recording recording_;
+  std::vector<Event> const &events_;
+  uint32_t const sessions_;
+  tools::Poller poller_;
+  Bridge bridge_;
+  Proxy proxy_;
+  tools::Histogram order_ack_;
+  tools::Histogram market_data_;
+  std::vector<std::unique_ptr<Client>> clients_;
+  size_t next_request_ = {};                          // note! all recorded requests before this have been matched
+  IdMap ids_;                                         // note! recorded request id => replayed request id
+  std::string key_;
+  std::string body_;  // note! rewritten upstream message
+  uint64_t unmatched_ = {};
+  uint64_t unresolved_ = {};
+  struct {
+    uint64_t upstream = {};
+    uint64_t client = {};
+  } sent_;
+  std::chrono::nanoseconds start_ = {};
+  std::chrono::nanoseconds end_ = {};
+  std::chrono::nanoseconds max_lag_ = {};
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
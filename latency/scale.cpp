@@ -0,0 +1,312 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "scale.hpp"
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === CONSTANTS ===
+
+namespace {
+uint64_t const HIGHEST_TRACKABLE_VALUE = std::chrono::nanoseconds{1min}.count();
+uint32_t const SIGNIFICANT_FIGURES = 3;
+
+auto const PROXY_CHECK_FREQUENCY = 100ms;
+
+auto const TIMER_FREQUENCY = 100ms;  // note! client::Manager
+
+auto const TEARDOWN_SETTLE_PERIOD = 1s;  // note! allow for the deferred removal of sessions
+
+uint32_t const SESSIONS_PER_SOURCE_ADDRESS = 16384;  // note! well below the default ephemeral port range
+
+rlim_t const FILE_DESCRIPTOR_MARGIN = 1024;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+// note! market data is only published on demand and no orders are sent
+auto create_settings(auto &settings) {
+  auto result = settings;
+  result.market_data_rate = 0.0;
+  result.order_rate = 0.0;
+  return result;
+}
+
+// note! both the harness and the proxy (inherited) must be able to open a socket per session
+void raise_file_descriptor_limit(uint32_t sessions) {
+  struct rlimit limit = {};
+  ::getrlimit(RLIMIT_NOFILE, &limit);
+  auto required = static_cast<rlim_t>(sessions) + FILE_DESCRIPTOR_MARGIN;
+  if (limit.rlim_cur >= required) {
+    return;
+  }
+  limit.rlim_cur = std::min(required, limit.rlim_max);
+  ::setrlimit(RLIMIT_NOFILE, &limit);
+  if (limit.rlim_cur < required) {
+    log::warn("Open file descriptors are limited to {} (required {})"sv, limit.rlim_cur, required);
+  }
+}
+
+auto per_session(auto value, auto sessions) {
+  return static_cast<double>(value) / static_cast<double>(sessions);
+}
+
+auto to_us(std::chrono::nanoseconds value) {
+  return static_cast<double>(value.count()) / 1000.0;
+}
+
+// note! returns false if the per-session cost has grown super-linearly (relative to the first step)
+bool check_growth(auto const &name, auto &first, auto &result, auto factor, auto get_value) {
+  auto reference = per_session(get_value(first), first.sessions);
+  auto value = per_session(get_value(result), result.sessions);
+  if (reference <= 0.0 || value <= factor * reference) {
+    return true;
+  }
+  log::error("Super-linear {}: sessions={} cost/session={:.1f} (sessions={} cost/session={:.1f})"sv, name, result.sessions, value, first.sessions, reference);
+  return false;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Scale::Scale(Settings const &settings)
+    : settings_{create_settings(settings)}, bridge_{poller_, settings_, Proxy::BRIDGE_COMP_ID, Proxy::UPSTREAM_COMP_ID},
+      order_ack_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES}, market_data_{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES} {
+}
+
+int Scale::run() {
+  raise_file_descriptor_limit(settings_.scale_sessions.back());
+  for (auto sessions : settings_.scale_sessions) {
+    log::info("Running step with sessions={}"sv, sessions);
+    Result result{
+        .sessions = sessions,
+    };
+    auto success = run_step(sessions, result);
+    clients_.clear();
+    first_pending_ = {};
+    if (!success) {
+      return EXIT_FAILURE;
+    }
+    results_.emplace_back(result);
+  }
+  return report();
+}
+
+bool Scale::run_step(uint32_t sessions, Result &result) {
+  bridge_.close();  // note! the previous proxy may not yet have been detected as gone
+  Proxy proxy{settings_, settings_.scale_sessions.back(), bridge_.port()};
+  proxy.start();
+  if (!wait(proxy, [&]() { return bridge_.ready(); }, "upstream logon"sv)) {
+    return false;
+  }
+  auto memory = static_cast<int64_t>(proxy.resident_memory());
+  auto start = clock::get_system();
+  if (!logon(proxy, sessions)) {
+    return false;
+  }
+  result.logon = clock::get_system() - start;
+  if (!wait(proxy, [&]() { return bridge_.subscriptions() >= sessions; }, "subscriptions"sv)) {
+    return false;
+  }
+  result.memory = static_cast<int64_t>(proxy.resident_memory()) - memory;
+  auto cpu_time = proxy.cpu_time();
+  if (!run_for(proxy, settings_.scale_idle_period)) {
+    return false;
+  }
+  result.idle = (proxy.cpu_time() - cpu_time) / (settings_.scale_idle_period / TIMER_FREQUENCY);
+  if (!broadcast(proxy, result.broadcast)) {
+    return false;
+  }
+  uint64_t disconnects = {};
+  for (auto &client : clients_) {
+    disconnects += (*client).statistics().disconnects;
+  }
+  if (disconnects != 0) {
+    log::error("Sessions were lost during the step (disconnects={})"sv, disconnects);
+    return false;
+  }
+  return teardown(proxy, result.teardown);
+}
+
+bool Scale::logon(Proxy &proxy, uint32_t sessions) {
+  auto histograms = Client::Histograms{
+      .order_ack = order_ack_,
+      .market_data = market_data_,
+  };
+  auto ready = [&]() {
+    while (first_pending_ < std::size(clients_) && (*clients_[first_pending_]).ready()) {
+      ++first_pending_;
+    }
+    // note! the number of outstanding logons is bounded (the listen backlog of the proxy is finite)
+    while (std::size(clients_) < sessions && (std::size(clients_) - first_pending_) < settings_.scale_logon_window) {
+      auto index = static_cast<uint32_t>(std::size(clients_));
+      clients_.emplace_back(std::make_unique<Client>(
+          poller_,
+          settings_,
+          bridge_,
+          histograms,
+          proxy.port(),
+          Proxy::CLIENT_COMP_ID,
+          Proxy::PROXY_COMP_ID,
+          Proxy::get_username(index),
+          Proxy::PASSWORD,
+          true,
+          INADDR_LOOPBACK + index / SESSIONS_PER_SOURCE_ADDRESS));
+    }
+    auto now = clock::get_system();
+    for (auto i = first_pending_; i < std::size(clients_); ++i) {
+      (*clients_[i]).refresh(now);
+    }
+    return first_pending_ == sessions;
+  };
+  return wait(proxy, ready, "client logon"sv);
+}
+
+// note! the time until the last session has received the update (one update per session)
+bool Scale::broadcast(Proxy &proxy, std::chrono::nanoseconds &result) {
+  tools::Histogram rounds{HIGHEST_TRACKABLE_VALUE, SIGNIFICANT_FIGURES};
+  for (uint32_t i = 0; i < settings_.scale_broadcast_rounds; ++i) {
+    market_data_.reset();
+    auto start = clock::get_system();
+    bridge_.publish();
+    if (!wait(proxy, [&]() { return market_data_.count() >= std::size(clients_); }, "market data"sv)) {
+      return false;
+    }
+    rounds.record((clock::get_system() - start).count());
+  }
+  result = std::chrono::nanoseconds{rounds.value_at_percentile(50.0)};
+  return true;
+}
+
+// note! the upstream disconnect is broadcast by the proxy to all sessions (the removal of sessions is deferred)
+bool Scale::teardown(Proxy &proxy, std::chrono::nanoseconds &result) {
+  auto disconnected = [&]() {
+    for (auto &client : clients_) {
+      if ((*client).ready()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto cpu_time = proxy.cpu_time();
+  bridge_.close();
+  if (!wait(proxy, disconnected, "client disconnect"sv) || !run_for(proxy, TEARDOWN_SETTLE_PERIOD)) {
+    return false;
+  }
+  result = proxy.cpu_time() - cpu_time;
+  return true;
+}
+
+template <typename Predicate>
+bool Scale::wait(Proxy &proxy, Predicate predicate, std::string_view const &description) {
+  auto deadline = clock::get_system() + settings_.startup_timeout;
+  auto next_check = std::chrono::nanoseconds{};
+  while (!predicate()) {
+    auto now = clock::get_system();
+    if (deadline < now) {
+      log::error("Timeout waiting for {}"sv, description);
+      return false;
+    }
+    if (next_check <= now) {
+      next_check = now + PROXY_CHECK_FREQUENCY;
+      if (!proxy.alive()) {
+        return false;
+      }
+    }
+    dispatch();
+  }
+  return true;
+}
+
+bool Scale::run_for(Proxy &proxy, std::chrono::nanoseconds duration) {
+  auto deadline = clock::get_system() + duration;
+  auto next_check = std::chrono::nanoseconds{};
+  while (true) {
+    auto now = clock::get_system();
+    if (deadline <= now) {
+      return true;
+    }
+    if (next_check <= now) {
+      next_check = now + PROXY_CHECK_FREQUENCY;
+      if (!proxy.alive()) {
+        return false;
+      }
+    }
+    dispatch();
+  }
+}
+
+// note! clients are only refreshed while logging on (they should not reconnect)
+void Scale::dispatch() {
+  poller_.dispatch(settings_.busy_poll ? 0ms : 1ms);
+  bridge_.refresh(clock::get_system());
+}
+
+int Scale::report() const {
+  fmt::print(
+      "\n"
+      "{:>10} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12}\n"sv,
+      "sessions"sv,
+      "logon/s"sv,
+      "logon(us)"sv,
+      "memory(B)"sv,
+      "timer(us)"sv,
+      "timer(ns)"sv,
+      "fanout(us)"sv,
+      "fanout(ns)"sv,
+      "teardown(us)"sv,
+      "teardown(ns)"sv);
+  for (auto &result : results_) {
+    auto logon_rate = static_cast<double>(result.sessions) / std::chrono::duration<double>{result.logon}.count();
+    fmt::print(
+        "{:>10} {:>12.0f} {:>12.1f} {:>12.0f} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}\n"sv,
+        result.sessions,
+        logon_rate,
+        per_session(to_us(result.logon), result.sessions),
+        per_session(result.memory, result.sessions),
+        to_us(result.idle),
+        per_session(result.idle.count(), result.sessions),
+        to_us(result.broadcast),
+        per_session(result.broadcast.count(), result.sessions),
+        to_us(result.teardown),
+        per_session(result.teardown.count(), result.sessions));
+  }
+  fmt::print(
+      "\n"
+      "logon = per session, memory = resident per session, timer = proxy cpu per {} tick (total and per session)\n"
+      "fanout = median time until all sessions have received a market data update (total and per session)\n"
+      "teardown = proxy cpu to disconnect and remove all sessions (total and per session)\n"
+      "\n"sv,
+      TIMER_FREQUENCY);
+  auto success = true;
+  auto factor = settings_.scale_super_linear_factor;
+  auto &first = results_.front();
+  for (auto &result : results_) {
+    success &= check_growth("logon"sv, first, result, factor, [](auto &value) { return value.logon.count(); });
+    success &= check_growth("memory"sv, first, result, factor, [](auto &value) { return value.memory; });
+    success &= check_growth("timer"sv, first, result, factor, [](auto &value) { return value.idle.count(); });
+    success &= check_growth("fanout"sv, first, result, factor, [](auto &value) { return value.broadcast.count(); });
+    success &= check_growth("teardown"sv, first, result, factor, [](auto &value) { return value.teardown.count(); });
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,75 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "roq/fix_proxy/tools/histogram.hpp"
+#include "roq/fix_proxy/tools/poller.hpp"
+
+#include "bridge.hpp"
+#include "client.hpp"
+#include "proxy.hpp"
+#include "settings.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// note!
+// connection-scale mode: the proxy is restarted for each step and the number of concurrent sessions is increased
+// each step measures logon throughput, resident memory, idle (timer) cost, market data fan-out and disconnect fan-out
+// costs are normalized per session and flagged when they grow faster than the number of sessions
+
+struct Scale final {
+  explicit Scale(Settings const &);
+
+  Scale(Scale &&) = delete;
+  Scale(Scale const &) = delete;
+
+  // note! returns the process exit code
+  int run();
+
+ protected:
+  struct Result final {
+    uint32_t sessions = {};
+    std::chrono::nanoseconds logon = {};
+    int64_t memory = {};
+    std::chrono::nanoseconds idle = {};  // note! cpu time per timer tick
+    std::chrono::nanoseconds broadcast = {};
+    std::chrono::nanoseconds teardown = {};
+  };
+
+  bool run_step(uint32_t sessions, Result &);
+
+  bool logon(Proxy &, uint32_t sessions);
+  bool broadcast(Proxy &, std::chrono::nanoseconds &result);
+  bool teardown(Proxy &, std::chrono::nanoseconds &result);
+
+  template <typename Predicate>
+  bool wait(Proxy &, Predicate predicate, std::string_view const &description);
+
+  bool run_for(Proxy &, std::chrono::nanoseconds duration);
+
+  void dispatch();
+
+  int report() const;
+
+ private:
+  Settings const settings_;  // note! orders and streaming are disabled
+  tools::Poller poller_;
+  Bridge bridge_;
+  tools::Histogram order_ack_;
+  tools::Histogram market_data_;
+  std::vector<std::unique_ptr<Client>> clients_;
+  size_t first_pending_ = {};  // note! clients before this index have logged on
+  std::vector<Result> results_;
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,145 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "settings.hpp"
+
+#include <absl/flags/flag.h>
+#include <absl/strings/numbers.h>
+#include <absl/time/time.h>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+// === FLAGS ===
+
+ABSL_FLAG(std::string, proxy, {}, "Path to the roq-fix-proxy binary (empty means the proxy has already been started)");
+ABSL_FLAG(std::string, proxy_args, {}, "Additional flags passed to the proxy (space separated)");
+ABSL_FLAG(uint16_t, proxy_port, 0, "Port used by the proxy to accept client connections (0 means any free port)");
+
+ABSL_FLAG(uint16_t, bridge_port, 0, "Port used by the stand-in fix-bridge to accept the upstream connection (0 means any free port)");
+ABSL_FLAG(double, market_data_rate, 1000.0, "Market data updates per second (per subscription, 0 means none)");
+ABSL_FLAG(uint32_t, market_data_burst, 1, "Market data updates sent back-to-back each time the bridge publishes (per subscription)");
+ABSL_FLAG(bool, market_data_session, false, "Use a dedicated upstream session for market data (served by a second bridge using bridge_port + 1)");
+
+ABSL_FLAG(uint32_t, clients, 1, "Number of simulated FIX clients");
+ABSL_FLAG(double, order_rate, 100.0, "Orders per second (per client, 0 means none)");
+ABSL_FLAG(std::string, account, "A1", "Account");
+ABSL_FLAG(std::string, exchange, "deribit", "Exchange");
+ABSL_FLAG(std::string, symbol, "BTC-PERPETUAL", "Symbol");
+
+ABSL_FLAG(absl::Duration, startup_timeout, absl::Seconds(10), "Maximum time to wait for the proxy and all clients to be ready");
+ABSL_FLAG(absl::Duration, warmup, absl::Seconds(2), "Warmup period (samples are discarded)");
+ABSL_FLAG(absl::Duration, duration, absl::Seconds(10), "Measurement period");
+ABSL_FLAG(bool, busy_poll, false, "Never block in the kernel (reduces measurement noise but consumes a CPU core)");
+ABSL_FLAG(bool, kernel_timestamps, false, "Also measure latency to the kernel receive timestamp of the client sockets (SO_TIMESTAMPING)");
+
+ABSL_FLAG(std::string, output_directory, {}, "Directory used to write the histograms (HdrHistogram percentile distribution format)");
+ABSL_FLAG(absl::Duration, order_ack_p99_limit, absl::ZeroDuration(), "Fail if the 99th percentile order ack latency exceeds this limit (0 means disabled)");
+ABSL_FLAG(absl::Duration, market_data_p99_limit, absl::ZeroDuration(), "Fail if the 99th percentile market data latency exceeds this limit (0 means disabled)");
+
+ABSL_FLAG(std::vector<std::string>, scale_sessions, {}, "Connection-scale mode: concurrent sessions per step (comma separated, empty means latency mode)");
+ABSL_FLAG(uint32_t, scale_logon_window, 256, "Connection-scale mode: maximum number of outstanding logons");
+ABSL_FLAG(absl::Duration, scale_idle_period, absl::Seconds(5), "Connection-scale mode: period used to measure the idle (timer) cost");
+ABSL_FLAG(uint32_t, scale_broadcast_rounds, 10, "Connection-scale mode: market data updates sent to all sessions per step");
+ABSL_FLAG(
+    double,
+    scale_super_linear_factor,
+    2.0,
+    "Connection-scale mode: fail if a per-session cost grows by more than this factor (relative to the first step)");
+
+ABSL_FLAG(std::vector<std::string>, replay, {}, "Replay mode: journal segments captured by the proxy (--journal_path, comma separated)");
+ABSL_FLAG(double, replay_speed, 0.0, "Replay mode: speed relative to the recorded pace (0 means as fast as possible)");
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+// === HELPERS ===
+
+namespace {
+template <typename T>
+auto get_duration(T const &flag) {
+  return absl::ToChronoNanoseconds(absl::GetFlag(flag));
+}
+
+auto get_sessions(auto const &values) {
+  std::vector<uint32_t> result;
+  for (auto &value : values) {
+    uint32_t tmp = {};
+    if (!absl::SimpleAtoi(value, &tmp) || tmp == 0) {
+      log::fatal(R"(Unexpected: invalid scale_sessions="{}")"sv, value);
+    }
+    if (!std::empty(result) && tmp <= result.back()) {
+      log::fatal("Unexpected: scale_sessions must be increasing"sv);
+    }
+    result.emplace_back(tmp);
+  }
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Settings Settings::create() {
+  auto result = Settings{
+      .proxy = absl::GetFlag(FLAGS_proxy),
+      .proxy_args = absl::GetFlag(FLAGS_proxy_args),
+      .proxy_port = absl::GetFlag(FLAGS_proxy_port),
+      .bridge_port = absl::GetFlag(FLAGS_bridge_port),
+      .market_data_rate = absl::GetFlag(FLAGS_market_data_rate),
+      .market_data_burst = absl::GetFlag(FLAGS_market_data_burst),
+      .market_data_session = absl::GetFlag(FLAGS_market_data_session),
+      .clients = absl::GetFlag(FLAGS_clients),
+      .order_rate = absl::GetFlag(FLAGS_order_rate),
+      .account = absl::GetFlag(FLAGS_account),
+      .exchange = absl::GetFlag(FLAGS_exchange),
+      .symbol = absl::GetFlag(FLAGS_symbol),
+      .startup_timeout = get_duration(FLAGS_startup_timeout),
+      .warmup = get_duration(FLAGS_warmup),
+      .duration = get_duration(FLAGS_duration),
+      .busy_poll = absl::GetFlag(FLAGS_busy_poll),
+      .kernel_timestamps = absl::GetFlag(FLAGS_kernel_timestamps),
+      .output_directory = absl::GetFlag(FLAGS_output_directory),
+      .order_ack_p99_limit = get_duration(FLAGS_order_ack_p99_limit),
+      .market_data_p99_limit = get_duration(FLAGS_market_data_p99_limit),
+      .scale_sessions = get_sessions(absl::GetFlag(FLAGS_scale_sessions)),
+      .scale_logon_window = absl::GetFlag(FLAGS_scale_logon_window),
+      .scale_idle_period = get_duration(FLAGS_scale_idle_period),
+      .scale_broadcast_rounds = absl::GetFlag(FLAGS_scale_broadcast_rounds),
+      .scale_super_linear_factor = absl::GetFlag(FLAGS_scale_super_linear_factor),
+      .replay = absl::GetFlag(FLAGS_replay),
+      .replay_speed = absl::GetFlag(FLAGS_replay_speed),
+  };
+  if (result.clients == 0) {
+    log::fatal("Unexpected: clients must be at least 1"sv);
+  }
+  if (std::empty(result.proxy) && (result.proxy_port == 0 || result.bridge_port == 0)) {
+    log::fatal("Unexpected: proxy_port and bridge_port are required when the proxy has already been started"sv);
+  }
+  if (result.order_rate < 0.0 || result.market_data_rate < 0.0) {
+    log::fatal("Unexpected: rates can not be negative"sv);
+  }
+  if (!std::empty(result.scale_sessions) && (result.scale_logon_window == 0 || result.scale_super_linear_factor <= 1.0)) {
+    log::fatal("Unexpected: scale_logon_window must be at least 1 and scale_super_linear_factor must exceed 1"sv);
+  }
+  if (!std::empty(result.replay) && !std::empty(result.scale_sessions)) {
+    log::fatal("Unexpected: replay and scale_sessions can not be combined"sv);
+  }
+  if (result.kernel_timestamps && (!std::empty(result.scale_sessions) || !std::empty(result.replay))) {
+    log::fatal("Unexpected: kernel_timestamps is only supported in latency mode"sv);
+  }
+  if (result.market_data_burst == 0) {
+    log::fatal("Unexpected: market_data_burst must be at least 1"sv);
+  }
+  if (result.market_data_session && (!std::empty(result.scale_sessions) || !std::empty(result.replay))) {
+    log::fatal("Unexpected: market_data_session is only supported in latency mode"sv);
+  }
+  if (result.replay_speed < 0.0) {
+    log::fatal("Unexpected: replay_speed can not be negative"sv);
+  }
+  return result;
+}
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,55 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace latency {
+
+struct Settings final {
+  static Settings create();
+
+  // proxy
+  std::string proxy;
+  std::string proxy_args;
+  uint16_t proxy_port = {};
+  // bridge
+  uint16_t bridge_port = {};
+  double market_data_rate = {};
+  uint32_t market_data_burst = {};
+  bool market_data_session = {};
+  // clients
+  uint32_t clients = {};
+  double order_rate = {};
+  std::string account;
+  std::string exchange;
+  std::string symbol;
+  // run
+  std::chrono::nanoseconds startup_timeout = {};
+  std::chrono::nanoseconds warmup = {};
+  std::chrono::nanoseconds duration = {};
+  bool busy_poll = {};
+  bool kernel_timestamps = {};
+  // report
+  std::string output_directory;
+  std::chrono::nanoseconds order_ack_p99_limit = {};
+  std::chrono::nanoseconds market_data_p99_limit = {};
+  // scale
+  std::vector<uint32_t> scale_sessions;
+  uint32_t scale_logon_window = {};
+  std::chrono::nanoseconds scale_idle_period = {};
+  uint32_t scale_broadcast_rounds = {};
+  double scale_super_linear_factor = {};
+  // replay
+  std::vector<std::string> replay;
+  double replay_speed = {};
+};
+
+}  // namespace latency
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,433 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+namespace roq {
+namespace fix_proxy {
+namespace auth {
+
+// note!
+// streaming (allocation free) parser for the auth feed
+//   {"jsonrpc":"2.0","id":...,"result":[{"action":"insert",...},...]}
+// unknown keys are skipped, strings are returned as views into the payload unless they contain escape sequences
+// in which case they are decoded into a (bounded) scratch buffer owned by the parser
+
+struct Parser final {
+  struct Insert final {
+    std::string_view component;
+    std::string_view username;
+    std::string_view password;
+    uint32_t strategy_id = {};
+  };
+
+  struct Remove final {
+    std::string_view component;
+    std::string_view username;
+  };
+
+  struct Error final {
+    std::string_view what;
+    size_t offset = {};
+  };
+
+  // note! returns false if the payload is malformed (updates already emitted are *not* rolled back)
+  template <typename Handler>
+  bool dispatch(std::string_view const &payload, Handler &handler) {
+    payload_ = payload;
+    offset_ = {};
+    error_ = {};
+    scratch_length_ = {};  // note! views from a previous payload are no longer valid
+    return parse_root(handler);
+  }
+
+  Error const &error() const { return error_; }
+
+ protected:
+  struct Item final {
+    std::string_view action;
+    std::string_view component;
+    std::string_view username;
+    std::string_view password;
+    uint32_t strategy_id = {};
+    bool has_password = false;
+    bool has_strategy_id = false;
+  };
+
+  template <typename Handler>
+  bool parse_root(Handler &handler) {
+    if (!expect('{')) {
+      return false;
+    }
+    if (consume('}')) {
+      return true;
+    }
+    while (true) {
+      std::string_view key;
+      if (!parse_key(key)) {
+        return false;
+      }
+      if (key == "result") {
+        if (!parse_result(handler)) {
+          return false;
+        }
+      } else if (!skip_value()) {
+        return false;
+      }
+      if (consume(',')) {
+        continue;
+      }
+      return expect('}');
+    }
+  }
+
+  template <typename Handler>
+  bool parse_result(Handler &handler) {
+    skip_whitespace();
+    if (peek() != '[') {
+      return skip_value();  // note! e.g. response to the subscribe request
+    }
+    ++offset_;
+    if (consume(']')) {
+      return true;
+    }
+    while (true) {
+      Item item;
+      scratch_length_ = {};
+      if (!parse_item(item)) {
+        return false;
+      }
+      emit(item, handler);
+      if (consume(',')) {
+        continue;
+      }
+      return expect(']');
+    }
+  }
+
+  bool parse_item(Item &item) {
+    if (!expect('{')) {
+      return false;
+    }
+    if (consume('}')) {
+      return true;
+    }
+    while (true) {
+      std::string_view key;
+      if (!parse_key(key)) {
+        return false;
+      }
+      auto success = true;
+      if (key == "action") {
+        success = parse_string(item.action);
+      } else if (key == "component") {
+        success = parse_string(item.component);
+      } else if (key == "username") {
+        success = parse_string(item.username);
+      } else if (key == "password") {
+        success = item.has_password = parse_string(item.password);
+      } else if (key == "strategy_id") {
+        success = item.has_strategy_id = parse_uint32(item.strategy_id);
+      } else {
+        success = skip_value();
+      }
+      if (!success) {
+        return false;
+      }
+      if (consume(',')) {
+        continue;
+      }
+      return expect('}');
+    }
+  }
+
+  template <typename Handler>
+  void emit(Item const &item, Handler &handler) {
+    if (item.action == "insert") {
+      if (!item.has_password || !item.has_strategy_id) {
+        handler(Error{.what = "insert: missing password or strategy_id", .offset = offset_});
+        return;
+      }
+      auto insert = Insert{
+          .component = item.component,
+          .username = item.username,
+          .password = item.password,
+          .strategy_id = item.strategy_id,
+      };
+      handler(insert);
+    } else if (item.action == "remove") {
+      auto remove = Remove{
+          .component = item.component,
+          .username = item.username,
+      };
+      handler(remove);
+    } else {
+      handler(Error{.what = "unexpected action", .offset = offset_});
+    }
+  }
+
+  // scanner
+
+  char peek() const { return offset_ < std::size(payload_) ? payload_[offset_] : '\0'; }
+
+  void skip_whitespace() {
+    while (offset_ < std::size(payload_)) {
+      switch (payload_[offset_]) {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+          ++offset_;
+          break;
+        default:
+          return;
+      }
+    }
+  }
+
+  bool consume(char value) {
+    skip_whitespace();
+    if (peek() != value) {
+      return false;
+    }
+    ++offset_;
+    return true;
+  }
+
+  bool expect(char value) {
+    if (consume(value)) {
+      return true;
+    }
+    return fail("unexpected character");
+  }
+
+  bool fail(std::string_view const &what) {
+    error_ = {
+        .what = what,
+        .offset = offset_,
+    };
+    return false;
+  }
+
+  bool parse_key(std::string_view &result) { return parse_string(result) && expect(':'); }
+
+  bool parse_string(std::string_view &result) {
+    if (!expect('"')) {
+      return false;
+    }
+    auto begin = offset_;
+    // fast path: no escape sequences
+    while (offset_ < std::size(payload_)) {
+      auto value = payload_[offset_];
+      if (value == '"') {
+        result = payload_.substr(begin, offset_ - begin);
+        ++offset_;
+        return true;
+      }
+      if (value == '\\') {
+        break;
+      }
+      ++offset_;
+    }
+    if (offset_ >= std::size(payload_)) {
+      return fail("unterminated string");
+    }
+    // slow path: decode into scratch
+    auto start = scratch_length_;
+    if (!append(payload_.substr(begin, offset_ - begin))) {
+      return false;
+    }
+    while (offset_ < std::size(payload_)) {
+      auto value = payload_[offset_++];
+      if (value == '"') {
+        result = {&scratch_[start], scratch_length_ - start};
+        return true;
+      }
+      if (value != '\\') {
+        if (!append(value)) {
+          return false;
+        }
+        continue;
+      }
+      if (offset_ >= std::size(payload_)) {
+        break;
+      }
+      auto success = true;
+      switch (payload_[offset_++]) {
+        case '"':
+          success = append('"');
+          break;
+        case '\\':
+          success = append('\\');
+          break;
+        case '/':
+          success = append('/');
+          break;
+        case 'b':
+          success = append('\b');
+          break;
+        case 'f':
+          success = append('\f');
+          break;
+        case 'n':
+          success = append('\n');
+          break;
+        case 'r':
+          success = append('\r');
+          break;
+        case 't':
+          success = append('\t');
+          break;
+        case 'u':
+          success = parse_unicode();
+          break;
+        default:
+          return fail("invalid escape sequence");
+      }
+      if (!success) {
+        return false;
+      }
+    }
+    return fail("unterminated string");
+  }
+
+  bool parse_hex4(uint32_t &result) {
+    if ((offset_ + 4) > std::size(payload_)) {
+      return fail("invalid unicode escape");
+    }
+    auto begin = std::data(payload_) + offset_;
+    auto [ptr, ec] = std::from_chars(begin, begin + 4, result, 16);
+    if (ec != std::errc{} || ptr != (begin + 4)) {
+      return fail("invalid unicode escape");
+    }
+    offset_ += 4;
+    return true;
+  }
+
+  bool parse_unicode() {
+    uint32_t code_point = {};
+    if (!parse_hex4(code_point)) {
+      return false;
+    }
+    if (code_point >= 0xD800 && code_point < 0xDC00) {
+      uint32_t low = {};
+      if (payload_.substr(offset_, 2) != "\\u") {
+        return fail("invalid surrogate pair");
+      }
+      offset_ += 2;
+      if (!parse_hex4(low) || low < 0xDC00 || low >= 0xE000) {
+        return fail("invalid surrogate pair");
+      }
+      code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+    }
+    if (code_point < 0x80) {
+      return append(static_cast<char>(code_point));
+    }
+    if (code_point < 0x800) {
+      return append(static_cast<char>(0xC0 | (code_point >> 6))) && append(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    if (code_point < 0x10000) {
+      return append(static_cast<char>(0xE0 | (code_point >> 12))) && append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F))) &&
+             append(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    return append(static_cast<char>(0xF0 | (code_point >> 18))) && append(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F))) &&
+           append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F))) && append(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+
+  bool parse_uint32(uint32_t &result) {
+    skip_whitespace();
+    auto begin = std::data(payload_) + offset_;
+    auto end = std::data(payload_) + std::size(payload_);
+    auto [ptr, ec] = std::from_chars(begin, end, result);
+    if (ec != std::errc{}) {
+      return fail("invalid number");
+    }
+    offset_ += ptr - begin;
+    return true;
+  }
+
+  bool skip_value() {
+    skip_whitespace();
+    size_t depth = 0;
+    do {
+      skip_whitespace();
+      if (offset_ >= std::size(payload_)) {
+        return fail("unexpected end of payload");
+      }
+      switch (payload_[offset_]) {
+        case '{':
+        case '[':
+          ++depth;
+          ++offset_;
+          continue;
+        case '}':
+        case ']':
+          if (depth == 0) {
+            return fail("unexpected character");
+          }
+          --depth;
+          ++offset_;
+          break;
+        case ',':
+        case ':':
+          if (depth == 0) {
+            return fail("unexpected character");
+          }
+          ++offset_;
+          continue;
+        case '"': {
+          std::string_view tmp;
+          auto scratch_length = scratch_length_;
+          if (!parse_string(tmp)) {
+            return false;
+          }
+          scratch_length_ = scratch_length;  // note! skipped strings don't consume scratch
+          break;
+        }
+        default:
+          // literal: number, true, false, null
+          while (offset_ < std::size(payload_)) {
+            auto value = payload_[offset_];
+            if (value == ',' || value == '}' || value == ']' || value == ' ' || value == '\t' || value == '\r' || value == '\n') {
+              break;
+            }
+            ++offset_;
+          }
+          break;
+      }
+    } while (depth > 0);
+    return true;
+  }
+
+  bool append(char value) {
+    if (scratch_length_ >= std::size(scratch_)) {
+      return fail("string too long");
+    }
+    scratch_[scratch_length_++] = value;
+    return true;
+  }
+
+  bool append(std::string_view const &value) {
+    if ((scratch_length_ + std::size(value)) > std::size(scratch_)) {
+      return fail("string too long");
+    }
+    value.copy(&scratch_[scratch_length_], std::size(value));
+    scratch_length_ += std::size(value);
+    return true;
+  }
+
+ private:
+  std::string_view payload_;
+  size_t offset_ = {};
+  Error error_;
+  std::array<char, 4096> scratch_;
+  size_t scratch_length_ = {};
+};
+
+}  // namespace auth
+}  // namespace fix_proxy
+}  // namespace roq
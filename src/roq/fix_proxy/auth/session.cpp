@@ -2,8 +2,6 @@
 
 #include "roq/fix_proxy/auth/session.hpp"
 
-#include <nlohmann/json.hpp>
-
 #include "roq/web/socket/client.hpp"
 
 #include "roq/logging.hpp"
@@ -44,8 +42,8 @@ auto create_connection(auto &handler, auto &settings, auto &context, auto &uri)
 
 // === IMPLEMENTATION ===
 
-Session::Session(Handler &handler, Settings const &settings, io::Context &context, io::web::URI const &uri)
-    : handler_{handler}, connection_{create_connection(*this, settings, context, uri)} {
+Session::Session(Handler &handler, Settings const &settings, io::Context &context, io::web::URI const &uri, Profiler &profiler)
+    : handler_{handler}, connection_{create_connection(*this, settings, context, uri)}, profiler_{profiler} {
 }
 
 void Session::operator()(Event<Start> const &) {
@@ -85,34 +83,27 @@ void Session::operator()(web::socket::Client::Latency const &) {
 }
 
 void Session::operator()(web::socket::Client::Text const &text) {
-  log::info(R"(DEBUG: text="{}")"sv, text.payload);
-  auto json = nlohmann::json::parse(text.payload);
-  auto result = json.at("result"sv);
-  for (auto &obj : result) {
-    auto action = obj.at("action"sv).template get<std::string_view>();
-    auto component = obj.at("component"sv).template get<std::string_view>();
-    auto username = obj.at("username"sv).template get<std::string_view>();
-    if (action == "insert"sv) {
-      auto password = obj.at("password"sv).template get<std::string_view>();
-      auto strategy_id = obj.at("strategy_id"sv).template get<uint32_t>();
-      log::info<1>(R"(action="{}", component="{}", username="{}", password="{}", strategy_id={})"sv, action, component, username, password, strategy_id);
-      auto insert = Insert{
-          .component = component,
-          .username = username,
-          .password = password,
-          .strategy_id = strategy_id,
-      };
+  Profiler::Scope scope{profiler_, Profiler::Callback::AUTH};
+  log::info<1>("size={}"sv, std::size(text.payload));  // note! payload contains passwords
+  struct Bridge final {
+    explicit Bridge(Handler &handler) : handler_{handler} {}
+
+    void operator()(Insert const &insert) {
+      log::info<1>(R"(action="insert", component="{}", username="{}", strategy_id={})"sv, insert.component, insert.username, insert.strategy_id);
       handler_(insert);
-    } else if (action == "remove"sv) {
-      log::info<1>(R"(action="{}", component="{}", username="{}")"sv, action, component, username);
-      auto remove = Remove{
-          .component = component,
-          .username = username,
-      };
+    }
+    void operator()(Remove const &remove) {
+      log::info<1>(R"(action="remove", component="{}", username="{}")"sv, remove.component, remove.username);
       handler_(remove);
-    } else {
-      log::warn(R"(Unexpected: action="{}")"sv, action);
     }
+    void operator()(Parser::Error const &error) { log::warn(R"(Unexpected: {} (offset={}))"sv, error.what, error.offset); }
+
+   private:
+    Handler &handler_;
+  } bridge{handler_};
+  if (!parser_.dispatch(text.payload, bridge)) {
+    auto &error = parser_.error();
+    log::warn(R"(Unexpected: malformed payload, {} (offset={}, size={}))"sv, error.what, error.offset, std::size(text.payload));
   }
 }
 
@@ -12,31 +12,25 @@
 
 #include "roq/web/socket/client.hpp"
 
+#include "roq/fix_proxy/profiler.hpp"
 #include "roq/fix_proxy/settings.hpp"
 
+#include "roq/fix_proxy/auth/parser.hpp"
+
 namespace roq {
 namespace fix_proxy {
 namespace auth {
 
 struct Session final : public web::socket::Client::Handler {
-  struct Insert final {
-    std::string_view component;
-    std::string_view username;
-    std::string_view password;
-    uint32_t strategy_id = {};
-  };
-
-  struct Remove final {
-    std::string_view component;
-    std::string_view username;
-  };
+  using Insert = Parser::Insert;
+  using Remove = Parser::Remove;
 
   struct Handler {
     virtual void operator()(Insert const &) = 0;
     virtual void operator()(Remove const &) = 0;
   };
 
-  Session(Handler &, Settings const &, io::Context &, io::web::URI const &);
+  Session(Handler &, Settings const &, io::Context &, io::web::URI const &, Profiler &);
 
   void operator()(Event<Start> const &);
   void operator()(Event<Stop> const &);
@@ -55,6 +49,8 @@ struct Session final : public web::socket::Client::Handler {
  private:
   Handler &handler_;
   std::unique_ptr<web::socket::Client> const connection_;
+  Parser parser_;
+  Profiler &profiler_;
 };
 
 }  // namespace auth
@@ -0,0 +1,17 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include "roq/fix_proxy/decoder.hpp"
+#include "roq/fix_proxy/messages.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace client {
+
+// note! decodes downstream (client => proxy) messages
+using Decoder = fix_proxy::Decoder<Messages::FromClient>;
+
+}  // namespace client
+}  // namespace fix_proxy
+}  // namespace roq
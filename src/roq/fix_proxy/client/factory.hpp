@@ -2,8 +2,6 @@
 
 #pragma once
 
-#include <memory>
-
 #include "roq/fix_proxy/shared.hpp"
 
 #include "roq/fix_proxy/client/session.hpp"
@@ -13,7 +11,7 @@ namespace fix_proxy {
 namespace client {
 
 struct Factory {
-  virtual std::unique_ptr<Session> create(uint64_t session_id, Shared &) = 0;
+  virtual Session create(uint64_t session_id, Shared &) = 0;  // note! constructed in place by the caller
 };
 
 }  // namespace client
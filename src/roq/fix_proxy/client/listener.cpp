@@ -15,11 +15,11 @@ namespace client {
 // === HELPERS ===
 
 namespace {
-auto create_listener(auto &handler, auto &settings, auto &context) {
-  if (std::empty(settings.client.listen_address)) {
+auto create_listener(auto &handler, auto &listen_address, auto &context) {
+  if (std::empty(listen_address)) {
     return std::unique_ptr<io::net::tcp::Listener>();
   }
-  auto network_address = io::NetworkAddress{settings.client.listen_address};
+  auto network_address = io::NetworkAddress{listen_address};
   log::debug("network_address={}"sv, network_address);
   return context.create_tcp_listener(handler, network_address);
 }
@@ -27,7 +27,8 @@ auto create_listener(auto &handler, auto &settings, auto &context) {
 
 // === IMPLEMENTATION ===
 
-Listener::Listener(Handler &handler, Settings const &settings, io::Context &context) : handler_{handler}, listener_{create_listener(*this, settings, context)} {
+Listener::Listener(Handler &handler, std::string_view const &listen_address, io::Context &context)
+    : handler_{handler}, listener_{create_listener(*this, listen_address, context)} {
 }
 
 // io::net::tcp::Listener::Handler
@@ -37,9 +38,9 @@ void Listener::operator()(io::net::tcp::Connection::Factory &factory) {
     explicit Bridge(io::net::tcp::Connection::Factory &factory) : factory_{factory} {}
 
    protected:
-    std::unique_ptr<Session> create(uint64_t session_id, Shared &shared) override {
+    Session create(uint64_t session_id, Shared &shared) override {
       log::info("Connected (session_id={})"sv, session_id);
-      return std::make_unique<Session>(factory_, session_id, shared);
+      return Session{factory_, session_id, shared};
     }
 
    private:
@@ -53,9 +54,9 @@ void Listener::operator()(io::net::tcp::Connection::Factory &factory, io::Networ
     Bridge(io::net::tcp::Connection::Factory &factory, io::NetworkAddress const &network_address) : factory_{factory}, network_address_{network_address} {}
 
    protected:
-    std::unique_ptr<Session> create(uint64_t session_id, Shared &shared) override {
+    Session create(uint64_t session_id, Shared &shared) override {
       log::info("Connected (session_id={}, peer={})"sv, session_id, network_address_.to_string_2());
-      return std::make_unique<Session>(factory_, session_id, shared);
+      return Session{factory_, session_id, shared};
     }
 
    private:
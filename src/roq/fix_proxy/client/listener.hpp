@@ -3,11 +3,10 @@
 #pragma once
 
 #include <memory>
+#include <string_view>
 
 #include "roq/io/context.hpp"
 
-#include "roq/fix_proxy/settings.hpp"
-
 #include "roq/fix_proxy/client/factory.hpp"
 
 namespace roq {
@@ -19,7 +18,7 @@ struct Listener final : public io::net::tcp::Listener::Handler {
     virtual void operator()(Factory &) = 0;
   };
 
-  Listener(Handler &, Settings const &, io::Context &);
+  Listener(Handler &, std::string_view const &listen_address, io::Context &);
 
  protected:
   // io::net::tcp::Listener::Handler
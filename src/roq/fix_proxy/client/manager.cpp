@@ -2,6 +2,9 @@
 
 #include "roq/fix_proxy/client/manager.hpp"
 
+#include <algorithm>
+
+#include "roq/clock.hpp"
 #include "roq/logging.hpp"
 
 using namespace std::literals;
@@ -13,35 +16,173 @@ namespace client {
 // === CONSTANTS ===
 
 namespace {
-auto const GARBAGE_COLLECTION_FREQUENCY = 1s;
+auto const STATISTICS_FREQUENCY = 60s;
+
+uint64_t const HIGHEST_TRACKABLE_LATENCY = std::chrono::nanoseconds{1s}.count();
+uint32_t const SIGNIFICANT_FIGURES = 3;
+}
+
+// === HELPERS ===
+
+namespace {
+auto create_listen_address(auto &settings) -> std::string_view {
+  if (settings.client.io_threads > 0) {
+    return {};  // note! shards are listening
+  }
+  return settings.client.listen_address;
+}
+
+template <typename R>
+auto create_shards(auto &settings, auto &shared) {
+  using result_type = std::remove_cvref_t<R>;
+  using value_type = typename result_type::value_type::element_type;
+  result_type result;
+  auto count = settings.client.io_threads;
+  if (count == 0) {
+    return result;
+  }
+  auto listeners = value_type::create_listeners(settings.client.listen_address, count);
+  for (uint32_t i = 0; i < count; ++i) {
+    result.emplace_back(std::make_unique<value_type>(settings, i, count, listeners[i], shared.has_verifier(), shared.metrics.shard(i), shared.wakeup));
+  }
+  return result;
 }
+}  // namespace
 
 // === IMPLEMENTATION ===
 
-Manager::Manager(Settings const &settings, io::Context &context, Shared &shared) : fix_listener_{*this, settings, context}, shared_{shared} {
+Manager::Manager(Settings const &settings, io::Context &context, Shared &shared)
+    : fix_listener_{*this, create_listen_address(settings), context}, shards_{create_shards<decltype(shards_)>(settings, shared)}, shared_{shared},
+      timer_latency_{HIGHEST_TRACKABLE_LATENCY, SIGNIFICANT_FIGURES}, cleanup_latency_{HIGHEST_TRACKABLE_LATENCY, SIGNIFICANT_FIGURES} {
+  auto decode_buffers = std::size(shared_.decode_buffer) + std::size(shared_.decode_buffer_2);
+  auto encode_buffer = shared_.encode_buffer.size();
+  log::info(
+      "Memory usage: decode_buffers={} (shared), encode_buffer={} (shared, initial), session={} (per session, initial)"sv,
+      decode_buffers,
+      encode_buffer,
+      sizeof(Session));
 }
 
 void Manager::operator()(Event<Timer> const &event) {
-  remove_zombies(event.value.now);
+  auto start = clock::get_system();
+  remove_zombies();
+  timer_latency_.record((clock::get_system() - start).count());
+  shared_.encode_buffer.refresh(event.value.now);
+  for (auto &shard : shards_) {
+    (*shard).refresh(event.value.now);
+  }
+  statistics(event.value.now);
+}
+
+size_t Manager::poll() {
+  size_t result = 0;
+  for (auto &shard : shards_) {
+    result += (*shard).poll(*this);
+  }
+  remove_zombies();
+  return result;
+}
+
+bool Manager::idle() const {
+  return std::ranges::all_of(shards_, [](auto &shard) { return (*shard).idle(); });
 }
 
 // fix::Listener::Handler
 
 void Manager::operator()(Factory &factory) {
-  auto session_id = ++shared_.next_session_id;
-  log::info("Adding session_id={}..."sv, session_id);
-  auto session = factory.create(session_id, shared_);
-  sessions_.try_emplace(session_id, std::move(session));
+  sessions_.emplace([&](auto session_id) {
+    log::info("Adding session_id={}..."sv, session_id);
+    return factory.create(session_id, shared_);
+  });
+}
+
+// Shard::Handler
+
+void Manager::operator()(Shard::Connected const &connected) {
+  auto link_id = connected.link_id;
+  uint64_t session_id = {};
+  sessions_.emplace([&](auto key) {
+    session_id = key;
+    log::info("Adding session_id={} (link_id={})..."sv, session_id, link_id);
+    return Session{connected.shard, link_id, session_id, shared_};
+  });
+  auto index = decltype(sessions_)::get_index(link_id);
+  if (index >= std::size(links_)) {
+    links_.resize(index + 1);
+  }
+  links_[index] = {
+      .link_id = link_id,
+      .session_id = session_id,
+  };
+}
+
+void Manager::operator()(Shard::Decoded const &decoded) {
+  auto link = find_link(decoded.link_id);
+  if (link == nullptr) [[unlikely]] {
+    return;
+  }
+  find((*link).session_id, [&](auto &session) { session(decoded); });
+}
+
+void Manager::operator()(Shard::Disconnected const &disconnected) {
+  auto link = find_link(disconnected.link_id);
+  if (link == nullptr) [[unlikely]] {
+    return;
+  }
+  log::info("Removing session_id={}..."sv, (*link).session_id);
+  sessions_.erase((*link).session_id);  // note! safe, not called from the session
+  *link = {};
 }
 
 // utilities
 
-void Manager::remove_zombies(std::chrono::nanoseconds now) {
-  if (now < next_garbage_collection_) {
+Manager::Link *Manager::find_link(uint64_t link_id) {
+  auto index = decltype(sessions_)::get_index(link_id);
+  if (index >= std::size(links_) || links_[index].link_id != link_id) [[unlikely]] {
+    return nullptr;
+  }
+  return &links_[index];
+}
+
+void Manager::remove_zombies() {
+  if (!shared_.session_cleanup_pending()) [[likely]] {
+    return;
+  }
+  auto start = clock::get_system();
+  shared_.session_cleanup([&](auto session_id) {
+    if (sessions_.erase(session_id)) {
+      log::info("Removed session_id={}"sv, session_id);
+      ++cleanup_count_;
+    }
+  });
+  cleanup_latency_.record((clock::get_system() - start).count());
+}
+
+void Manager::statistics(std::chrono::nanoseconds now) {
+  if (now < next_statistics_) {
     return;
   }
-  next_garbage_collection_ = now + GARBAGE_COLLECTION_FREQUENCY;
-  shared_.session_cleanup([&](auto session_id) { sessions_.erase(session_id); });
+  next_statistics_ = now + STATISTICS_FREQUENCY;
+  size_t total = 0;
+  sessions_.for_each([&](auto &session) { total += session.memory_usage(); });
+  auto count = std::size(sessions_);
+  log::info("Statistics: sessions={}, memory_usage={}, per_session={}"sv, count, total, count > 0 ? total / count : size_t{0});
+  auto &encode_buffer = shared_.encode_buffer;
+  log::info("Statistics: encode_buffer={{size={}, growth_count={}}} (shared)"sv, encode_buffer.size(), encode_buffer.growth_count());
+  log::info(
+      "Statistics: timer={{count={}, p50={}ns, p99={}ns, max={}ns}}, cleanup={{removed={}, count={}, p50={}ns, p99={}ns, max={}ns}}"sv,
+      timer_latency_.count(),
+      timer_latency_.value_at_percentile(50.0),
+      timer_latency_.value_at_percentile(99.0),
+      timer_latency_.max(),
+      cleanup_count_,
+      cleanup_latency_.count(),
+      cleanup_latency_.value_at_percentile(50.0),
+      cleanup_latency_.value_at_percentile(99.0),
+      cleanup_latency_.max());
+  timer_latency_.reset();
+  cleanup_latency_.reset();
+  cleanup_count_ = {};
 }
 
 }  // namespace client
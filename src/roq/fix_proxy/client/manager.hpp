@@ -4,51 +4,66 @@
 
 #include <chrono>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "roq/start.hpp"
 #include "roq/stop.hpp"
 #include "roq/timer.hpp"
 
-#include "roq/utils/container.hpp"
-
 #include "roq/io/context.hpp"
 
 #include "roq/fix_proxy/settings.hpp"
 #include "roq/fix_proxy/shared.hpp"
 
+#include "roq/fix_proxy/tools/histogram.hpp"
+#include "roq/fix_proxy/tools/slot_map.hpp"
+
 #include "roq/fix_proxy/client/session.hpp"
 
 #include "roq/fix_proxy/client/listener.hpp"
+#include "roq/fix_proxy/client/shard.hpp"
 
 namespace roq {
 namespace fix_proxy {
 namespace client {
 
-struct Manager final : public Listener::Handler {
+struct Manager final : public Listener::Handler, public Shard::Handler {
   Manager(Settings const &, io::Context &, Shared &);
 
   void operator()(Event<Timer> const &);
 
+  // note! shards must be polled from the event loop thread
+  bool has_shards() const { return !std::empty(shards_); }
+
+  size_t poll();
+
+  // note! nothing is waiting for the event loop thread (shards)
+  bool idle() const;
+
   void dispatch(auto &value) {
-    for (auto &[_, item] : sessions_) {
-      (*item)(value);
-    }
+    sessions_.for_each([&](auto &session) { session(value); });
   }
 
   template <typename Callback>
   void get_all_sessions(Callback callback) {
-    for (auto &[_, session] : sessions_) {
-      callback(*session);
+    sessions_.for_each(callback);
+  }
+
+  template <typename Callback>
+  void get_all_shards(Callback callback) const {
+    for (auto &shard : shards_) {
+      callback(std::as_const(*shard));
     }
   }
 
   template <typename Callback>
   bool find(uint64_t session_id, Callback callback) {
-    auto iter = sessions_.find(session_id);
-    if (iter == std::end(sessions_)) {
+    auto session = sessions_.find(session_id);
+    if (session == nullptr) [[unlikely]] {
       return false;
     }
-    callback(*(*iter).second);
+    callback(*session);
     return true;
   }
 
@@ -56,15 +71,35 @@ struct Manager final : public Listener::Handler {
   // fix::Listener::Handler
   void operator()(Factory &) override;
 
+  // Shard::Handler
+  void operator()(Shard::Connected const &) override;
+  void operator()(Shard::Decoded const &) override;
+  void operator()(Shard::Disconnected const &) override;
+
   // utilities
 
-  void remove_zombies(std::chrono::nanoseconds now);
+  struct Link final {
+    uint64_t link_id = {};
+    uint64_t session_id = {};
+  };
+
+  Link *find_link(uint64_t link_id);
+
+  void remove_zombies();
+
+  void statistics(std::chrono::nanoseconds now);
 
  private:
   Listener fix_listener_;
+  std::vector<std::unique_ptr<Shard>> const shards_;
   Shared &shared_;
-  utils::unordered_map<uint64_t, std::unique_ptr<Session>> sessions_;
-  std::chrono::nanoseconds next_garbage_collection_ = {};
+  tools::SlotMap<Session> sessions_;
+  std::vector<Link> links_;  // note! indexed by link id (slot index)
+  std::chrono::nanoseconds next_statistics_ = {};
+  // note! cost of the timer (iterating the sessions) and of removing sessions, reported with the statistics
+  tools::Histogram timer_latency_;
+  tools::Histogram cleanup_latency_;
+  size_t cleanup_count_ = {};
 };
 
 }  // namespace client
@@ -2,10 +2,16 @@
 
 #include "roq/fix_proxy/client/session.hpp"
 
+#include <magic_enum/magic_enum_format.hpp>
+
 #include <nameof.hpp>
 
+#include <cstring>
 #include <exception>
+#include <type_traits>
+#include <variant>
 
+#include "roq/clock.hpp"
 #include "roq/logging.hpp"
 
 #include "roq/utils/debug/fix/message.hpp"
@@ -19,129 +25,146 @@ namespace client {
 // === CONSTANTS ===
 
 namespace {
-auto const FIX_VERSION = fix::Version::FIX_44;
+auto const REJECT_LOG_INTERVAL = 1s;
 }  // namespace
 
 // === IMPLEMENTATION ===
 
 Session::Session(io::net::tcp::Connection::Factory &factory, uint64_t session_id, Shared &shared)
-    : connection_{factory.create(*this)}, session_id_{session_id}, shared_{shared}, decode_buffer_(shared.settings.client.decode_buffer_size),
-      decode_buffer_2_(shared.settings.client.decode_buffer_size) {
-}
-
-void Session::force_disconnect() {
-  close();
-}
-
-// fix::proxy::Manager
-
-// - connection
-
-void Session::operator()(Trace<fix::proxy::Manager::Disconnect> const &) {
-  close();
-}
-
-// - manager => client
-
-void Session::operator()(Trace<fix::codec::Reject> const &event) {
-  send<2>(event);
-}
-
-void Session::operator()(Trace<fix::codec::Logon> const &event) {
-  send<2>(event);
-}
-
-void Session::operator()(Trace<fix::codec::Logout> const &event) {
-  send<2>(event);
-}
-
-void Session::operator()(Trace<fix::codec::Heartbeat> const &event) {
-  send<2>(event);
-}
-
-void Session::operator()(Trace<fix::codec::TestRequest> const &event) {
-  send<2>(event);
-}
-
-// - server => client
-
-void Session::operator()(Trace<fix::codec::BusinessMessageReject> const &event) {
-  send<2>(event);
-}
-
-void Session::operator()(Trace<fix::codec::TradingSessionStatus> const &event) {
-  send<2>(event);
-}
-
-void Session::operator()(Trace<fix::codec::SecurityList> const &event) {
-  send<2>(event);
+    : connection_{factory.create(*this)}, session_id_{session_id}, shared_{shared} {
 }
 
-void Session::operator()(Trace<fix::codec::SecurityDefinition> const &event) {
-  send<2>(event);
+Session::Session(Shard &shard, uint64_t link_id, uint64_t session_id, Shared &shared)
+    : shard_{&shard}, link_id_{link_id}, session_id_{session_id}, shared_{shared} {
 }
 
-void Session::operator()(Trace<fix::codec::SecurityStatus> const &event) {
-  send<2>(event);
-}
-
-void Session::operator()(Trace<fix::codec::MarketDataRequestReject> const &event) {
-  send<2>(event);
+void Session::operator()(Shard::Decoded const &decoded) {
+  Profiler::Scope scope{shared_.profiler, Profiler::Callback::CLIENT_READ, session_id_};
+  auto &trace_info = decoded.trace_info;
+  auto &header = decoded.header;
+  auto &raw = decoded.raw;
+  receive_time_ = trace_info.source_receive_time;
+  auto journal = shared_.journal.event_loop();
+  if (journal != nullptr) [[unlikely]] {
+    (*journal).write(Journal::Peer::CLIENT, Journal::Direction::INBOUND, session_id_, receive_time_, raw);
+  }
+  if (shared_.settings.test.fix_debug) {
+    log::info<0>("[session_id={}]: {}"sv, session_id_, utils::debug::fix::Message{raw});
+  }
+  statistics_.bytes_received += std::size(raw);
+  try {
+    if (header.msg_type == fix::MsgType::LOGON && std::holds_alternative<std::monostate>(decoded.value) && shared_.has_verifier()) [[unlikely]] {
+      suspend(raw);
+      if (verification_ != Verification::PENDING) {
+        (*shard_).resume(link_id_);
+      }
+      return;
+    }
+    check(header);
+    if (std::empty(comp_id_)) [[unlikely]] {
+      comp_id_ = header.sender_comp_id;
+    }
+    if (!entitlements_(header.msg_type)) [[unlikely]] {
+      reject(trace_info, header);  // note! not decoded by the shard once the link has been restricted
+      return;
+    }
+    if (std::holds_alternative<std::monostate>(decoded.value)) [[unlikely]] {
+      log::warn("Unexpected: msg_type={}"sv, header.msg_type);
+      return;
+    }
+    auto helper = [&]<typename T>(T const &value) {
+      if constexpr (!std::is_same_v<T, std::monostate>) {
+        dispatch(trace_info, header, value, decoded.decode_start, decoded.decode_end);
+      }
+    };
+    std::visit(helper, decoded.value);
+  } catch (Exception &e) {
+    log::error("Exception: {}"sv, e);
+    close();
+  } catch (std::exception &e) {
+    log::error("Exception: {}"sv, e.what());
+    close();
+  }
 }
 
-void Session::operator()(Trace<fix::codec::MarketDataSnapshotFullRefresh> const &event) {
-  send<2>(event);
+size_t Session::memory_usage() const {
+  return sizeof(*this) + comp_id_.capacity() + logon_.frame.capacity();
 }
 
-void Session::operator()(Trace<fix::codec::MarketDataIncrementalRefresh> const &event) {
-  send<2>(event);
+void Session::force_disconnect() {
+  close();
 }
 
-void Session::operator()(Trace<fix::codec::ExecutionReport> const &event) {
-  send<2>(event);
+void Session::resume() {
+  assert(verification_ == Verification::PENDING);
+  verification_ = Verification::UNDEFINED;
+  try {
+    logon();
+  } catch (Exception &e) {
+    log::error("Exception: {}"sv, e);
+    close();
+    return;
+  } catch (std::exception &e) {
+    log::error("Exception: {}"sv, e.what());
+    close();
+    return;
+  }
+  if (static_cast<bool>(connection_)) {
+    process();
+  } else {
+    (*shard_).resume(link_id_);  // note! the shard has paused the link
+  }
 }
 
-void Session::operator()(Trace<fix::codec::OrderCancelReject> const &event) {
-  send<2>(event);
-}
+// fix::proxy::Manager
 
-void Session::operator()(Trace<fix::codec::OrderMassCancelReport> const &event) {
-  send<2>(event);
-}
+// - connection
 
-void Session::operator()(Trace<fix::codec::TradeCaptureReportRequestAck> const &event) {
-  send<2>(event);
+void Session::operator()(Trace<fix::proxy::Manager::Disconnect> const &) {
+  close();
 }
 
-void Session::operator()(Trace<fix::codec::TradeCaptureReport> const &event) {
-  send<2>(event);
-}
+// io::net::tcp::Connection::Handler
 
-void Session::operator()(Trace<fix::codec::RequestForPositionsAck> const &event) {
-  send<2>(event);
+void Session::operator()(io::net::tcp::Connection::Read const &) {
+  Profiler::Scope scope{shared_.profiler, Profiler::Callback::CLIENT_READ, session_id_};
+  receive_time_ = clock::get_system();
+  auto size = std::size(buffer_.data());
+  buffer_.append(*connection_);
+  shared_.metrics.event_loop().add(Metrics::Counter::CLIENT_BYTES_RECEIVED, std::size(buffer_.data()) - size);
+  if (verification_ == Verification::PENDING) [[unlikely]] {
+    return;  // note! buffered until logon has been verified
+  }
+  process();
 }
 
-void Session::operator()(Trace<fix::codec::PositionReport> const &event) {
-  send<2>(event);
+void Session::operator()(io::net::tcp::Connection::Disconnected const &) {
+  shared_.session_remove(session_id_);  // note! deferred (can't be removed from its own callback)
 }
 
-void Session::operator()(Trace<fix::codec::MassQuoteAck> const &event) {
-  send<2>(event);
-}
+// inbound
 
-void Session::operator()(Trace<fix::codec::QuoteStatusReport> const &event) {
-  send<2>(event);
+void Session::process() {
+  auto bytes = process(buffer_.data());
+  buffer_.drain(bytes);
 }
 
-// io::net::tcp::Connection::Handler
-
-void Session::operator()(io::net::tcp::Connection::Read const &) {
-  buffer_.append(*connection_);
-  auto buffer = buffer_.data();
+// note! frames are journaled before they are decoded (which may throw)
+size_t Session::process(std::span<std::byte const> const &data) {
+  auto &frames = shared_.frames;
+  frames.clear();
+  auto [bytes, status] = shared_.frame_scanner.scan(data, frames);
+  size_t total_bytes = 0;
+  auto journal = shared_.journal.event_loop();
+  auto logon = false;
   try {
-    size_t total_bytes = 0;
     auto helper = [&](auto &message) {
+      if (message.header.msg_type == fix::MsgType::LOGON && shared_.has_verifier()) [[unlikely]] {
+        logon = true;  // note! decoded by suspend (once the frame has been copied)
+        return;
+      }
       TraceInfo trace_info;
+      trace_info.source_receive_time = receive_time_;
       check(message.header);
       Trace event{trace_info, message};
       parse(event);
@@ -149,20 +172,23 @@ void Session::operator()(io::net::tcp::Connection::Read const &) {
     auto logger = [&]([[maybe_unused]] auto &message) {
       // note! here we could log the raw binary message
     };
-    while (!std::empty(buffer)) {
-      auto bytes = fix::Reader<FIX_VERSION>::dispatch(buffer, helper, logger);
-      if (bytes == 0) {
-        break;
+    for (auto &frame : frames) {
+      if (journal != nullptr) [[unlikely]] {
+        (*journal).write(Journal::Peer::CLIENT, Journal::Direction::INBOUND, session_id_, receive_time_, frame);
       }
       if (shared_.settings.test.fix_debug) {
-        auto message = buffer.subspan(0, bytes);
-        log::info<0>("[session_id={}]: {}"sv, session_id_, utils::debug::fix::Message{message});
+        log::info<0>("[session_id={}]: {}"sv, session_id_, utils::debug::fix::Message{frame});
+      }
+      total_bytes += std::size(frame);
+      fix::Reader<FIX_VERSION>::dispatch(frame, helper, logger);
+      if (logon) [[unlikely]] {
+        logon = false;
+        suspend(frame);
+        if (verification_ == Verification::PENDING) {
+          break;  // note! the remaining bytes are buffered until the logon has been verified
+        }
       }
-      assert(bytes <= std::size(buffer));
-      total_bytes += bytes;
-      buffer = buffer.subspan(bytes);
     }
-    buffer_.drain(total_bytes);
   } catch (SystemError &e) {
     log::error("Exception: {}"sv, e);
     close();
@@ -176,136 +202,115 @@ void Session::operator()(io::net::tcp::Connection::Read const &) {
     auto e = std::current_exception();
     log::fatal(R"(Unhandled exception: type="{}")"sv, typeid(e).name());
   }
+  if (status != tools::FrameScanner::Status::OK && total_bytes == bytes) [[unlikely]] {
+    // note! the content is not logged (it may include credentials)
+    log::error("Message could not be framed (session_id={}, status={}, length={})"sv, session_id_, status, std::size(data) - total_bytes);
+    close();
+  }
+  statistics_.bytes_received += total_bytes;
+  return total_bytes;
 }
 
-void Session::operator()(io::net::tcp::Connection::Disconnected const &) {
-  // xXX FIXME HANS
-}
-
-// outbound
-
-template <std::size_t level, typename T>
-void Session::send(Trace<T> const &event) {
-  auto sending_time = clock::get_realtime();
-  send<level>(event, sending_time);
-}
-
-template <std::size_t level, typename T>
-void Session::send(Trace<T> const &event, std::chrono::nanoseconds sending_time) {
-  auto &[trace_info, value] = event;
-  log::info<level>("send (=> client): {}={}"sv, nameof::nameof_short_type<T>(), value);
-  assert(!std::empty(comp_id_));
-  auto header = fix::Header{
-      .version = FIX_VERSION,
-      .msg_type = T::MSG_TYPE,
-      .sender_comp_id = shared_.settings.client.comp_id,
-      .target_comp_id = comp_id_,
-      .msg_seq_num = ++outbound_.msg_seq_num,  // note!
-      .sending_time = sending_time,
-  };
-  auto helper = [&](auto &buffer) {
-    auto message = value.encode(header, buffer);
-    return std::size(message);
+void Session::suspend(std::span<std::byte const> const &frame) {
+  logon_.frame.assign(std::begin(frame), std::end(frame));  // note! the decoded logon must outlive the input buffer
+  logon_.receive_time = receive_time_;
+  auto helper = [&](auto &message) {
+    logon_.header = message.header;
+    logon_.value = fix::codec::Logon::create(message);
   };
-  if ((*connection_).send(helper)) {
-  } else {
-    log::warn("HERE"sv);
+  auto logger = []([[maybe_unused]] auto &message) {};
+  fix::Reader<FIX_VERSION>::dispatch(std::span<std::byte const>{logon_.frame}, helper, logger);
+  auto &value = logon_.value;
+  if (shared_.verify(session_id_, value.username, value.password, value.raw_data)) {
+    verification_ = Verification::PENDING;
+    return;
   }
+  logon();  // note! not queued, the proxy manager will validate synchronously
 }
 
-// inbound
+void Session::logon() {
+  auto decode_start = clock::get_system();
+  TraceInfo trace_info;
+  trace_info.source_receive_time = logon_.receive_time;
+  check(logon_.header);
+  if (std::empty(comp_id_)) [[unlikely]] {
+    comp_id_ = logon_.header.sender_comp_id;
+  }
+  dispatch(trace_info, logon_.header, logon_.value, decode_start);
+}
 
 void Session::parse(Trace<fix::Message> const &event) {
   auto &[trace_info, message] = event;
+  auto decode_start = clock::get_system();
   if (std::empty(comp_id_)) [[unlikely]] {
     comp_id_ = message.header.sender_comp_id;
   }
-  switch (message.header.msg_type) {
-    using enum fix::MsgType;
-    case REJECT:
-      dispatch<fix::codec::Reject>(event);
-      break;
-    case LOGON:
-      dispatch<fix::codec::Logon>(event);
-      break;
-    case LOGOUT:
-      dispatch<fix::codec::Logout>(event);
-      break;
-    case HEARTBEAT:
-      dispatch<fix::codec::Heartbeat>(event);
-      break;
-    case TEST_REQUEST:
-      dispatch<fix::codec::TestRequest>(event);
-      break;
-    case RESEND_REQUEST:
-      dispatch<fix::codec::ResendRequest>(event);
-      break;
-    case BUSINESS_MESSAGE_REJECT:
-      dispatch<fix::codec::BusinessMessageReject>(event);
-      break;
-    case TRADING_SESSION_STATUS_REQUEST:
-      dispatch<fix::codec::TradingSessionStatusRequest>(event);
-      break;
-    case SECURITY_LIST_REQUEST:
-      dispatch<fix::codec::SecurityListRequest>(event);
-      break;
-    case SECURITY_DEFINITION_REQUEST:
-      dispatch<fix::codec::SecurityDefinitionRequest>(event, decode_buffer_);
-      break;
-    case SECURITY_STATUS_REQUEST:
-      dispatch<fix::codec::SecurityStatusRequest>(event, decode_buffer_);
-      break;
-    case MARKET_DATA_REQUEST:
-      dispatch<fix::codec::MarketDataRequest>(event, decode_buffer_);
-      break;
-    case NEW_ORDER_SINGLE:
-      dispatch<fix::codec::NewOrderSingle>(event, decode_buffer_);
-      break;
-    case ORDER_CANCEL_REPLACE_REQUEST:
-      dispatch<fix::codec::OrderCancelReplaceRequest>(event, decode_buffer_);
-      break;
-    case ORDER_CANCEL_REQUEST:
-      dispatch<fix::codec::OrderCancelRequest>(event, decode_buffer_);
-      break;
-    case ORDER_MASS_CANCEL_REQUEST:
-      dispatch<fix::codec::OrderMassCancelRequest>(event, decode_buffer_);
-      break;
-    case ORDER_STATUS_REQUEST:
-      dispatch<fix::codec::OrderStatusRequest>(event, decode_buffer_);
-      break;
-    case ORDER_MASS_STATUS_REQUEST:
-      dispatch<fix::codec::OrderMassStatusRequest>(event, decode_buffer_);
-      break;
-    case TRADE_CAPTURE_REPORT_REQUEST:
-      dispatch<fix::codec::TradeCaptureReportRequest>(event, decode_buffer_);
-      break;
-    case REQUEST_FOR_POSITIONS:
-      dispatch<fix::codec::RequestForPositions>(event, decode_buffer_);
-      break;
-    case MASS_QUOTE:
-      dispatch<fix::codec::MassQuote>(event, decode_buffer_, decode_buffer_2_);
-      break;
-    case QUOTE_CANCEL:
-      dispatch<fix::codec::QuoteCancel>(event, decode_buffer_);
-      break;
-    default:
-      log::warn("Unexpected: msg_type={}"sv, message.header.msg_type);
-      break;
-  };
+  if (!entitlements_(message.header.msg_type)) [[unlikely]] {
+    reject(trace_info, message.header);  // note! the body is never decoded
+    return;
+  }
+  auto helper = [&](auto &value) { dispatch(trace_info, message.header, value, decode_start); };
+  if (!Decoder::dispatch(message, shared_.decode_buffer, shared_.decode_buffer_2, helper)) [[unlikely]] {
+    log::warn("Unexpected: msg_type={}"sv, message.header.msg_type);
+  }
 }
 
-template <typename T, typename... Args>
-void Session::dispatch(Trace<fix::Message> const &event, Args &&...args) {
-  auto &[trace_info, message] = event;
-  auto value = T::create(message, std::forward<Args>(args)...);
+template <typename T>
+void Session::dispatch(
+    TraceInfo const &trace_info, fix::Header const &header, T const &value, std::chrono::nanoseconds decode_start, std::chrono::nanoseconds decode_end) {
   log::info<1>("session_id={}, {}={}"sv, session_id_, nameof::nameof_short_type<T>(), value);
-  create_trace_and_dispatch(shared_.proxy, trace_info, value, message.header, session_id_);
+  shared_.metrics.message(Metrics::Peer::CLIENT, Metrics::Direction::RECEIVED, T::MSG_TYPE);
+  ++statistics_.messages_received;
+  if constexpr (std::is_same_v<T, fix::codec::Logon>) {
+    auto iter = shared_.credentials.find(value.username);
+    credentials_ = iter != std::end(shared_.credentials) ? &(*iter).second : nullptr;  // note! not yet authenticated
+  } else if constexpr (OrderTracker::is_request<T>()) {
+    shared_.orders.prepare(strategy_id_);  // note! the proxy manager forwards the request synchronously
+  }
+  auto trace_info_2 = shared_.tracer.route(Tracer::Direction::UPSTREAM, T::MSG_TYPE, trace_info, decode_start, decode_end);
+  create_trace_and_dispatch(shared_.proxy, trace_info_2, value, header, session_id_);
+}
+
+void Session::logged_on() {
+  if (credentials_ == nullptr) [[unlikely]] {
+    log::warn("Unexpected: logon accepted without credentials, only session-level messages are allowed (session_id={})"sv, session_id_);
+    strategy_id_ = {};
+    entitlements_ = Entitlements<Messages::FromClient>::none();
+  } else {
+    strategy_id_ = (*credentials_).strategy_id;
+    entitlements_ = (*credentials_).entitlements;
+  }
+  if (shard_ != nullptr) {
+    (*shard_).entitle(link_id_, entitlements_);  // note! messages not entitled are no longer decoded by the shard
+  }
+}
+
+void Session::reject(TraceInfo const &trace_info, fix::Header const &header) {
+  auto now = clock::get_system();
+  if (reject_log_.next <= now) {
+    log::warn("Not entitled: session_id={}, msg_type={} (suppressed={})"sv, session_id_, header.msg_type, reject_log_.suppressed);
+    reject_log_.next = now + REJECT_LOG_INTERVAL;
+    reject_log_.suppressed = {};
+  } else {
+    ++reject_log_.suppressed;
+  }
+  shared_.metrics.event_loop().add(Metrics::Counter::CLIENT_NOT_ENTITLED);
+  ++statistics_.not_entitled;
+  auto business_message_reject = fix::codec::BusinessMessageReject{
+      .ref_seq_num = header.msg_seq_num,
+      .ref_msg_type = header.msg_type,
+      .business_reject_reason = fix::BusinessRejectReason::NOT_AUTHORIZED,
+      .text = "not entitled"sv,
+  };
+  send<2>(Trace{trace_info, business_message_reject});
 }
 
 void Session::check(fix::Header const &header) {
   auto current = header.msg_seq_num;
   auto expected = inbound_.msg_seq_num + 1;
   if (current != expected) [[unlikely]] {
+    shared_.metrics.event_loop().add(Metrics::Counter::CLIENT_SEQUENCE_GAPS);
+    ++statistics_.sequence_gaps;
     if (expected < current) {
       log::warn(
           "*** SEQUENCE GAP *** "
@@ -325,10 +330,29 @@ void Session::check(fix::Header const &header) {
   inbound_.msg_seq_num = current;
 }
 
+// outbound
+
+bool Session::send(std::span<std::byte const> const &message) {
+  auto helper = [&](auto &buffer) {
+    assert(std::size(message) <= std::size(buffer));
+    std::memcpy(std::data(buffer), std::data(message), std::size(message));
+    return std::size(message);
+  };
+  return (*connection_).send(helper);
+}
+
 // utils
 
 void Session::close() {
-  (*connection_).close();
+  if (closing_) {
+    return;
+  }
+  closing_ = true;
+  if (static_cast<bool>(connection_)) {
+    (*connection_).close();
+  } else {
+    (*shard_).close(link_id_);
+  }
 }
 
 }  // namespace client
@@ -2,10 +2,19 @@
 
 #pragma once
 
+#include <nameof.hpp>
+
+#include <cassert>
+#include <chrono>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
 #include "roq/trace.hpp"
 
 #include "roq/io/buffer.hpp"
@@ -14,49 +23,65 @@
 
 #include "roq/fix/proxy/manager.hpp"
 
+#include "roq/fix_proxy/entitlements.hpp"
+#include "roq/fix_proxy/messages.hpp"
 #include "roq/fix_proxy/shared.hpp"
 
+#include "roq/fix_proxy/client/decoder.hpp"
+#include "roq/fix_proxy/client/shard.hpp"
+
 namespace roq {
 namespace fix_proxy {
 namespace client {
 
 struct Session final : public io::net::tcp::Connection::Handler {
+  static constexpr auto FIX_VERSION = fix::Version::FIX_44;
+
+  // note! only accessed by the event loop thread
+  struct Statistics final {
+    uint64_t messages_received = {};
+    uint64_t messages_sent = {};
+    uint64_t bytes_received = {};
+    uint64_t bytes_sent = {};
+    uint64_t send_failures = {};
+    uint64_t sequence_gaps = {};
+    uint64_t not_entitled = {};
+  };
+
   Session(io::net::tcp::Connection::Factory &, uint64_t session_id, Shared &);
+  Session(Shard &, uint64_t link_id, uint64_t session_id, Shared &);  // note! connection is owned by a shard
 
   Session(Session const &) = delete;
 
+  void operator()(Shard::Decoded const &);
+
+  uint64_t session_id() const { return session_id_; }
+  std::string_view comp_id() const { return comp_id_; }
+
+  Statistics const &statistics() const { return statistics_; }
+
+  // note! excludes i/o buffers and the decode buffers shared by all sessions
+  size_t memory_usage() const;
+
   void force_disconnect();
 
+  // note! continue processing after asynchronous logon verification
+  void resume();
+
   // fix::proxy::Manager
 
   // - connection
   void operator()(Trace<fix::proxy::Manager::Disconnect> const &);
 
-  // - manager => client
-  void operator()(Trace<fix::codec::Reject> const &);
-  void operator()(Trace<fix::codec::Logon> const &);
-  void operator()(Trace<fix::codec::Logout> const &);
-  void operator()(Trace<fix::codec::Heartbeat> const &);
-  void operator()(Trace<fix::codec::TestRequest> const &);
-
-  // - server => client
-  void operator()(Trace<fix::codec::BusinessMessageReject> const &);
-  void operator()(Trace<fix::codec::TradingSessionStatus> const &);
-  void operator()(Trace<fix::codec::SecurityList> const &);
-  void operator()(Trace<fix::codec::SecurityDefinition> const &);
-  void operator()(Trace<fix::codec::SecurityStatus> const &);
-  void operator()(Trace<fix::codec::MarketDataRequestReject> const &);
-  void operator()(Trace<fix::codec::MarketDataSnapshotFullRefresh> const &);
-  void operator()(Trace<fix::codec::MarketDataIncrementalRefresh> const &);
-  void operator()(Trace<fix::codec::ExecutionReport> const &);
-  void operator()(Trace<fix::codec::OrderCancelReject> const &);
-  void operator()(Trace<fix::codec::OrderMassCancelReport> const &);
-  void operator()(Trace<fix::codec::TradeCaptureReportRequestAck> const &);
-  void operator()(Trace<fix::codec::TradeCaptureReport> const &);
-  void operator()(Trace<fix::codec::RequestForPositionsAck> const &);
-  void operator()(Trace<fix::codec::PositionReport> const &);
-  void operator()(Trace<fix::codec::MassQuoteAck> const &);
-  void operator()(Trace<fix::codec::QuoteStatusReport> const &);
+  // - messages (manager => client, server => client)
+  template <typename T>
+  requires(Messages::ToClient::contains<T>())
+  void operator()(Trace<T> const &event) {
+    if constexpr (std::is_same_v<T, fix::codec::Logon>) {
+      logged_on();  // note! the logon has been accepted
+    }
+    send<2>(event);
+  }
 
  protected:
   // io::net::tcp::Connection::Handler
@@ -69,18 +94,87 @@ struct Session final : public io::net::tcp::Connection::Handler {
   template <std::size_t level, typename T>
   void send_and_close(Trace<T> const &);
 
+  // note! defined here (instantiated by the controller)
   template <std::size_t level, typename T>
-  void send(Trace<T> const &);
+  void send(Trace<T> const &event) {
+    auto sending_time = clock::get_realtime();
+    send<level>(event, sending_time);
+  }
 
   template <std::size_t level, typename T>
-  void send(Trace<T> const &, std::chrono::nanoseconds sending_time);
+  void send(Trace<T> const &event, std::chrono::nanoseconds sending_time) {
+    using namespace std::literals;
+    if (closing_) [[unlikely]] {
+      return;  // note! the connection is being closed
+    }
+    auto &[trace_info, value] = event;
+    log::info<level>("send (=> client): {}={}"sv, nameof::nameof_short_type<T>(), value);
+    assert(!std::empty(comp_id_));
+    auto encode_start = clock::get_system();
+    std::chrono::nanoseconds encode_end = {};
+    auto header = fix::Header{
+        .version = FIX_VERSION,
+        .msg_type = T::MSG_TYPE,
+        .sender_comp_id = shared_.settings.client.comp_id,
+        .target_comp_id = comp_id_,
+        .msg_seq_num = ++outbound_.msg_seq_num,  // note!
+        .sending_time = sending_time,
+    };
+    size_t length = {};
+    auto journal = shared_.journal.event_loop();
+    auto journaled = false;
+    auto helper = [&](auto &buffer) {
+      auto message = value.encode(header, buffer);
+      encode_end = clock::get_system();
+      length = std::size(message);
+      if (journal != nullptr) [[unlikely]] {
+        journaled = (*journal).prepare(Journal::Peer::CLIENT, Journal::Direction::OUTBOUND, session_id_, encode_end, message);
+      }
+      return length;
+    };
+    auto success = static_cast<bool>(connection_) ? send(shared_.encode_buffer.encode(helper)) : (*shard_).send(link_id_, helper);
+    auto &metrics = shared_.metrics;
+    if (success) {
+      if (journaled) [[unlikely]] {
+        (*journal).commit();  // note! only messages which have been sent
+      }
+      shared_.tracer.send(Tracer::Direction::DOWNSTREAM, T::MSG_TYPE, trace_info, encode_start, encode_end);
+      metrics.message(Metrics::Peer::CLIENT, Metrics::Direction::SENT, T::MSG_TYPE);
+      if (static_cast<bool>(connection_)) {
+        metrics.event_loop().add(Metrics::Counter::CLIENT_BYTES_SENT, length);  // note! otherwise counted by the shard
+      }
+      ++statistics_.messages_sent;
+      statistics_.bytes_sent += length;
+    } else {
+      // note! the sequence number has been consumed, the client would see a gap
+      metrics.event_loop().add(Metrics::Counter::CLIENT_SEND_FAILURES);
+      ++statistics_.send_failures;
+      log::warn("Unable to send, closing connection (session_id={}, msg_type={})"sv, session_id_, T::MSG_TYPE);
+      close();
+    }
+  }
+
+  bool send(std::span<std::byte const> const &message);  // note! already encoded
 
   // inbound
 
+  void process();
+
+  size_t process(std::span<std::byte const> const &);
+
+  void suspend(std::span<std::byte const> const &frame);
+
+  void logon();
+
+  void logged_on();
+
   void parse(Trace<fix::Message> const &);
 
-  template <typename T, typename... Args>
-  void dispatch(Trace<fix::Message> const &, Args &&...);
+  void reject(TraceInfo const &, fix::Header const &);
+
+  // note! decode_end is zero when decoded by the event loop thread
+  template <typename T>
+  void dispatch(TraceInfo const &, fix::Header const &, T const &, std::chrono::nanoseconds decode_start, std::chrono::nanoseconds decode_end = {});
 
   void check(fix::Header const &);
 
@@ -90,6 +184,8 @@ struct Session final : public io::net::tcp::Connection::Handler {
 
  private:
   std::unique_ptr<io::net::tcp::Connection> const connection_;
+  Shard *const shard_ = {};
+  uint64_t const link_id_ = {};
   uint64_t const session_id_;
   Shared &shared_;
   // messaging
@@ -100,9 +196,29 @@ struct Session final : public io::net::tcp::Connection::Handler {
     uint64_t msg_seq_num = {};
   } inbound_;
   std::string comp_id_;
+  Shared::Credentials const *credentials_ = {};  // note! from the logon request (nullptr if the username is unknown)
+  // note! from the credentials, applied when the logon has been accepted
+  uint32_t strategy_id_ = {};
+  Entitlements<Messages::FromClient> entitlements_ = Entitlements<Messages::FromClient>::none();
+  enum class Verification {
+    UNDEFINED,
+    PENDING,
+  } verification_ = {};
+  // note! only used with asynchronous verification: the logon is decoded once and dispatched when verified
+  struct {
+    std::vector<std::byte> frame;
+    fix::Header header = {};
+    fix::codec::Logon value;
+    std::chrono::nanoseconds receive_time = {};
+  } logon_;
   io::Buffer buffer_;
-  std::vector<std::byte> decode_buffer_;
-  std::vector<std::byte> decode_buffer_2_;
+  std::chrono::nanoseconds receive_time_ = {};  // note! when the bytes being processed were read
+  struct {
+    std::chrono::nanoseconds next = {};
+    uint64_t suppressed = {};
+  } reject_log_;  // note! rate limited
+  bool closing_ = {};
+  Statistics statistics_;
 };
 
 }  // namespace client
@@ -0,0 +1,985 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/client/shard.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include <magic_enum/magic_enum_format.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+#include "roq/fix/reader.hpp"
+
+#include "roq/fix_proxy/tools/rx_timestamp.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace client {
+
+// === CONSTANTS ===
+
+namespace {
+auto const FIX_VERSION = fix::Version::FIX_44;
+
+size_t const INITIAL_BUFFER_SIZE = 4096;          // note! grows on demand (kept small to support many concurrent connections)
+size_t const MAX_BUFFER_SIZE = 16 * 1024 * 1024;  // note! inbound (largest message) and outbound (slow consumers are disconnected)
+
+auto const IDLE_TIMEOUT = 100ms;  // note! only used when not busy polling (the shard is woken up by the event loop thread)
+
+auto const ENCODE_BUFFER_QUIET_PERIOD = 60s;
+
+uint32_t const IO_URING_ENTRIES = 1024;       // note! submitted early if an iteration prepares more requests
+uint32_t const IO_URING_BUFFER_COUNT = 1024;  // note! released as soon as the bytes have been copied
+uint32_t const IO_URING_BUFFER_SIZE = 4096;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+// note! "path" (unix domain socket), "port" (any interface) or "host:port"
+auto create_socket_address(std::string_view const &listen_address, struct sockaddr_storage &result) -> socklen_t {
+  auto address = listen_address;
+  if (address.starts_with("unix://"sv)) {
+    address.remove_prefix(7);
+  } else if (address.starts_with("tcp://"sv)) {
+    address.remove_prefix(6);
+  }
+  auto is_port = [](auto &value) { return !std::empty(value) && std::ranges::all_of(value, [](auto c) { return c >= '0' && c <= '9'; }); };
+  auto pos = address.rfind(':');
+  auto host = pos != address.npos ? address.substr(0, pos) : std::string_view{};
+  auto port = pos != address.npos ? address.substr(pos + 1) : address;
+  if (!is_port(port)) {
+    struct sockaddr_un sockaddr = {};
+    sockaddr.sun_family = AF_UNIX;
+    if (std::size(address) >= sizeof(sockaddr.sun_path)) {
+      log::fatal(R"(Unexpected: listen_address="{}" (path is too long))"sv, listen_address);
+    }
+    std::memcpy(sockaddr.sun_path, std::data(address), std::size(address));
+    std::memcpy(&result, &sockaddr, sizeof(sockaddr));
+    return sizeof(sockaddr);
+  }
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  struct addrinfo *info = nullptr;
+  auto node = std::string{host};
+  auto service = std::string{port};
+  auto error = ::getaddrinfo(std::empty(node) ? nullptr : node.c_str(), service.c_str(), &hints, &info);
+  if (error != 0 || info == nullptr) {
+    log::fatal(R"(Unexpected: listen_address="{}" (error={}))"sv, listen_address, ::gai_strerror(error));
+  }
+  auto length = (*info).ai_addrlen;
+  std::memcpy(&result, (*info).ai_addr, length);
+  ::freeaddrinfo(info);
+  return length;
+}
+
+int create_listener(auto &listen_address, auto &sockaddr, auto length, bool reuse_port) {
+  auto result = ::socket(sockaddr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (result < 0) {
+    log::fatal(R"(Unexpected: listen_address="{}" (error={}))"sv, listen_address, std::strerror(errno));
+  }
+  if (sockaddr.ss_family == AF_UNIX) {
+    ::unlink(reinterpret_cast<struct sockaddr_un const &>(sockaddr).sun_path);  // note! stale socket from a previous run
+  } else {
+    int flag = 1;
+    ::setsockopt(result, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+    if (reuse_port) {
+      ::setsockopt(result, SOL_SOCKET, SO_REUSEPORT, &flag, sizeof(flag));
+    }
+  }
+  if (::bind(result, reinterpret_cast<struct sockaddr const *>(&sockaddr), length) < 0 || ::listen(result, SOMAXCONN) < 0) {
+    log::fatal(R"(Unexpected: unable to listen on "{}" (error={}))"sv, listen_address, std::strerror(errno));
+  }
+  return result;
+}
+
+auto to_string(struct sockaddr_storage const &sockaddr) -> std::string {
+  char buffer[INET6_ADDRSTRLEN] = {};
+  switch (sockaddr.ss_family) {
+    case AF_INET: {
+      auto &value = reinterpret_cast<struct sockaddr_in const &>(sockaddr);
+      ::inet_ntop(AF_INET, &value.sin_addr, buffer, sizeof(buffer));
+      return fmt::format("{}:{}"sv, buffer, ntohs(value.sin_port));
+    }
+    case AF_INET6: {
+      auto &value = reinterpret_cast<struct sockaddr_in6 const &>(sockaddr);
+      ::inet_ntop(AF_INET6, &value.sin6_addr, buffer, sizeof(buffer));
+      return fmt::format("[{}]:{}"sv, buffer, ntohs(value.sin6_port));
+    }
+    default:
+      return "unix"s;
+  }
+}
+
+template <typename R>
+auto create_slots(auto &settings) {
+  using result_type = std::remove_cvref_t<R>;
+  if (settings.client.io_pipeline_depth == 0) {
+    log::fatal("Unexpected: client_io_pipeline_depth must be positive when client_io_threads is used"sv);
+  }
+  result_type result(settings.client.io_pipeline_depth);
+  for (auto &item : result) {
+    item.decode_buffer.resize(settings.client.decode_buffer_size);
+    item.decode_buffer_2.resize(settings.client.decode_buffer_size);
+  }
+  return result;
+}
+
+auto create_io_uring(auto &settings) -> std::unique_ptr<tools::IoUring> {
+  if (!settings.client.io_uring) {
+    return {};
+  }
+  if (settings.client.io_kernel_timestamps) {
+    log::fatal("Unexpected: client_io_kernel_timestamps is not supported with client_io_uring"sv);
+  }
+  return std::make_unique<tools::IoUring>(IO_URING_ENTRIES, IO_URING_BUFFER_COUNT, IO_URING_BUFFER_SIZE);
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+std::vector<int> Shard::create_listeners(std::string_view const &listen_address, uint32_t count) {
+  struct sockaddr_storage sockaddr = {};
+  auto length = create_socket_address(listen_address, sockaddr);
+  std::vector<int> result;
+  if (sockaddr.ss_family == AF_UNIX) {
+    // note! unix domain sockets don't support SO_REUSEPORT, all shards accept from the same socket
+    result.emplace_back(create_listener(listen_address, sockaddr, length, false));
+    for (uint32_t i = 1; i < count; ++i) {
+      result.emplace_back(::fcntl(result[0], F_DUPFD_CLOEXEC, 0));
+    }
+  } else {
+    // note! the kernel distributes new connections across the shards
+    for (uint32_t i = 0; i < count; ++i) {
+      result.emplace_back(create_listener(listen_address, sockaddr, length, true));
+    }
+  }
+  log::info(R"(Listening on "{}" (shards={}))"sv, listen_address, count);
+  return result;
+}
+
+Shard::Shard(Settings const &settings, uint32_t index, uint32_t count, int listener, bool verify, Metrics::Slot &metrics, tools::Wakeup &event_loop)
+    : index_{index}, count_{count}, listener_{listener}, verify_{verify}, busy_poll_{settings.loop.busy_poll},
+      socket_busy_poll_{static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(settings.loop.socket_busy_poll).count())},
+      kernel_timestamps_{settings.client.io_kernel_timestamps},
+      encode_buffer_size_{settings.client.encode_buffer_size}, frame_scanner_{true}, metrics_{metrics}, event_loop_{event_loop},
+      slots_{create_slots<decltype(slots_)>(settings)}, free_{std::size(slots_)}, ready_{std::size(slots_)}, outbound_{4 * encode_buffer_size_},
+      encode_buffer_{encode_buffer_size_, ENCODE_BUFFER_QUIET_PERIOD}, notifier_{wakeup_, metrics_}, io_uring_{create_io_uring(settings)} {
+  for (uint32_t i = 0; i < std::size(slots_); ++i) {
+    [[maybe_unused]] auto success = free_.try_push(i);
+    assert(success);
+  }
+  if (io_uring_) {
+    thread_ = std::thread{[this]() { run_io_uring(); }};
+    return;
+  }
+  poller_.add(listener_, *this);
+  poller_.add(wakeup_.fd(), notifier_);
+  thread_ = std::thread{[this]() { run(); }};
+}
+
+Shard::~Shard() {
+  stop_.store(true, std::memory_order_release);
+  wakeup_.signal();
+  thread_.join();
+  links_.clear();
+  ::close(listener_);
+}
+
+size_t Shard::poll(Handler &handler) {
+  size_t result = 0;
+  auto helper = [&](auto index) {
+    auto &slot = slots_[index];
+    switch (slot.type) {
+      using enum Slot::Type;
+      case CONNECTED: {
+        auto connected = Connected{
+            .shard = *this,
+            .link_id = slot.link_id,
+        };
+        handler(connected);
+        break;
+      }
+      case DECODED: {
+        auto decoded = Decoded{
+            .link_id = slot.link_id,
+            .trace_info = slot.trace_info,
+            .header = slot.header,
+            .raw = slot.raw,
+            .value = slot.value,
+            .decode_start = slot.decode_start,
+            .decode_end = slot.decode_end,
+        };
+        handler(decoded);
+        break;
+      }
+      case DISCONNECTED: {
+        auto disconnected = Disconnected{
+            .link_id = slot.link_id,
+        };
+        handler(disconnected);
+        break;
+      }
+    }
+    [[maybe_unused]] auto success = free_.try_push(index);  // note! can't fail (same capacity)
+    assert(success);
+    ++result;
+  };
+  while (ready_.try_pop(helper)) {
+  }
+  if (!std::empty(retry_)) [[unlikely]] {
+    size_t count = 0;
+    for (auto &command : retry_) {
+      if (!try_write(command)) {
+        break;
+      }
+      ++count;
+    }
+    retry_.erase(std::begin(retry_), std::begin(retry_) + count);
+  }
+  return result;
+}
+
+void Shard::close(uint64_t link_id) {
+  auto command = Command{
+      .header{
+          .link_id = link_id,
+          .type = Type::CLOSE,
+      },
+  };
+  write(command);
+}
+
+void Shard::resume(uint64_t link_id) {
+  auto command = Command{
+      .header{
+          .link_id = link_id,
+          .type = Type::RESUME,
+      },
+  };
+  write(command);
+}
+
+void Shard::entitle(uint64_t link_id, Entitlements<Messages::FromClient> const &entitlements) {
+  auto command = Command{
+      .header{
+          .link_id = link_id,
+          .type = Type::ENTITLEMENTS,
+      },
+      .entitlements = entitlements,
+  };
+  write(command);
+}
+
+// tools::Poller::Handler
+
+void Shard::operator()(uint32_t) {
+  accept();
+}
+
+// utilities
+
+void Shard::write(Command const &command) {
+  if (std::empty(retry_) && try_write(command)) [[likely]] {
+    return;
+  }
+  retry_.emplace_back(command);  // note! commands are forwarded in order
+}
+
+bool Shard::try_write(Command const &command) {
+  auto &[header, entitlements] = command;
+  auto length = sizeof(header) + (header.type == Type::ENTITLEMENTS ? sizeof(entitlements) : 0);
+  auto success = outbound_.write(length, [&](auto data) {
+    std::memcpy(std::data(data), &header, sizeof(header));
+    if (header.type == Type::ENTITLEMENTS) {
+      std::memcpy(std::data(data) + sizeof(header), &entitlements, sizeof(entitlements));
+    }
+  });
+  if (success) {
+    wakeup_.notify();
+  }
+  return success;
+}
+
+// note! shard thread
+
+void Shard::run() {
+  log::info("Shard #{} is now running (busy_poll={})"sv, index_, busy_poll_);
+  auto helper = [&](auto &buffer) {
+    Header header;
+    std::memcpy(&header, std::data(buffer), sizeof(header));
+    process(header, buffer.subspan(sizeof(header)));
+  };
+  while (!stop_.load(std::memory_order_acquire)) {
+    auto timeout = 0ms;
+    if (!busy_poll_ && std::empty(pending_)) {
+      wakeup_.prepare();
+      if (outbound_.size() == 0) {
+        timeout = IDLE_TIMEOUT;  // note! woken up by the event loop thread
+      }
+    }
+    metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+    poller_.dispatch(timeout);
+    wakeup_.cancel();
+    while (outbound_.read(helper)) {
+    }
+    flush();
+    for (auto link_id : zombies_) {
+      links_.erase(to_key(link_id));
+    }
+    zombies_.clear();
+    if (committed_) {
+      committed_ = false;
+      event_loop_.notify();
+    }
+  }
+  log::info("Shard #{} has terminated"sv, index_);
+}
+
+// note! same as run() except requests are prepared and then submitted (and completions awaited) by a single system call
+void Shard::run_io_uring() {
+  log::info("Shard #{} is now running (busy_poll={}, io_uring=true)"sv, index_, busy_poll_);
+  auto &io_uring = *io_uring_;
+  auto helper = [&](auto &buffer) {
+    Header header;
+    std::memcpy(&header, std::data(buffer), sizeof(header));
+    process(header, buffer.subspan(sizeof(header)));
+  };
+  io_uring.accept(listener_, to_user_data(0, Request::ACCEPT));
+  io_uring.read(wakeup_.fd(), std::as_writable_bytes(std::span{&wakeup_counter_, 1}), to_user_data(0, Request::WAKEUP));
+  while (!stop_.load(std::memory_order_acquire)) {
+    auto timeout = 0ms;
+    if (!busy_poll_ && std::empty(pending_)) {
+      wakeup_.prepare();
+      if (outbound_.size() == 0) {
+        timeout = IDLE_TIMEOUT;  // note! woken up by the event loop thread
+      }
+    }
+    io_uring.enter(timeout);
+    wakeup_.cancel();
+    io_uring.dispatch([&](auto &completion) { dispatch(completion); });
+    while (outbound_.read(helper)) {
+    }
+    flush();
+    for (auto link_id : writers_) {
+      auto link = find(link_id);
+      if (link != nullptr) {
+        (*link).update();
+      }
+    }
+    writers_.clear();
+    // note! a link can only be destroyed once the kernel no longer references its buffers
+    std::erase_if(zombies_, [&](auto link_id) {
+      auto link = find(link_id);
+      if (link != nullptr && (*link).requests() > 0) {
+        return false;
+      }
+      links_.erase(to_key(link_id));
+      return true;
+    });
+    metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS, io_uring.system_calls() - system_calls_);
+    system_calls_ = io_uring.system_calls();
+    if (committed_) {
+      committed_ = false;
+      event_loop_.notify();
+    }
+  }
+  // note! requests are not cancelled when the thread exits, the kernel could otherwise still reference the listener and the links
+  size_t requests = 2;  // note! accept and wakeup
+  links_.for_each([&](auto &link) { requests += link.requests(); });
+  io_uring.cancel_all(to_user_data(0, Request::CANCEL));
+  while (requests > 0) {
+    io_uring.enter(IDLE_TIMEOUT);
+    io_uring.dispatch([&](auto &completion) {
+      if (completion.has_buffer()) {
+        io_uring.release(completion.buffer_id());
+      }
+      auto request = from_user_data(completion.user_data).second;
+      if (request == Request::ACCEPT && completion.result >= 0) {
+        ::close(completion.result);
+      }
+      if (request != Request::CANCEL && !completion.more()) {
+        --requests;
+      }
+    });
+  }
+  log::info("Shard #{} has terminated"sv, index_);
+}
+
+void Shard::accept() {
+  while (true) {
+    struct sockaddr_storage sockaddr = {};
+    socklen_t length = sizeof(sockaddr);
+    metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+    auto fd = ::accept4(listener_, reinterpret_cast<struct sockaddr *>(&sockaddr), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        log::warn("Unable to accept (shard={}, error={})"sv, index_, std::strerror(errno));
+      }
+      return;  // note! also when another shard accepted the connection (shared unix domain socket)
+    }
+    connected(fd, sockaddr);
+  }
+}
+
+void Shard::connected(int fd, struct sockaddr_storage const &sockaddr) {
+  if (sockaddr.ss_family != AF_UNIX) {
+    int flag = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    if (socket_busy_poll_ > 0 && ::setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &socket_busy_poll_, sizeof(socket_busy_poll_)) < 0) [[unlikely]] {
+      log::warn("Unable to enable SO_BUSY_POLL (shard={}, error={})"sv, index_, std::strerror(errno));  // note! EPERM requires CAP_NET_ADMIN
+    }
+  }
+  if (kernel_timestamps_ && !tools::RxTimestamp::enable(fd)) [[unlikely]] {
+    log::warn("Unable to enable kernel timestamps (shard={}, error={})"sv, index_, std::strerror(errno));  // note! falls back to the read time
+  }
+  log::info("Connected (shard={}, peer={})"sv, index_, to_string(sockaddr));
+  auto &link = links_.emplace([&](auto key) { return Link{*this, fd, to_link_id(key)}; });
+  if (!link.process()) {
+    link.defer();
+  }
+}
+
+void Shard::process(Header const &header, std::span<std::byte const> const &payload) {
+  auto link = find(header.link_id);
+  if (link == nullptr) {
+    return;  // note! already disconnected
+  }
+  switch (header.type) {
+    using enum Type;
+    case SEND:
+      (*link).send(payload);
+      break;
+    case CLOSE:
+      (*link).close();
+      break;
+    case RESUME:
+      (*link).resume();
+      break;
+    case ENTITLEMENTS: {
+      Entitlements<Messages::FromClient> entitlements;
+      static_assert(std::is_trivially_copyable_v<decltype(entitlements)>);
+      assert(std::size(payload) == sizeof(entitlements));
+      std::memcpy(&entitlements, std::data(payload), sizeof(entitlements));
+      (*link).entitle(entitlements);
+      break;
+    }
+  }
+}
+
+void Shard::flush() {
+  if (std::empty(pending_)) [[likely]] {
+    return;
+  }
+  auto pending = std::move(pending_);  // note! links may defer again
+  pending_.clear();
+  for (auto link_id : pending) {
+    auto link = find(link_id);
+    if (link != nullptr) {
+      (*link).retry();
+    }
+  }
+}
+
+bool Shard::decode(
+    Slot &slot,
+    std::span<std::byte const> const &frame,
+    uint64_t link_id,
+    Entitlements<Messages::FromClient> const &entitlements,
+    std::chrono::nanoseconds receive_time) {
+  auto decode_start = clock::get_system();
+  slot.raw.assign(std::begin(frame), std::end(frame));  // note! capacity is retained
+  slot.type = Slot::Type::DECODED;
+  slot.link_id = link_id;
+  slot.trace_info = {};
+  slot.trace_info.source_receive_time = receive_time;
+  slot.value = {};
+  auto result = false;
+  auto parser = [&](auto &message) {
+    slot.header = message.header;
+    if (verify_ && message.header.msg_type == fix::MsgType::LOGON) [[unlikely]] {
+      result = true;  // note! decoded by the session (it must outlive the slot)
+      return;
+    }
+    if (!entitlements(message.header.msg_type)) [[unlikely]] {
+      return;  // note! the body is never decoded, the session rejects the message
+    }
+    // note! monostate if the msg_type is not supported
+    Decoder::dispatch(message, slot.decode_buffer, slot.decode_buffer_2, [&](auto &value) { slot.value = value; });
+  };
+  auto logger = []([[maybe_unused]] auto &message) {};
+  fix::Reader<FIX_VERSION>::dispatch(std::span<std::byte const>{slot.raw}, parser, logger);
+  slot.decode_start = decode_start;
+  slot.decode_end = clock::get_system();
+  return result;
+}
+
+Shard::Slot *Shard::acquire() {
+  if (slot_ == nullptr) {
+    free_.try_pop([&](auto index) {
+      slot_index_ = index;
+      slot_ = &slots_[index];
+    });
+  }
+  return slot_;
+}
+
+void Shard::commit() {
+  assert(slot_ != nullptr);
+  [[maybe_unused]] auto success = ready_.try_push(slot_index_);  // note! can't fail (same capacity)
+  assert(success);
+  slot_ = nullptr;
+  committed_ = true;
+}
+
+void Shard::dispatch(tools::IoUring::Completion const &completion) {
+  auto [key, request] = from_user_data(completion.user_data);
+  switch (request) {
+    using enum Request;
+    case ACCEPT: {
+      if (completion.result >= 0) {
+        struct sockaddr_storage sockaddr = {};
+        socklen_t length = sizeof(sockaddr);
+        metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+        ::getpeername(completion.result, reinterpret_cast<struct sockaddr *>(&sockaddr), &length);
+        connected(completion.result, sockaddr);
+      } else if (completion.result != -EAGAIN && completion.result != -EINTR) {
+        log::warn("Unable to accept (shard={}, error={})"sv, index_, std::strerror(-completion.result));
+      }
+      if (!completion.more()) {
+        (*io_uring_).accept(listener_, completion.user_data);  // note! terminated, e.g. when the completion queue overflowed
+      }
+      break;
+    }
+    case WAKEUP:
+      (*io_uring_).read(wakeup_.fd(), std::as_writable_bytes(std::span{&wakeup_counter_, 1}), completion.user_data);  // note! replaces clear()
+      break;
+    case RECEIVE:
+    case SEND: {
+      auto link = links_.find(key);
+      if (link == nullptr) [[unlikely]] {
+        log::fatal("Unexpected: link not found (user_data={:#x})"sv, completion.user_data);  // note! links are only destroyed when idle
+      }
+      if (request == RECEIVE) {
+        (*link).received(completion);
+      } else {
+        (*link).sent(completion);
+      }
+      break;
+    }
+    case CANCEL:
+      break;  // note! the cancelled request also completes
+  }
+}
+
+Shard::Link *Shard::find(uint64_t link_id) {
+  if ((Links::get_index(link_id) % count_) != index_) [[unlikely]] {
+    return nullptr;
+  }
+  return links_.find(to_key(link_id));
+}
+
+// link
+
+Shard::Link::Link(Shard &shard, int fd, uint64_t link_id) : shard_{shard}, fd_{fd}, link_id_{link_id}, inbound_(INITIAL_BUFFER_SIZE) {
+  if (shard_.io_uring_) {
+    (*shard_.io_uring_).receive(fd_, to_user_data(Request::RECEIVE));
+    ++requests_;
+    return;
+  }
+  shard_.poller_.add(fd_, *this);
+}
+
+Shard::Link::~Link() {
+  if (state_ == State::READY && !shard_.io_uring_) {
+    shard_.poller_.remove(fd_);
+  }
+  ::close(fd_);
+}
+
+bool Shard::Link::process() {
+  if (!announced_) {
+    auto slot = shard_.acquire();
+    if (slot == nullptr) {
+      return false;
+    }
+    (*slot).type = Slot::Type::CONNECTED;
+    (*slot).link_id = link_id_;
+    shard_.commit();
+    announced_ = true;
+  }
+  auto &frames = shard_.frames_;
+  frames.clear();
+  auto buffer = std::span<std::byte const>{inbound_}.subspan(0, length_);
+  auto [bytes, status] = paused_ ? tools::FrameScanner::Result{} : shard_.frame_scanner_.scan(buffer, frames);
+  size_t total_bytes = 0;
+  auto result = true;
+  try {
+    for (auto &frame : frames) {
+      auto slot = shard_.acquire();
+      if (slot == nullptr) [[unlikely]] {
+        result = false;  // note! retried once the event loop thread has released a slot
+        break;
+      }
+      auto logon = shard_.decode(*slot, frame, link_id_, entitlements_, receive_time_);
+      shard_.commit();
+      total_bytes += std::size(frame);
+      if (logon) [[unlikely]] {
+        paused_ = true;
+        break;
+      }
+    }
+  } catch (std::exception &e) {
+    // note! the content is not logged (it may include credentials)
+    log::error(R"(Message could not be parsed (link_id={}, length={}, what="{}"))"sv, link_id_, std::size(buffer) - total_bytes, e.what());
+    total_bytes = length_;
+    if (state_ == State::READY) {
+      disconnect();
+    }
+  }
+  if (result && !paused_ && status != tools::FrameScanner::Status::OK && total_bytes == bytes) [[unlikely]] {
+    log::error("Message could not be framed (link_id={}, status={}, length={})"sv, link_id_, status, std::size(buffer) - total_bytes);
+    total_bytes = length_;
+    if (state_ == State::READY) {
+      disconnect();
+    }
+  }
+  if (total_bytes > 0) {
+    std::memmove(std::data(inbound_), std::data(inbound_) + total_bytes, length_ - total_bytes);
+    length_ -= total_bytes;
+  }
+  if (!result) {
+    return false;
+  }
+  if (state_ == State::DISCONNECTING && (paused_ || total_bytes >= bytes)) {
+    auto slot = shard_.acquire();
+    if (slot == nullptr) {
+      return false;
+    }
+    (*slot).type = Slot::Type::DISCONNECTED;
+    (*slot).link_id = link_id_;
+    shard_.commit();
+    state_ = State::ZOMBIE;
+    shard_.zombies_.emplace_back(link_id_);
+  }
+  return true;
+}
+
+void Shard::Link::send(std::span<std::byte const> const &message) {
+  if (state_ != State::READY) {
+    return;
+  }
+  if (!std::empty(outbound_) || shard_.io_uring_) {
+    auto pending = std::size(outbound_) + std::size(sending_);
+    if ((pending + std::size(message)) > MAX_BUFFER_SIZE) [[unlikely]] {
+      shard_.metrics_.add(Metrics::Counter::CLIENT_SEND_FAILURES);
+      log::warn("Slow consumer, closing connection (link_id={}, pending={})"sv, link_id_, pending);
+      close();
+      return;
+    }
+    if (std::empty(outbound_) && !writing_) {
+      shard_.writers_.emplace_back(link_id_);
+    }
+    outbound_.insert(std::end(outbound_), std::begin(message), std::end(message));
+    return;  // note! sent when the socket becomes writable (io_uring: once the iteration has drained the ring buffer)
+  }
+  shard_.metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+  auto result = ::send(fd_, std::data(message), std::size(message), MSG_NOSIGNAL);
+  if (result < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      shard_.metrics_.add(Metrics::Counter::CLIENT_SEND_FAILURES);
+      log::warn("Unable to send (link_id={}, error={})"sv, link_id_, std::strerror(errno));
+      disconnect();
+      return;
+    }
+    result = 0;
+  }
+  shard_.metrics_.add(Metrics::Counter::CLIENT_BYTES_SENT, result);
+  if (static_cast<size_t>(result) < std::size(message)) {
+    outbound_.insert(std::end(outbound_), std::begin(message) + result, std::end(message));
+    update();
+  }
+}
+
+// note! bytes not yet accepted by the socket are discarded
+void Shard::Link::close() {
+  if (state_ != State::READY) {
+    return;
+  }
+  length_ = {};  // note! inbound messages are discarded
+  disconnect();
+  if (!process()) {
+    defer();
+  }
+}
+
+void Shard::Link::entitle(Entitlements<Messages::FromClient> const &entitlements) {
+  entitlements_ = entitlements;
+}
+
+void Shard::Link::resume() {
+  if (!paused_) {
+    return;
+  }
+  paused_ = false;
+  if (!process()) {
+    defer();
+  }
+  update();
+}
+
+void Shard::Link::retry() {
+  deferred_ = false;
+  if (!process()) {
+    defer();
+  }
+  update();
+}
+
+// tools::Poller::Handler
+
+void Shard::Link::operator()(uint32_t events) {
+  if ((events & EPOLLOUT) != 0 && !flush()) {
+    disconnect();
+  }
+  if (state_ != State::READY) {
+    return;
+  }
+  if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0 && !deferred_) {
+    if (!fill()) {
+      disconnect();  // note! remaining messages are forwarded first
+    }
+    if (!process()) {
+      defer();
+    }
+  }
+}
+
+// note! returns false if the connection was closed
+bool Shard::Link::fill() {
+  auto empty = length_ == 0;
+  if (empty) {
+    receive_time_ = clock::get_system();
+  }
+  while (true) {
+    if (length_ == std::size(inbound_)) {
+      if (std::size(inbound_) >= MAX_BUFFER_SIZE) [[unlikely]] {
+        if (paused_) {
+          return true;  // note! read interest has been dropped
+        }
+        log::warn("Message is too large (link_id={}, size={})"sv, link_id_, length_);
+        return false;
+      }
+      inbound_.resize(2 * std::size(inbound_));
+    }
+    auto buffer = std::span{inbound_}.subspan(length_);
+    auto receive_time = std::chrono::nanoseconds{};
+    shard_.metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+    auto result = shard_.kernel_timestamps_ ? tools::RxTimestamp::receive(fd_, buffer, receive_time) : ::recv(fd_, std::data(buffer), std::size(buffer), 0);
+    if (result > 0) {
+      shard_.metrics_.add(Metrics::Counter::CLIENT_BYTES_RECEIVED, result);
+      length_ += result;
+      if (empty && receive_time.count() != 0) {
+        receive_time_ = receive_time + (clock::get_system() - clock::get_realtime());  // note! realtime to system clock
+        empty = false;
+      }
+      if (static_cast<size_t>(result) < std::size(buffer)) {
+        return true;  // note! socket has been drained
+      }
+      continue;
+    }
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    }
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    log::info("Disconnected (link_id={})"sv, link_id_);
+    return false;  // note! closed by peer or error
+  }
+}
+
+// note! returns false if the connection should be closed
+bool Shard::Link::flush() {
+  if (std::empty(outbound_)) {
+    return true;
+  }
+  shard_.metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+  auto result = ::send(fd_, std::data(outbound_), std::size(outbound_), MSG_NOSIGNAL);
+  if (result < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return true;
+    }
+    shard_.metrics_.add(Metrics::Counter::CLIENT_SEND_FAILURES);
+    log::warn("Unable to send (link_id={}, error={})"sv, link_id_, std::strerror(errno));
+    return false;
+  }
+  shard_.metrics_.add(Metrics::Counter::CLIENT_BYTES_SENT, result);
+  outbound_.erase(std::begin(outbound_), std::begin(outbound_) + result);
+  update();
+  return true;
+}
+
+void Shard::Link::disconnect() {
+  if (state_ != State::READY) {
+    return;
+  }
+  state_ = State::DISCONNECTING;
+  if (shard_.io_uring_) {
+    if (reading_ && !cancelling_) {
+      (*shard_.io_uring_).cancel(to_user_data(Request::RECEIVE), to_user_data(Request::CANCEL));
+      cancelling_ = true;
+    }
+  } else {
+    shard_.poller_.remove(fd_);
+  }
+  ::shutdown(fd_, SHUT_RDWR);
+  outbound_.clear();
+}
+
+void Shard::Link::defer() {
+  if (deferred_) {
+    return;
+  }
+  deferred_ = true;
+  shard_.pending_.emplace_back(link_id_);
+  update();
+}
+
+void Shard::Link::update() {
+  if (state_ != State::READY) {
+    return;
+  }
+  if (shard_.io_uring_) {
+    update_io_uring();
+    return;
+  }
+  auto reading = !paused_ && !deferred_;
+  auto writing = !std::empty(outbound_);
+  if (reading == reading_ && writing == writing_) {
+    return;
+  }
+  reading_ = reading;
+  writing_ = writing;
+  shard_.metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+  shard_.poller_.modify(fd_, *this, writing, reading);
+}
+
+// note! the receive is cancelled (not re-armed) while paused or waiting for a free slot and at most one send is in flight
+void Shard::Link::update_io_uring() {
+  auto &io_uring = *shard_.io_uring_;
+  auto reading = !paused_ && !deferred_;
+  if (reading && !reading_) {
+    io_uring.receive(fd_, to_user_data(Request::RECEIVE));
+    ++requests_;
+    reading_ = true;
+  } else if (!reading && reading_ && !cancelling_) {
+    io_uring.cancel(to_user_data(Request::RECEIVE), to_user_data(Request::CANCEL));
+    cancelling_ = true;
+  }
+  if (!writing_ && !std::empty(outbound_)) {
+    std::swap(outbound_, sending_);  // note! capacity is retained
+    io_uring.send(fd_, sending_, to_user_data(Request::SEND));
+    ++requests_;
+    writing_ = true;
+  }
+}
+
+// io_uring
+
+void Shard::Link::received(tools::IoUring::Completion const &completion) {
+  if (!completion.more()) {
+    --requests_;
+    reading_ = false;
+    cancelling_ = false;
+  }
+  auto &io_uring = *shard_.io_uring_;
+  auto closed = completion.result == 0 || (completion.result < 0 && completion.result != -ENOBUFS && completion.result != -ECANCELED);
+  if (completion.has_buffer()) {
+    auto buffer = io_uring.buffer(completion.buffer_id(), completion.result);
+    if (state_ == State::READY) {
+      if ((length_ + std::size(buffer)) > std::size(inbound_)) {
+        if ((length_ + std::size(buffer)) > MAX_BUFFER_SIZE) [[unlikely]] {
+          log::warn("Message is too large (link_id={}, size={})"sv, link_id_, length_);
+          closed = true;
+        } else {
+          inbound_.resize(std::max(2 * std::size(inbound_), length_ + std::size(buffer)));
+        }
+      }
+      if (!closed) {
+        if (length_ == 0) {
+          receive_time_ = clock::get_system();
+        }
+        std::memcpy(std::data(inbound_) + length_, std::data(buffer), std::size(buffer));
+        length_ += std::size(buffer);
+        shard_.metrics_.add(Metrics::Counter::CLIENT_BYTES_RECEIVED, std::size(buffer));
+      }
+    }
+    io_uring.release(completion.buffer_id());
+  }
+  if (state_ != State::READY) {
+    return;
+  }
+  if (closed) {
+    if (completion.result <= 0) {
+      log::info("Disconnected (link_id={})"sv, link_id_);
+    }
+    disconnect();  // note! remaining messages are forwarded first
+  }
+  if (!deferred_ && !process()) {
+    defer();
+  }
+  update();  // note! re-armed if the receive was terminated (e.g. no free buffers)
+}
+
+void Shard::Link::sent(tools::IoUring::Completion const &completion) {
+  --requests_;
+  writing_ = false;
+  if (state_ != State::READY) {
+    sending_.clear();
+    return;
+  }
+  if (completion.result < 0) {
+    shard_.metrics_.add(Metrics::Counter::CLIENT_SEND_FAILURES);
+    log::warn("Unable to send (link_id={}, error={})"sv, link_id_, std::strerror(-completion.result));
+    sending_.clear();
+    disconnect();
+    if (!process()) {
+      defer();
+    }
+    return;
+  }
+  shard_.metrics_.add(Metrics::Counter::CLIENT_BYTES_SENT, completion.result);
+  sending_.erase(std::begin(sending_), std::begin(sending_) + completion.result);
+  if (!std::empty(sending_)) [[unlikely]] {
+    outbound_.insert(std::begin(outbound_), std::begin(sending_), std::end(sending_));  // note! partial send
+    sending_.clear();
+  }
+  update();
+}
+
+}  // namespace client
+}  // namespace fix_proxy
+}  // namespace roq
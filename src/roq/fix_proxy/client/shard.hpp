@@ -0,0 +1,356 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "roq/trace.hpp"
+
+#include "roq/fix/message.hpp"
+
+#include "roq/fix_proxy/entitlements.hpp"
+#include "roq/fix_proxy/messages.hpp"
+#include "roq/fix_proxy/metrics.hpp"
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/tools/encode_buffer.hpp"
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+#include "roq/fix_proxy/tools/io_uring.hpp"
+#include "roq/fix_proxy/tools/poller.hpp"
+#include "roq/fix_proxy/tools/slot_map.hpp"
+#include "roq/fix_proxy/tools/spsc_buffer.hpp"
+#include "roq/fix_proxy/tools/spsc_queue.hpp"
+#include "roq/fix_proxy/tools/wakeup.hpp"
+
+#include "roq/fix_proxy/client/decoder.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace client {
+
+// note!
+// client connections owned by a dedicated thread (non-blocking sockets, epoll)
+// all shards accept from the same listen address (SO_REUSEPORT for tcp, a shared socket for unix domain sockets)
+// inbound messages are framed, validated and decoded by the shard into a fixed number of preallocated slots (same design as the upstream pipeline)
+// a logon is not decoded when verification is asynchronous: the link is paused until the event loop thread resumes it
+// outbound messages are encoded by the event loop thread (growing scratch buffer), copied into the ring buffer and sent by the shard
+// unsent bytes are buffered per link
+// the event loop thread owns the protocol state (sessions), the two threads only communicate through single-producer single-consumer queues
+// entitlements are forwarded once a logon has been accepted: messages not entitled are not decoded (only the header is forwarded)
+// receive timestamps are optionally taken by the kernel (converted from realtime to the system clock), otherwise when the bytes were read
+// link ids are slot map keys with the slot index interleaved across shards (index * count + shard)
+// io_uring can be used instead of epoll: all requests prepared by an iteration (receive, send, cancel) are submitted by a single
+// system call which also waits for completions, a link is only destroyed once it has no requests in flight
+
+struct Shard final : public tools::Poller::Handler {
+  struct Connected final {
+    Shard &shard;
+    uint64_t link_id = {};
+  };
+
+  struct Decoded final {
+    uint64_t link_id = {};
+    TraceInfo const &trace_info;  // note! source_receive_time is when the bytes were read (or received by the kernel)
+    fix::Header const &header;
+    std::span<std::byte const> raw;
+    Decoder::Value const &value;  // note! monostate if the msg_type is not supported or not entitled (or the logon is waiting for verification)
+    std::chrono::nanoseconds decode_start = {};
+    std::chrono::nanoseconds decode_end = {};
+  };
+
+  struct Disconnected final {
+    uint64_t link_id = {};
+  };
+
+  struct Handler {
+    virtual void operator()(Connected const &) = 0;
+    virtual void operator()(Decoded const &) = 0;
+    virtual void operator()(Disconnected const &) = 0;
+  };
+
+  struct Depth final {
+    size_t ready = {};     // note! slots
+    size_t outbound = {};  // note! bytes
+  };
+
+  // note! one listening socket per shard (ownership is transferred)
+  static std::vector<int> create_listeners(std::string_view const &listen_address, uint32_t count);
+
+  // note! verify means logon messages are verified asynchronously (the link is paused until resumed)
+  Shard(Settings const &, uint32_t index, uint32_t count, int listener, bool verify, Metrics::Slot &, tools::Wakeup &event_loop);
+
+  Shard(Shard &&) = delete;
+  Shard(Shard const &) = delete;
+
+  ~Shard();
+
+  // note! the following methods may only be called from the event loop thread
+
+  // returns the number of events dispatched
+  size_t poll(Handler &);
+
+  // note! returns false if the outbound ring buffer is full
+  template <typename Callback>
+  bool send(uint64_t link_id, Callback callback) {
+    auto header = Header{
+        .link_id = link_id,
+        .type = Type::SEND,
+    };
+    auto message = encode_buffer_.encode(callback);  // note! the ring buffer only reserves the encoded length
+    auto success = outbound_.write(sizeof(header) + std::size(message), [&](auto data) {
+      std::memcpy(std::data(data), &header, sizeof(header));
+      std::memcpy(std::data(data) + sizeof(header), std::data(message), std::size(message));
+    });
+    if (success) {
+      wakeup_.notify();
+    }
+    return success;
+  }
+
+  // note! the following are retried (by poll) if the outbound ring buffer is full
+
+  void close(uint64_t link_id);
+
+  // note! continue processing inbound messages after a logon
+  void resume(uint64_t link_id);
+
+  // note! everything is decoded until the link has been restricted (the session remains responsible for rejecting)
+  void entitle(uint64_t link_id, Entitlements<Messages::FromClient> const &);
+
+  void refresh(std::chrono::nanoseconds now) { encode_buffer_.refresh(now); }
+
+  // note! nothing is waiting for the event loop thread
+  bool idle() const { return ready_.empty(); }
+
+  uint32_t index() const { return index_; }
+
+  Depth depth() const {
+    return {
+        .ready = ready_.size(),
+        .outbound = outbound_.size(),
+    };
+  }
+
+ protected:
+  // tools::Poller::Handler (listener)
+  void operator()(uint32_t events) override;
+
+  enum class Type : uint8_t {
+    SEND,
+    CLOSE,
+    RESUME,
+    ENTITLEMENTS,
+  };
+
+  struct Header final {
+    uint64_t link_id = {};
+    Type type = {};
+  };
+
+  struct Command final {
+    Header header;
+    Entitlements<Messages::FromClient> entitlements;  // note! only forwarded with ENTITLEMENTS
+  };
+
+  void write(Command const &);
+
+  bool try_write(Command const &);
+
+  struct Slot final {
+    enum class Type {
+      CONNECTED,
+      DECODED,
+      DISCONNECTED,
+    } type = {};
+    uint64_t link_id = {};
+    TraceInfo trace_info;
+    std::chrono::nanoseconds decode_start = {};
+    std::chrono::nanoseconds decode_end = {};
+    fix::Header header;
+    std::vector<std::byte> raw;
+    std::vector<std::byte> decode_buffer;
+    std::vector<std::byte> decode_buffer_2;
+    Decoder::Value value;
+  };
+
+  // note! io_uring user_data identifies the request and the link (shard requests use the zero key)
+  enum class Request : uint8_t {
+    ACCEPT,
+    WAKEUP,
+    RECEIVE,
+    SEND,
+    CANCEL,
+  };
+
+  struct Link final : public tools::Poller::Handler {
+    Link(Shard &, int fd, uint64_t link_id);
+
+    Link(Link const &) = delete;
+
+    ~Link();
+
+    // note! returns false if waiting for a free slot
+    bool process();
+
+    void defer();
+
+    void send(std::span<std::byte const> const &);
+
+    void close();
+
+    void resume();
+
+    void entitle(Entitlements<Messages::FromClient> const &);
+
+    // note! after waiting for a free slot
+    void retry();
+
+    // note! read interest is dropped while paused or waiting for a free slot (backpressure)
+    void update();
+
+    // io_uring
+    void received(tools::IoUring::Completion const &);
+    void sent(tools::IoUring::Completion const &);
+    uint32_t requests() const { return requests_; }
+
+   protected:
+    // tools::Poller::Handler
+    void operator()(uint32_t events) override;
+
+    bool fill();
+    bool flush();
+
+    void disconnect();
+
+    void update_io_uring();
+
+    uint64_t to_user_data(Request request) const { return Shard::to_user_data(shard_.to_key(link_id_), request); }
+
+   private:
+    Shard &shard_;
+    int const fd_;
+    uint64_t const link_id_;
+    std::vector<std::byte> inbound_;
+    size_t length_ = {};
+    std::chrono::nanoseconds receive_time_ = {};  // note! oldest unprocessed bytes (kernel receive time if enabled)
+    std::vector<std::byte> outbound_;             // note! only bytes the socket could not accept (io_uring: not yet submitted)
+    std::vector<std::byte> sending_;              // note! io_uring: owned by the kernel until the send has completed
+    uint32_t requests_ = {};                      // note! io_uring: requests in flight (receive and send)
+    Entitlements<Messages::FromClient> entitlements_;
+    enum class State {
+      READY,
+      DISCONNECTING,  // note! remaining messages are forwarded before the disconnect
+      ZOMBIE,
+    } state_ = {};
+    bool announced_ = {};  // note! connected event has been forwarded
+    bool paused_ = {};     // note! logon waiting for verification
+    bool deferred_ = {};   // note! waiting for a free slot
+    bool reading_ = true;
+    bool writing_ = {};
+    bool cancelling_ = {};  // note! io_uring: the receive is being cancelled
+  };
+
+  struct Notifier final : public tools::Poller::Handler {
+    Notifier(tools::Wakeup &wakeup, Metrics::Slot &metrics) : wakeup_{wakeup}, metrics_{metrics} {}
+
+   protected:
+    void operator()(uint32_t) override {
+      metrics_.add(Metrics::Counter::CLIENT_SYSTEM_CALLS);
+      wakeup_.clear();
+    }
+
+   private:
+    tools::Wakeup &wakeup_;
+    Metrics::Slot &metrics_;
+  };
+
+  void run();
+  void run_io_uring();
+
+  void accept();
+  void connected(int fd, struct sockaddr_storage const &);
+
+  // io_uring
+  void dispatch(tools::IoUring::Completion const &);
+
+  void process(Header const &, std::span<std::byte const> const &payload);
+
+  void flush();
+
+  // note! returns true if the frame is a logon waiting for verification
+  bool decode(
+      Slot &,
+      std::span<std::byte const> const &frame,
+      uint64_t link_id,
+      Entitlements<Messages::FromClient> const &,
+      std::chrono::nanoseconds receive_time);
+
+  Slot *acquire();
+  void commit();
+
+  using Links = tools::SlotMap<Link>;
+
+  Link *find(uint64_t link_id);
+
+  uint64_t to_link_id(uint64_t key) const { return Links::make_key(Links::get_generation(key), (Links::get_index(key) * count_) + index_); }
+  uint64_t to_key(uint64_t link_id) const { return Links::make_key(Links::get_generation(link_id), Links::get_index(link_id) / count_); }
+
+  // note! the index of the key is limited to 29 bits
+  static uint64_t to_user_data(uint64_t key, Request request) {
+    return Links::make_key(Links::get_generation(key), (Links::get_index(key) << 3) | static_cast<uint32_t>(request));
+  }
+  static std::pair<uint64_t, Request> from_user_data(uint64_t user_data) {
+    auto index = Links::get_index(user_data);
+    return {Links::make_key(Links::get_generation(user_data), index >> 3), static_cast<Request>(index & 7)};
+  }
+
+ private:
+  uint32_t const index_;
+  uint32_t const count_;
+  int const listener_;
+  bool const verify_;
+  bool const busy_poll_;
+  int const socket_busy_poll_;  // note! microseconds
+  bool const kernel_timestamps_;
+  size_t const encode_buffer_size_;
+  tools::FrameScanner const frame_scanner_;
+  Metrics::Slot &metrics_;  // note! only updated by the shard thread
+  tools::Wakeup &event_loop_;
+  std::vector<Slot> slots_;
+  tools::SPSCQueue<uint32_t> free_;    // note! event loop => shard
+  tools::SPSCQueue<uint32_t> ready_;   // note! shard => event loop
+  tools::SPSCBuffer outbound_;         // note! event loop => shard
+  tools::Wakeup wakeup_;               // note! event loop => shard
+  tools::EncodeBuffer encode_buffer_;  // note! event loop thread
+  std::vector<Command> retry_;         // note! event loop thread: commands not yet forwarded (ring buffer was full)
+  // note! only accessed by the shard thread
+  tools::Poller poller_;
+  Notifier notifier_;
+  Links links_;
+  std::unique_ptr<tools::IoUring> io_uring_;  // note! optional
+  uint64_t wakeup_counter_ = {};              // note! io_uring: the eventfd is read by the kernel
+  uint64_t system_calls_ = {};                // note! io_uring: already counted
+  uint32_t slot_index_ = {};
+  Slot *slot_ = {};
+  bool committed_ = {};  // note! the event loop thread should be notified
+  std::vector<std::span<std::byte const>> frames_;
+  std::vector<uint64_t> pending_;  // note! links waiting for a free slot
+  std::vector<uint64_t> writers_;  // note! io_uring: links with bytes to send (one send per link and iteration)
+  std::vector<uint64_t> zombies_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+
+}  // namespace client
+}  // namespace fix_proxy
+}  // namespace roq
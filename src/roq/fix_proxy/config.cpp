@@ -85,6 +85,14 @@ auto parse_user(auto &node) {
       // XXX TODO
     } else if (key == "strategy_id"sv) {
       result.strategy_id = value.template value<uint32_t>().value();
+    } else if (key == "msg_types"sv) {
+      if (value.is_array()) {
+        for (auto &node_2 : *value.as_array()) {
+          result.msg_types.emplace_back(node_2.template value<std::string>().value());
+        }
+      } else {
+        log::fatal(R"(Unexpected: user key="{}" must be an array)"sv, key.str());
+      }
     } else {
       log::fatal(R"(Unexpected: user key="{}")"sv, key.str());
     }
@@ -9,6 +9,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "roq/utils/container.hpp"
 
@@ -21,6 +22,7 @@ struct User final {
   std::string password;
   std::string accounts;  // XXX TODO
   uint32_t strategy_id = {};
+  std::vector<std::string> msg_types;  // note! empty means all
 };
 
 struct Config final {
@@ -49,15 +51,16 @@ struct fmt::formatter<roq::fix_proxy::User> {
         R"({{)"
         R"(component="{}", )"
         R"(username="{}", )"
-        R"(password="{}", )"
+        R"(password="***", )"  // note! never log secrets
         R"(accounts="{}", )"
-        R"(strategy_id={})"
+        R"(strategy_id={}, )"
+        R"(msg_types=[{}])"
         R"(}})"sv,
         value.component,
         value.username,
-        value.password,
         value.accounts,
-        value.strategy_id);
+        value.strategy_id,
+        fmt::join(value.msg_types, ", "sv));
   }
 };
 
@@ -6,13 +6,15 @@
 
 #include <magic_enum/magic_enum_format.hpp>
 
+#include <utility>
+
+#include "roq/clock.hpp"
 #include "roq/event.hpp"
 #include "roq/timer.hpp"
 
 #include "roq/exceptions.hpp"
 
 #include "roq/utils/common.hpp"
-#include "roq/utils/safe_cast.hpp"
 #include "roq/utils/update.hpp"
 
 #include "roq/fix/map.hpp"
@@ -35,81 +37,113 @@ auto const TIMER_FREQUENCY = 100ms;
 // === HELPERS ===
 
 namespace {
-template <typename R>
-auto create_username_to_password_and_strategy_id_and_component_id(auto &config) {
-  using result_type = std::remove_cvref_t<R>;
-  result_type result;
-  for (auto &[_, user] : config.users) {
-    result.try_emplace(user.username, user.password, user.strategy_id, user.component);
-  }
+// note! FNV-1a
+uint64_t create_fingerprint(auto &username, auto &raw_data) {
+  uint64_t result = 0xcbf29ce484222325;
+  auto helper = [&](auto &value) {
+    for (auto item : value) {
+      result = (result ^ static_cast<uint8_t>(item)) * 0x100000001b3;
+    }
+  };
+  helper(username);
+  result = (result ^ 0xff) * 0x100000001b3;  // note! separator (not valid utf-8)
+  helper(raw_data);
   return result;
 }
 
-auto create_proxy(auto &handler, auto &settings) {
-  auto options = fix::proxy::Manager::Options{
-      .server{
-          .username = settings.server.username,
-          .password = settings.server.password,
-          .ping_freq = utils::safe_cast(settings.server.ping_freq),
-          .request_timeout = settings.server.request_timeout,
-      },
-      .client{
-          .auth_method = settings.client.auth_method,
-          .auth_timestamp_tolerance = settings.client.auth_timestamp_tolerance,
-          .logon_heartbeat_min = utils::safe_cast(settings.client.logon_heartbeat_min),
-          .logon_heartbeat_max = utils::safe_cast(settings.client.logon_heartbeat_max),
-          .request_timeout = settings.client.request_timeout,
-          .heartbeat_freq = utils::safe_cast(settings.client.heartbeat_freq),
-      },
-      .test{
-          .disable_remove_cl_ord_id = settings.test.disable_remove_cl_ord_id,
-      }};
-  return fix::proxy::Manager::create(handler, options);
+auto create_verifier(auto &handler, auto &settings, auto &crypto, auto &context) -> std::unique_ptr<tools::Verifier> {
+  if (settings.client.auth_threads == 0 || crypto.method() == tools::Crypto::Method::UNDEFINED) {
+    return {};
+  }
+  return std::make_unique<tools::Verifier>(handler, crypto, context, settings.client.auth_threads, settings.client.auth_poll_freq);
+}
+
+auto create_context_wakeup(auto &handler, auto &settings, auto &context, auto &shared) -> std::unique_ptr<tools::ContextWakeup> {
+  if (settings.client.io_threads == 0 || settings.loop.busy_poll) {
+    return {};
+  }
+  return std::make_unique<tools::ContextWakeup>(handler, context, shared.wakeup);
 }
 
-auto create_auth_session(auto &handler, auto &settings, auto &context) -> std::unique_ptr<auth::Session> {
+auto create_auth_session(auto &handler, auto &settings, auto &context, auto &profiler) -> std::unique_ptr<auth::Session> {
   if (std::empty(settings.auth.uri)) {
     return {};
   }
   io::web::URI uri{settings.auth.uri};
-  return std::make_unique<auth::Session>(handler, settings, context, uri);
+  return std::make_unique<auth::Session>(handler, settings, context, uri, profiler);
 }
 
-auto create_server_session(auto &handler, auto &settings, auto &context, auto &connections, auto &proxy) {
-  if (std::size(connections) != 1) {
-    log::fatal("Unexpected: only supporting a single upstream fix-bridge"sv);
+auto create_server_session(auto &handler, auto &settings, auto &context, auto &connections, auto &proxy, auto &shared) {
+  if (std::empty(connections) || std::size(connections) > TRAFFIC_CLASSES) {
+    log::fatal("Unexpected: expected between 1 and {} upstream connections (order entry, market data, reference data)"sv, TRAFFIC_CLASSES);
   }
   auto &connection = connections[0];
   auto uri = io::web::URI{connection};
-  return server::Session{handler, settings, context, uri, proxy};
+  return server::Session{
+      handler,
+      settings,
+      context,
+      uri,
+      TrafficClass::ORDER_ENTRY,
+      proxy,
+      proxy,
+      shared.tracer,
+      shared.metrics,
+      shared.journal,
+      shared.orders,
+      shared.profiler};
+}
+
+// note! indexed by traffic class, connections are optional (and given in that order) for anything but order entry
+template <typename R>
+R create_upstreams(auto &handler, auto &settings, auto &context, auto &connections, auto &proxy, auto &shared) {
+  using result_type = std::remove_cvref_t<R>;
+  result_type result;
+  for (size_t i = 1; i < std::size(connections); ++i) {
+    auto uri = io::web::URI{connections[i]};
+    result[i] = std::make_unique<Upstream>(handler, settings, context, uri, static_cast<TrafficClass>(i), proxy, shared);
+  }
+  return result;
 }
 }  // namespace
 
 // === IMPLEMENTATION ===
 
 Controller::Controller(Settings const &settings, Config const &config, io::Context &context, std::span<std::string_view const> const &connections)
-    : username_to_password_and_strategy_id_and_component_id_{create_username_to_password_and_strategy_id_and_component_id<
-          decltype(username_to_password_and_strategy_id_and_component_id_)>(config)},
-      crypto_{settings.client.auth_method, settings.client.auth_timestamp_tolerance}, context_{context},
+    : crypto_{settings.client.auth_method, settings.client.auth_timestamp_tolerance}, nonce_set_{settings.client.auth_timestamp_tolerance}, context_{context},
       terminate_{context.create_signal(*this, io::sys::Signal::Type::TERMINATE)}, interrupt_{context.create_signal(*this, io::sys::Signal::Type::INTERRUPT)},
-      timer_{context.create_timer(*this, TIMER_FREQUENCY)}, proxy_{create_proxy(*this, settings)}, shared_{settings, *proxy_},
-      auth_session_{create_auth_session(*this, settings, context)}, server_session_{create_server_session(*this, settings, context, connections, *proxy_)},
-      client_manager_{settings, context, shared_} {
+      timer_{context.create_timer(*this, TIMER_FREQUENCY)}, verifier_{create_verifier(*this, settings, crypto_, context)},
+      proxy_{Shared::create_proxy(*this, settings)}, shared_{settings, config, *proxy_, verifier_.get()},
+      context_wakeup_{create_context_wakeup(*this, settings, context, shared_)},
+      auth_session_{create_auth_session(*this, settings, context, shared_.profiler)},
+      server_session_{create_server_session(*this, settings, context, connections, *proxy_, shared_)},
+      upstreams_{create_upstreams<decltype(upstreams_)>(*this, settings, context, connections, *proxy_, shared_)}, client_manager_{settings, context, shared_},
+      service_{*this, settings, context} {
 }
 
 void Controller::run() {
   log::info("Event loop is now running"sv);
+  configure_thread();
   {
     MessageInfo message_info;
     Start start;
     create_event_and_dispatch(server_session_, message_info, start);
+    for_each_upstream([&](auto &session) { create_event_and_dispatch(session, message_info, start); });
+  }
+  if (busy_poll()) {
+    spin();
+  } else {
+    if (static_cast<bool>(context_wakeup_)) {
+      poll_shards();  // note! the shards will not notify before the event loop thread has announced it will block
+    }
+    (*timer_).resume();
+    context_.dispatch();
   }
-  (*timer_).resume();
-  context_.dispatch();
   {
     MessageInfo message_info;
     Stop stop;
     create_event_and_dispatch(server_session_, message_info, stop);
+    for_each_upstream([&](auto &session) { create_event_and_dispatch(session, message_info, stop); });
   }
   log::info("Event loop has terminated"sv);
 }
@@ -119,38 +153,55 @@ void Controller::run() {
 void Controller::operator()(io::sys::Signal::Event const &event) {
   log::warn("*** SIGNAL: {} ***"sv, event.type);
   context_.stop();
+  stop_ = true;
 }
 
 // io::sys::Timer::Handler
 
 void Controller::operator()(io::sys::Timer::Event const &event) {
-  auto timer = Timer{
-      .now = event.now,
-  };
-  // (*proxy_)(event);
-  dispatch(timer);
+  if (static_cast<bool>(context_wakeup_)) {
+    poll_shards();  // note! commands waiting for space in a ring buffer are retried when polled
+  }
+  refresh(event.now);
 }
 
 // fix::proxy::Manager::Handler
 
 // authentication:
 
-std::pair<fix::codec::Error, uint32_t> Controller::operator()(fix::proxy::Manager::Credentials const &credentials, [[maybe_unused]] uint64_t session_id) {
-  auto iter_1 = username_to_password_and_strategy_id_and_component_id_.find(credentials.username);
-  if (iter_1 == std::end(username_to_password_and_strategy_id_and_component_id_)) {
+std::pair<fix::codec::Error, uint32_t> Controller::operator()(fix::proxy::Manager::Credentials const &credentials, uint64_t session_id) {
+  auto &metrics = shared_.metrics.event_loop();
+  auto reject = [&](auto error) -> std::pair<fix::codec::Error, uint32_t> {
+    metrics.add(Metrics::Counter::CLIENT_LOGON_FAILURE);
+    return {error, {}};
+  };
+  auto iter_1 = shared_.credentials.find(credentials.username);
+  if (iter_1 == std::end(shared_.credentials)) {
     log::warn("Invalid: username"sv);
-    return {fix::codec::Error::INVALID_USERNAME, {}};
+    return reject(fix::codec::Error::INVALID_USERNAME);
   }
-  auto &[secret, strategy_id, component] = (*iter_1).second;
-  if (credentials.component != component) {
+  auto &user = (*iter_1).second;
+  if (credentials.component != user.component) {
     log::warn("Invalid: component"sv);
-    return {fix::codec::Error::INVALID_COMPONENT, {}};
+    return reject(fix::codec::Error::INVALID_COMPONENT);
   }
-  if (!crypto_.validate(credentials.password, secret, credentials.raw_data)) {
+  auto validate = [&]() {
+    auto iter_2 = verified_.find(session_id);
+    if (iter_2 != std::end(verified_)) {
+      return (*iter_2).second;  // note! already verified (asynchronously)
+    }
+    return crypto_.validate(credentials.password, user.password, user.key, credentials.raw_data);
+  };
+  if (!validate()) {
     log::warn("Invalid: password"sv);
-    return {fix::codec::Error::INVALID_PASSWORD, {}};
+    return reject(fix::codec::Error::INVALID_PASSWORD);
   }
-  return {{}, strategy_id};
+  if (is_replay(credentials)) {
+    log::warn("Invalid: replay"sv);
+    return reject(fix::codec::Error::INVALID_PASSWORD);
+  }
+  metrics.add(Metrics::Counter::CLIENT_LOGON_SUCCESS);
+  return {{}, user.strategy_id};
 }
 
 // server:
@@ -163,98 +214,6 @@ void Controller::operator()(Trace<fix::proxy::Manager::Disconnected> const &) {
 void Controller::operator()(Trace<fix::proxy::Manager::Ready> const &) {
 }
 
-// - manager => server
-
-void Controller::operator()(Trace<fix::codec::Reject> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::Logon> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::Logout> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::Heartbeat> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::TestRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-// - client => server
-
-void Controller::operator()(Trace<fix::codec::BusinessMessageReject> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::UserRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::TradingSessionStatusRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::SecurityListRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::SecurityDefinitionRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::SecurityStatusRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::MarketDataRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::NewOrderSingle> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::OrderCancelReplaceRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::OrderCancelRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::OrderMassCancelRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::OrderStatusRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::OrderMassStatusRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::TradeCaptureReportRequest> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::RequestForPositions> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::MassQuote> const &event) {
-  dispatch_to_server(event);
-}
-
-void Controller::operator()(Trace<fix::codec::QuoteCancel> const &event) {
-  dispatch_to_server(event);
-}
-
 // client:
 
 // - connection
@@ -263,121 +222,231 @@ void Controller::operator()(Trace<fix::proxy::Manager::Disconnect> const &event,
   dispatch_to_client(event, session_id);
 }
 
-// - manager => client
-
-void Controller::operator()(Trace<fix::codec::Reject> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-void Controller::operator()(Trace<fix::codec::Logon> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-void Controller::operator()(Trace<fix::codec::Logout> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-void Controller::operator()(Trace<fix::codec::Heartbeat> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-void Controller::operator()(Trace<fix::codec::TestRequest> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-// - server => client
+// tools::Verifier::Handler
 
-void Controller::operator()(Trace<fix::codec::BusinessMessageReject> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-void Controller::operator()(Trace<fix::codec::TradingSessionStatus> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-void Controller::operator()(Trace<fix::codec::SecurityList> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
-
-void Controller::operator()(Trace<fix::codec::SecurityDefinition> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+void Controller::operator()(tools::Verifier::Result const &result) {
+  Profiler::Scope scope{shared_.profiler, Profiler::Callback::VERIFIER};
+  auto session_id = result.session_id;
+  auto found = client_manager_.find(session_id, [&](auto &session) {
+    verified_.insert_or_assign(session_id, result.success);
+    session.resume();  // note! logon is now dispatched to the proxy manager
+    verified_.erase(session_id);
+  });
+  if (!found) {
+    log::warn("Undeliverable: session_id={}"sv, session_id);
+  }
 }
 
-void Controller::operator()(Trace<fix::codec::SecurityStatus> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
+// tools::ContextWakeup::Handler
 
-void Controller::operator()(Trace<fix::codec::MarketDataRequestReject> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+void Controller::operator()(tools::ContextWakeup::Notified const &) {
+  poll_shards();
 }
 
-void Controller::operator()(Trace<fix::codec::MarketDataSnapshotFullRefresh> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
+// auth::Session::Handler
 
-void Controller::operator()(Trace<fix::codec::MarketDataIncrementalRefresh> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+void Controller::operator()(auth::Session::Insert const &) {
+  // shared_.add_user(insert.username, insert.password, insert.strategy_id, insert.component);
 }
 
-void Controller::operator()(Trace<fix::codec::ExecutionReport> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+void Controller::operator()(auth::Session::Remove const &) {
+  // shared_.remove_user(remove.username);
 }
 
-void Controller::operator()(Trace<fix::codec::OrderCancelReject> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
+// server::Session::Handler
 
-void Controller::operator()(Trace<fix::codec::OrderMassCancelReport> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+void Controller::operator()(Trace<server::Session::Ready> const &event) {
+  auto &[trace_info, ready] = event;
+  if (ready.traffic_class != TrafficClass::ORDER_ENTRY) {
+    return;  // note! tracked by Upstream
+  }
+  ready_ = true;
+  shared_.metrics.upstream(TrafficClass::ORDER_ENTRY, Metrics::UpstreamState::READY);
 }
 
-void Controller::operator()(Trace<fix::codec::TradeCaptureReportRequestAck> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+// note! only the order entry session is required, a dedicated session rejects its own subscriptions (see Upstream)
+void Controller::operator()(Trace<server::Session::Disconnected> const &event) {
+  auto &[trace_info, disconnected] = event;
+  if (disconnected.traffic_class != TrafficClass::ORDER_ENTRY) {
+    return;
+  }
+  ready_ = false;
+  client_manager_.get_all_sessions([&](auto &session) { session.force_disconnect(); });
 }
 
-void Controller::operator()(Trace<fix::codec::TradeCaptureReport> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
+// service::Server::Handler
 
-void Controller::operator()(Trace<fix::codec::RequestForPositionsAck> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+// note! the response is rebuilt at most once per interval (the cost to the event loop does not depend on the number of scrapers)
+void Controller::operator()(service::Session::Scrape const &scrape) {
+  auto now = clock::get_system();
+  if (std::empty(metrics_) || next_metrics_ <= now) {
+    Profiler::Scope scope{shared_.profiler, Profiler::Callback::SERVICE};
+    metrics_.clear();
+    tools::Prometheus prometheus{metrics_};
+    write(prometheus);
+    next_metrics_ = now + shared_.settings.service.metrics_interval;
+  }
+  scrape.body.append(metrics_);
 }
 
-void Controller::operator()(Trace<fix::codec::PositionReport> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
-}
+// utilities
 
-void Controller::operator()(Trace<fix::codec::MassQuoteAck> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+// note! families must not be interleaved (each is written in one pass)
+void Controller::write(tools::Prometheus &prometheus) {
+  using Type = tools::Prometheus::Type;
+  shared_.metrics.write(prometheus);
+  shared_.tracer.write(prometheus);
+  shared_.orders.write(prometheus);
+  shared_.profiler.write(prometheus);
+  // queues
+  prometheus.describe("roq_fix_proxy_queue_bytes"sv, Type::GAUGE, "Bytes waiting in the ring buffers between threads"sv);
+  client_manager_.get_all_shards([&](auto &shard) {
+    auto index = fmt::format("{}"sv, shard.index());
+    prometheus.sample("roq_fix_proxy_queue_bytes"sv, {{"queue"sv, "shard_outbound"sv}, {"shard"sv, index}}, uint64_t{shard.depth().outbound});
+  });
+  if (server_session_.has_pipeline()) {
+    auto depth = server_session_.pipeline_depth();
+    prometheus.sample("roq_fix_proxy_queue_bytes"sv, {{"queue"sv, "pipeline_outbound"sv}}, uint64_t{depth.outbound});
+    prometheus.describe("roq_fix_proxy_pipeline_ready_slots"sv, Type::GAUGE, "Decoded upstream messages waiting for the event loop thread"sv);
+    prometheus.sample("roq_fix_proxy_pipeline_ready_slots"sv, {}, uint64_t{depth.ready});
+  }
+  if (client_manager_.has_shards()) {
+    prometheus.describe("roq_fix_proxy_shard_ready_slots"sv, Type::GAUGE, "Decoded client messages waiting for the event loop thread"sv);
+    client_manager_.get_all_shards([&](auto &shard) {
+      auto index = fmt::format("{}"sv, shard.index());
+      prometheus.sample("roq_fix_proxy_shard_ready_slots"sv, {{"shard"sv, index}}, uint64_t{shard.depth().ready});
+    });
+  }
+  // sessions
+  uint64_t sessions = {};
+  client_manager_.get_all_sessions([&]([[maybe_unused]] auto &session) { ++sessions; });
+  prometheus.describe("roq_fix_proxy_sessions"sv, Type::GAUGE, "Client sessions"sv);
+  prometheus.sample("roq_fix_proxy_sessions"sv, {}, sessions);
+  if (shared_.journal.enabled()) {
+    prometheus.describe("roq_fix_proxy_journal_dropped_total"sv, Type::COUNTER, "Messages not captured because a journal ring buffer was full"sv);
+    prometheus.sample("roq_fix_proxy_journal_dropped_total"sv, {}, shared_.journal.dropped());
+  }
+  if (!shared_.settings.service.session_metrics) {
+    return;
+  }
+  // note! aggregated by comp_id (bounded cardinality, a comp_id may have several sessions, e.g. when reconnecting)
+  for (auto &[_, statistics] : comp_ids_) {
+    statistics = {};
+  }
+  client_manager_.get_all_sessions([&](auto &session) {
+    auto comp_id = session.comp_id();
+    if (std::empty(comp_id)) {
+      return;  // note! not logged on
+    }
+    auto iter = comp_ids_.find(comp_id);
+    if (iter == std::end(comp_ids_)) {
+      iter = comp_ids_.try_emplace(std::string{comp_id}).first;
+    }
+    auto &lhs = (*iter).second;
+    auto &rhs = session.statistics();
+    lhs.messages_received += rhs.messages_received;
+    lhs.messages_sent += rhs.messages_sent;
+    lhs.bytes_received += rhs.bytes_received;
+    lhs.bytes_sent += rhs.bytes_sent;
+    lhs.send_failures += rhs.send_failures;
+    lhs.sequence_gaps += rhs.sequence_gaps;
+    lhs.not_entitled += rhs.not_entitled;
+  });
+  auto helper = [&](auto const &name, auto const &help, auto get_value) {
+    prometheus.describe(name, Type::COUNTER, help);
+    for (auto &[comp_id, statistics] : comp_ids_) {
+      auto [received, sent] = get_value(statistics);
+      prometheus.sample(name, {{"comp_id"sv, comp_id}, {"direction"sv, "received"sv}}, received);
+      prometheus.sample(name, {{"comp_id"sv, comp_id}, {"direction"sv, "sent"sv}}, sent);
+    }
+  };
+  helper("roq_fix_proxy_session_messages_total"sv, "Messages received or sent (by client comp_id)"sv, [](auto &statistics) {
+    return std::pair{statistics.messages_received, statistics.messages_sent};
+  });
+  helper("roq_fix_proxy_session_bytes_total"sv, "Bytes received or sent (by client comp_id)"sv, [](auto &statistics) {
+    return std::pair{statistics.bytes_received, statistics.bytes_sent};
+  });
+  auto helper_2 = [&](auto const &name, auto const &help, auto get_value) {
+    prometheus.describe(name, Type::COUNTER, help);
+    for (auto &[comp_id, statistics] : comp_ids_) {
+      prometheus.sample(name, {{"comp_id"sv, comp_id}}, get_value(statistics));
+    }
+  };
+  helper_2("roq_fix_proxy_session_send_failures_total"sv, "Messages which could not be sent (by client comp_id)"sv, [](auto &statistics) {
+    return statistics.send_failures;
+  });
+  helper_2("roq_fix_proxy_session_sequence_gaps_total"sv, "Inbound sequence gaps or replays (by client comp_id)"sv, [](auto &statistics) {
+    return statistics.sequence_gaps;
+  });
+  helper_2("roq_fix_proxy_session_not_entitled_total"sv, "Messages rejected by the entitlements (by client comp_id)"sv, [](auto &statistics) {
+    return statistics.not_entitled;
+  });
 }
 
-void Controller::operator()(Trace<fix::codec::QuoteStatusReport> const &event, uint64_t session_id) {
-  dispatch_to_client(event, session_id);
+bool Controller::busy_poll() const {
+  return shared_.settings.loop.busy_poll;  // note! required by the pipeline
 }
 
-// auth::Session::Handler
-
-void Controller::operator()(auth::Session::Insert const &) {
-  // shared_.add_user(insert.username, insert.password, insert.strategy_id, insert.component);
+void Controller::configure_thread() {
+  auto &loop = shared_.settings.loop;
+  if (loop.cpu_affinity >= 0) {
+    tools::Scheduling::set_affinity(static_cast<uint32_t>(loop.cpu_affinity));
+  }
+  if (loop.sched_fifo_priority > 0) {
+    tools::Scheduling::set_fifo_priority(loop.sched_fifo_priority);
+  }
 }
 
-void Controller::operator()(auth::Session::Remove const &) {
-  // shared_.remove_user(remove.username);
+// note! timer is driven from the loop
+void Controller::spin() {
+  log::info("Event loop is busy polling"sv);
+  std::chrono::nanoseconds next_refresh = {};
+  auto &profiler = shared_.profiler;
+  while (!stop_) {
+    profiler.begin();
+    context_.drain();
+    if (server_session_.has_pipeline()) {
+      server_session_.poll();
+      for_each_upstream([](auto &session) { session.poll(); });
+    }
+    client_manager_.poll();
+    if (static_cast<bool>(verifier_)) {
+      (*verifier_).poll();  // note! results are delivered without waiting for the timer
+    }
+    auto now = clock::get_system();
+    if (next_refresh <= now) {
+      next_refresh = now + TIMER_FREQUENCY;
+      refresh(now);
+    }
+    profiler.end();
+  }
 }
 
-// server::Session::Handler
-
-void Controller::operator()(Trace<server::Session::Ready> const &) {
-  ready_ = true;
+// note! the io::Context is blocking, shards notify through the context (only after prepare) and must therefore be idle before returning
+void Controller::poll_shards() {
+  auto &wakeup = shared_.wakeup;
+  while (true) {
+    client_manager_.poll();
+    wakeup.prepare();
+    if (client_manager_.idle()) {
+      return;
+    }
+    wakeup.cancel();
+  }
 }
 
-void Controller::operator()(Trace<server::Session::Disconnected> const &) {
-  ready_ = false;
-  client_manager_.get_all_sessions([&](auto &session) { session.force_disconnect(); });
+void Controller::refresh(std::chrono::nanoseconds now) {
+  Profiler::Scope scope{shared_.profiler, Profiler::Callback::TIMER};
+  auto timer = Timer{
+      .now = now,
+  };
+  // (*proxy_)(event);
+  dispatch(timer);
+  shared_.tracer.refresh(now);
+  shared_.orders.refresh(now);
+  service_.refresh(now);
 }
 
-// utilities
-
 template <typename... Args>
 void Controller::dispatch(Args &&...args) {
   MessageInfo message_info;
@@ -386,25 +455,21 @@ void Controller::dispatch(Args &&...args) {
     (*auth_session_)(event);
   }
   server_session_(event);
+  for_each_upstream([&](auto &session) { session(event); });
   client_manager_(event);
 }
 
-template <typename T>
-void Controller::dispatch_to_server(Trace<T> const &event) {
-  server_session_(event);
-}
-
-template <typename T>
-bool Controller::dispatch_to_client(Trace<T> const &event, uint64_t session_id) {
-  auto success = false;
-  client_manager_.find(session_id, [&](auto &session) {
-    session(event);
-    success = true;
-  });
-  if (!success) {
-    log::warn<0>("Undeliverable: session_id={}"sv, session_id);
+// note! only hmac_sha256_ts has a bounded window, the nonce is only remembered for as long as the timestamp is valid
+bool Controller::is_replay(fix::proxy::Manager::Credentials const &credentials) {
+  if (crypto_.method() != tools::Crypto::Method::HMAC_SHA256_TS) {
+    return false;
+  }
+  std::chrono::milliseconds timestamp;
+  if (!tools::Crypto::parse_timestamp(timestamp, credentials.raw_data)) {
+    return true;  // note! can't happen (already validated)
   }
-  return success;
+  auto fingerprint = create_fingerprint(credentials.username, credentials.raw_data);
+  return !nonce_set_.insert(timestamp, fingerprint);
 }
 
 /*
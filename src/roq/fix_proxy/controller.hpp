@@ -2,10 +2,15 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <memory>
 #include <span>
+#include <string>
 #include <string_view>
 
+#include "roq/logging.hpp"
+
 #include "roq/utils/container.hpp"
 
 #include "roq/io/context.hpp"
@@ -16,10 +21,18 @@
 #include "roq/fix/proxy/manager.hpp"
 
 #include "roq/fix_proxy/config.hpp"
+#include "roq/fix_proxy/messages.hpp"
+#include "roq/fix_proxy/router.hpp"
 #include "roq/fix_proxy/settings.hpp"
 #include "roq/fix_proxy/shared.hpp"
+#include "roq/fix_proxy/upstream.hpp"
 
+#include "roq/fix_proxy/tools/context_wakeup.hpp"
 #include "roq/fix_proxy/tools/crypto.hpp"
+#include "roq/fix_proxy/tools/nonce_set.hpp"
+#include "roq/fix_proxy/tools/prometheus.hpp"
+#include "roq/fix_proxy/tools/scheduling.hpp"
+#include "roq/fix_proxy/tools/verifier.hpp"
 
 #include "roq/fix_proxy/auth/session.hpp"
 
@@ -28,14 +41,19 @@
 #include "roq/fix_proxy/client/manager.hpp"
 #include "roq/fix_proxy/client/session.hpp"
 
+#include "roq/fix_proxy/service/server.hpp"
+
 namespace roq {
 namespace fix_proxy {
 
 struct Controller final : public io::sys::Signal::Handler,
                           public io::sys::Timer::Handler,
-                          public fix::proxy::Manager::Handler,
+                          public Router<Controller>,
+                          public tools::Verifier::Handler,
+                          public tools::ContextWakeup::Handler,
                           public auth::Session::Handler,
-                          public server::Session::Handler {
+                          public server::Session::Handler,
+                          public service::Server::Handler {
   Controller(Settings const &, Config const &, io::Context &, std::span<std::string_view const> const &connections);
 
   Controller(Controller &&) = delete;
@@ -44,6 +62,11 @@ struct Controller final : public io::sys::Signal::Handler,
   void run();
 
  protected:
+  template <typename, typename, typename...>
+  friend struct ServerRoute;
+  template <typename, typename, typename...>
+  friend struct ClientRoute;
+
   bool ready() const { return ready_; }
 
   // io::sys::Signal::Handler
@@ -54,6 +77,8 @@ struct Controller final : public io::sys::Signal::Handler,
 
   // fix::proxy::Manager::Handler
 
+  using Router<Controller>::operator();
+
   // authentication:
   std::pair<fix::codec::Error, uint32_t> operator()(fix::proxy::Manager::Credentials const &, uint64_t session_id) override;
 
@@ -61,58 +86,18 @@ struct Controller final : public io::sys::Signal::Handler,
   // - connection
   void operator()(Trace<fix::proxy::Manager::Disconnected> const &) override;
   void operator()(Trace<fix::proxy::Manager::Ready> const &) override;
-  // - manager => server
-  void operator()(Trace<fix::codec::Reject> const &) override;
-  void operator()(Trace<fix::codec::Logon> const &) override;
-  void operator()(Trace<fix::codec::Logout> const &) override;
-  void operator()(Trace<fix::codec::Heartbeat> const &) override;
-  void operator()(Trace<fix::codec::TestRequest> const &) override;
-  // - client => server
-  void operator()(Trace<fix::codec::BusinessMessageReject> const &) override;
-  void operator()(Trace<fix::codec::UserRequest> const &) override;
-  void operator()(Trace<fix::codec::TradingSessionStatusRequest> const &) override;
-  void operator()(Trace<fix::codec::SecurityListRequest> const &) override;
-  void operator()(Trace<fix::codec::SecurityDefinitionRequest> const &) override;
-  void operator()(Trace<fix::codec::SecurityStatusRequest> const &) override;
-  void operator()(Trace<fix::codec::MarketDataRequest> const &) override;
-  void operator()(Trace<fix::codec::NewOrderSingle> const &) override;
-  void operator()(Trace<fix::codec::OrderCancelReplaceRequest> const &) override;
-  void operator()(Trace<fix::codec::OrderCancelRequest> const &) override;
-  void operator()(Trace<fix::codec::OrderMassCancelRequest> const &) override;
-  void operator()(Trace<fix::codec::OrderStatusRequest> const &) override;
-  void operator()(Trace<fix::codec::OrderMassStatusRequest> const &) override;
-  void operator()(Trace<fix::codec::TradeCaptureReportRequest> const &) override;
-  void operator()(Trace<fix::codec::RequestForPositions> const &) override;
-  void operator()(Trace<fix::codec::MassQuote> const &) override;
-  void operator()(Trace<fix::codec::QuoteCancel> const &) override;
+  // - messages (see Router)
 
   // client:
   // - connection
   void operator()(Trace<fix::proxy::Manager::Disconnect> const &, uint64_t session_id) override;
-  // - manager => client
-  void operator()(Trace<fix::codec::Reject> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::Logon> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::Logout> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::Heartbeat> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::TestRequest> const &, uint64_t session_id) override;
-  // - server => client
-  void operator()(Trace<fix::codec::BusinessMessageReject> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::TradingSessionStatus> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::SecurityList> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::SecurityDefinition> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::SecurityStatus> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::MarketDataRequestReject> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::MarketDataSnapshotFullRefresh> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::MarketDataIncrementalRefresh> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::ExecutionReport> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::OrderCancelReject> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::OrderMassCancelReport> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::TradeCaptureReportRequestAck> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::TradeCaptureReport> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::RequestForPositionsAck> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::PositionReport> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::MassQuoteAck> const &, uint64_t session_id) override;
-  void operator()(Trace<fix::codec::QuoteStatusReport> const &, uint64_t session_id) override;
+  // - messages (see Router)
+
+  // tools::Verifier::Handler
+  void operator()(tools::Verifier::Result const &) override;
+
+  // tools::ContextWakeup::Handler
+  void operator()(tools::ContextWakeup::Notified const &) override;
 
   // auth::Session::Handler
   void operator()(auth::Session::Insert const &) override;
@@ -122,30 +107,88 @@ struct Controller final : public io::sys::Signal::Handler,
   void operator()(Trace<server::Session::Ready> const &) override;
   void operator()(Trace<server::Session::Disconnected> const &) override;
 
+  // service::Server::Handler
+  void operator()(service::Session::Scrape const &) override;
+
   // utilities
 
+  void write(tools::Prometheus &);
+
+  bool busy_poll() const;
+
+  void configure_thread();
+
+  void spin();
+
+  void poll_shards();
+
+  void refresh(std::chrono::nanoseconds now);
+
   template <typename... Args>
   void dispatch(Args &&...);
 
+  // note! defined here (the overrides generated by Router may be instantiated by any translation unit)
+  // routed by traffic class, falls back to the order entry session if there is no dedicated session (or it is not ready)
+  // also used for requests the dedicated session does not own (e.g. unsubscribing what was subscribed while falling back)
   template <typename T>
-  void dispatch_to_server(Trace<T> const &);
+  void dispatch_to_server(Trace<T> const &event) {
+    constexpr auto traffic_class = Messages::get_traffic_class<T>();
+    if constexpr (traffic_class != TrafficClass::ORDER_ENTRY) {
+      auto &upstream = upstreams_[static_cast<size_t>(traffic_class)];
+      if (static_cast<bool>(upstream) && (*upstream).ready() && (*upstream).send(event)) {
+        return;
+      }
+    }
+    server_session_(event);
+  }
 
   template <typename T>
-  bool dispatch_to_client(Trace<T> const &, uint64_t session_id);
+  bool dispatch_to_client(Trace<T> const &event, uint64_t session_id) {
+    using namespace std::literals;
+    auto success = false;
+    client_manager_.find(session_id, [&](auto &session) {
+      session(event);
+      success = true;
+    });
+    if (!success) {
+      log::warn<0>("Undeliverable: session_id={}"sv, session_id);
+    }
+    return success;
+  }
+
+  bool is_replay(fix::proxy::Manager::Credentials const &);
+
+  template <typename Callback>
+  void for_each_upstream(Callback callback) {
+    for (auto &upstream : upstreams_) {
+      if (static_cast<bool>(upstream)) {
+        callback((*upstream).session());
+      }
+    }
+  }
 
  private:
-  utils::unordered_map<std::string, std::tuple<std::string, uint32_t, std::string>> const username_to_password_and_strategy_id_and_component_id_;
   tools::Crypto crypto_;
+  tools::NonceSet nonce_set_;
   io::Context &context_;
   std::unique_ptr<io::sys::Signal> const terminate_;
   std::unique_ptr<io::sys::Signal> const interrupt_;
   std::unique_ptr<io::sys::Timer> const timer_;
+  std::unique_ptr<tools::Verifier> const verifier_;
+  utils::unordered_map<uint64_t, bool> verified_;  // note! session_id => asynchronous verification result
   std::unique_ptr<fix::proxy::Manager> proxy_;
   Shared shared_;
+  std::unique_ptr<tools::ContextWakeup> const context_wakeup_;  // note! shards wake up the io::Context (when not busy polling)
   std::unique_ptr<auth::Session> auth_session_;
-  server::Session server_session_;
+  server::Session server_session_;                                     // note! order entry
+  std::array<std::unique_ptr<Upstream>, TRAFFIC_CLASSES> upstreams_;  // note! indexed by traffic class (dedicated sessions only)
   client::Manager client_manager_;
+  service::Server service_;
+  std::string metrics_;                                                      // note! the last scrape response
+  std::chrono::nanoseconds next_metrics_ = {};                               // note! the response is rebuilt after this time
+  utils::unordered_map<std::string, client::Session::Statistics> comp_ids_;  // note! aggregated session metrics (reused)
   bool ready_ = {};
+  bool stop_ = {};
 };
 
 }  // namespace fix_proxy
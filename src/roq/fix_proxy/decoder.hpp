@@ -0,0 +1,77 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+#include "roq/fix/message.hpp"
+
+#include "roq/fix_proxy/messages.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// decodes the messages of a type list using a dispatch table indexed by msg_type (generated at compile-time)
+// the decode buffers are passed to the message types requiring them
+// the decoded value may reference the message and the decode buffers
+
+template <typename List>
+struct Decoder;
+
+template <typename... Ts>
+struct Decoder<TypeList<Ts...>> final {
+  using Value = std::variant<std::monostate, Ts...>;
+
+  // note! returns false if msg_type is not supported
+  template <typename Callback>
+  static bool dispatch(
+      fix::Message const &message, std::vector<std::byte> &decode_buffer, std::vector<std::byte> &decode_buffer_2, Callback callback) {
+    auto index = static_cast<size_t>(message.header.msg_type);
+    if (index >= SIZE) [[unlikely]] {
+      return false;
+    }
+    auto function = TABLE<Callback>[index];
+    if (function == nullptr) [[unlikely]] {
+      return false;
+    }
+    (*function)(message, decode_buffer, decode_buffer_2, callback);
+    return true;
+  }
+
+ protected:
+  static constexpr size_t SIZE = std::max({static_cast<size_t>(Ts::MSG_TYPE)...}) + 1;
+
+  static_assert(SIZE <= 4096, "msg_type is expected to be a small enumeration");
+
+  template <typename Callback>
+  using Function = void (*)(fix::Message const &, std::vector<std::byte> &, std::vector<std::byte> &, Callback &);
+
+  template <typename T, typename Callback>
+  static void create(fix::Message const &message, std::vector<std::byte> &decode_buffer, std::vector<std::byte> &decode_buffer_2, Callback &callback) {
+    if constexpr (requires { T::create(message, decode_buffer, decode_buffer_2); }) {
+      auto value = T::create(message, decode_buffer, decode_buffer_2);
+      callback(value);
+    } else if constexpr (requires { T::create(message, decode_buffer); }) {
+      auto value = T::create(message, decode_buffer);
+      callback(value);
+    } else {
+      auto value = T::create(message);
+      callback(value);
+    }
+  }
+
+  template <typename Callback>
+  static constexpr auto TABLE = []() {
+    std::array<Function<Callback>, SIZE> result = {};
+    ((result[static_cast<size_t>(Ts::MSG_TYPE)] = &create<Ts, Callback>), ...);
+    return result;
+  }();
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
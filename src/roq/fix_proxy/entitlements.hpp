@@ -0,0 +1,109 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <nameof.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "roq/logging.hpp"
+
+#include "roq/fix/message.hpp"
+
+#include "roq/fix_proxy/messages.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// the message types a user is allowed to send, compiled into a bitmask indexed by the position in the type list
+// checked using the msg_type of the header, i.e. before the message is decoded
+// session-level messages are always allowed and message types not in the type list are left to the decoder
+// default constructed means everything is allowed, none() means only session-level messages are allowed
+
+template <typename List>
+struct Entitlements;
+
+template <typename... Ts>
+struct Entitlements<TypeList<Ts...>> final {
+  Entitlements() = default;
+
+  // note! used until a logon has been accepted (and for users without credentials)
+  static Entitlements none() { return Entitlements{SESSION}; }
+
+  // note! names are the message types, e.g. "NewOrderSingle" (an empty range means everything is allowed)
+  template <typename R>
+  static Entitlements create(R const &names) {
+    using namespace std::literals;
+    if (std::empty(names)) {
+      return {};
+    }
+    auto mask = SESSION;
+    for (auto &name : names) {
+      if (!is_valid(name)) [[unlikely]] {
+        log::fatal(R"(Unexpected: msg_type="{}")"sv, name);
+      }
+      mask |= Mask{1} << find(name);
+    }
+    return Entitlements{mask};
+  }
+
+  // note! create() terminates if a name is not in the type list
+  static bool is_valid(std::string_view const &name) { return find(name) < sizeof...(Ts); }
+
+  bool operator()(fix::MsgType msg_type) const {
+    auto index = static_cast<size_t>(msg_type);
+    if (index >= SIZE) [[unlikely]] {
+      return true;
+    }
+    return (mask_ & TABLE[index]) != 0;
+  }
+
+  template <typename T>
+  bool contains() const {
+    return (*this)(T::MSG_TYPE);
+  }
+
+ protected:
+  using Mask = uint64_t;
+
+  static_assert(sizeof...(Ts) <= 64, "the type list must fit the mask");
+
+  static constexpr Mask ALL = ~Mask{};
+
+  static constexpr Mask SESSION = []() {
+    Mask result = {};
+    size_t index = 0;
+    ((result |= Messages::SessionLevel::contains<Ts>() ? (Mask{1} << index) : Mask{}, ++index), ...);
+    return result;
+  }();
+
+  static constexpr size_t SIZE = std::max({static_cast<size_t>(Ts::MSG_TYPE)...}) + 1;
+
+  // note! msg_type => bit (all bits when not in the type list)
+  static constexpr auto TABLE = []() {
+    std::array<Mask, SIZE> result;
+    result.fill(ALL);
+    size_t index = 0;
+    ((result[static_cast<size_t>(Ts::MSG_TYPE)] = Mask{1} << index, ++index), ...);
+    return result;
+  }();
+
+  static size_t find(std::string_view const &name) {
+    size_t result = 0;
+    ((nameof::nameof_short_type<Ts>() == name ? false : (++result, true)) && ...);
+    return result;
+  }
+
+  explicit Entitlements(Mask mask) : mask_{mask} {}
+
+ private:
+  Mask mask_ = ALL;
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,53 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/journal.hpp"
+
+#include <algorithm>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+
+// === HELPERS ===
+
+namespace {
+// note! a record must fit in half the ring (larger inbound messages are dropped and reported by the writer)
+auto get_buffer_size(auto &settings) -> size_t {
+  auto max_message = std::max<size_t>(settings.client.encode_buffer_size, settings.server.encode_buffer_size);  // note! largest outbound message
+  auto min_buffer_size = tools::JournalWriter::Channel::get_buffer_size(max_message);
+  size_t result = settings.journal.buffer_size;
+  if (result < min_buffer_size) {
+    log::warn("Journal buffer_size={} is too small for messages of {} bytes, using buffer_size={}"sv, result, max_message, min_buffer_size);
+    result = min_buffer_size;
+  }
+  return result;
+}
+
+auto create_writer(auto &settings) -> std::unique_ptr<tools::JournalWriter> {
+  auto &journal = settings.journal;
+  if (std::empty(journal.path)) {
+    return {};
+  }
+  auto channels = settings.server.pipeline_depth > 0 ? 1 + TRAFFIC_CLASSES : 1;  // note! event loop thread, pipelines
+  auto buffer_size = get_buffer_size(settings);
+  log::info(R"(Journal (path="{}", segment_size={}, buffer_size={}, channels={}))"sv, journal.path, journal.segment_size, buffer_size, channels);
+  auto config = tools::JournalWriter::Config{
+      .path = journal.path,
+      .segment_size = journal.segment_size,
+      .buffer_size = buffer_size,
+      .channels = static_cast<size_t>(channels),
+  };
+  return std::make_unique<tools::JournalWriter>(config);
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Journal::Journal(Settings const &settings) : writer_{create_writer(settings)} {
+}
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,52 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "roq/fix_proxy/messages.hpp"
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/tools/journal.hpp"
+#include "roq/fix_proxy/tools/journal_writer.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// optional capture of raw fix messages (--journal_path), decoded offline by roq-fix-proxy-journal
+// the event loop thread and each pipeline (reader thread) have their own channel
+
+struct Journal final {
+  using Peer = tools::Journal::Peer;
+  using Direction = tools::Journal::Direction;
+  using Channel = tools::JournalWriter::Channel;
+
+  explicit Journal(Settings const &);
+
+  Journal(Journal &&) = delete;
+  Journal(Journal const &) = delete;
+
+  // note! nullptr when disabled
+  Channel *event_loop() { return get(0); }
+  Channel *pipeline(TrafficClass traffic_class) { return get(1 + static_cast<size_t>(traffic_class)); }
+
+  bool enabled() const { return static_cast<bool>(writer_); }
+
+  uint64_t dropped() const { return enabled() ? (*writer_).dropped() : 0; }
+
+ protected:
+  Channel *get(size_t index) {
+    if (!enabled() || index >= std::size(*writer_)) {
+      return nullptr;
+    }
+    return &(*writer_)[index];
+  }
+
+ private:
+  std::unique_ptr<tools::JournalWriter> const writer_;
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
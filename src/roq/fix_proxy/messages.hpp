@@ -0,0 +1,178 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "roq/fix/proxy/manager.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+template <typename... Ts>
+struct TypeList final {
+  static constexpr size_t size() { return sizeof...(Ts); }
+
+  template <typename T>
+  static constexpr bool contains() {
+    return (std::is_same_v<T, Ts> || ...);
+  }
+
+  // note! e.g. apply<std::variant, std::monostate> is std::variant<std::monostate, Ts...>
+  template <template <typename...> typename F, typename... Prefix>
+  using apply = F<Prefix..., Ts...>;
+};
+
+// note!
+// messages sent upstream are partitioned by traffic class, each class may use a dedicated upstream session
+// order entry is the default and its session is the only one required
+
+enum class TrafficClass : uint8_t {
+  ORDER_ENTRY,
+  MARKET_DATA,
+  REFERENCE_DATA,
+};
+
+static constexpr size_t TRAFFIC_CLASSES = 3;
+
+// note!
+// the supported messages, by direction, are only listed here
+// decoders (Decoder), the overrides of fix::proxy::Manager::Handler (Router) and the forwarding done by the sessions are generated
+// adding a message type is therefore a matter of adding it to the relevant lists (the compiler will fail if the proxy manager disagrees)
+
+struct Messages final {
+  // client => proxy (decoded by client::Session)
+  using FromClient = TypeList<
+      fix::codec::Reject,
+      fix::codec::Logon,
+      fix::codec::Logout,
+      fix::codec::Heartbeat,
+      fix::codec::TestRequest,
+      fix::codec::ResendRequest,
+      fix::codec::BusinessMessageReject,
+      fix::codec::TradingSessionStatusRequest,
+      fix::codec::SecurityListRequest,
+      fix::codec::SecurityDefinitionRequest,
+      fix::codec::SecurityStatusRequest,
+      fix::codec::MarketDataRequest,
+      fix::codec::NewOrderSingle,
+      fix::codec::OrderCancelReplaceRequest,
+      fix::codec::OrderCancelRequest,
+      fix::codec::OrderMassCancelRequest,
+      fix::codec::OrderStatusRequest,
+      fix::codec::OrderMassStatusRequest,
+      fix::codec::TradeCaptureReportRequest,
+      fix::codec::RequestForPositions,
+      fix::codec::MassQuote,
+      fix::codec::QuoteCancel>;
+
+  // server => proxy (decoded by server::Session or by the pipeline)
+  using FromServer = TypeList<
+      fix::codec::Reject,
+      fix::codec::Logon,
+      fix::codec::Logout,
+      fix::codec::Heartbeat,
+      fix::codec::TestRequest,
+      fix::codec::ResendRequest,
+      fix::codec::BusinessMessageReject,
+      fix::codec::UserResponse,
+      fix::codec::TradingSessionStatus,
+      fix::codec::SecurityList,
+      fix::codec::SecurityDefinition,
+      fix::codec::SecurityStatus,
+      fix::codec::MarketDataRequestReject,
+      fix::codec::MarketDataSnapshotFullRefresh,
+      fix::codec::MarketDataIncrementalRefresh,
+      fix::codec::ExecutionReport,
+      fix::codec::OrderCancelReject,
+      fix::codec::OrderMassCancelReport,
+      fix::codec::TradeCaptureReportRequestAck,
+      fix::codec::TradeCaptureReport,
+      fix::codec::RequestForPositionsAck,
+      fix::codec::PositionReport,
+      fix::codec::MassQuoteAck,
+      fix::codec::QuoteStatusReport>;
+
+  // proxy manager => server (manager and client requests)
+  using ToServer = TypeList<
+      fix::codec::Reject,
+      fix::codec::Logon,
+      fix::codec::Logout,
+      fix::codec::Heartbeat,
+      fix::codec::TestRequest,
+      fix::codec::BusinessMessageReject,
+      fix::codec::UserRequest,
+      fix::codec::TradingSessionStatusRequest,
+      fix::codec::SecurityListRequest,
+      fix::codec::SecurityDefinitionRequest,
+      fix::codec::SecurityStatusRequest,
+      fix::codec::MarketDataRequest,
+      fix::codec::NewOrderSingle,
+      fix::codec::OrderCancelReplaceRequest,
+      fix::codec::OrderCancelRequest,
+      fix::codec::OrderMassCancelRequest,
+      fix::codec::OrderStatusRequest,
+      fix::codec::OrderMassStatusRequest,
+      fix::codec::TradeCaptureReportRequest,
+      fix::codec::RequestForPositions,
+      fix::codec::MassQuote,
+      fix::codec::QuoteCancel>;
+
+  // proxy manager => client (manager and server responses)
+  using ToClient = TypeList<
+      fix::codec::Reject,
+      fix::codec::Logon,
+      fix::codec::Logout,
+      fix::codec::Heartbeat,
+      fix::codec::TestRequest,
+      fix::codec::BusinessMessageReject,
+      fix::codec::TradingSessionStatus,
+      fix::codec::SecurityList,
+      fix::codec::SecurityDefinition,
+      fix::codec::SecurityStatus,
+      fix::codec::MarketDataRequestReject,
+      fix::codec::MarketDataSnapshotFullRefresh,
+      fix::codec::MarketDataIncrementalRefresh,
+      fix::codec::ExecutionReport,
+      fix::codec::OrderCancelReject,
+      fix::codec::OrderMassCancelReport,
+      fix::codec::TradeCaptureReportRequestAck,
+      fix::codec::TradeCaptureReport,
+      fix::codec::RequestForPositionsAck,
+      fix::codec::PositionReport,
+      fix::codec::MassQuoteAck,
+      fix::codec::QuoteStatusReport>;
+
+  // handled by the proxy manager owning the upstream session (never routed by traffic class)
+  using SessionLevel = TypeList<
+      fix::codec::Reject,
+      fix::codec::Logon,
+      fix::codec::Logout,
+      fix::codec::Heartbeat,
+      fix::codec::TestRequest,
+      fix::codec::ResendRequest>;
+
+  // proxy manager => server (everything else is order entry)
+  using MarketData = TypeList<fix::codec::MarketDataRequest>;
+  using ReferenceData = TypeList<
+      fix::codec::TradingSessionStatusRequest,
+      fix::codec::SecurityListRequest,
+      fix::codec::SecurityDefinitionRequest,
+      fix::codec::SecurityStatusRequest>;
+
+  template <typename T>
+  static constexpr TrafficClass get_traffic_class() {
+    if constexpr (MarketData::contains<T>()) {
+      return TrafficClass::MARKET_DATA;
+    } else if constexpr (ReferenceData::contains<T>()) {
+      return TrafficClass::REFERENCE_DATA;
+    } else {
+      return TrafficClass::ORDER_ENTRY;
+    }
+  }
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,157 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/metrics.hpp"
+
+#include <fmt/format.h>
+
+#include <magic_enum/magic_enum_format.hpp>
+
+#include <cassert>
+#include <initializer_list>
+#include <type_traits>
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+
+// === CONSTANTS ===
+
+namespace {
+size_t const MAX_MSG_TYPES = 32;  // note! per peer and direction (an additional entry is shared by all other message types)
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+// note! event loop thread, shards, pipelines
+auto get_slots(auto &settings) -> size_t {
+  return 1 + settings.client.io_threads + TRAFFIC_CLASSES;
+}
+
+template <typename R>
+auto create_messages() {
+  using result_type = std::remove_cvref_t<R>;
+  result_type result;
+  for (auto &item : result) {
+    item.msg_types.reserve(MAX_MSG_TYPES);
+    item.counts.resize(MAX_MSG_TYPES + 1);
+  }
+  return result;
+}
+
+auto get_index(Metrics::Peer peer, Metrics::Direction direction) {
+  return static_cast<size_t>(peer) * 2 + static_cast<size_t>(direction);
+}
+
+auto get_name(Metrics::Peer peer) {
+  switch (peer) {
+    using enum Metrics::Peer;
+    case CLIENT:
+      return "client"sv;
+    case SERVER:
+      return "server"sv;
+  }
+  assert(false);
+  return std::string_view{};
+}
+
+auto get_name(Metrics::Direction direction) {
+  switch (direction) {
+    using enum Metrics::Direction;
+    case RECEIVED:
+      return "received"sv;
+    case SENT:
+      return "sent"sv;
+  }
+  assert(false);
+  return std::string_view{};
+}
+
+auto get_name(TrafficClass traffic_class) {
+  switch (traffic_class) {
+    using enum TrafficClass;
+    case ORDER_ENTRY:
+      return "order_entry"sv;
+    case MARKET_DATA:
+      return "market_data"sv;
+    case REFERENCE_DATA:
+      return "reference_data"sv;
+  }
+  assert(false);
+  return std::string_view{};
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Metrics::Metrics(Settings const &settings) : counters_{get_slots(settings)}, messages_{create_messages<decltype(messages_)>()} {
+}
+
+void Metrics::message(Peer peer, Direction direction, fix::MsgType msg_type) {
+  auto &[msg_types, counts] = messages_[get_index(peer, direction)];
+  for (size_t i = 0; i < std::size(msg_types); ++i) {
+    if (msg_types[i] == msg_type) [[likely]] {
+      ++counts[i];
+      return;
+    }
+  }
+  if (std::size(msg_types) < MAX_MSG_TYPES) {
+    msg_types.emplace_back(msg_type);  // note! capacity has been reserved
+    ++counts[std::size(msg_types) - 1];
+    return;
+  }
+  ++counts.back();
+}
+
+void Metrics::write(tools::Prometheus &prometheus) const {
+  using enum Counter;
+  using Type = tools::Prometheus::Type;
+  auto helper = [&](auto const &name, auto counter, std::initializer_list<tools::Prometheus::Label> labels) {
+    prometheus.sample(name, labels, counters_.get(counter));
+  };
+  prometheus.describe("roq_fix_proxy_bytes_total"sv, Type::COUNTER, "Bytes received or sent"sv);
+  helper("roq_fix_proxy_bytes_total"sv, CLIENT_BYTES_RECEIVED, {{"peer"sv, "client"sv}, {"direction"sv, "received"sv}});
+  helper("roq_fix_proxy_bytes_total"sv, CLIENT_BYTES_SENT, {{"peer"sv, "client"sv}, {"direction"sv, "sent"sv}});
+  helper("roq_fix_proxy_bytes_total"sv, SERVER_BYTES_RECEIVED, {{"peer"sv, "server"sv}, {"direction"sv, "received"sv}});
+  helper("roq_fix_proxy_bytes_total"sv, SERVER_BYTES_SENT, {{"peer"sv, "server"sv}, {"direction"sv, "sent"sv}});
+  prometheus.describe("roq_fix_proxy_send_failures_total"sv, Type::COUNTER, "Messages which could not be sent"sv);
+  helper("roq_fix_proxy_send_failures_total"sv, CLIENT_SEND_FAILURES, {{"peer"sv, "client"sv}});
+  helper("roq_fix_proxy_send_failures_total"sv, SERVER_SEND_FAILURES, {{"peer"sv, "server"sv}});
+  prometheus.describe("roq_fix_proxy_sequence_gaps_total"sv, Type::COUNTER, "Inbound sequence gaps (or replays)"sv);
+  helper("roq_fix_proxy_sequence_gaps_total"sv, CLIENT_SEQUENCE_GAPS, {{"peer"sv, "client"sv}});
+  helper("roq_fix_proxy_sequence_gaps_total"sv, SERVER_SEQUENCE_GAPS, {{"peer"sv, "server"sv}});
+  prometheus.describe("roq_fix_proxy_logons_total"sv, Type::COUNTER, "Client logon attempts"sv);
+  helper("roq_fix_proxy_logons_total"sv, CLIENT_LOGON_SUCCESS, {{"result"sv, "success"sv}});
+  helper("roq_fix_proxy_logons_total"sv, CLIENT_LOGON_FAILURE, {{"result"sv, "failure"sv}});
+  prometheus.describe("roq_fix_proxy_not_entitled_total"sv, Type::COUNTER, "Client messages rejected by the entitlements"sv);
+  helper("roq_fix_proxy_not_entitled_total"sv, CLIENT_NOT_ENTITLED, {});
+  prometheus.describe("roq_fix_proxy_shard_system_calls_total"sv, Type::COUNTER, "System calls made by the client shards"sv);
+  helper("roq_fix_proxy_shard_system_calls_total"sv, CLIENT_SYSTEM_CALLS, {});
+  prometheus.describe("roq_fix_proxy_messages_total"sv, Type::COUNTER, "Messages received or sent (by message type)"sv);
+  for (auto peer : {Peer::CLIENT, Peer::SERVER}) {
+    for (auto direction : {Direction::RECEIVED, Direction::SENT}) {
+      auto &[msg_types, counts] = messages_[get_index(peer, direction)];
+      auto sample = [&](auto const &msg_type, auto count) {
+        prometheus.sample(
+            "roq_fix_proxy_messages_total"sv, {{"peer"sv, get_name(peer)}, {"direction"sv, get_name(direction)}, {"msg_type"sv, msg_type}}, count);
+      };
+      for (size_t i = 0; i < std::size(msg_types); ++i) {
+        sample(fmt::format("{}"sv, msg_types[i]), counts[i]);
+      }
+      if (counts.back() != 0) {
+        sample("OTHER"sv, counts.back());
+      }
+    }
+  }
+  prometheus.describe("roq_fix_proxy_upstream_state"sv, Type::GAUGE, "Upstream connection (0=disconnected, 1=connected, 2=ready)"sv);
+  for (size_t i = 0; i < std::size(upstream_states_); ++i) {
+    if (upstream_states_[i].has_value()) {
+      auto traffic_class = static_cast<TrafficClass>(i);
+      prometheus.sample("roq_fix_proxy_upstream_state"sv, {{"upstream"sv, get_name(traffic_class)}}, static_cast<uint64_t>(*upstream_states_[i]));
+    }
+  }
+}
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,97 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "roq/fix/message.hpp"
+
+#include "roq/fix_proxy/messages.hpp"
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/tools/counters.hpp"
+#include "roq/fix_proxy/tools/prometheus.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// global counters, only aggregated (and formatted) when scraped
+// each thread owns a counter slot: the event loop thread, then one per shard, then one per pipeline (reader) thread
+// messages are counted by type on the event loop thread (all messages are decoded and encoded there)
+
+struct Metrics final {
+  enum class Counter : uint8_t {
+    CLIENT_BYTES_RECEIVED,
+    CLIENT_BYTES_SENT,
+    CLIENT_SEND_FAILURES,
+    CLIENT_SEQUENCE_GAPS,
+    CLIENT_LOGON_SUCCESS,
+    CLIENT_LOGON_FAILURE,
+    CLIENT_NOT_ENTITLED,
+    CLIENT_SYSTEM_CALLS,  // note! shards only
+    SERVER_BYTES_RECEIVED,
+    SERVER_BYTES_SENT,
+    SERVER_SEND_FAILURES,
+    SERVER_SEQUENCE_GAPS,
+  };
+
+  static constexpr size_t COUNTERS = 12;
+
+  using Counters = tools::Counters<Counter, COUNTERS>;
+  using Slot = Counters::Slot;
+
+  enum class Peer : uint8_t {
+    CLIENT,
+    SERVER,
+  };
+
+  enum class Direction : uint8_t {
+    RECEIVED,
+    SENT,
+  };
+
+  enum class UpstreamState : uint8_t {
+    DISCONNECTED,
+    CONNECTED,
+    READY,
+  };
+
+  explicit Metrics(Settings const &);
+
+  Metrics(Metrics &&) = delete;
+  Metrics(Metrics const &) = delete;
+
+  // note! the owner of a slot is the only thread allowed to update it
+
+  Slot &event_loop() { return counters_[0]; }
+  Slot &shard(uint32_t index) { return counters_[1 + index]; }
+  Slot &pipeline(TrafficClass traffic_class) { return counters_[std::size(counters_) - TRAFFIC_CLASSES + static_cast<size_t>(traffic_class)]; }
+
+  // note! the following methods may only be called from the event loop thread
+
+  void message(Peer, Direction, fix::MsgType);
+
+  void upstream(TrafficClass traffic_class, UpstreamState state) { upstream_states_[static_cast<size_t>(traffic_class)] = state; }
+
+  void write(tools::Prometheus &) const;
+
+ protected:
+  struct Messages final {
+    std::vector<fix::MsgType> msg_types;  // note! searched linearly (few message types)
+    std::vector<uint64_t> counts;         // note! preallocated, assigned on first use (the last entry is shared when exhausted)
+  };
+
+  static constexpr size_t MESSAGES = 4;  // note! peer x direction
+
+ private:
+  Counters counters_;
+  std::array<Messages, MESSAGES> messages_;
+  std::array<std::optional<UpstreamState>, TRAFFIC_CLASSES> upstream_states_;  // note! only the upstream sessions being used
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
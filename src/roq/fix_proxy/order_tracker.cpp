@@ -0,0 +1,237 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/order_tracker.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+
+// === CONSTANTS ===
+
+namespace {
+auto const STATISTICS_FREQUENCY = 60s;
+
+uint64_t const HIGHEST_TRACKABLE_LATENCY = std::chrono::nanoseconds{10s}.count();
+uint32_t const SIGNIFICANT_FIGURES = 2;
+
+// note! upper bounds of the prometheus histogram buckets
+std::array<uint64_t, 19> const BUCKETS{
+    10000,
+    25000,
+    50000,
+    100000,
+    250000,
+    500000,
+    1000000,
+    2500000,
+    5000000,
+    10000000,
+    25000000,
+    50000000,
+    100000000,
+    250000000,
+    500000000,
+    1000000000,
+    2500000000,
+    5000000000,
+    10000000000,
+};
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_histogram() {
+  return tools::Histogram{HIGHEST_TRACKABLE_LATENCY, SIGNIFICANT_FIGURES};
+}
+
+auto create_buckets() {
+  return tools::Buckets{BUCKETS};
+}
+
+auto summary(auto &histogram) {
+  return fmt::format(
+      "{{p50={}ns, p99={}ns, max={}ns}}"sv, histogram.value_at_percentile(50.0), histogram.value_at_percentile(99.0), histogram.max());
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+OrderTracker::OrderTracker(Settings const &settings)
+    : timeout_{settings.server.order_timeout}, table_{settings.server.order_tracking_capacity} {
+  log::info("Memory usage: order_tracker={}"sv, memory_usage());
+}
+
+uint32_t OrderTracker::add_upstream(std::string_view const &name) {
+  upstreams_.push_back({
+      .name = std::string{name},
+      .statistics{
+          .latency = create_histogram(),
+          .buckets = create_buckets(),
+      },
+  });
+  return static_cast<uint32_t>(std::size(upstreams_) - 1);
+}
+
+void OrderTracker::request(uint32_t upstream, std::string_view const &cl_ord_id, std::chrono::nanoseconds send_time) {
+  if (!enabled()) {
+    return;
+  }
+  auto order = Order{
+      .send_time = send_time,
+      .strategy_id = strategy_id_,
+      .upstream = upstream,
+  };
+  strategy_id_ = {};
+  if (!table_.insert(cl_ord_id, order)) [[unlikely]] {
+    ++untracked_;
+    return;
+  }
+  ++upstreams_[upstream].statistics.requests;
+  ++get_strategy(order.strategy_id).requests;
+}
+
+void OrderTracker::response(uint32_t upstream, std::string_view const &cl_ord_id, std::chrono::nanoseconds receive_time) {
+  Order order;
+  if (!table_.extract(cl_ord_id, order)) {
+    return;  // note! not a request (e.g. a fill) or not the first response
+  }
+  auto latency = static_cast<uint64_t>(std::max<int64_t>((receive_time - order.send_time).count(), 0));  // note! clamped (clock resolution)
+  for (auto statistics : {&upstreams_[upstream].statistics, &get_strategy(order.strategy_id)}) {
+    (*statistics).latency.record(latency);
+    (*statistics).buckets.record(latency);
+    ++(*statistics).responses;
+  }
+}
+
+void OrderTracker::disconnected(uint32_t upstream) {
+  table_.erase_if([&]([[maybe_unused]] auto const &cl_ord_id, auto const &order) {
+    if (order.upstream != upstream) {
+      return false;
+    }
+    unanswered(order);
+    return true;
+  });
+}
+
+void OrderTracker::refresh(std::chrono::nanoseconds now) {
+  if (!std::empty(table_)) {
+    auto expired = now - timeout_;
+    table_.erase_if([&]([[maybe_unused]] auto const &cl_ord_id, auto const &order) {
+      if (expired < order.send_time) {
+        return false;
+      }
+      unanswered(order);
+      return true;
+    });
+  }
+  if (now < next_statistics_) {
+    return;
+  }
+  next_statistics_ = now + STATISTICS_FREQUENCY;
+  statistics();
+}
+
+size_t OrderTracker::memory_usage() const {
+  auto result = sizeof(*this) + table_.memory_usage();
+  for (auto &item : upstreams_) {
+    result += sizeof(item) + item.statistics.latency.memory_usage() + item.statistics.buckets.memory_usage();
+  }
+  for (auto &[_, item] : strategies_) {
+    result += sizeof(item) + item.latency.memory_usage() + item.buckets.memory_usage();
+  }
+  return result;
+}
+
+void OrderTracker::write(tools::Prometheus &prometheus) const {
+  using Type = tools::Prometheus::Type;
+  if (!enabled()) {
+    return;
+  }
+  auto helper = [&](auto const &prefix, auto const &label, auto get_items) {
+    auto latency = fmt::format("roq_fix_proxy_{}order_latency_nanoseconds"sv, prefix);
+    auto orders = fmt::format("roq_fix_proxy_{}orders_total"sv, prefix);
+    prometheus.describe(latency, Type::HISTOGRAM, "Order round-trip latency excluding the proxy"sv);
+    get_items([&](auto const &value, auto &statistics) {
+      if (statistics.buckets.count() == 0) {
+        return;
+      }
+      prometheus.histogram(latency, {{label, value}}, statistics.buckets);
+    });
+    prometheus.describe(orders, Type::COUNTER, "Order requests sent upstream (by status)"sv);
+    get_items([&](auto const &value, auto &statistics) {
+      prometheus.sample(orders, {{label, value}, {"status"sv, "sent"sv}}, statistics.requests);
+      prometheus.sample(orders, {{label, value}, {"status"sv, "answered"sv}}, statistics.responses);
+      prometheus.sample(orders, {{label, value}, {"status"sv, "unanswered"sv}}, statistics.unanswered);
+    });
+  };
+  helper(""sv, "upstream"sv, [&](auto callback) {
+    for (auto &item : upstreams_) {
+      callback(item.name, item.statistics);
+    }
+  });
+  helper("strategy_"sv, "strategy_id"sv, [&](auto callback) {
+    for (auto &[strategy_id, statistics] : strategies_) {
+      callback(fmt::format("{}"sv, strategy_id), statistics);
+    }
+  });
+  prometheus.describe("roq_fix_proxy_orders_untracked_total"sv, Type::COUNTER, "Order requests not tracked (table full or ClOrdID too long)"sv);
+  prometheus.sample("roq_fix_proxy_orders_untracked_total"sv, {}, untracked_);
+  prometheus.describe("roq_fix_proxy_orders_outstanding"sv, Type::GAUGE, "Order requests waiting for a response"sv);
+  prometheus.sample("roq_fix_proxy_orders_outstanding"sv, {}, uint64_t{std::size(table_)});
+}
+
+OrderTracker::Statistics &OrderTracker::get_strategy(uint32_t strategy_id) {
+  auto iter = strategies_.find(strategy_id);
+  if (iter != std::end(strategies_)) [[likely]] {
+    return (*iter).second;
+  }
+  auto statistics = Statistics{
+      .latency = create_histogram(),
+      .buckets = create_buckets(),
+  };
+  return (*strategies_.try_emplace(strategy_id, std::move(statistics)).first).second;
+}
+
+void OrderTracker::unanswered(Order const &order) {
+  ++upstreams_[order.upstream].statistics.unanswered;
+  ++get_strategy(order.strategy_id).unanswered;
+}
+
+void OrderTracker::statistics() {
+  auto helper = [&](auto const &label, auto const &value, auto &statistics) {
+    auto &latency = statistics.latency;
+    if (latency.count() == 0 && statistics.unanswered == 0) {
+      return;
+    }
+    log::info(
+        "Orders: {}={}, sent={}, answered={}, unanswered={}, latency={}"sv,
+        label,
+        value,
+        statistics.requests,
+        statistics.responses,
+        statistics.unanswered,
+        summary(latency));
+    latency.reset();
+  };
+  for (auto &item : upstreams_) {
+    helper("upstream"sv, item.name, item.statistics);
+  }
+  for (auto &[strategy_id, statistics] : strategies_) {
+    helper("strategy_id"sv, strategy_id, statistics);
+  }
+  if (untracked_ > 0) {
+    log::warn("Orders: untracked={}, outstanding={}"sv, untracked_, std::size(table_));
+  }
+}
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,113 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "roq/utils/container.hpp"
+
+#include "roq/fix/codec/execution_report.hpp"
+#include "roq/fix/codec/new_order_single.hpp"
+#include "roq/fix/codec/order_cancel_reject.hpp"
+#include "roq/fix/codec/order_cancel_replace_request.hpp"
+#include "roq/fix/codec/order_cancel_request.hpp"
+
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/tools/buckets.hpp"
+#include "roq/fix_proxy/tools/histogram.hpp"
+#include "roq/fix_proxy/tools/order_table.hpp"
+#include "roq/fix_proxy/tools/prometheus.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// round-trip latency of order requests sent upstream (NewOrderSingle, OrderCancelReplaceRequest, OrderCancelRequest)
+// requests are keyed by the ClOrdID sent upstream and matched by the first ExecutionReport or OrderCancelReject with that ClOrdID
+// latency is from the request being sent until the response was read from the socket, i.e. excluding the proxy itself (see Tracer)
+// the strategy is prepared by the client session (the proxy manager forwards requests synchronously)
+// requests are counted as unanswered when timing out or when the upstream connection is lost
+// only used by the event loop thread, the table is preallocated (histograms are allocated on first use of a strategy)
+
+struct OrderTracker final {
+  template <typename T>
+  static constexpr bool is_request() {
+    return std::is_same_v<T, fix::codec::NewOrderSingle> || std::is_same_v<T, fix::codec::OrderCancelReplaceRequest> ||
+           std::is_same_v<T, fix::codec::OrderCancelRequest>;
+  }
+
+  template <typename T>
+  static constexpr bool is_response() {
+    return std::is_same_v<T, fix::codec::ExecutionReport> || std::is_same_v<T, fix::codec::OrderCancelReject>;
+  }
+
+  explicit OrderTracker(Settings const &);
+
+  OrderTracker(OrderTracker &&) = delete;
+  OrderTracker(OrderTracker const &) = delete;
+
+  bool enabled() const { return table_.capacity() > 0; }
+
+  // note! returns the index identifying the upstream
+  uint32_t add_upstream(std::string_view const &name);
+
+  void prepare(uint32_t strategy_id) { strategy_id_ = strategy_id; }
+
+  void request(uint32_t upstream, std::string_view const &cl_ord_id, std::chrono::nanoseconds send_time);
+  void response(uint32_t upstream, std::string_view const &cl_ord_id, std::chrono::nanoseconds receive_time);
+
+  // note! outstanding requests will never receive a response
+  void disconnected(uint32_t upstream);
+
+  // note! times out requests and periodically logs (and resets) the histograms
+  void refresh(std::chrono::nanoseconds now);
+
+  size_t memory_usage() const;
+
+  // note! cumulative since start
+  void write(tools::Prometheus &) const;
+
+ protected:
+  struct Order final {
+    std::chrono::nanoseconds send_time = {};
+    uint32_t strategy_id = {};
+    uint32_t upstream = {};
+  };
+
+  struct Statistics final {
+    tools::Histogram latency;  // note! reset by the periodic log
+    tools::Buckets buckets;    // note! never reset (prometheus)
+    uint64_t requests = {};
+    uint64_t responses = {};
+    uint64_t unanswered = {};
+  };
+
+  struct Upstream final {
+    std::string name;
+    Statistics statistics;
+  };
+
+  Statistics &get_strategy(uint32_t strategy_id);
+
+  void unanswered(Order const &);
+
+  void statistics();
+
+ private:
+  std::chrono::nanoseconds const timeout_;
+  tools::OrderTable<Order> table_;
+  std::vector<Upstream> upstreams_;
+  utils::unordered_map<uint32_t, Statistics> strategies_;
+  uint32_t strategy_id_ = {};  // note! prepared by the client session
+  uint64_t untracked_ = {};    // note! table was full or ClOrdID too long
+  std::chrono::nanoseconds next_statistics_ = {};
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,130 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/profiler.hpp"
+
+#include <fmt/format.h>
+
+#include <cassert>
+#include <iterator>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+
+// === CONSTANTS ===
+
+namespace {
+auto const CALIBRATION_PERIOD = 10ms;
+auto const LOG_INTERVAL = 1s;  // note! at most one stall is logged per interval
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto get_name(Profiler::Callback callback) {
+  switch (callback) {
+    using enum Profiler::Callback;
+    case SERVER_READ:
+      return "server_read"sv;
+    case CLIENT_READ:
+      return "client_read"sv;
+    case TIMER:
+      return "timer"sv;
+    case AUTH:
+      return "auth"sv;
+    case VERIFIER:
+      return "verifier"sv;
+    case SERVICE:
+      return "service"sv;
+  }
+  assert(false);
+  return std::string_view{};
+}
+
+auto calibrate() {
+  auto result = tools::TSC::calibrate(CALIBRATION_PERIOD);
+  log::info("TSC: cycles_per_nanosecond={:.3f}"sv, result);
+  return result;
+}
+
+auto get_budget(auto &settings, auto cycles_per_nanosecond) {
+  return static_cast<uint64_t>(static_cast<double>(settings.loop.stall_budget.count()) * cycles_per_nanosecond);
+}
+
+auto get_log_interval(auto cycles_per_nanosecond) {
+  return static_cast<uint64_t>(static_cast<double>(std::chrono::nanoseconds{LOG_INTERVAL}.count()) * cycles_per_nanosecond);
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Profiler::Profiler(Settings const &settings)
+    : cycles_per_nanosecond_{calibrate()}, budget_{get_budget(settings, cycles_per_nanosecond_)}, log_interval_{get_log_interval(cycles_per_nanosecond_)} {
+}
+
+void Profiler::write(tools::Prometheus &prometheus) const {
+  using Type = tools::Prometheus::Type;
+  prometheus.describe("roq_fix_proxy_callback_seconds_total"sv, Type::COUNTER, "Time spent by event loop callbacks (by callback)"sv);
+  for (size_t i = 0; i < CALLBACKS; ++i) {
+    auto name = get_name(static_cast<Callback>(i));
+    prometheus.sample("roq_fix_proxy_callback_seconds_total"sv, {{"callback"sv, name}}, to_seconds(totals_[i].cycles));
+  }
+  prometheus.describe("roq_fix_proxy_callbacks_total"sv, Type::COUNTER, "Event loop callbacks (by callback)"sv);
+  for (size_t i = 0; i < CALLBACKS; ++i) {
+    auto name = get_name(static_cast<Callback>(i));
+    prometheus.sample("roq_fix_proxy_callbacks_total"sv, {{"callback"sv, name}}, totals_[i].calls);
+  }
+  prometheus.describe("roq_fix_proxy_stalls_total"sv, Type::COUNTER, "Event loop iterations exceeding the stall budget"sv);
+  prometheus.sample("roq_fix_proxy_stalls_total"sv, {}, stalls_);
+}
+
+// note! formatting is only done when a stall is logged, stalls detected within the log interval are only counted
+void Profiler::finish() {
+  dirty_ = false;
+  uint64_t cycles = {};
+  for (auto &item : current_) {
+    cycles += item.cycles;
+  }
+  if (budget_ > 0 && budget_ < cycles) [[unlikely]] {
+    ++stalls_;
+    auto now = tools::TSC::now();
+    if (now < next_log_) {
+      ++suppressed_;
+      current_ = {};
+      return;
+    }
+    next_log_ = now + log_interval_;
+    fmt::memory_buffer breakdown;
+    for (size_t i = 0; i < CALLBACKS; ++i) {
+      auto &item = current_[i];
+      if (item.calls == 0) {
+        continue;
+      }
+      auto callback = static_cast<Callback>(i);
+      fmt::format_to(
+          std::back_inserter(breakdown), ", {}={{calls={}, duration={:.1f}us"sv, get_name(callback), item.calls, to_seconds(item.cycles) * 1.0e6);
+      if (callback == Callback::CLIENT_READ) {
+        fmt::format_to(std::back_inserter(breakdown), ", max={:.1f}us, session_id={}"sv, to_seconds(item.max_cycles) * 1.0e6, item.max_id);
+      }
+      fmt::format_to(std::back_inserter(breakdown), "}}"sv);
+    }
+    log::warn(
+        "*** STALL *** duration={:.1f}us (budget={:.1f}us){} (suppressed={})"sv,
+        to_seconds(cycles) * 1.0e6,
+        to_seconds(budget_) * 1.0e6,
+        std::string_view{std::data(breakdown), std::size(breakdown)},
+        suppressed_);
+    suppressed_ = {};
+  }
+  current_ = {};
+}
+
+double Profiler::to_seconds(uint64_t cycles) const {
+  return static_cast<double>(cycles) / (cycles_per_nanosecond_ * 1.0e9);
+}
+
+}  // namespace fix_proxy
+}  // namespace roq
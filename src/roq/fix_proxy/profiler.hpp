@@ -0,0 +1,122 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/tools/prometheus.hpp"
+#include "roq/fix_proxy/tools/tsc.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// cycle accounting of the callbacks run by the event loop thread (using the time-stamp counter)
+// only the outermost callback is accounted, e.g. routing and sending is included in the read which triggered it
+// an iteration is one pass of the busy polling loop or, when blocking, a single callback
+// iterations exceeding the budget are logged with their breakdown (by callback, client reads also by the most expensive session)
+// logging is rate limited, the next log line includes the number of stalls suppressed since the previous one (all are counted by the metrics)
+// only used by the event loop thread
+
+struct Profiler final {
+  enum class Callback : uint8_t {
+    SERVER_READ,
+    CLIENT_READ,
+    TIMER,
+    AUTH,
+    VERIFIER,
+    SERVICE,
+  };
+
+  static constexpr size_t CALLBACKS = 6;
+
+  struct Scope final {
+    Scope(Profiler &profiler, Callback callback, uint64_t id = {}) : profiler_{profiler}, callback_{callback}, id_{id}, start_{profiler.enter()} {}
+
+    Scope(Scope &&) = delete;
+    Scope(Scope const &) = delete;
+
+    ~Scope() { profiler_.leave(callback_, id_, start_); }
+
+   private:
+    Profiler &profiler_;
+    Callback const callback_;
+    uint64_t const id_;
+    uint64_t const start_;
+  };
+
+  explicit Profiler(Settings const &);
+
+  Profiler(Profiler &&) = delete;
+  Profiler(Profiler const &) = delete;
+
+  // note! only used when busy polling
+  void begin() { iteration_ = true; }
+  void end() {
+    iteration_ = false;
+    if (dirty_) {
+      finish();
+    }
+  }
+
+  void write(tools::Prometheus &) const;
+
+ protected:
+  uint64_t enter() { return depth_++ == 0 ? tools::TSC::now() : 0; }
+
+  void leave(Callback callback, uint64_t id, uint64_t start) {
+    if (--depth_ != 0) {
+      return;
+    }
+    auto cycles = tools::TSC::now() - start;
+    auto index = static_cast<size_t>(callback);
+    auto &current = current_[index];
+    current.cycles += cycles;
+    ++current.calls;
+    if (current.max_cycles < cycles) {
+      current.max_cycles = cycles;
+      current.max_id = id;
+    }
+    auto &total = totals_[index];
+    total.cycles += cycles;
+    ++total.calls;
+    dirty_ = true;
+    if (!iteration_) {
+      finish();
+    }
+  }
+
+  void finish();
+
+  double to_seconds(uint64_t cycles) const;
+
+ private:
+  double const cycles_per_nanosecond_;
+  uint64_t const budget_;        // note! cycles (zero means stalls are not detected)
+  uint64_t const log_interval_;  // note! cycles
+  uint32_t depth_ = {};
+  bool iteration_ = {};
+  bool dirty_ = {};
+  struct Current final {
+    uint64_t cycles = {};
+    uint64_t calls = {};
+    uint64_t max_cycles = {};
+    uint64_t max_id = {};  // note! session id of the most expensive call (client reads)
+  };
+  std::array<Current, CALLBACKS> current_ = {};
+  struct Total final {
+    uint64_t cycles = {};
+    uint64_t calls = {};
+  };
+  std::array<Total, CALLBACKS> totals_ = {};
+  uint64_t stalls_ = {};
+  uint64_t next_log_ = {};  // note! cycles
+  uint64_t suppressed_ = {};
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
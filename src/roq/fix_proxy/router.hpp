@@ -0,0 +1,50 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstdint>
+
+#include "roq/trace.hpp"
+
+#include "roq/fix/proxy/manager.hpp"
+
+#include "roq/fix_proxy/messages.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// implements the message overrides of fix::proxy::Manager::Handler (generated from Messages::ToServer and Messages::ToClient)
+// messages are forwarded (non-virtual) to Derived::dispatch_to_server and Derived::dispatch_to_client
+// the overrides are final, i.e. the only virtual call is the one made by the proxy manager
+// authentication and connection events are not messages and must be implemented by Derived
+
+template <typename Derived, typename Base, typename... Ts>
+struct ServerRoute : public Base {
+  using Base::operator();
+};
+
+template <typename Derived, typename Base, typename T, typename... Ts>
+struct ServerRoute<Derived, Base, T, Ts...> : public ServerRoute<Derived, Base, Ts...> {
+  using ServerRoute<Derived, Base, Ts...>::operator();
+
+  void operator()(Trace<T> const &event) final { static_cast<Derived &>(*this).dispatch_to_server(event); }
+};
+
+template <typename Derived, typename Base, typename... Ts>
+struct ClientRoute : public Base {
+  using Base::operator();
+};
+
+template <typename Derived, typename Base, typename T, typename... Ts>
+struct ClientRoute<Derived, Base, T, Ts...> : public ClientRoute<Derived, Base, Ts...> {
+  using ClientRoute<Derived, Base, Ts...>::operator();
+
+  void operator()(Trace<T> const &event, uint64_t session_id) final { static_cast<Derived &>(*this).dispatch_to_client(event, session_id); }
+};
+
+template <typename Derived>
+using Router = Messages::ToClient::apply<ClientRoute, Derived, Messages::ToServer::apply<ServerRoute, Derived, fix::proxy::Manager::Handler>>;
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,329 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/server/pipeline.hpp"
+
+#include <magic_enum/magic_enum_format.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <exception>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+#include "roq/utils/debug/fix/message.hpp"
+
+#include "roq/io/engine/context_factory.hpp"
+
+#include "roq/fix/reader.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace server {
+
+// === CONSTANTS ===
+
+namespace {
+auto const FIX_VERSION = fix::Version::FIX_44;
+
+auto const REFRESH_FREQUENCY = 100ms;
+auto const ENCODE_BUFFER_QUIET_PERIOD = 60s;
+
+auto const BACKPRESSURE_TIMEOUT = 100ms;  // note! the reader thread is never blocked, a full ring buffer for this long means it is stuck
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_connection_factory(auto &settings, auto &context, auto &uri) {
+  log::debug("uri={}"sv, uri);
+  auto config = io::net::ConnectionFactory::Config{
+      .interface = {},
+      .uris = {&uri, 1},
+      .validate_certificate = settings.net.tls_validate_certificate,
+  };
+  return io::net::ConnectionFactory::create(context, config);
+}
+
+auto create_connection_manager(auto &handler, auto &settings, auto &connection_factory) {
+  auto config = io::net::ConnectionManager::Config{
+      .connection_timeout = settings.net.connection_timeout,
+      .disconnect_on_idle_timeout = {},
+      .always_reconnect = true,
+  };
+  return io::net::ConnectionManager::create(handler, connection_factory, config);
+}
+
+template <typename R>
+auto create_slots(auto &settings) {
+  using result_type = std::remove_cvref_t<R>;
+  result_type result(settings.server.pipeline_depth);
+  for (auto &item : result) {
+    item.decode_buffer.resize(settings.server.decode_buffer_size);
+    item.decode_buffer_2.resize(settings.server.decode_buffer_size);
+  }
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Pipeline::Pipeline(Settings const &settings, io::web::URI const &uri, Metrics::Slot &metrics, Journal::Channel *journal)
+    : debug_{settings.server.debug}, frame_scanner_{settings.server.validate_checksum}, context_{io::engine::ContextFactory::create()},
+      connection_factory_{create_connection_factory(settings, *context_, uri)},
+      connection_manager_{create_connection_manager(*this, settings, *connection_factory_)}, slots_{create_slots<decltype(slots_)>(settings)},
+      free_{std::size(slots_)}, ready_{std::size(slots_)}, outbound_{4 * settings.server.encode_buffer_size},
+      encode_buffer_{settings.server.encode_buffer_size, ENCODE_BUFFER_QUIET_PERIOD}, metrics_{metrics}, journal_{journal} {
+  for (uint32_t i = 0; i < std::size(slots_); ++i) {
+    [[maybe_unused]] auto success = free_.try_push(i);
+    assert(success);
+  }
+  log::info(
+      "Using a pipeline of {} slot(s) to decode upstream messages (validate_checksum={}, avx2={})"sv,
+      std::size(slots_),
+      settings.server.validate_checksum,
+      tools::FrameScanner::has_avx2());
+  thread_ = std::thread{[this]() { run(); }};
+}
+
+Pipeline::~Pipeline() {
+  stop_.store(true, std::memory_order_release);
+  thread_.join();
+}
+
+size_t Pipeline::poll(Handler &handler) {
+  size_t result = 0;
+  auto helper = [&](auto index) {
+    auto &slot = slots_[index];
+    switch (slot.type) {
+      using enum Slot::Type;
+      case CONNECTED:
+        handler(Connected{});
+        break;
+      case DISCONNECTED:
+        handler(Disconnected{});
+        break;
+      case DECODED: {
+        auto decoded = Decoded{
+            .trace_info = slot.trace_info,
+            .header = slot.header,
+            .value = slot.value,
+            .decode_start = slot.decode_start,
+            .decode_end = slot.decode_end,
+        };
+        handler(decoded);
+        break;
+      }
+    }
+    [[maybe_unused]] auto success = free_.try_push(index);  // note! can't fail (same capacity)
+    assert(success);
+    ++result;
+  };
+  while (ready_.try_pop(helper)) {
+  }
+  return result;
+}
+
+void Pipeline::start() {
+  write(Command::START, {});
+}
+
+void Pipeline::stop() {
+  write(Command::STOP, {});
+}
+
+void Pipeline::close() {
+  write(Command::CLOSE, {});
+}
+
+// io::net::ConnectionManager::Handler
+
+void Pipeline::operator()(io::net::ConnectionManager::Connected const &) {
+  notify(Slot::Type::CONNECTED);
+}
+
+void Pipeline::operator()(io::net::ConnectionManager::Disconnected const &) {
+  pending_ = false;
+  notify(Slot::Type::DISCONNECTED);
+}
+
+void Pipeline::operator()(io::net::ConnectionManager::Read const &) {
+  receive_time_ = clock::get_system();
+  read();
+}
+
+void Pipeline::operator()(io::net::ConnectionManager::Write const &) {
+}
+
+// utilities
+
+// note! backpressure: waits for the reader thread to drain the ring buffer (messages are never dropped)
+bool Pipeline::write(Command command, std::span<std::byte const> const &payload) {
+  auto helper = [&](auto data) {
+    std::memcpy(std::data(data), &command, sizeof(command));
+    if (!std::empty(payload)) {
+      std::memcpy(std::data(data) + sizeof(command), std::data(payload), std::size(payload));
+    }
+  };
+  if (outbound_.write(sizeof(command) + std::size(payload), helper)) [[likely]] {
+    return true;
+  }
+  auto deadline = clock::get_system() + BACKPRESSURE_TIMEOUT;
+  while (!outbound_.write(sizeof(command) + std::size(payload), helper)) {
+    if (clock::get_system() > deadline) [[unlikely]] {
+      log::error("Unable to forward command={} to the reader thread (timeout={})"sv, command, BACKPRESSURE_TIMEOUT);
+      return false;
+    }
+    std::this_thread::yield();  // note! reader thread is draining
+  }
+  return true;
+}
+
+// note! reader thread
+
+void Pipeline::run() {
+  log::info("Pipeline is now running"sv);
+  auto helper = [&](auto &buffer) {
+    Command command;
+    std::memcpy(&command, std::data(buffer), sizeof(command));
+    process(command, buffer.subspan(sizeof(command)));
+  };
+  while (!stop_.load(std::memory_order_acquire)) {
+    (*context_).drain();
+    while (outbound_.read(helper)) {
+    }
+    if (pending_) {
+      read();
+    }
+    auto now = clock::get_system();
+    if (next_refresh_ <= now) {
+      next_refresh_ = now + REFRESH_FREQUENCY;
+      (*connection_manager_).refresh(now);
+    }
+  }
+  log::info("Pipeline has terminated"sv);
+}
+
+void Pipeline::process(Command command, std::span<std::byte const> const &payload) {
+  switch (command) {
+    using enum Command;
+    case START:
+      (*connection_manager_).start();
+      break;
+    case STOP:
+      (*connection_manager_).stop();
+      break;
+    case CLOSE:
+      (*connection_manager_).close();
+      break;
+    case SEND: {
+      auto helper = [&](auto &buffer) {
+        assert(std::size(payload) <= std::size(buffer));
+        std::memcpy(std::data(buffer), std::data(payload), std::size(payload));
+        return std::size(payload);
+      };
+      if ((*connection_manager_).send(helper)) {
+        metrics_.add(Metrics::Counter::SERVER_BYTES_SENT, std::size(payload));
+      } else {
+        metrics_.add(Metrics::Counter::SERVER_SEND_FAILURES);
+        log::warn("Unable to send, closing connection"sv);
+        (*connection_manager_).close();
+      }
+      break;
+    }
+  }
+}
+
+void Pipeline::read() {
+  pending_ = false;
+  auto buffer = (*connection_manager_).buffer();
+  frames_.clear();
+  auto [bytes, status] = frame_scanner_.scan(buffer, frames_);
+  size_t total_bytes = 0;
+  try {
+    for (auto &frame : frames_) {
+      if (debug_) [[unlikely]] {
+        log::info("{}"sv, utils::debug::fix::Message{frame});
+      }
+      auto slot = acquire();
+      if (slot == nullptr) [[unlikely]] {
+        pending_ = true;  // note! retried once the event loop thread has released a slot
+        break;
+      }
+      if (journal_ != nullptr) [[unlikely]] {
+        (*journal_).write(Journal::Peer::SERVER, Journal::Direction::INBOUND, 0, receive_time_, frame);  // note! before decoding (which may throw)
+      }
+      if (decode(*slot, frame)) {
+        commit();
+      }
+      total_bytes += std::size(frame);
+    }
+  } catch (std::exception &e) {
+    log::warn("{}"sv, utils::debug::fix::Message{buffer.subspan(total_bytes)});
+    log::error(R"(Message could not be parsed. PLEASE REPORT! (what="{}"))"sv, e.what());
+    (*connection_manager_).close();
+  }
+  if (status != tools::FrameScanner::Status::OK && total_bytes == bytes) [[unlikely]] {
+    log::warn("{}"sv, utils::debug::fix::Message{buffer.subspan(total_bytes)});
+    log::error("Message could not be framed (status={})"sv, status);
+    (*connection_manager_).close();
+  }
+  metrics_.add(Metrics::Counter::SERVER_BYTES_RECEIVED, total_bytes);
+  (*connection_manager_).drain(total_bytes);
+}
+
+bool Pipeline::decode(Slot &slot, std::span<std::byte const> const &message) {
+  auto decode_start = clock::get_system();
+  slot.raw.assign(std::begin(message), std::end(message));  // note! capacity is retained
+  auto result = false;
+  auto parser = [&](auto &message) {
+    result = Decoder::dispatch(message, slot.decode_buffer, slot.decode_buffer_2, [&](auto &value) { slot.value = value; });
+    if (!result) {
+      log::warn("Unexpected msg_type={}"sv, message.header.msg_type);
+      return;
+    }
+    slot.type = Slot::Type::DECODED;
+    slot.trace_info = {};
+    slot.trace_info.source_receive_time = receive_time_;
+    slot.decode_start = decode_start;
+    slot.decode_end = clock::get_system();
+    slot.header = message.header;
+  };
+  auto logger = []([[maybe_unused]] auto &message) {};
+  fix::Reader<FIX_VERSION>::dispatch(std::span<std::byte const>{slot.raw}, parser, logger);
+  return result;
+}
+
+void Pipeline::notify(Slot::Type type) {
+  while (acquire() == nullptr) {
+    if (stop_.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::this_thread::yield();  // note! event loop thread is draining
+  }
+  (*slot_).type = type;
+  commit();
+}
+
+Pipeline::Slot *Pipeline::acquire() {
+  if (slot_ == nullptr) {
+    free_.try_pop([&](auto index) {
+      index_ = index;
+      slot_ = &slots_[index];
+    });
+  }
+  return slot_;
+}
+
+void Pipeline::commit() {
+  assert(slot_ != nullptr);
+  [[maybe_unused]] auto success = ready_.try_push(index_);  // note! can't fail (same capacity)
+  assert(success);
+  slot_ = nullptr;
+}
+
+}  // namespace server
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,171 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "roq/api.hpp"
+
+#include "roq/io/context.hpp"
+
+#include "roq/io/web/uri.hpp"
+
+#include "roq/io/net/connection_factory.hpp"
+#include "roq/io/net/connection_manager.hpp"
+
+#include "roq/fix/message.hpp"
+
+#include "roq/fix_proxy/journal.hpp"
+#include "roq/fix_proxy/metrics.hpp"
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/tools/encode_buffer.hpp"
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+#include "roq/fix_proxy/tools/spsc_buffer.hpp"
+#include "roq/fix_proxy/tools/spsc_queue.hpp"
+
+#include "roq/fix_proxy/server/decoder.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace server {
+
+// note!
+// the upstream connection is owned by a dedicated (reader) thread running its own event loop
+// inbound messages are framed (all complete frames in one pass), validated and decoded by the reader thread into a fixed number of preallocated slots
+// each slot owns a copy of the raw message and its own decode buffers (decoded values reference these)
+// slot indices are exchanged with the event loop thread through single-producer single-consumer queues
+// outbound messages are encoded on the event loop thread and forwarded to the reader thread for sending
+// both threads are busy polling (requires loop_busy_poll)
+
+struct Pipeline final : public io::net::ConnectionManager::Handler {
+  struct Connected final {};
+  struct Disconnected final {};
+  struct Decoded final {
+    TraceInfo const &trace_info;  // note! source_receive_time is when the bytes were read
+    fix::Header const &header;
+    Decoder::Value const &value;
+    std::chrono::nanoseconds decode_start = {};
+    std::chrono::nanoseconds decode_end = {};
+  };
+
+  struct Handler {
+    virtual void operator()(Connected const &) = 0;
+    virtual void operator()(Disconnected const &) = 0;
+    virtual void operator()(Decoded const &) = 0;
+  };
+
+  struct Depth final {
+    size_t ready = {};     // note! slots
+    size_t outbound = {};  // note! bytes
+  };
+
+  Pipeline(Settings const &, io::web::URI const &, Metrics::Slot &, Journal::Channel *);
+
+  Pipeline(Pipeline &&) = delete;
+  Pipeline(Pipeline const &) = delete;
+
+  ~Pipeline();
+
+  // note! the following methods may only be called from the event loop thread
+
+  // returns the number of events dispatched
+  size_t poll(Handler &);
+
+  void start();
+  void stop();
+  void close();
+
+  // note! waits for the reader thread if the ring buffer is full (returns false if it is stuck)
+  template <typename Callback>
+  bool send(Callback callback) {
+    auto message = encode_buffer_.encode(callback);
+    return write(Command::SEND, message);
+  }
+
+  void refresh(std::chrono::nanoseconds now) { encode_buffer_.refresh(now); }
+
+  Depth depth() const {
+    return {
+        .ready = ready_.size(),
+        .outbound = outbound_.size(),
+    };
+  }
+
+ protected:
+  // io::net::ConnectionManager::Handler
+  void operator()(io::net::ConnectionManager::Connected const &) override;
+  void operator()(io::net::ConnectionManager::Disconnected const &) override;
+  void operator()(io::net::ConnectionManager::Read const &) override;
+  void operator()(io::net::ConnectionManager::Write const &) override;
+
+  enum class Command : uint8_t {
+    START,
+    STOP,
+    CLOSE,
+    SEND,
+  };
+
+  bool write(Command, std::span<std::byte const> const &payload);
+
+  struct Slot final {
+    enum class Type {
+      CONNECTED,
+      DISCONNECTED,
+      DECODED,
+    } type = {};
+    TraceInfo trace_info;
+    std::chrono::nanoseconds decode_start = {};
+    std::chrono::nanoseconds decode_end = {};
+    fix::Header header;
+    std::vector<std::byte> raw;
+    std::vector<std::byte> decode_buffer;
+    std::vector<std::byte> decode_buffer_2;
+    Decoder::Value value;
+  };
+
+  void run();
+
+  void process(Command, std::span<std::byte const> const &payload);
+
+  void read();
+
+  bool decode(Slot &, std::span<std::byte const> const &message);
+
+  void notify(Slot::Type);
+
+  Slot *acquire();
+  void commit();
+
+ private:
+  bool const debug_;
+  tools::FrameScanner const frame_scanner_;
+  std::unique_ptr<io::Context> const context_;
+  std::unique_ptr<io::net::ConnectionFactory> const connection_factory_;
+  std::unique_ptr<io::net::ConnectionManager> const connection_manager_;
+  std::vector<Slot> slots_;
+  tools::SPSCQueue<uint32_t> free_;   // note! event loop => reader
+  tools::SPSCQueue<uint32_t> ready_;  // note! reader => event loop
+  tools::SPSCBuffer outbound_;        // note! event loop => reader
+  tools::EncodeBuffer encode_buffer_;
+  // note! only accessed by the reader thread
+  Metrics::Slot &metrics_;
+  Journal::Channel *const journal_;  // note! nullptr when disabled
+  uint32_t index_ = {};
+  Slot *slot_ = {};
+  std::vector<std::span<std::byte const>> frames_;
+  bool pending_ = {};  // note! inbound data waiting for a free slot
+  std::chrono::nanoseconds receive_time_ = {};
+  std::chrono::nanoseconds next_refresh_ = {};
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+
+}  // namespace server
+}  // namespace fix_proxy
+}  // namespace roq
@@ -2,8 +2,17 @@
 
 #include "roq/fix_proxy/server/session.hpp"
 
+#include <fmt/format.h>
+
+#include <magic_enum/magic_enum_format.hpp>
+
 #include <nameof.hpp>
 
+#include <string>
+#include <type_traits>
+#include <variant>
+
+#include "roq/clock.hpp"
 #include "roq/logging.hpp"
 
 #include "roq/utils/debug/fix/message.hpp"
@@ -17,16 +26,13 @@ namespace roq {
 namespace fix_proxy {
 namespace server {
 
-// === CONSTANTS ===
-
-namespace {
-auto const FIX_VERSION = fix::Version::FIX_44;
-}  // namespace
-
 // === HELPERS ===
 
 namespace {
-auto create_connection_factory(auto &settings, auto &context, auto &uri) {
+auto create_connection_factory(auto &settings, auto &context, auto &uri) -> std::unique_ptr<io::net::ConnectionFactory> {
+  if (settings.server.pipeline_depth > 0) {
+    return {};  // note! owned by the pipeline
+  }
   log::debug("uri={}"sv, uri);
   auto config = io::net::ConnectionFactory::Config{
       .interface = {},
@@ -36,223 +42,176 @@ auto create_connection_factory(auto &settings, auto &context, auto &uri) {
   return io::net::ConnectionFactory::create(context, config);
 }
 
-auto create_connection_manager(auto &handler, auto &settings, auto &connection_factory) {
+auto create_connection_manager(auto &handler, auto &settings, auto &connection_factory) -> std::unique_ptr<io::net::ConnectionManager> {
+  if (!static_cast<bool>(connection_factory)) {
+    return {};
+  }
   auto config = io::net::ConnectionManager::Config{
       .connection_timeout = settings.net.connection_timeout,
       .disconnect_on_idle_timeout = {},
       .always_reconnect = true,
   };
-  return io::net::ConnectionManager::create(handler, connection_factory, config);
-}
-}  // namespace
-
-// === IMPLEMENTATION ===
-
-Session::Session(Handler &handler, Settings const &settings, io::Context &context, io::web::URI const &uri, fix::proxy::Manager &proxy)
-    : handler_{handler}, sender_comp_id_{settings.server.sender_comp_id}, target_comp_id_{settings.server.target_comp_id}, debug_{settings.server.debug},
-      connection_factory_{create_connection_factory(settings, context, uri)},
-      connection_manager_{create_connection_manager(*this, settings, *connection_factory_)}, decode_buffer_(settings.server.decode_buffer_size),
-      decode_buffer_2_(settings.server.decode_buffer_size), proxy_{proxy}
-
-{
+  return io::net::ConnectionManager::create(handler, *connection_factory, config);
 }
 
-void Session::operator()(Event<Start> const &) {
-  (*connection_manager_).start();
-}
-
-void Session::operator()(Event<Stop> const &) {
-  (*connection_manager_).stop();
-}
-
-void Session::operator()(Event<Timer> const &event) {
-  (*connection_manager_).refresh(event.value.now);
-}
-
-// fix::proxy::Manager::Handler
-
-// - manager => server
-
-void Session::operator()(Trace<fix::codec::Reject> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::Logon> const &event) {
-  auto &[trace_info, logon] = event;
-  auto logon_2 = logon;
-  logon_2.next_expected_msg_seq_num = inbound_.msg_seq_num + 1;  // note!
-  Trace event_2{trace_info, logon_2};
-  send(event_2);
-}
-
-void Session::operator()(Trace<fix::codec::Logout> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::Heartbeat> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::TestRequest> const &event) {
-  send(event);
-}
-
-// - client => server
-
-void Session::operator()(Trace<fix::codec::BusinessMessageReject> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::UserRequest> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::TradingSessionStatusRequest> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::SecurityListRequest> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::SecurityDefinitionRequest> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::SecurityStatusRequest> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::MarketDataRequest> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::NewOrderSingle> const &event) {
-  send(event);
-}
-
-void Session::operator()(Trace<fix::codec::OrderCancelReplaceRequest> const &event) {
-  send(event);
+auto create_pipeline(auto &settings, auto &uri, auto traffic_class, auto &metrics, auto &journal) -> std::unique_ptr<Pipeline> {
+  if (settings.server.pipeline_depth == 0) {
+    return {};
+  }
+  if (!settings.loop.busy_poll) {
+    log::fatal("Unexpected: server_pipeline_depth requires loop_busy_poll"sv);
+  }
+  return std::make_unique<Pipeline>(settings, uri, metrics.pipeline(traffic_class), journal.pipeline(traffic_class));
 }
 
-void Session::operator()(Trace<fix::codec::OrderCancelRequest> const &event) {
-  send(event);
+auto get_upstream_name(auto &settings, auto traffic_class) -> std::string {
+  if (traffic_class == TrafficClass::ORDER_ENTRY) {
+    return settings.server.target_comp_id;
+  }
+  return fmt::format("{}:{}"sv, settings.server.target_comp_id, traffic_class);
 }
 
-void Session::operator()(Trace<fix::codec::OrderMassCancelRequest> const &event) {
-  send(event);
+size_t get_decode_buffer_size(auto &settings) {
+  if (settings.server.pipeline_depth > 0) {
+    return {};  // note! each pipeline slot has its own decode buffers
+  }
+  return settings.server.decode_buffer_size;
 }
+}  // namespace
 
-void Session::operator()(Trace<fix::codec::OrderStatusRequest> const &event) {
-  send(event);
-}
+// === IMPLEMENTATION ===
 
-void Session::operator()(Trace<fix::codec::OrderMassStatusRequest> const &event) {
-  send(event);
+Session::Session(
+    Handler &handler,
+    Settings const &settings,
+    io::Context &context,
+    io::web::URI const &uri,
+    TrafficClass traffic_class,
+    fix::proxy::Manager &proxy,
+    fix::proxy::Manager &session_proxy,
+    Tracer &tracer,
+    Metrics &metrics,
+    Journal &journal,
+    OrderTracker &orders,
+    Profiler &profiler)
+    : handler_{handler}, traffic_class_{traffic_class}, sender_comp_id_{settings.server.sender_comp_id},
+      target_comp_id_{settings.server.target_comp_id}, debug_{settings.server.debug}, frame_scanner_{settings.server.validate_checksum},
+      connection_factory_{create_connection_factory(settings, context, uri)},
+      connection_manager_{create_connection_manager(*this, settings, connection_factory_)},
+      pipeline_{create_pipeline(settings, uri, traffic_class, metrics, journal)}, decode_buffer_(get_decode_buffer_size(settings)),
+      decode_buffer_2_(get_decode_buffer_size(settings)), proxy_{proxy}, session_proxy_{session_proxy}, tracer_{tracer}, metrics_{metrics},
+      journal_{journal.event_loop()}, orders_{orders}, upstream_{orders.add_upstream(get_upstream_name(settings, traffic_class))}, profiler_{profiler} {
+  metrics_.upstream(traffic_class_, Metrics::UpstreamState::DISCONNECTED);
 }
 
-void Session::operator()(Trace<fix::codec::TradeCaptureReportRequest> const &event) {
-  send(event);
+size_t Session::poll() {
+  return (*pipeline_).poll(*this);
 }
 
-void Session::operator()(Trace<fix::codec::RequestForPositions> const &event) {
-  send(event);
+void Session::operator()(Event<Start> const &) {
+  if (static_cast<bool>(pipeline_)) {
+    (*pipeline_).start();
+  } else {
+    (*connection_manager_).start();
+  }
 }
 
-void Session::operator()(Trace<fix::codec::MassQuote> const &event) {
-  send(event);
+void Session::operator()(Event<Stop> const &) {
+  if (static_cast<bool>(pipeline_)) {
+    (*pipeline_).stop();
+  } else {
+    (*connection_manager_).stop();
+  }
 }
 
-void Session::operator()(Trace<fix::codec::QuoteCancel> const &event) {
-  send(event);
+void Session::operator()(Event<Timer> const &event) {
+  if (static_cast<bool>(pipeline_)) {
+    (*pipeline_).refresh(event.value.now);  // note! connection is refreshed by the reader thread
+    return;
+  }
+  (*connection_manager_).refresh(event.value.now);
 }
 
 // io::net::ConnectionManager::Handler
 
 void Session::operator()(io::net::ConnectionManager::Connected const &) {
-  log::debug("Connected"sv);
-  TraceInfo trace_info;
-  auto connected = fix::proxy::Manager::Connected{};
-  create_trace_and_dispatch(proxy_, trace_info, connected);
+  connected();
 }
 
 void Session::operator()(io::net::ConnectionManager::Disconnected const &) {
-  log::debug("Disconnected"sv);
-  TraceInfo trace_info;
-  auto disconnected = fix::proxy::Manager::Disconnected{};
-  create_trace_and_dispatch(proxy_, trace_info, disconnected);
-  // XXX HANS
-  Disconnected disconnected_2;
-  Trace event{trace_info, disconnected_2};
-  //
-  handler_(event);
-  outbound_ = {};
-  inbound_ = {};
+  disconnected();
 }
 
 void Session::operator()(io::net::ConnectionManager::Read const &) {
+  Profiler::Scope scope{profiler_, Profiler::Callback::SERVER_READ};
   auto logger = [this](auto &message) {
     if (debug_) [[unlikely]] {
       log::info("{}"sv, utils::debug::fix::Message{message});
     }
   };
+  auto receive_time = clock::get_system();
   auto buffer = (*connection_manager_).buffer();
+  frames_.clear();
+  auto [bytes, status] = frame_scanner_.scan(buffer, frames_);
   size_t total_bytes = 0;
-  while (!std::empty(buffer)) {
+  for (auto &frame : frames_) {
+    if (journal_ != nullptr) [[unlikely]] {
+      (*journal_).write(Journal::Peer::SERVER, Journal::Direction::INBOUND, 0, receive_time, frame);  // note! before decoding (which may throw)
+    }
     TraceInfo trace_info;
+    trace_info.source_receive_time = receive_time;
     auto parser = [&](auto &message) {
       try {
         check(message.header);
         Trace event{trace_info, message};
         parse(event);
       } catch (std::exception &) {
-        log::warn("{}"sv, utils::debug::fix::Message{buffer});
+        log::warn("{}"sv, utils::debug::fix::Message{frame});
 #ifndef NDEBUG
-        log::warn("{}"sv, utils::debug::hex::Message{buffer});
+        log::warn("{}"sv, utils::debug::hex::Message{frame});
 #endif
         log::error("Message could not be parsed. PLEASE REPORT!"sv);
         throw;
       }
     };
-    auto bytes = fix::Reader<FIX_VERSION>::dispatch(buffer, parser, logger);
-    if (bytes == 0) {
-      break;
-    }
-    assert(bytes <= std::size(buffer));
-    total_bytes += bytes;
-    buffer = buffer.subspan(bytes);
+    total_bytes += std::size(frame);
+    fix::Reader<FIX_VERSION>::dispatch(frame, parser, logger);
+  }
+  if (status != tools::FrameScanner::Status::OK && total_bytes == bytes) [[unlikely]] {
+    log::warn("{}"sv, utils::debug::fix::Message{buffer.subspan(total_bytes)});
+    log::error("Message could not be framed (status={})"sv, status);
+    (*connection_manager_).close();
   }
+  metrics_.event_loop().add(Metrics::Counter::SERVER_BYTES_RECEIVED, total_bytes);
   (*connection_manager_).drain(total_bytes);
 }
 
 void Session::operator()(io::net::ConnectionManager::Write const &) {
 }
 
-// outbound
+// Pipeline::Handler
 
-template <typename T>
-void Session::send(Trace<T> const &event) {
-  auto &[trace_info, value] = event;
-  log::info<2>("send (=> server): {}={}"sv, nameof::nameof_short_type<T>(), value);
-  auto sending_time = clock::get_realtime();
-  auto header = fix::Header{
-      .version = FIX_VERSION,
-      .msg_type = T::MSG_TYPE,
-      .sender_comp_id = sender_comp_id_,
-      .target_comp_id = target_comp_id_,
-      .msg_seq_num = ++outbound_.msg_seq_num,  // note!
-      .sending_time = sending_time,
-  };
-  auto helper = [&](auto &buffer) {
-    auto message = value.encode(header, buffer);
-    if (debug_) [[unlikely]] {
-      log::info("{}"sv, utils::debug::fix::Message{message});
-    }
-    return std::size(message);
-  };
-  if ((*connection_manager_).send(helper)) {
-  } else {
-    log::warn("HERE"sv);
+void Session::operator()(Pipeline::Connected const &) {
+  connected();
+}
+
+void Session::operator()(Pipeline::Disconnected const &) {
+  disconnected();
+}
+
+void Session::operator()(Pipeline::Decoded const &decoded) {
+  Profiler::Scope scope{profiler_, Profiler::Callback::SERVER_READ};
+  try {
+    check(decoded.header);
+    auto helper = [&]<typename T>(T const &value) {
+      if constexpr (!std::is_same_v<T, std::monostate>) {
+        dispatch(decoded.trace_info, value, decoded.decode_start, decoded.decode_end);
+      }
+    };
+    std::visit(helper, decoded.value);
+  } catch (std::exception &e) {
+    log::error(R"(Exception: what="{}")"sv, e.what());
+    close();
   }
 }
 
@@ -260,102 +219,38 @@ void Session::send(Trace<T> const &event) {
 
 void Session::parse(Trace<fix::Message> const &event) {
   auto &[trace_info, message] = event;
+  auto decode_start = clock::get_system();
   try {
-    switch (message.header.msg_type) {
-      using enum fix::MsgType;
-      case REJECT:
-        dispatch<fix::codec::Reject>(event);
-        break;
-      case LOGON:
-        dispatch<fix::codec::Logon>(event);
-        break;
-      case LOGOUT:
-        dispatch<fix::codec::Logout>(event);
-        break;
-      case HEARTBEAT:
-        dispatch<fix::codec::Heartbeat>(event);
-        break;
-      case TEST_REQUEST:
-        dispatch<fix::codec::TestRequest>(event);
-        break;
-      case RESEND_REQUEST:
-        dispatch<fix::codec::ResendRequest>(event);
-        break;
-      case BUSINESS_MESSAGE_REJECT:
-        dispatch<fix::codec::BusinessMessageReject>(event);
-        break;
-      case USER_RESPONSE:
-        dispatch<fix::codec::UserResponse>(event);
-        break;
-      case TRADING_SESSION_STATUS:
-        dispatch<fix::codec::TradingSessionStatus>(event, decode_buffer_);
-        break;
-      case SECURITY_LIST:
-        dispatch<fix::codec::SecurityList>(event, decode_buffer_);
-        break;
-      case SECURITY_DEFINITION:
-        dispatch<fix::codec::SecurityDefinition>(event, decode_buffer_);
-        break;
-      case SECURITY_STATUS:
-        dispatch<fix::codec::SecurityStatus>(event, decode_buffer_);
-        break;
-      case MARKET_DATA_REQUEST_REJECT:
-        dispatch<fix::codec::MarketDataRequestReject>(event, decode_buffer_);
-        break;
-      case MARKET_DATA_SNAPSHOT_FULL_REFRESH:
-        dispatch<fix::codec::MarketDataSnapshotFullRefresh>(event, decode_buffer_);
-        break;
-      case MARKET_DATA_INCREMENTAL_REFRESH:
-        dispatch<fix::codec::MarketDataIncrementalRefresh>(event, decode_buffer_);
-        break;
-      case EXECUTION_REPORT:
-        dispatch<fix::codec::ExecutionReport>(event, decode_buffer_);
-        break;
-      case ORDER_CANCEL_REJECT:
-        dispatch<fix::codec::OrderCancelReject>(event, decode_buffer_);
-        break;
-      case ORDER_MASS_CANCEL_REPORT:
-        dispatch<fix::codec::OrderMassCancelReport>(event, decode_buffer_);
-        break;
-      case TRADE_CAPTURE_REPORT_REQUEST_ACK:
-        dispatch<fix::codec::TradeCaptureReportRequestAck>(event, decode_buffer_);
-        break;
-      case TRADE_CAPTURE_REPORT:
-        dispatch<fix::codec::TradeCaptureReport>(event, decode_buffer_, decode_buffer_2_);
-        break;
-      case REQUEST_FOR_POSITIONS_ACK:
-        dispatch<fix::codec::RequestForPositionsAck>(event, decode_buffer_);
-        break;
-      case POSITION_REPORT:
-        dispatch<fix::codec::PositionReport>(event, decode_buffer_);
-        break;
-      case MASS_QUOTE_ACK:
-        dispatch<fix::codec::MassQuoteAck>(event, decode_buffer_, decode_buffer_2_);
-        break;
-      case QUOTE_STATUS_REPORT:
-        dispatch<fix::codec::QuoteStatusReport>(event);
-        break;
-      default:
-        log::warn("Unexpected msg_type={}"sv, message.header.msg_type);
+    auto helper = [&](auto &value) { dispatch(trace_info, value, decode_start); };
+    if (!Decoder::dispatch(message, decode_buffer_, decode_buffer_2_, helper)) {
+      log::warn("Unexpected msg_type={}"sv, message.header.msg_type);
     }
   } catch (std::exception &e) {
     log::error(R"(Exception: what="{}")"sv, e.what());
-    (*connection_manager_).close();
+    close();
   }
 }
 
-template <typename T, typename... Args>
-void Session::dispatch(Trace<fix::Message> const &event, Args &&...args) {
-  auto &[trace_info, message] = event;
-  auto value = T::create(message, std::forward<Args>(args)...);
+template <typename T>
+void Session::dispatch(TraceInfo const &trace_info, T const &value, std::chrono::nanoseconds decode_start, std::chrono::nanoseconds decode_end) {
   log::info<1>("{}={}"sv, nameof::nameof_short_type<T>(), value);
-  create_trace_and_dispatch(proxy_, trace_info, value);
+  metrics_.message(Metrics::Peer::SERVER, Metrics::Direction::RECEIVED, T::MSG_TYPE);
+  if constexpr (OrderTracker::is_response<T>()) {
+    orders_.response(upstream_, value.cl_ord_id, trace_info.source_receive_time);
+  }
+  auto trace_info_2 = tracer_.route(Tracer::Direction::DOWNSTREAM, T::MSG_TYPE, trace_info, decode_start, decode_end);
+  if constexpr (Messages::SessionLevel::contains<T>()) {
+    create_trace_and_dispatch(session_proxy_, trace_info_2, value);
+  } else {
+    create_trace_and_dispatch(proxy_, trace_info_2, value);
+  }
 }
 
 void Session::check(fix::Header const &header) {
   auto current = header.msg_seq_num;
   auto expected = inbound_.msg_seq_num + 1;
   if (current != expected) [[unlikely]] {
+    metrics_.event_loop().add(Metrics::Counter::SERVER_SEQUENCE_GAPS);
     if (expected < current) {
       log::warn(
           "*** SEQUENCE GAP *** "
@@ -375,6 +270,42 @@ void Session::check(fix::Header const &header) {
   inbound_.msg_seq_num = current;
 }
 
+// - connection
+
+void Session::connected() {
+  log::debug("Connected (traffic_class={})"sv, traffic_class_);
+  metrics_.upstream(traffic_class_, Metrics::UpstreamState::CONNECTED);
+  TraceInfo trace_info;
+  auto connected = fix::proxy::Manager::Connected{};
+  create_trace_and_dispatch(session_proxy_, trace_info, connected);
+}
+
+void Session::disconnected() {
+  log::debug("Disconnected (traffic_class={})"sv, traffic_class_);
+  metrics_.upstream(traffic_class_, Metrics::UpstreamState::DISCONNECTED);
+  orders_.disconnected(upstream_);
+  TraceInfo trace_info;
+  auto disconnected = fix::proxy::Manager::Disconnected{};
+  create_trace_and_dispatch(session_proxy_, trace_info, disconnected);
+  // XXX HANS
+  auto disconnected_2 = Disconnected{
+      .traffic_class = traffic_class_,
+  };
+  Trace event{trace_info, disconnected_2};
+  //
+  handler_(event);
+  outbound_ = {};
+  inbound_ = {};
+}
+
+void Session::close() {
+  if (static_cast<bool>(pipeline_)) {
+    (*pipeline_).close();
+  } else {
+    (*connection_manager_).close();
+  }
+}
+
 }  // namespace server
 }  // namespace fix_proxy
 }  // namespace roq
@@ -2,12 +2,21 @@
 
 #pragma once
 
+#include <nameof.hpp>
+
+#include <chrono>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "roq/api.hpp"
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+#include "roq/utils/debug/fix/message.hpp"
 
 #include "roq/io/context.hpp"
 
@@ -20,53 +29,84 @@
 
 #include "roq/fix/proxy/manager.hpp"
 
+#include "roq/fix_proxy/journal.hpp"
+#include "roq/fix_proxy/messages.hpp"
+#include "roq/fix_proxy/metrics.hpp"
+#include "roq/fix_proxy/order_tracker.hpp"
+#include "roq/fix_proxy/profiler.hpp"
 #include "roq/fix_proxy/settings.hpp"
+#include "roq/fix_proxy/tracer.hpp"
+
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+
+#include "roq/fix_proxy/server/pipeline.hpp"
 
 namespace roq {
 namespace fix_proxy {
 namespace server {
 
-struct Session final : public io::net::ConnectionManager::Handler {
-  struct Ready final {};
-  struct Disconnected final {};
+struct Session final : public io::net::ConnectionManager::Handler, public Pipeline::Handler {
+  static constexpr auto FIX_VERSION = fix::Version::FIX_44;
+
+  struct Ready final {
+    TrafficClass traffic_class = {};
+  };
+  struct Disconnected final {
+    TrafficClass traffic_class = {};
+  };
   struct Handler {
     virtual void operator()(Trace<Ready> const &) = 0;
     virtual void operator()(Trace<Disconnected> const &) = 0;
   };
 
-  Session(Handler &, Settings const &, io::Context &, io::web::URI const &, fix::proxy::Manager &);
+  // note! session-level messages are dispatched to session_proxy, everything else to proxy (may be the same)
+  Session(
+      Handler &,
+      Settings const &,
+      io::Context &,
+      io::web::URI const &,
+      TrafficClass,
+      fix::proxy::Manager &proxy,
+      fix::proxy::Manager &session_proxy,
+      Tracer &,
+      Metrics &,
+      Journal &,
+      OrderTracker &,
+      Profiler &);
+
+  TrafficClass traffic_class() const { return traffic_class_; }
+
+  // note! the pipeline must be polled from the event loop thread
+  bool has_pipeline() const { return static_cast<bool>(pipeline_); }
+
+  size_t poll();
+
+  // note! zero when not using the pipeline
+  Pipeline::Depth pipeline_depth() const {
+    if (static_cast<bool>(pipeline_)) {
+      return (*pipeline_).depth();
+    }
+    return {};
+  }
 
   void operator()(Event<Start> const &);
   void operator()(Event<Stop> const &);
   void operator()(Event<Timer> const &);
 
-  // fix::proxy::Manager::Handler
-
-  // - manager => server
-  void operator()(Trace<fix::codec::Reject> const &);
-  void operator()(Trace<fix::codec::Logon> const &);
-  void operator()(Trace<fix::codec::Logout> const &);
-  void operator()(Trace<fix::codec::Heartbeat> const &);
-  void operator()(Trace<fix::codec::TestRequest> const &);
-
-  // - client => server
-  void operator()(Trace<fix::codec::BusinessMessageReject> const &);
-  void operator()(Trace<fix::codec::UserRequest> const &);
-  void operator()(Trace<fix::codec::TradingSessionStatusRequest> const &);
-  void operator()(Trace<fix::codec::SecurityListRequest> const &);
-  void operator()(Trace<fix::codec::SecurityDefinitionRequest> const &);
-  void operator()(Trace<fix::codec::SecurityStatusRequest> const &);
-  void operator()(Trace<fix::codec::MarketDataRequest> const &);
-  void operator()(Trace<fix::codec::NewOrderSingle> const &);
-  void operator()(Trace<fix::codec::OrderCancelReplaceRequest> const &);
-  void operator()(Trace<fix::codec::OrderCancelRequest> const &);
-  void operator()(Trace<fix::codec::OrderMassCancelRequest> const &);
-  void operator()(Trace<fix::codec::OrderStatusRequest> const &);
-  void operator()(Trace<fix::codec::OrderMassStatusRequest> const &);
-  void operator()(Trace<fix::codec::TradeCaptureReportRequest> const &);
-  void operator()(Trace<fix::codec::RequestForPositions> const &);
-  void operator()(Trace<fix::codec::MassQuote> const &);
-  void operator()(Trace<fix::codec::QuoteCancel> const &);
+  // fix::proxy::Manager::Handler (manager => server, client => server)
+  template <typename T>
+  requires(Messages::ToServer::contains<T>())
+  void operator()(Trace<T> const &event) {
+    if constexpr (std::is_same_v<T, fix::codec::Logon>) {
+      auto &[trace_info, logon] = event;
+      auto logon_2 = logon;
+      logon_2.next_expected_msg_seq_num = inbound_.msg_seq_num + 1;  // note!
+      Trace event_2{trace_info, logon_2};
+      send(event_2);
+    } else {
+      send(event);
+    }
+  }
 
  protected:
   // io::net::ConnectionManager::Handler
@@ -76,31 +116,96 @@ struct Session final : public io::net::ConnectionManager::Handler {
   void operator()(io::net::ConnectionManager::Read const &) override;
   void operator()(io::net::ConnectionManager::Write const &) override;
 
+  // Pipeline::Handler
+
+  void operator()(Pipeline::Connected const &) override;
+  void operator()(Pipeline::Disconnected const &) override;
+  void operator()(Pipeline::Decoded const &) override;
+
   // tools
 
   // - outbound
 
+  // note! defined here (instantiated by the controller)
   template <typename T>
-  void send(Trace<T> const &);
+  void send(Trace<T> const &event) {
+    using namespace std::literals;
+    auto &[trace_info, value] = event;
+    log::info<2>("send (=> server): {}={}"sv, nameof::nameof_short_type<T>(), value);
+    auto encode_start = clock::get_system();
+    std::chrono::nanoseconds encode_end = {};
+    auto sending_time = clock::get_realtime();
+    auto header = fix::Header{
+        .version = FIX_VERSION,
+        .msg_type = T::MSG_TYPE,
+        .sender_comp_id = sender_comp_id_,
+        .target_comp_id = target_comp_id_,
+        .msg_seq_num = ++outbound_.msg_seq_num,  // note!
+        .sending_time = sending_time,
+    };
+    size_t length = {};
+    auto journaled = false;
+    auto helper = [&](auto &buffer) {
+      auto message = value.encode(header, buffer);
+      encode_end = clock::get_system();
+      length = std::size(message);
+      if (journal_ != nullptr) [[unlikely]] {
+        journaled = (*journal_).prepare(Journal::Peer::SERVER, Journal::Direction::OUTBOUND, 0, encode_end, message);
+      }
+      if (debug_) [[unlikely]] {
+        log::info("{}"sv, utils::debug::fix::Message{message});
+      }
+      return std::size(message);
+    };
+    auto success = static_cast<bool>(pipeline_) ? (*pipeline_).send(helper) : (*connection_manager_).send(helper);
+    if (success) {
+      if (journaled) [[unlikely]] {
+        (*journal_).commit();  // note! only messages which have been sent (or handed over to the pipeline)
+      }
+      tracer_.send(Tracer::Direction::UPSTREAM, T::MSG_TYPE, trace_info, encode_start, encode_end);
+      if constexpr (OrderTracker::is_request<T>()) {
+        orders_.request(upstream_, value.cl_ord_id, encode_end);
+      }
+      metrics_.message(Metrics::Peer::SERVER, Metrics::Direction::SENT, T::MSG_TYPE);
+      if (!static_cast<bool>(pipeline_)) {
+        metrics_.event_loop().add(Metrics::Counter::SERVER_BYTES_SENT, length);  // note! otherwise counted by the pipeline
+      }
+    } else {
+      metrics_.event_loop().add(Metrics::Counter::SERVER_SEND_FAILURES);
+      log::warn("Unable to send, closing connection (msg_type={})"sv, T::MSG_TYPE);
+      close();  // note! a message must never be silently dropped
+    }
+  }
 
   // - inbound
 
   void parse(Trace<fix::Message> const &);
 
-  template <typename T, typename... Args>
-  void dispatch(Trace<fix::Message> const &, Args &&...);
+  // note! decode_end is zero when decoded by the event loop thread
+  template <typename T>
+  void dispatch(TraceInfo const &, T const &, std::chrono::nanoseconds decode_start, std::chrono::nanoseconds decode_end = {});
 
   void check(fix::Header const &);
 
+  // - connection
+
+  void connected();
+  void disconnected();
+
+  void close();
+
  private:
   Handler &handler_;
+  TrafficClass const traffic_class_;
   // config
   std::string_view const sender_comp_id_;
   std::string_view const target_comp_id_;
   bool const debug_;
+  tools::FrameScanner const frame_scanner_;
   // connection
   std::unique_ptr<io::net::ConnectionFactory> const connection_factory_;
   std::unique_ptr<io::net::ConnectionManager> const connection_manager_;
+  std::unique_ptr<Pipeline> const pipeline_;  // note! connection is owned by the pipeline
   // messaging
   struct {
     uint64_t msg_seq_num = {};
@@ -110,8 +215,16 @@ struct Session final : public io::net::ConnectionManager::Handler {
   } outbound_;
   std::vector<std::byte> decode_buffer_;
   std::vector<std::byte> decode_buffer_2_;
+  std::vector<std::span<std::byte const>> frames_;
   // proxy
   fix::proxy::Manager &proxy_;
+  fix::proxy::Manager &session_proxy_;  // note! owns the session-level protocol of this connection
+  Tracer &tracer_;
+  Metrics &metrics_;
+  Journal::Channel *const journal_;  // note! nullptr when disabled
+  OrderTracker &orders_;
+  uint32_t const upstream_;  // note! index used by the order tracker
+  Profiler &profiler_;
 };
 
 }  // namespace server
@@ -0,0 +1,58 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/service/server.hpp"
+
+#include <algorithm>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace service {
+
+// === HELPERS ===
+
+namespace {
+auto create_listener(auto &handler, auto &settings, auto &context) -> std::unique_ptr<io::net::tcp::Listener> {
+  auto &listen_address = settings.service.listen_address;
+  if (std::empty(listen_address)) {
+    return {};
+  }
+  log::info(R"(Service listening on "{}")"sv, listen_address);
+  auto network_address = io::NetworkAddress{listen_address};
+  return context.create_tcp_listener(handler, network_address);
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Server::Server(Handler &handler, Settings const &settings, io::Context &context)
+    : handler_{handler}, listener_{create_listener(*this, settings, context)} {
+}
+
+// note! sessions can't be removed from their own callbacks
+void Server::refresh(std::chrono::nanoseconds) {
+  std::erase_if(sessions_, [](auto &session) { return (*session).zombie(); });
+}
+
+// io::net::tcp::Listener::Handler
+
+void Server::operator()(io::net::tcp::Connection::Factory &factory) {
+  add(factory);
+}
+
+void Server::operator()(io::net::tcp::Connection::Factory &factory, io::NetworkAddress const &network_address) {
+  log::info<1>("Connected (service_session_id={}, peer={})"sv, next_session_id_ + 1, network_address.to_string_2());
+  add(factory);
+}
+
+void Server::add(io::net::tcp::Connection::Factory &factory) {
+  auto session_id = ++next_session_id_;
+  sessions_.emplace_back(std::make_unique<Session>(handler_, factory, session_id, response_));
+}
+
+}  // namespace service
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,51 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "roq/io/context.hpp"
+
+#include "roq/fix_proxy/settings.hpp"
+
+#include "roq/fix_proxy/service/session.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace service {
+
+// note!
+// http endpoint (--service_listen_address), disabled when the listen address is empty
+// owned by the event loop thread
+
+struct Server final : public io::net::tcp::Listener::Handler {
+  using Handler = Session::Handler;
+
+  Server(Handler &, Settings const &, io::Context &);
+
+  Server(Server &&) = delete;
+  Server(Server const &) = delete;
+
+  void refresh(std::chrono::nanoseconds now);
+
+ protected:
+  // io::net::tcp::Listener::Handler
+  void operator()(io::net::tcp::Connection::Factory &) override;
+  void operator()(io::net::tcp::Connection::Factory &, io::NetworkAddress const &) override;
+
+  void add(io::net::tcp::Connection::Factory &);
+
+ private:
+  Handler &handler_;
+  std::unique_ptr<io::net::tcp::Listener> const listener_;
+  std::vector<std::unique_ptr<Session>> sessions_;
+  uint64_t next_session_id_ = {};
+  std::string response_;
+};
+
+}  // namespace service
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,186 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/service/session.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "roq/logging.hpp"
+
+#include "roq/fix_proxy/tools/prometheus.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace service {
+
+// === CONSTANTS ===
+
+namespace {
+size_t const MAX_REQUEST_SIZE = 8192;  // note! request line and headers
+
+auto const CONTENT_TYPE_TEXT = "text/plain; charset=utf-8"sv;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto trim(std::string_view value) {
+  while (!std::empty(value) && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!std::empty(value) && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+bool iequals(std::string_view const &lhs, std::string_view const &rhs) {
+  return std::size(lhs) == std::size(rhs) && std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), [](auto lhs, auto rhs) {
+           return std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs));
+         });
+}
+
+// note! headers follow the request line, separated by crlf
+bool has_connection_close(std::string_view headers) {
+  while (!std::empty(headers)) {
+    auto pos = headers.find("\r\n"sv);
+    auto line = headers.substr(0, pos);
+    headers.remove_prefix(pos == headers.npos ? std::size(headers) : pos + 2);
+    auto separator = line.find(':');
+    if (separator == line.npos) {
+      continue;
+    }
+    if (iequals(trim(line.substr(0, separator)), "connection"sv) && iequals(trim(line.substr(separator + 1)), "close"sv)) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Session::Session(Handler &handler, io::net::tcp::Connection::Factory &factory, uint64_t session_id, std::string &response)
+    : handler_{handler}, session_id_{session_id}, response_{response}, connection_{factory.create(*this)} {
+}
+
+// io::net::tcp::Connection::Handler
+
+void Session::operator()(io::net::tcp::Connection::Read const &) {
+  buffer_.append(*connection_);
+  while (!zombie_) {
+    auto data = buffer_.data();
+    auto bytes = process({reinterpret_cast<char const *>(std::data(data)), std::size(data)});
+    if (bytes == 0) {
+      break;
+    }
+    buffer_.drain(bytes);
+    if (close_) {
+      close();
+    }
+  }
+}
+
+void Session::operator()(io::net::tcp::Connection::Disconnected const &) {
+  log::info<1>("Disconnected (service_session_id={})"sv, session_id_);
+  zombie_ = true;
+}
+
+// note! request line is "method SP request-target SP http-version"
+size_t Session::process(std::string_view const &request) {
+  auto end = request.find("\r\n\r\n"sv);
+  if (end == request.npos) {
+    if (std::size(request) > MAX_REQUEST_SIZE) [[unlikely]] {
+      close_ = true;
+      respond("431 Request Header Fields Too Large"sv, CONTENT_TYPE_TEXT, {});
+      return std::size(request);
+    }
+    return 0;
+  }
+  auto result = end + 4;
+  auto head = request.substr(0, end);
+  auto pos = head.find("\r\n"sv);
+  auto line = head.substr(0, pos);
+  auto headers = pos == head.npos ? std::string_view{} : head.substr(pos + 2);
+  auto pos_1 = line.find(' ');
+  auto pos_2 = line.rfind(' ');
+  if (pos_1 == line.npos || pos_1 == pos_2) [[unlikely]] {
+    close_ = true;
+    respond("400 Bad Request"sv, CONTENT_TYPE_TEXT, {});
+    return result;
+  }
+  auto method = line.substr(0, pos_1);
+  auto target = line.substr(pos_1 + 1, pos_2 - pos_1 - 1);
+  auto version = line.substr(pos_2 + 1);
+  close_ = version == "HTTP/1.0"sv || has_connection_close(headers);
+  log::info<1>(R"(Request (service_session_id={}): method="{}", target="{}")"sv, session_id_, method, target);
+  if (method != "GET"sv) {
+    close_ = true;  // note! a body could follow
+    respond("405 Method Not Allowed"sv, CONTENT_TYPE_TEXT, {});
+    return result;
+  }
+  auto path = target.substr(0, target.find('?'));
+  if (path == "/metrics"sv) {
+    response_.clear();
+    auto scrape = Scrape{
+        .body = response_,
+    };
+    handler_(scrape);
+    respond("200 OK"sv, tools::Prometheus::CONTENT_TYPE, response_);
+  } else {
+    respond("404 Not Found"sv, CONTENT_TYPE_TEXT, {});
+  }
+  return result;
+}
+
+void Session::respond(std::string_view const &status, std::string_view const &content_type, std::string_view const &body) {
+  auto header = fmt::format(
+      "HTTP/1.1 {}\r\n"
+      "Content-Type: {}\r\n"
+      "Content-Length: {}\r\n"
+      "{}"
+      "\r\n"sv,
+      status,
+      content_type,
+      std::size(body),
+      close_ ? "Connection: close\r\n"sv : ""sv);
+  if (!send(header) || !send(body)) [[unlikely]] {
+    log::warn("Unable to send response (service_session_id={})"sv, session_id_);
+    close();
+  }
+}
+
+// note! the connection buffer may be smaller than the message
+bool Session::send(std::string_view const &message) {
+  auto remaining = message;
+  while (!std::empty(remaining)) {
+    size_t length = {};
+    auto helper = [&](auto &buffer) {
+      length = std::min(std::size(buffer), std::size(remaining));
+      std::memcpy(std::data(buffer), std::data(remaining), length);
+      return length;
+    };
+    if (!(*connection_).send(helper) || length == 0) {
+      return false;
+    }
+    remaining.remove_prefix(length);
+  }
+  return true;
+}
+
+void Session::close() {
+  if (zombie_) {
+    return;
+  }
+  (*connection_).close();
+  zombie_ = true;
+}
+
+}  // namespace service
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,62 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "roq/io/buffer.hpp"
+
+#include "roq/io/net/tcp/connection.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace service {
+
+// note!
+// minimal http/1.1 server connection (GET only, persistent unless the client asks to close)
+// responses are built by the event loop thread on demand, nothing is maintained between requests
+
+struct Session final : public io::net::tcp::Connection::Handler {
+  struct Scrape final {
+    std::string &body;  // note! append metrics using the prometheus text format
+  };
+
+  struct Handler {
+    virtual void operator()(Scrape const &) = 0;
+  };
+
+  Session(Handler &, io::net::tcp::Connection::Factory &, uint64_t session_id, std::string &response);
+
+  Session(Session const &) = delete;
+
+  bool zombie() const { return zombie_; }
+
+ protected:
+  // io::net::tcp::Connection::Handler
+  void operator()(io::net::tcp::Connection::Read const &) override;
+  void operator()(io::net::tcp::Connection::Disconnected const &) override;
+
+  // note! returns the number of bytes consumed (zero if the request is incomplete)
+  size_t process(std::string_view const &request);
+
+  void respond(std::string_view const &status, std::string_view const &content_type, std::string_view const &body);
+
+  bool send(std::string_view const &);
+
+  void close();
+
+ private:
+  Handler &handler_;
+  uint64_t const session_id_;
+  std::string &response_;  // note! shared by all sessions (capacity is retained)
+  std::unique_ptr<io::net::tcp::Connection> const connection_;
+  io::Buffer buffer_;
+  bool close_ = {};  // note! close once the response has been sent
+  bool zombie_ = {};
+};
+
+}  // namespace service
+}  // namespace fix_proxy
+}  // namespace roq
@@ -29,6 +29,9 @@ Settings Settings::create(args::Parser const &) {
       .auth = flags::Auth::create(),
       .server = flags::Server::create(),
       .client = flags::Client::create(),
+      .loop = flags::Loop::create(),
+      .service = flags::Service::create(),
+      .journal = flags::Journal::create(),
       .test{
           .enable_order_mass_cancel = flags.enable_order_mass_cancel,
           .disable_remove_cl_ord_id = flags.disable_remove_cl_ord_id,
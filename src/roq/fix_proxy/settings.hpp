@@ -12,7 +12,10 @@
 
 #include "roq/fix_proxy/flags/auth.hpp"
 #include "roq/fix_proxy/flags/client.hpp"
+#include "roq/fix_proxy/flags/journal.hpp"
+#include "roq/fix_proxy/flags/loop.hpp"
 #include "roq/fix_proxy/flags/server.hpp"
+#include "roq/fix_proxy/flags/service.hpp"
 
 namespace roq {
 namespace fix_proxy {
@@ -31,6 +34,9 @@ struct Settings final {
   flags::Auth auth;
   flags::Server server;
   flags::Client client;
+  flags::Loop loop;
+  flags::Service service;
+  flags::Journal journal;
 
   struct {
     bool enable_order_mass_cancel = {};
@@ -58,6 +64,9 @@ struct fmt::formatter<roq::fix_proxy::Settings> {
         R"(auth={}, )"
         R"(server={}, )"
         R"(client={}, )"
+        R"(loop={}, )"
+        R"(service={}, )"
+        R"(journal={}, )"
         R"(test={{)"
         R"(enable_order_mass_cancel={}, )"
         R"(disable_remove_cl_ord_id={})"
@@ -69,6 +78,9 @@ struct fmt::formatter<roq::fix_proxy::Settings> {
         value.auth,
         value.server,
         value.client,
+        value.loop,
+        value.service,
+        value.journal,
         value.test.enable_order_mass_cancel,
         value.test.disable_remove_cl_ord_id);
   }
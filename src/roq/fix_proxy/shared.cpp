@@ -2,14 +2,81 @@
 
 #include "roq/fix_proxy/shared.hpp"
 
+#include "roq/utils/safe_cast.hpp"
+
 using namespace std::literals;
 
 namespace roq {
 namespace fix_proxy {
 
+// === CONSTANTS ===
+
+namespace {
+auto const ENCODE_BUFFER_QUIET_PERIOD = 60s;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+template <typename R>
+auto create_credentials(auto &config) {
+  using result_type = std::remove_cvref_t<R>;
+  using value_type = typename result_type::mapped_type;
+  result_type result;
+  for (auto &[_, user] : config.users) {
+    auto credentials = value_type{
+        .password = user.password,
+        .strategy_id = user.strategy_id,
+        .component = user.component,
+        .key = tools::Crypto::create_key(user.password),
+        .entitlements = Entitlements<Messages::FromClient>::create(user.msg_types),
+    };
+    result.try_emplace(user.username, std::move(credentials));
+  }
+  return result;
+}
+}  // namespace
+
 // === IMPLEMENTATION ===
 
-Shared::Shared(Settings const &settings, fix::proxy::Manager &proxy) : settings{settings}, proxy{proxy} {
+Shared::Shared(Settings const &settings, Config const &config, fix::proxy::Manager &proxy, tools::Verifier *verifier)
+    : settings{settings}, proxy{proxy}, credentials{create_credentials<decltype(credentials)>(config)},
+      decode_buffer(settings.client.decode_buffer_size), decode_buffer_2(settings.client.decode_buffer_size),
+      encode_buffer{settings.client.encode_buffer_size, ENCODE_BUFFER_QUIET_PERIOD}, metrics{settings}, journal{settings}, orders{settings},
+      profiler{settings}, verifier_{verifier} {
+}
+
+std::unique_ptr<fix::proxy::Manager> Shared::create_proxy(fix::proxy::Manager::Handler &handler, Settings const &settings) {
+  auto options = fix::proxy::Manager::Options{
+      .server{
+          .username = settings.server.username,
+          .password = settings.server.password,
+          .ping_freq = utils::safe_cast(settings.server.ping_freq),
+          .request_timeout = settings.server.request_timeout,
+      },
+      .client{
+          .auth_method = settings.client.auth_method,
+          .auth_timestamp_tolerance = settings.client.auth_timestamp_tolerance,
+          .logon_heartbeat_min = utils::safe_cast(settings.client.logon_heartbeat_min),
+          .logon_heartbeat_max = utils::safe_cast(settings.client.logon_heartbeat_max),
+          .request_timeout = settings.client.request_timeout,
+          .heartbeat_freq = utils::safe_cast(settings.client.heartbeat_freq),
+      },
+      .test{
+          .disable_remove_cl_ord_id = settings.test.disable_remove_cl_ord_id,
+      }};
+  return fix::proxy::Manager::create(handler, options);
+}
+
+bool Shared::verify(uint64_t session_id, std::string_view const &username, std::string_view const &password, std::string_view const &raw_data) {
+  if (verifier_ == nullptr) {
+    return false;
+  }
+  auto iter = credentials.find(username);
+  if (iter == std::end(credentials)) {
+    return false;  // note! rejected synchronously
+  }
+  return (*verifier_).submit(session_id, password, (*iter).second.key, raw_data);
 }
 
 }  // namespace fix_proxy
@@ -2,39 +2,92 @@
 
 #pragma once
 
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "roq/utils/container.hpp"
 
 #include "roq/fix/proxy/manager.hpp"
 
+#include "roq/fix_proxy/config.hpp"
+#include "roq/fix_proxy/entitlements.hpp"
+#include "roq/fix_proxy/journal.hpp"
+#include "roq/fix_proxy/messages.hpp"
+#include "roq/fix_proxy/metrics.hpp"
+#include "roq/fix_proxy/order_tracker.hpp"
+#include "roq/fix_proxy/profiler.hpp"
 #include "roq/fix_proxy/settings.hpp"
+#include "roq/fix_proxy/tracer.hpp"
+
+#include "roq/fix_proxy/tools/crypto.hpp"
+#include "roq/fix_proxy/tools/encode_buffer.hpp"
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+#include "roq/fix_proxy/tools/verifier.hpp"
+#include "roq/fix_proxy/tools/wakeup.hpp"
 
 namespace roq {
 namespace fix_proxy {
 
 struct Shared final {
-  Shared(Settings const &, fix::proxy::Manager &);
+  struct Credentials final {
+    std::string password;
+    uint32_t strategy_id = {};
+    std::string component;
+    tools::Crypto::Key key;  // note! precomputed from password
+    Entitlements<Messages::FromClient> entitlements;
+  };
+
+  Shared(Settings const &, Config const &, fix::proxy::Manager &, tools::Verifier *);
 
   Shared(Shared const &) = delete;
 
-  uint64_t next_session_id = {};
+  // note! one per upstream session (the first one is also used by all client sessions)
+  static std::unique_ptr<fix::proxy::Manager> create_proxy(fix::proxy::Manager::Handler &, Settings const &);
 
   Settings const &settings;
   fix::proxy::Manager &proxy;
 
-  void session_remove(uint64_t session_id) { sessions_to_remove_.emplace(session_id); }
+  utils::unordered_map<std::string, Credentials> const credentials;  // note! username => credentials
+
+  // note! scratch space lent to client sessions while decoding (sessions are processed sequentially by the event loop thread)
+  std::vector<std::byte> decode_buffer;
+  std::vector<std::byte> decode_buffer_2;
+  std::vector<std::span<std::byte const>> frames;
+
+  tools::FrameScanner const frame_scanner{true};  // note! client sessions handled by the event loop thread
+  tools::EncodeBuffer encode_buffer;                // note! client sessions handled by the event loop thread
+
+  Tracer tracer;
+  Metrics metrics;
+  Journal journal;
+  OrderTracker orders;
+  Profiler profiler;
+
+  tools::Wakeup wakeup;  // note! used by other threads to wake up the event loop thread (when not busy polling)
+
+  bool has_verifier() const { return verifier_ != nullptr; }
+
+  // note! returns true if verification has been queued (result is delivered asynchronously)
+  bool verify(uint64_t session_id, std::string_view const &username, std::string_view const &password, std::string_view const &raw_data);
+
+  void session_remove(uint64_t session_id) { sessions_to_remove_.emplace_back(session_id); }
+
+  bool session_cleanup_pending() const { return !std::empty(sessions_to_remove_); }
 
   template <typename Callback>
   void session_cleanup(Callback callback) {
-    for (auto session_id : sessions_to_remove_) {
-      callback(session_id);
+    for (size_t i = 0; i < std::size(sessions_to_remove_); ++i) {  // note! callback may append
+      callback(sessions_to_remove_[i]);
     }
     sessions_to_remove_.clear();
   }
 
  private:
-  utils::unordered_set<uint32_t> sessions_to_remove_;
+  tools::Verifier *const verifier_;
+  std::vector<uint64_t> sessions_to_remove_;
 };
 
 }  // namespace fix_proxy
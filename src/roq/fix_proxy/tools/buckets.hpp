@@ -0,0 +1,65 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// cumulative distribution using fixed upper bounds (the prometheus histogram type)
+// counts are never reset, prometheus derives rates and quantiles from the increase between scrapes
+// bounds must be strictly increasing and outlive the buckets, values above the last bound are only included by count() (+Inf)
+// counts are preallocated, recording a value is allocation free
+
+struct Buckets final {
+  explicit Buckets(std::span<uint64_t const> const &bounds) : bounds_{bounds}, counts_(std::size(bounds)) {
+    assert(std::is_sorted(std::begin(bounds), std::end(bounds)));
+  }
+
+  Buckets(Buckets &&) = default;
+  Buckets(Buckets const &) = delete;
+
+  // note! excludes sizeof(Buckets)
+  size_t memory_usage() const { return std::size(counts_) * sizeof(uint64_t); }
+
+  uint64_t count() const { return count_; }
+  uint64_t sum() const { return sum_; }
+
+  void record(uint64_t value) {
+    auto iter = std::lower_bound(std::begin(bounds_), std::end(bounds_), value);  // note! first bound >= value
+    if (iter != std::end(bounds_)) {
+      ++counts_[std::distance(std::begin(bounds_), iter)];
+    }
+    ++count_;
+    sum_ += value;
+  }
+
+  // note! callback(bound, count) is called for each bound in increasing order, count includes all values less than or equal to the bound
+  template <typename Callback>
+  void for_each(Callback callback) const {
+    uint64_t count = {};
+    for (size_t i = 0; i < std::size(bounds_); ++i) {
+      count += counts_[i];
+      callback(bounds_[i], count);
+    }
+  }
+
+ private:
+  std::span<uint64_t const> bounds_;
+  std::vector<uint64_t> counts_;
+  uint64_t count_ = {};
+  uint64_t sum_ = {};
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,90 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/context_wakeup.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === HELPERS ===
+
+namespace {
+auto create_path() {
+  return fmt::format("/tmp/roq-fix-proxy-wakeup-{}.sock"sv, ::getpid());
+}
+
+auto create_listener(auto &handler, auto &path, auto &context) {
+  ::unlink(path.c_str());  // note! stale socket from a previous run (same pid)
+  auto network_address = io::NetworkAddress{path};
+  return context.create_tcp_listener(handler, network_address);
+}
+
+// note! non-blocking, a producer must never block (wake-ups are coalesced)
+int create_connection(auto &path) {
+  auto result = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (result < 0) {
+    log::fatal("Unexpected: socket failed (error={})"sv, std::strerror(errno));
+  }
+  struct sockaddr_un sockaddr = {};
+  sockaddr.sun_family = AF_UNIX;
+  if (std::size(path) >= sizeof(sockaddr.sun_path)) {
+    log::fatal(R"(Unexpected: path="{}" (path is too long))"sv, path);
+  }
+  std::memcpy(sockaddr.sun_path, std::data(path), std::size(path));
+  if (::connect(result, reinterpret_cast<struct sockaddr const *>(&sockaddr), sizeof(sockaddr)) < 0) {
+    log::fatal(R"(Unexpected: unable to connect to "{}" (error={}))"sv, path, std::strerror(errno));
+  }
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+ContextWakeup::ContextWakeup(Handler &handler, io::Context &context, Wakeup &wakeup)
+    : handler_{handler}, path_{create_path()}, listener_{create_listener(*this, path_, context)} {
+  auto fd = create_connection(path_);  // note! completes before the connection has been accepted
+  ::unlink(path_.c_str());             // note! the connection outlives the path
+  wakeup.redirect(fd);
+}
+
+// io::net::tcp::Listener::Handler
+
+void ContextWakeup::operator()(io::net::tcp::Connection::Factory &factory) {
+  if (static_cast<bool>(connection_)) {
+    log::fatal("Unexpected"sv);
+  }
+  connection_ = factory.create(*this);
+}
+
+void ContextWakeup::operator()(io::net::tcp::Connection::Factory &factory, io::NetworkAddress const &) {
+  (*this)(factory);
+}
+
+// io::net::tcp::Connection::Handler
+
+void ContextWakeup::operator()(io::net::tcp::Connection::Read const &) {
+  buffer_.append(*connection_);
+  buffer_.drain(std::size(buffer_.data()));  // note! content is irrelevant
+  handler_(Notified{});
+}
+
+void ContextWakeup::operator()(io::net::tcp::Connection::Disconnected const &) {
+  log::fatal("Unexpected: wakeup connection was closed"sv);
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,56 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "roq/io/buffer.hpp"
+#include "roq/io/context.hpp"
+
+#include "roq/io/net/tcp/connection.hpp"
+
+#include "roq/fix_proxy/tools/wakeup.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// lets other threads wake up an event loop thread blocked in io::Context::dispatch()
+// the io::Context only observes sockets it owns: a private unix domain socket is accepted by the context and the wakeup is
+// redirected to the connecting end, i.e. producers are unchanged (notify) and the consumer must call prepare() before it
+// returns to the io::Context (and check for work after prepare)
+
+struct ContextWakeup final : public io::net::tcp::Listener::Handler, public io::net::tcp::Connection::Handler {
+  struct Notified final {};
+
+  struct Handler {
+    virtual void operator()(Notified const &) = 0;
+  };
+
+  ContextWakeup(Handler &, io::Context &, Wakeup &);
+
+  ContextWakeup(ContextWakeup &&) = delete;
+  ContextWakeup(ContextWakeup const &) = delete;
+
+ protected:
+  // io::net::tcp::Listener::Handler
+  void operator()(io::net::tcp::Connection::Factory &) override;
+  void operator()(io::net::tcp::Connection::Factory &, io::NetworkAddress const &) override;
+
+  // io::net::tcp::Connection::Handler
+  void operator()(io::net::tcp::Connection::Read const &) override;
+  void operator()(io::net::tcp::Connection::Disconnected const &) override;
+
+ private:
+  Handler &handler_;
+  std::string const path_;
+  std::unique_ptr<io::net::tcp::Listener> const listener_;
+  std::unique_ptr<io::net::tcp::Connection> connection_;
+  io::Buffer buffer_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,65 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// monotonic counters updated by a fixed number of threads, each thread owns a slot (padded to whole cache lines)
+// the owner updates its slot without read-modify-write (single writer), any thread may aggregate (relaxed loads)
+// aggregation is only done when the counters are being reported, the hot path never touches a shared cache line
+
+template <typename Key, size_t N>
+struct Counters final {
+  static constexpr size_t const CACHE_LINE_SIZE = 64;
+
+  struct alignas(CACHE_LINE_SIZE) Slot final {
+    // note! may only be called by the owner
+    void add(Key key, uint64_t value = 1) {
+      auto &counter = counters_[static_cast<size_t>(key)];
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    uint64_t get(Key key) const { return counters_[static_cast<size_t>(key)].load(std::memory_order_relaxed); }
+
+   private:
+    std::array<std::atomic<uint64_t>, N> counters_ = {};
+  };
+
+  explicit Counters(size_t slots) : slots_(slots) { assert(slots > 0); }
+
+  Counters(Counters &&) = delete;
+  Counters(Counters const &) = delete;
+
+  size_t size() const { return std::size(slots_); }
+
+  Slot &operator[](size_t index) {
+    assert(index < std::size(slots_));
+    return slots_[index];
+  }
+
+  // note! sum of all slots (values may be slightly stale)
+  uint64_t get(Key key) const {
+    uint64_t result = {};
+    for (auto &slot : slots_) {
+      result += slot.get(key);
+    }
+    return result;
+  }
+
+ private:
+  std::vector<Slot> slots_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -7,6 +7,8 @@
 
 #include <magic_enum/magic_enum_format.hpp>
 
+#include <span>
+
 #include "roq/clock.hpp"
 
 #include "roq/logging.hpp"
@@ -15,8 +17,6 @@
 
 #include "roq/utils/charconv/from_chars.hpp"
 
-#include "roq/utils/codec/base64.hpp"
-
 using namespace std::literals;
 
 namespace roq {
@@ -32,6 +32,84 @@ auto parse_method(auto &auth_method) {
   }
   return utils::parse_enum<Crypto::Method>(auth_method);
 };
+
+// note! returns 0xff if not a valid base64 character
+constexpr uint8_t decode_base64(char value) {
+  if (value >= 'A' && value <= 'Z') {
+    return value - 'A';
+  }
+  if (value >= 'a' && value <= 'z') {
+    return value - 'a' + 26;
+  }
+  if (value >= '0' && value <= '9') {
+    return value - '0' + 52;
+  }
+  if (value == '+') {
+    return 62;
+  }
+  if (value == '/') {
+    return 63;
+  }
+  return 0xff;
+}
+
+// note! decodes into a fixed size buffer, padding is optional
+bool decode_signature(HMAC::Digest &result, std::string_view const &signature) {
+  auto length = std::size(signature);
+  while (length > 0 && signature[length - 1] == '=') {
+    --length;
+  }
+  auto const expected = ((HMAC::DIGEST_LENGTH * 4) + 2) / 3;
+  if (length != expected) {
+    return false;
+  }
+  uint32_t buffer = {};
+  size_t bits = {}, offset = {};
+  for (size_t i = 0; i < length; ++i) {
+    auto value = decode_base64(signature[i]);
+    if (value == 0xff) {
+      return false;
+    }
+    buffer = (buffer << 6) | value;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      result[offset++] = static_cast<std::byte>(buffer >> bits);
+    }
+  }
+  // note! only accept the canonical encoding (unused bits must be zero)
+  if ((buffer & ((1u << bits) - 1)) != 0) {
+    return false;
+  }
+  return offset == std::size(result);
+}
+
+// note! constant time (length is not considered a secret)
+bool compare(std::span<std::byte const> const &lhs, std::span<std::byte const> const &rhs) {
+  if (std::size(lhs) != std::size(rhs)) {
+    return false;
+  }
+  std::byte result = {};
+  for (size_t i = 0; i < std::size(lhs); ++i) {
+    result |= lhs[i] ^ rhs[i];
+  }
+  return result == std::byte{};
+}
+
+bool compare(std::string_view const &lhs, std::string_view const &rhs) {
+  return compare(std::as_bytes(std::span{lhs}), std::as_bytes(std::span{rhs}));
+}
+
+bool validate_signature(std::string_view const &password, Crypto::Key const &key, std::string_view const &raw_data) {
+  HMAC::Digest received;
+  if (!decode_signature(received, password)) {
+    log::warn("DEBUG signature could not be decoded"sv);
+    return false;
+  }
+  HMAC::Digest computed;
+  HMAC::sign(computed, key, raw_data);
+  return compare(computed, received);
+}
 }  // namespace
 
 // === IMPLEMENTATION ===
@@ -43,61 +121,60 @@ Crypto::Crypto(std::string_view const &method, std::chrono::nanoseconds timestam
 
 template <>
 bool Crypto::validate_helper<Crypto::Method::UNDEFINED>(
-    std::string_view const &password, std::string_view const &secret, [[maybe_unused]] std::string_view const &raw_data) {
-  return password == secret;
+    std::string_view const &password,
+    std::string_view const &secret,
+    [[maybe_unused]] Key const &key,
+    [[maybe_unused]] std::string_view const &raw_data) const {
+  return compare(password, secret);
 }
 
 template <>
-bool Crypto::validate_helper<Crypto::Method::HMAC_SHA256>(std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data) {
-  MAC mac{secret};  // alloc
-  // mac.clear();
-  mac.update(raw_data);
-  auto digest = mac.final(digest_);
-  std::string signature;
-  utils::codec::Base64::encode(signature, digest, false, false);  // alloc
-  auto result = signature == password;
-  log::warn(R"(DEBUG computed="{}, received="{}")"sv, signature, password);
-  return result;
+bool Crypto::validate_helper<Crypto::Method::HMAC_SHA256>(
+    std::string_view const &password, [[maybe_unused]] std::string_view const &secret, Key const &key, std::string_view const &raw_data) const {
+  return validate_signature(password, key, raw_data);
 }
 
 template <>
 bool Crypto::validate_helper<Crypto::Method::HMAC_SHA256_TS>(
-    std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data) {
-  auto pos = raw_data.find_first_of('.');
-  if (pos == std::string_view::npos) {
-    log::warn(R"(DEBUG no period in raw_data="{}")"sv, raw_data);
+    std::string_view const &password, [[maybe_unused]] std::string_view const &secret, Key const &key, std::string_view const &raw_data) const {
+  std::chrono::milliseconds sending_time_utc;
+  if (!parse_timestamp(sending_time_utc, raw_data)) {
+    log::warn("DEBUG no period in raw_data"sv);
     return false;
   }
-  auto tmp = utils::charconv::from_chars<int64_t>(raw_data.substr(0, pos));
-  std::chrono::milliseconds sending_time_utc{tmp};
   auto now = clock::get_realtime();
   auto diff = sending_time_utc < now ? (now - sending_time_utc) : (sending_time_utc - now);
   if (diff > timestamp_tolerance_) {
     log::warn("DEBUG now={}, sending_time_utc={}"sv, now, sending_time_utc);
     return false;
   }
-  MAC mac{secret};  // alloc
-  // mac.clear();
-  mac.update(raw_data);
-  auto digest = mac.final(digest_);
-  std::string signature;
-  utils::codec::Base64::encode(signature, digest, false, false);  // alloc
-  if (signature != password) {
-    log::warn(R"(DEBUG computed="{}", password="{}")"sv, signature, password);
+  return validate_signature(password, key, raw_data);
+}
+
+bool Crypto::parse_timestamp(std::chrono::milliseconds &result, std::string_view const &raw_data) {
+  auto pos = raw_data.find_first_of('.');
+  if (pos == std::string_view::npos) {
     return false;
   }
+  auto tmp = utils::charconv::from_chars<int64_t>(raw_data.substr(0, pos));
+  result = std::chrono::milliseconds{tmp};
   return true;
 }
 
-bool Crypto::validate(std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data) {
+bool Crypto::validate(std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data) const {
+  auto key = method_ == Method::UNDEFINED ? Key{} : create_key(secret);
+  return validate(password, secret, key, raw_data);
+}
+
+bool Crypto::validate(std::string_view const &password, std::string_view const &secret, Key const &key, std::string_view const &raw_data) const {
   switch (method_) {
     using enum Method;
     case UNDEFINED:
-      return validate_helper<Method::UNDEFINED>(password, secret, raw_data);
+      return validate_helper<Method::UNDEFINED>(password, secret, key, raw_data);
     case HMAC_SHA256:
-      return validate_helper<Method::HMAC_SHA256>(password, secret, raw_data);
+      return validate_helper<Method::HMAC_SHA256>(password, secret, key, raw_data);
     case HMAC_SHA256_TS:
-      return validate_helper<Method::HMAC_SHA256_TS>(password, secret, raw_data);
+      return validate_helper<Method::HMAC_SHA256_TS>(password, secret, key, raw_data);
   }
   log::fatal("Unexpected"sv);
 }
@@ -5,24 +5,27 @@
 #include <chrono>
 #include <string_view>
 
-#include "roq/utils/hash/sha256.hpp"
-
-#include "roq/utils/mac/hmac.hpp"
+#include "roq/fix_proxy/tools/hmac.hpp"
 
 namespace roq {
 namespace fix_proxy {
 namespace tools {
 
 struct Crypto final {
-  using Hash = utils::hash::SHA256;
-  using MAC = utils::mac::HMAC<utils::hash::SHA256>;
+  using Key = HMAC::Key;
 
   Crypto(std::string_view const &method, std::chrono::nanoseconds timestamp_tolerance);
 
   Crypto(Crypto &&) = delete;
   Crypto(Crypto const &) = delete;
 
-  bool validate(std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data);
+  // note! pad state should be precomputed once per secret and cached next to the credentials
+  static Key create_key(std::string_view const &secret) { return HMAC::create_key(secret); }
+
+  // note! slow path, computes the key
+  bool validate(std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data) const;
+
+  bool validate(std::string_view const &password, std::string_view const &secret, Key const &, std::string_view const &raw_data) const;
 
   enum class Method {
     UNDEFINED,
@@ -30,14 +33,18 @@ struct Crypto final {
     HMAC_SHA256_TS,
   };
 
+  Method method() const { return method_; }
+
+  // note! hmac_sha256_ts: raw_data is a millisecond timestamp followed by a period and the nonce
+  static bool parse_timestamp(std::chrono::milliseconds &result, std::string_view const &raw_data);
+
  protected:
   template <Method>
-  bool validate_helper(std::string_view const &password, std::string_view const &secret, std::string_view const &raw_data);
+  bool validate_helper(std::string_view const &password, std::string_view const &secret, Key const &, std::string_view const &raw_data) const;
 
  private:
   Method const method_;
   std::chrono::nanoseconds const timestamp_tolerance_;
-  std::array<std::byte, MAC::DIGEST_LENGTH> digest_;
 };
 
 }  // namespace tools
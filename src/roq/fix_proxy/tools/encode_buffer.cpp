@@ -0,0 +1,48 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/encode_buffer.hpp"
+
+#include <algorithm>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === IMPLEMENTATION ===
+
+EncodeBuffer::EncodeBuffer(size_t max_size, std::chrono::nanoseconds quiet_period)
+    : initial_size_{std::min(INITIAL_SIZE, max_size)}, max_size_{max_size}, quiet_period_{quiet_period}, buffer_(initial_size_) {
+}
+
+void EncodeBuffer::refresh(std::chrono::nanoseconds now) {
+  if (used_) {
+    used_ = false;
+    next_shrink_ = now + quiet_period_;
+    return;
+  }
+  if (size() <= initial_size_ || now < next_shrink_) {
+    return;
+  }
+  log::info("Encode buffer is shrinking from {} to {} bytes"sv, size(), initial_size_);
+  std::vector<std::byte>(initial_size_).swap(buffer_);  // note! releases memory
+}
+
+bool EncodeBuffer::grow() {
+  if (size() >= max_size_) {
+    return false;
+  }
+  auto capacity = std::min(2 * size(), max_size_);
+  ++growth_count_;
+  log::info("Encode buffer is growing from {} to {} bytes (growth_count={})"sv, size(), capacity, growth_count_);
+  std::vector<std::byte>(capacity).swap(buffer_);  // note! content is discarded (message will be encoded again)
+  used_ = true;
+  return true;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,71 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "roq/exceptions.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// encode buffer starting small and growing geometrically (up to max_size) when a message doesn't fit
+// encoders throw OverflowError when the buffer is too small: the buffer is then grown and the message is encoded again
+// any other exception is propagated (the buffer is not grown)
+// the buffer shrinks back to its initial size once no message has needed the extra space for a quiet period
+
+struct EncodeBuffer final {
+  static constexpr size_t INITIAL_SIZE = 4096;
+
+  EncodeBuffer(size_t max_size, std::chrono::nanoseconds quiet_period);
+
+  EncodeBuffer(EncodeBuffer &&) = delete;
+  EncodeBuffer(EncodeBuffer const &) = delete;
+
+  size_t size() const { return std::size(buffer_); }
+
+  size_t growth_count() const { return growth_count_; }
+
+  // note! the result is only valid until the next call
+  template <typename Callback>
+  std::span<std::byte const> encode(Callback callback) {
+    while (true) {
+      try {
+        std::span<std::byte> buffer{buffer_};
+        auto length = callback(buffer);
+        if (length > initial_size_) [[unlikely]] {
+          used_ = true;
+        }
+        return buffer.subspan(0, length);
+      } catch (OverflowError &) {
+        if (!grow()) {
+          throw;
+        }
+      }
+    }
+  }
+
+  // note! should be called periodically
+  void refresh(std::chrono::nanoseconds now);
+
+ protected:
+  bool grow();
+
+ private:
+  size_t const initial_size_;
+  size_t const max_size_;
+  std::chrono::nanoseconds const quiet_period_;
+  std::vector<std::byte> buffer_;
+  size_t growth_count_ = {};
+  bool used_ = {};  // note! extra space has been needed since last refresh
+  std::chrono::nanoseconds next_shrink_ = {};
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,177 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <cassert>
+#include <cstring>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === CONSTANTS ===
+
+namespace {
+std::byte const SOH{0x1};
+
+size_t const CHECKSUM_LENGTH = 7;  // note! "10=XYZ|"
+
+size_t const MAX_BODY_LENGTH_DIGITS = 9;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+bool has_prefix(std::span<std::byte const> const &buffer, size_t offset, std::string_view const &prefix) {
+  return (offset + std::size(prefix)) <= std::size(buffer) && std::memcmp(std::data(buffer) + offset, std::data(prefix), std::size(prefix)) == 0;
+}
+
+bool is_digit(std::byte value) {
+  return value >= std::byte{'0'} && value <= std::byte{'9'};
+}
+
+uint32_t to_digit(std::byte value) {
+  return static_cast<uint32_t>(value) - '0';
+}
+
+using checksum_type = uint8_t (*)(std::span<std::byte const> const &);
+
+checksum_type get_checksum() {
+  if (FrameScanner::has_avx2()) {
+    return FrameScanner::checksum_avx2;
+  }
+  return FrameScanner::checksum_scalar;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+FrameScanner::FrameScanner(bool validate_checksum) : validate_checksum_{validate_checksum} {
+}
+
+FrameScanner::Result FrameScanner::scan(std::span<std::byte const> const &buffer, std::vector<std::span<std::byte const>> &frames) const {
+  Result result;
+  while (result.bytes < std::size(buffer)) {
+    auto frame = buffer.subspan(result.bytes);
+    // 8=BeginString|
+    if (std::size(frame) < 2 && frame[0] == std::byte{'8'}) {
+      break;  // note! incomplete
+    }
+    if (!has_prefix(frame, 0, "8="sv)) {
+      result.status = Status::INVALID_BEGIN_STRING;
+      break;
+    }
+    auto end = static_cast<std::byte const *>(std::memchr(std::data(frame), static_cast<int>(SOH), std::size(frame)));
+    if (end == nullptr) {
+      break;  // note! incomplete
+    }
+    size_t offset = (end - std::data(frame)) + 1;
+    // 9=BodyLength|
+    if (!has_prefix(frame, offset, "9="sv)) {
+      if ((offset + 2) > std::size(frame)) {
+        break;  // note! incomplete
+      }
+      result.status = Status::INVALID_BODY_LENGTH;
+      break;
+    }
+    offset += 2;
+    uint32_t body_length = {};
+    size_t digits = 0;
+    while (offset < std::size(frame) && is_digit(frame[offset]) && digits <= MAX_BODY_LENGTH_DIGITS) {
+      body_length = (body_length * 10) + to_digit(frame[offset]);
+      ++offset;
+      ++digits;
+    }
+    if (offset == std::size(frame)) {
+      break;  // note! incomplete
+    }
+    if (digits == 0 || digits > MAX_BODY_LENGTH_DIGITS || frame[offset] != SOH) {
+      result.status = Status::INVALID_BODY_LENGTH;
+      break;
+    }
+    ++offset;
+    // ...|10=CheckSum|
+    auto body_end = offset + body_length;
+    auto length = body_end + CHECKSUM_LENGTH;
+    if (length > std::size(frame)) {
+      break;  // note! incomplete
+    }
+    if (!has_prefix(frame, body_end, "10="sv) || frame[length - 1] != SOH) {
+      result.status = Status::INVALID_BODY_LENGTH;  // note! checksum tag must follow the body
+      break;
+    }
+    if (validate_checksum_) {
+      auto tmp = frame.subspan(body_end + 3, 3);
+      if (!is_digit(tmp[0]) || !is_digit(tmp[1]) || !is_digit(tmp[2])) {
+        result.status = Status::INVALID_CHECKSUM;
+        break;
+      }
+      auto expected = (to_digit(tmp[0]) * 100) + (to_digit(tmp[1]) * 10) + to_digit(tmp[2]);
+      if (checksum(frame.subspan(0, body_end)) != expected) {
+        result.status = Status::INVALID_CHECKSUM;
+        break;
+      }
+    }
+    frames.emplace_back(frame.subspan(0, length));
+    result.bytes += length;
+  }
+  return result;
+}
+
+bool FrameScanner::has_avx2() {
+#if defined(__x86_64__)
+  static bool const result = __builtin_cpu_supports("avx2");
+  return result;
+#else
+  return false;
+#endif
+}
+
+uint8_t FrameScanner::checksum(std::span<std::byte const> const &buffer) {
+  static checksum_type const result = get_checksum();
+  return (*result)(buffer);
+}
+
+uint8_t FrameScanner::checksum_scalar(std::span<std::byte const> const &buffer) {
+  uint32_t result = {};
+  for (auto value : buffer) {
+    result += static_cast<uint8_t>(value);
+  }
+  return static_cast<uint8_t>(result);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) uint8_t FrameScanner::checksum_avx2(std::span<std::byte const> const &buffer) {
+  auto data = reinterpret_cast<uint8_t const *>(std::data(buffer));
+  auto length = std::size(buffer);
+  auto zero = _mm256_setzero_si256();
+  auto sum = _mm256_setzero_si256();
+  size_t i = 0;
+  // note! sad against zero sums each group of 8 bytes into a 64-bit lane
+  for (; (i + 32) <= length; i += 32) {
+    auto value = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i));
+    sum = _mm256_add_epi64(sum, _mm256_sad_epu8(value, zero));
+  }
+  auto tmp = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+  auto result = static_cast<uint64_t>(_mm_cvtsi128_si64(tmp)) + static_cast<uint64_t>(_mm_extract_epi64(tmp, 1));
+  for (; i < length; ++i) {
+    result += data[i];
+  }
+  return static_cast<uint8_t>(result);
+}
+#else
+uint8_t FrameScanner::checksum_avx2(std::span<std::byte const> const &buffer) {
+  return checksum_scalar(buffer);
+}
+#endif
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,53 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// finds all complete FIX frames in a buffer: 8=BeginString|9=BodyLength|...|10=CheckSum|
+// BodyLength is validated by finding the CheckSum tag exactly where it is expected
+// CheckSum is the sum of all bytes preceding the CheckSum tag (modulo 256)
+// the checksum is computed using AVX2 when supported by the CPU (chosen at runtime) with a scalar fallback
+
+struct FrameScanner final {
+  enum class Status {
+    OK,
+    INVALID_BEGIN_STRING,
+    INVALID_BODY_LENGTH,
+    INVALID_CHECKSUM,
+  };
+
+  struct Result final {
+    size_t bytes = {};  // note! frames are contiguous
+    Status status = {};
+  };
+
+  explicit FrameScanner(bool validate_checksum);
+
+  FrameScanner(FrameScanner &&) = delete;
+  FrameScanner(FrameScanner const &) = delete;
+
+  // note! frames are appended, scanning stops at the first incomplete or invalid frame
+  Result scan(std::span<std::byte const> const &buffer, std::vector<std::span<std::byte const>> &frames) const;
+
+  static bool has_avx2();
+
+  static uint8_t checksum(std::span<std::byte const> const &);
+  static uint8_t checksum_scalar(std::span<std::byte const> const &);
+  static uint8_t checksum_avx2(std::span<std::byte const> const &);  // note! only if has_avx2()
+
+ private:
+  bool const validate_checksum_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,140 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === HELPERS ===
+
+namespace {
+auto get_sub_bucket_half_count_magnitude(auto highest_trackable_value, auto significant_figures) -> uint32_t {
+  if (significant_figures < 1 || significant_figures > 5) {
+    log::fatal("Unexpected: significant_figures={} (must be in the range [1, 5])"sv, significant_figures);
+  }
+  if (highest_trackable_value < 2) {
+    log::fatal("Unexpected: highest_trackable_value={} (must be at least 2)"sv, highest_trackable_value);
+  }
+  auto largest_value_with_single_unit_resolution = 2.0 * std::pow(10.0, significant_figures);
+  auto sub_bucket_count_magnitude = static_cast<uint32_t>(std::ceil(std::log2(largest_value_with_single_unit_resolution)));
+  return std::max<uint32_t>(sub_bucket_count_magnitude, 1) - 1;
+}
+
+size_t get_bucket_count(uint64_t highest_trackable_value, uint64_t sub_bucket_count) {
+  size_t result = 1;
+  auto smallest_untrackable_value = sub_bucket_count;
+  while (smallest_untrackable_value <= highest_trackable_value) {
+    ++result;
+    if (smallest_untrackable_value > (std::numeric_limits<uint64_t>::max() >> 1)) {
+      break;
+    }
+    smallest_untrackable_value <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Histogram::Histogram(uint64_t highest_trackable_value, uint32_t significant_figures)
+    : highest_trackable_value_{highest_trackable_value},
+      sub_bucket_half_count_magnitude_{get_sub_bucket_half_count_magnitude(highest_trackable_value, significant_figures)},
+      sub_bucket_half_count_{uint64_t{1} << sub_bucket_half_count_magnitude_}, sub_bucket_mask_{(sub_bucket_half_count_ << 1) - 1},
+      counts_((get_bucket_count(highest_trackable_value, sub_bucket_half_count_ << 1) + 1) * sub_bucket_half_count_) {
+}
+
+uint64_t Histogram::min() const {
+  return total_count_ != 0 ? min_ : 0;
+}
+
+uint64_t Histogram::max() const {
+  return max_;
+}
+
+double Histogram::mean() const {
+  return total_count_ != 0 ? sum_ / static_cast<double>(total_count_) : 0.0;
+}
+
+uint64_t Histogram::value_at_percentile(double percentile) const {
+  if (total_count_ == 0) {
+    return {};
+  }
+  auto fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+  auto count_at_percentile = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total_count_))), 1);
+  uint64_t total = {};
+  for (size_t i = 0; i < std::size(counts_); ++i) {
+    total += counts_[i];
+    if (total >= count_at_percentile) {
+      return std::clamp(highest_equivalent_value(i), min_, max_);
+    }
+  }
+  return max_;
+}
+
+void Histogram::record(uint64_t value, uint64_t count) {
+  value = std::min(value, highest_trackable_value_);
+  counts_[index_of(value)] += count;
+  min_ = total_count_ != 0 ? std::min(min_, value) : value;
+  max_ = std::max(max_, value);
+  total_count_ += count;
+  sum_ += static_cast<double>(value) * static_cast<double>(count);
+}
+
+void Histogram::reset() {
+  std::fill(std::begin(counts_), std::end(counts_), 0);
+  total_count_ = {};
+  min_ = {};
+  max_ = {};
+  sum_ = {};
+}
+
+void Histogram::merge(Histogram const &other) {
+  assert(std::size(counts_) == std::size(other.counts_));
+  if (other.total_count_ == 0) {
+    return;
+  }
+  for (size_t i = 0; i < std::size(counts_); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  min_ = total_count_ != 0 ? std::min(min_, other.min_) : other.min_;
+  max_ = std::max(max_, other.max_);
+  total_count_ += other.total_count_;
+  sum_ += other.sum_;
+}
+
+size_t Histogram::index_of(uint64_t value) const {
+  auto pow2_ceiling = 64 - std::countl_zero(value | sub_bucket_mask_);
+  auto bucket_index = pow2_ceiling - static_cast<int32_t>(sub_bucket_half_count_magnitude_ + 1);
+  auto sub_bucket_index = value >> bucket_index;
+  return (static_cast<size_t>(bucket_index + 1) << sub_bucket_half_count_magnitude_) + (sub_bucket_index - sub_bucket_half_count_);
+}
+
+uint64_t Histogram::lowest_equivalent_value(size_t index) const {
+  auto bucket_index = static_cast<int32_t>(index >> sub_bucket_half_count_magnitude_) - 1;
+  auto sub_bucket_index = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+  if (bucket_index < 0) {
+    sub_bucket_index -= sub_bucket_half_count_;
+    bucket_index = 0;
+  }
+  return sub_bucket_index << bucket_index;
+}
+
+uint64_t Histogram::highest_equivalent_value(size_t index) const {
+  auto bucket_index = std::max(static_cast<int32_t>(index >> sub_bucket_half_count_magnitude_) - 1, 0);
+  return lowest_equivalent_value(index) + (uint64_t{1} << bucket_index) - 1;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
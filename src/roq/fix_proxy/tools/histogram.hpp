@@ -0,0 +1,76 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// high dynamic range histogram (same bucketing as HdrHistogram)
+// values are grouped into power-of-two buckets, each bucket is linearly divided into sub-buckets
+// the relative error is bounded by the number of significant figures (3 means 0.1%)
+// counts are preallocated, recording a value is allocation free
+// values above highest_trackable_value are clamped
+
+struct Histogram final {
+  Histogram(uint64_t highest_trackable_value, uint32_t significant_figures);
+
+  Histogram(Histogram &&) = default;
+  Histogram(Histogram const &) = delete;
+
+  uint64_t highest_trackable_value() const { return highest_trackable_value_; }
+
+  // note! excludes sizeof(Histogram)
+  size_t memory_usage() const { return std::size(counts_) * sizeof(uint64_t); }
+
+  uint64_t count() const { return total_count_; }
+  uint64_t min() const;
+  uint64_t max() const;
+  double mean() const;
+
+  // note! percentile is in the range [0, 100]
+  uint64_t value_at_percentile(double percentile) const;
+
+  void record(uint64_t value, uint64_t count = 1);
+
+  void reset();
+
+  // note! requires the same configuration
+  void merge(Histogram const &);
+
+  // note! callback(value, count) is called for each non-empty bucket in increasing order of value
+  template <typename Callback>
+  void for_each(Callback callback) const {
+    for (size_t i = 0; i < std::size(counts_); ++i) {
+      if (counts_[i] != 0) {
+        callback(highest_equivalent_value(i), counts_[i]);
+      }
+    }
+  }
+
+ protected:
+  size_t index_of(uint64_t value) const;
+
+  uint64_t lowest_equivalent_value(size_t index) const;
+  uint64_t highest_equivalent_value(size_t index) const;
+
+ private:
+  uint64_t const highest_trackable_value_;
+  uint32_t const sub_bucket_half_count_magnitude_;
+  uint64_t const sub_bucket_half_count_;
+  uint64_t const sub_bucket_mask_;
+  std::vector<uint64_t> counts_;
+  uint64_t total_count_ = {};
+  uint64_t min_ = {};
+  uint64_t max_ = {};
+  double sum_ = {};
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
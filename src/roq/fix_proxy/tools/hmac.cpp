@@ -0,0 +1,152 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/hmac.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === CONSTANTS ===
+
+namespace {
+constexpr std::array<uint32_t, 8> const INITIAL_HASH{
+    0x6a09e667,
+    0xbb67ae85,
+    0x3c6ef372,
+    0xa54ff53a,
+    0x510e527f,
+    0x9b05688c,
+    0x1f83d9ab,
+    0x5be0cd19,
+};
+
+constexpr std::array<uint32_t, 64> const ROUND_CONSTANTS{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be,
+    0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa,
+    0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+    0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+    0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr uint8_t const INNER_PAD = 0x36;
+constexpr uint8_t const OUTER_PAD = 0x5c;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+void compress(std::array<uint32_t, 8> &hash, uint8_t const *block) {
+  std::array<uint32_t, 64> w;
+  for (size_t i = 0; i < 16; ++i) {
+    w[i] = (static_cast<uint32_t>(block[(i * 4) + 0]) << 24) | (static_cast<uint32_t>(block[(i * 4) + 1]) << 16) |
+           (static_cast<uint32_t>(block[(i * 4) + 2]) << 8) | static_cast<uint32_t>(block[(i * 4) + 3]);
+  }
+  for (size_t i = 16; i < 64; ++i) {
+    auto s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    auto s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+  auto [a, b, c, d, e, f, g, h] = hash;
+  for (size_t i = 0; i < 64; ++i) {
+    auto s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+    auto ch = (e & f) ^ (~e & g);
+    auto tmp_1 = h + s1 + ch + ROUND_CONSTANTS[i] + w[i];
+    auto s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+    auto maj = (a & b) ^ (a & c) ^ (b & c);
+    auto tmp_2 = s0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + tmp_1;
+    d = c;
+    c = b;
+    b = a;
+    a = tmp_1 + tmp_2;
+  }
+  hash[0] += a;
+  hash[1] += b;
+  hash[2] += c;
+  hash[3] += d;
+  hash[4] += e;
+  hash[5] += f;
+  hash[6] += g;
+  hash[7] += h;
+}
+
+// note! absorbs message and applies the final padding
+void finalize(HMAC::Digest &digest, HMAC::State state, uint8_t const *data, size_t length) {
+  auto total = state.length + length;
+  while (length >= HMAC::BLOCK_LENGTH) {
+    compress(state.hash, data);
+    data += HMAC::BLOCK_LENGTH;
+    length -= HMAC::BLOCK_LENGTH;
+  }
+  std::array<uint8_t, HMAC::BLOCK_LENGTH * 2> tail = {};
+  std::memcpy(std::data(tail), data, length);
+  tail[length] = 0x80;
+  auto blocks = (length + 1 + 8) > HMAC::BLOCK_LENGTH ? 2 : 1;
+  auto bits = total * 8;
+  auto end = (blocks * HMAC::BLOCK_LENGTH);
+  for (size_t i = 0; i < 8; ++i) {
+    tail[end - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+  }
+  for (size_t i = 0; i < static_cast<size_t>(blocks); ++i) {
+    compress(state.hash, &tail[i * HMAC::BLOCK_LENGTH]);
+  }
+  for (size_t i = 0; i < 8; ++i) {
+    auto value = state.hash[i];
+    digest[(i * 4) + 0] = static_cast<std::byte>(value >> 24);
+    digest[(i * 4) + 1] = static_cast<std::byte>(value >> 16);
+    digest[(i * 4) + 2] = static_cast<std::byte>(value >> 8);
+    digest[(i * 4) + 3] = static_cast<std::byte>(value);
+  }
+}
+
+auto create_state(std::array<uint8_t, HMAC::BLOCK_LENGTH> const &key, uint8_t pad) {
+  std::array<uint8_t, HMAC::BLOCK_LENGTH> block;
+  for (size_t i = 0; i < HMAC::BLOCK_LENGTH; ++i) {
+    block[i] = key[i] ^ pad;
+  }
+  auto result = HMAC::State{
+      .hash = INITIAL_HASH,
+      .length = HMAC::BLOCK_LENGTH,
+  };
+  compress(result.hash, std::data(block));
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+HMAC::Key HMAC::create_key(std::string_view const &secret) {
+  std::array<uint8_t, BLOCK_LENGTH> key = {};
+  if (std::size(secret) > BLOCK_LENGTH) {
+    Digest digest;
+    auto state = State{
+        .hash = INITIAL_HASH,
+        .length = {},
+    };
+    finalize(digest, state, reinterpret_cast<uint8_t const *>(std::data(secret)), std::size(secret));
+    std::memcpy(std::data(key), std::data(digest), std::size(digest));
+  } else {
+    std::memcpy(std::data(key), std::data(secret), std::size(secret));
+  }
+  return {
+      .inner = create_state(key, INNER_PAD),
+      .outer = create_state(key, OUTER_PAD),
+  };
+}
+
+void HMAC::sign(Digest &digest, Key const &key, std::string_view const &message) {
+  Digest inner;
+  finalize(inner, key.inner, reinterpret_cast<uint8_t const *>(std::data(message)), std::size(message));
+  finalize(digest, key.outer, reinterpret_cast<uint8_t const *>(std::data(inner)), std::size(inner));
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
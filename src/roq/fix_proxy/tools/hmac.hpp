@@ -0,0 +1,43 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// HMAC/SHA256 where the inner and outer pad state is computed once per secret (Key)
+// signing is then allocation free and only hashes the message (+ 1 block for the outer digest)
+// Key is trivially copyable and can be handed to other threads
+
+struct HMAC final {
+  static constexpr size_t BLOCK_LENGTH = 64;
+  static constexpr size_t DIGEST_LENGTH = 32;
+
+  using Digest = std::array<std::byte, DIGEST_LENGTH>;
+
+  struct State final {
+    std::array<uint32_t, 8> hash = {};
+    uint64_t length = {};  // bytes absorbed
+  };
+
+  struct Key final {
+    State inner;
+    State outer;
+  };
+
+  static Key create_key(std::string_view const &secret);
+
+  static void sign(Digest &, Key const &, std::string_view const &message);
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
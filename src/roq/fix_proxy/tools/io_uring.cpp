@@ -0,0 +1,220 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/io_uring.hpp"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === CONSTANTS ===
+
+namespace {
+uint32_t const COMPLETION_QUEUE_MULTIPLIER = 4;  // note! multishot requests produce many completions per submission
+
+uint16_t const BUFFER_GROUP = 0;
+
+uint32_t const MAX_BUFFER_COUNT = 65536;  // note! buffer id is 16 bits
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_io_uring(auto entries, auto &params) {
+  params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+  params.cq_entries = COMPLETION_QUEUE_MULTIPLIER * entries;
+  auto result = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  if (result < 0) {
+    log::fatal("Unexpected: io_uring_setup failed (error={})"sv, std::strerror(errno));  // note! EINVAL means the kernel is too old
+  }
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+    log::fatal("Unexpected: io_uring is not supported by the kernel (features={:#x})"sv, params.features);
+  }
+  return result;
+}
+
+// note! anonymous if fd is negative
+auto create_mapping(size_t length, int fd, off_t offset) {
+  auto flags = fd < 0 ? (MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE) : (MAP_SHARED | MAP_POPULATE);
+  auto result = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, fd, offset);
+  if (result == MAP_FAILED) {
+    log::fatal("Unexpected: mmap failed (error={})"sv, std::strerror(errno));
+  }
+  return std::span{static_cast<std::byte *>(result), length};
+}
+
+template <typename T>
+T *get(auto &mapping, uint32_t offset) {
+  return reinterpret_cast<T *>(std::data(mapping) + offset);
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+IoUring::IoUring(uint32_t entries, uint32_t buffer_count, uint32_t buffer_size)
+    : fd_{create_io_uring(entries, params_)}, buffer_count_{buffer_count}, buffer_size_{buffer_size} {
+  auto sq_size = params_.sq_off.array + params_.sq_entries * sizeof(uint32_t);
+  auto cq_size = params_.cq_off.cqes + params_.cq_entries * sizeof(struct io_uring_cqe);
+  ring_ = create_mapping(std::max(sq_size, cq_size), fd_, IORING_OFF_SQ_RING);  // note! shared by both queues
+  sqes_ = create_mapping(params_.sq_entries * sizeof(struct io_uring_sqe), fd_, IORING_OFF_SQES);
+  sq_head_ = get<uint32_t>(ring_, params_.sq_off.head);
+  sq_tail_ = get<uint32_t>(ring_, params_.sq_off.tail);
+  sq_flags_ = get<uint32_t>(ring_, params_.sq_off.flags);
+  sq_mask_ = *get<uint32_t>(ring_, params_.sq_off.ring_mask);
+  auto array = get<uint32_t>(ring_, params_.sq_off.array);
+  for (uint32_t i = 0; i < params_.sq_entries; ++i) {
+    array[i] = i;  // note! submission queue entries are used in order
+  }
+  cq_head_ = get<uint32_t>(ring_, params_.cq_off.head);
+  cq_tail_ = get<uint32_t>(ring_, params_.cq_off.tail);
+  cqes_ = get<struct io_uring_cqe>(ring_, params_.cq_off.cqes);
+  cq_mask_ = *get<uint32_t>(ring_, params_.cq_off.ring_mask);
+  prepared_ = *sq_tail_;
+  if (buffer_count_ == 0 || buffer_count_ > MAX_BUFFER_COUNT) {
+    log::fatal("Unexpected: buffer_count={} (max={})"sv, buffer_count_, MAX_BUFFER_COUNT);
+  }
+  buffers_ = create_mapping(size_t{buffer_count_} * buffer_size_, -1, 0);
+  provide(0, buffer_count_);
+}
+
+IoUring::~IoUring() {
+  ::close(fd_);  // note! outstanding requests are cancelled
+  ::munmap(std::data(buffers_), std::size(buffers_));
+  ::munmap(std::data(sqes_), std::size(sqes_));
+  ::munmap(std::data(ring_), std::size(ring_));
+}
+
+void IoUring::accept(int fd, uint64_t user_data) {
+  auto &sqe = acquire();
+  sqe.opcode = IORING_OP_ACCEPT;
+  sqe.fd = fd;
+  sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe.accept_flags = SOCK_CLOEXEC;
+  sqe.user_data = user_data;
+}
+
+void IoUring::receive(int fd, uint64_t user_data) {
+  auto &sqe = acquire();
+  sqe.opcode = IORING_OP_RECV;
+  sqe.fd = fd;
+  sqe.flags = IOSQE_BUFFER_SELECT;
+  sqe.ioprio = IORING_RECV_MULTISHOT;
+  sqe.buf_group = BUFFER_GROUP;
+  sqe.user_data = user_data;
+}
+
+void IoUring::read(int fd, std::span<std::byte> const &buffer, uint64_t user_data) {
+  auto &sqe = acquire();
+  sqe.opcode = IORING_OP_READ;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<uint64_t>(std::data(buffer));
+  sqe.len = static_cast<uint32_t>(std::size(buffer));
+  sqe.off = ~uint64_t{};  // note! current file position (not seekable)
+  sqe.user_data = user_data;
+}
+
+void IoUring::send(int fd, std::span<std::byte const> const &buffer, uint64_t user_data) {
+  auto &sqe = acquire();
+  sqe.opcode = IORING_OP_SEND;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<uint64_t>(std::data(buffer));
+  sqe.len = static_cast<uint32_t>(std::size(buffer));
+  sqe.msg_flags = MSG_NOSIGNAL;
+  sqe.user_data = user_data;
+}
+
+void IoUring::cancel(uint64_t target, uint64_t user_data) {
+  auto &sqe = acquire();
+  sqe.opcode = IORING_OP_ASYNC_CANCEL;
+  sqe.fd = -1;
+  sqe.addr = target;
+  sqe.user_data = user_data;
+}
+
+void IoUring::cancel_all(uint64_t user_data) {
+  auto &sqe = acquire();
+  sqe.opcode = IORING_OP_ASYNC_CANCEL;
+  sqe.fd = -1;
+  sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY | IORING_ASYNC_CANCEL_ALL;
+  sqe.user_data = user_data;
+}
+
+bool IoUring::enter(std::chrono::nanoseconds timeout) {
+  auto submit = prepared_ - std::atomic_ref{*sq_head_}.load(std::memory_order_acquire);
+  std::atomic_ref{*sq_tail_}.store(prepared_, std::memory_order_release);
+  auto wait = timeout.count() > 0;
+  // note! completions may be pending (task work) or have overflowed
+  auto flags = std::atomic_ref{*sq_flags_}.load(std::memory_order_relaxed);
+  auto get_events = wait || (flags & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW)) != 0;
+  if (submit == 0 && !get_events) {
+    return false;
+  }
+  auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  struct __kernel_timespec timespec = {
+      .tv_sec = seconds.count(),
+      .tv_nsec = (timeout - seconds).count(),
+  };
+  struct io_uring_getevents_arg getevents_arg = {};
+  getevents_arg.ts = reinterpret_cast<uint64_t>(&timespec);
+  auto enter_flags = (get_events ? IORING_ENTER_GETEVENTS : 0u) | (wait ? IORING_ENTER_EXT_ARG : 0u);
+  ++system_calls_;
+  auto result = ::syscall(
+      __NR_io_uring_enter, fd_, submit, wait ? 1u : 0u, enter_flags, wait ? &getevents_arg : nullptr, wait ? sizeof(getevents_arg) : size_t{0});
+  if (result < 0 && errno != EINTR && errno != ETIME && errno != EBUSY && errno != EAGAIN) {
+    log::fatal("Unexpected: io_uring_enter failed (error={})"sv, std::strerror(errno));
+  }
+  return true;
+}
+
+std::span<std::byte const> IoUring::buffer(uint16_t buffer_id, size_t length) const {
+  return buffers_.subspan(size_t{buffer_id} * buffer_size_, length);
+}
+
+void IoUring::release(uint16_t buffer_id) {
+  provide(buffer_id, 1);
+}
+
+// utilities
+
+void IoUring::provide(uint16_t buffer_id, uint32_t count) {
+  auto &sqe = acquire();
+  sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+  sqe.fd = static_cast<int32_t>(count);
+  sqe.addr = reinterpret_cast<uint64_t>(std::data(buffers_) + size_t{buffer_id} * buffer_size_);
+  sqe.len = buffer_size_;
+  sqe.off = buffer_id;
+  sqe.buf_group = BUFFER_GROUP;
+  sqe.user_data = PROVIDED;
+}
+
+void IoUring::provided(Completion const &completion) {
+  if (completion.result < 0) [[unlikely]] {
+    log::fatal("Unexpected: provide buffers failed (error={})"sv, std::strerror(-completion.result));
+  }
+}
+
+struct io_uring_sqe &IoUring::acquire() {
+  if ((prepared_ - std::atomic_ref{*sq_head_}.load(std::memory_order_acquire)) >= params_.sq_entries) [[unlikely]] {
+    enter(0ns);  // note! the kernel consumes all entries (IORING_SETUP_SUBMIT_ALL)
+  }
+  auto &result = reinterpret_cast<struct io_uring_sqe *>(std::data(sqes_))[prepared_ & sq_mask_];
+  result = {};
+  ++prepared_;
+  return result;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
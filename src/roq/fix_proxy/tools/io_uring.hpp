@@ -0,0 +1,126 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// minimal io_uring using the system calls directly (i.e. not liburing), only to be used by a single thread
+// requests are prepared in the submission queue and all of them are submitted by the next call to enter() (one system call)
+// accept and receive are multishot: a request keeps producing completions until it has been cancelled or terminated
+// received bytes are placed by the kernel into buffers selected from a group of buffers provided to io_uring
+// the buffer of a completion must be released after use, a multishot receive is terminated when there are no free buffers
+// user_data identifies the request (chosen by the caller, except for PROVIDED which is reserved)
+// provided buffers use IORING_OP_PROVIDE_BUFFERS, i.e. not a registered buffer ring (IORING_REGISTER_PBUF_RING), because the
+// latter has been observed to fail receive with ENOBUFS on some kernels (released buffers are resubmitted by the next enter)
+
+struct IoUring final {
+  static constexpr uint64_t PROVIDED = ~uint64_t{};  // note! reserved user_data
+
+  struct Completion final {
+    uint64_t user_data = {};
+    int32_t result = {};  // note! negative errno
+    uint32_t flags = {};
+
+    bool more() const { return (flags & IORING_CQE_F_MORE) != 0; }  // note! multishot request has not been terminated
+    bool has_buffer() const { return (flags & IORING_CQE_F_BUFFER) != 0; }
+    uint16_t buffer_id() const { return static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT); }
+  };
+
+  // note! buffer_count can not exceed 65536
+  IoUring(uint32_t entries, uint32_t buffer_count, uint32_t buffer_size);
+
+  IoUring(IoUring &&) = delete;
+  IoUring(IoUring const &) = delete;
+
+  ~IoUring();
+
+  void accept(int fd, uint64_t user_data);
+  void receive(int fd, uint64_t user_data);
+
+  // note! buffer must remain valid until the completion
+  void read(int fd, std::span<std::byte> const &, uint64_t user_data);
+  void send(int fd, std::span<std::byte const> const &, uint64_t user_data);
+
+  // note! the request identified by target (its user_data), the result is -ENOENT if it has already completed
+  void cancel(uint64_t target, uint64_t user_data);
+
+  // note! requests are not cancelled when the submitting thread exits, the result is the number of requests cancelled
+  void cancel_all(uint64_t user_data);
+
+  // note! submits all prepared requests and waits for at least one completion unless the timeout is zero
+  // returns false if a system call was not needed (nothing to submit and not waiting)
+  bool enter(std::chrono::nanoseconds timeout);
+
+  // returns the number of completions dispatched
+  template <typename Callback>
+  size_t dispatch(Callback callback) {
+    auto head = *cq_head_;
+    auto tail = std::atomic_ref{*cq_tail_}.load(std::memory_order_acquire);
+    size_t result = 0;
+    while (head != tail) {
+      auto &cqe = cqes_[head & cq_mask_];
+      auto completion = Completion{
+          .user_data = cqe.user_data,
+          .result = cqe.res,
+          .flags = cqe.flags,
+      };
+      std::atomic_ref{*cq_head_}.store(++head, std::memory_order_release);  // note! before the callback (which may prepare requests)
+      if (completion.user_data == PROVIDED) {
+        provided(completion);
+        continue;
+      }
+      callback(completion);
+      ++result;
+    }
+    return result;
+  }
+
+  std::span<std::byte const> buffer(uint16_t buffer_id, size_t length) const;
+
+  void release(uint16_t buffer_id);
+
+  // note! number of system calls made by enter() (also when the submission queue was full)
+  uint64_t system_calls() const { return system_calls_; }
+
+ protected:
+  // note! submits if the submission queue is full
+  struct io_uring_sqe &acquire();
+
+  void provide(uint16_t buffer_id, uint32_t count);
+  void provided(Completion const &);
+
+ private:
+  struct io_uring_params params_ = {};
+  int const fd_;
+  std::span<std::byte> ring_;
+  std::span<std::byte> sqes_;
+  uint32_t *sq_tail_ = {};
+  uint32_t *sq_head_ = {};
+  uint32_t *sq_flags_ = {};
+  uint32_t sq_mask_ = {};
+  uint32_t *cq_head_ = {};
+  uint32_t *cq_tail_ = {};
+  struct io_uring_cqe *cqes_ = {};
+  uint32_t cq_mask_ = {};
+  uint32_t prepared_ = {};  // note! submission queue tail (published by enter)
+  // provided buffers
+  uint32_t const buffer_count_;
+  uint32_t const buffer_size_;
+  std::span<std::byte> buffers_;
+  uint64_t system_calls_ = {};
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
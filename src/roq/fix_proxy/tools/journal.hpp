@@ -0,0 +1,55 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// binary journal of raw fix frames (segment files written by JournalWriter, read by JournalReader)
+// a segment starts with a file header followed by records, each record is a header followed by the raw frame
+// integers use the host byte order (the journal is not meant to be moved between architectures)
+// timestamps are recorded using the (monotonic) system clock, the file header allows conversion to realtime
+
+struct Journal final {
+  static constexpr std::array<char, 8> const MAGIC = {'R', 'O', 'Q', 'F', 'I', 'X', 'J', 'L'};
+  static constexpr uint32_t const VERSION = 1;
+
+  enum class Peer : uint8_t {
+    CLIENT,
+    SERVER,
+  };
+
+  enum class Direction : uint8_t {
+    INBOUND,
+    OUTBOUND,
+  };
+
+  struct FileHeader final {
+    std::array<char, 8> magic = {};
+    uint32_t version = {};
+    uint32_t reserved = {};
+    int64_t system_origin = {};    // note! nanoseconds, sampled together with realtime_origin
+    int64_t realtime_origin = {};  // note! nanoseconds since epoch
+  };
+
+  struct RecordHeader final {
+    uint32_t length = {};  // note! raw frame, excluding this header
+    Peer peer = {};
+    Direction direction = {};
+    uint16_t reserved = {};
+    uint64_t session_id = {};  // note! zero for the upstream connection
+    int64_t timestamp = {};    // note! nanoseconds (system clock), receive time for inbound, encode time for outbound
+  };
+
+  static_assert(sizeof(FileHeader) == 32);
+  static_assert(sizeof(RecordHeader) == 24);
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
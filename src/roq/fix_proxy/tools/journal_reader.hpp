@@ -0,0 +1,85 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "roq/fix_proxy/tools/journal.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// iterates the records of a journal segment (the caller owns the data)
+// a truncated last record is expected if the process did not terminate cleanly
+
+struct JournalReader final {
+  enum class Status {
+    OK,
+    INVALID_HEADER,
+    UNSUPPORTED_VERSION,
+    TRUNCATED,
+  };
+
+  struct Record final {
+    Journal::Peer peer = {};
+    Journal::Direction direction = {};
+    uint64_t session_id = {};
+    std::chrono::nanoseconds timestamp = {};  // note! system clock
+    std::chrono::nanoseconds realtime = {};   // note! converted using the segment's origin
+    std::span<std::byte const> message;
+  };
+
+  explicit JournalReader(std::span<std::byte const> const &data) : data_{data} {}
+
+  template <typename Callback>
+  Status dispatch(Callback callback) const {
+    Journal::FileHeader file_header;
+    if (std::size(data_) < sizeof(file_header)) {
+      return Status::INVALID_HEADER;
+    }
+    std::memcpy(&file_header, std::data(data_), sizeof(file_header));
+    if (file_header.magic != Journal::MAGIC) {
+      return Status::INVALID_HEADER;
+    }
+    if (file_header.version != Journal::VERSION) {
+      return Status::UNSUPPORTED_VERSION;
+    }
+    auto offset = std::chrono::nanoseconds{file_header.realtime_origin - file_header.system_origin};
+    auto buffer = data_.subspan(sizeof(file_header));
+    while (!std::empty(buffer)) {
+      Journal::RecordHeader header;
+      if (std::size(buffer) < sizeof(header)) {
+        return Status::TRUNCATED;
+      }
+      std::memcpy(&header, std::data(buffer), sizeof(header));
+      if (std::size(buffer) < (sizeof(header) + header.length)) {
+        return Status::TRUNCATED;
+      }
+      auto timestamp = std::chrono::nanoseconds{header.timestamp};
+      auto record = Record{
+          .peer = header.peer,
+          .direction = header.direction,
+          .session_id = header.session_id,
+          .timestamp = timestamp,
+          .realtime = timestamp + offset,
+          .message = buffer.subspan(sizeof(header), header.length),
+      };
+      callback(record);
+      buffer = buffer.subspan(sizeof(header) + header.length);
+    }
+    return Status::OK;
+  }
+
+ private:
+  std::span<std::byte const> const data_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,187 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/journal_writer.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <cerrno>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === CONSTANTS ===
+
+namespace {
+size_t const WRITE_BUFFER_SIZE = 1048576;
+size_t const MAX_BATCH = 1024;  // note! records per channel before visiting the next channel
+
+auto const POLL_INTERVAL = 1ms;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_channels(auto &config) {
+  std::vector<std::unique_ptr<JournalWriter::Channel>> result;
+  for (size_t i = 0; i < config.channels; ++i) {
+    result.emplace_back(std::make_unique<JournalWriter::Channel>(config.buffer_size));
+  }
+  return result;
+}
+
+bool write_all(int fd, std::span<std::byte const> buffer) {
+  while (!std::empty(buffer)) {
+    auto result = ::write(fd, std::data(buffer), std::size(buffer));
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    buffer = buffer.subspan(static_cast<size_t>(result));
+  }
+  return true;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+JournalWriter::JournalWriter(Config const &config)
+    : path_{config.path}, segment_size_{config.segment_size}, channels_{create_channels(config)},
+      start_time_{std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())} {
+  write_buffer_.reserve(WRITE_BUFFER_SIZE);
+  if (!open()) {
+    log::fatal(R"(Unable to open journal (path="{}"))"sv, path_);
+  }
+  thread_ = std::thread{[this]() { run(); }};
+}
+
+JournalWriter::~JournalWriter() {
+  stop_.store(true, std::memory_order_release);
+  thread_.join();
+}
+
+uint64_t JournalWriter::dropped() const {
+  uint64_t result = {};
+  for (auto &channel : channels_) {
+    result += (*channel).dropped();
+  }
+  return result;
+}
+
+// note! background thread
+
+void JournalWriter::run() {
+  log::info("Journal is now running"sv);
+  while (!stop_.load(std::memory_order_acquire)) {
+    if (drain() == 0) {
+      flush();
+      check();
+      std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+  }
+  while (drain() > 0) {
+  }
+  flush();
+  close();
+  log::info("Journal has terminated"sv);
+}
+
+size_t JournalWriter::drain() {
+  size_t result = 0;
+  auto helper = [&](auto &record) { append(record); };
+  for (auto &channel : channels_) {
+    for (size_t i = 0; i < MAX_BATCH && (*channel).buffer_.read(helper); ++i) {
+      ++result;
+    }
+  }
+  return result;
+}
+
+void JournalWriter::check() {
+  uint64_t oversized = {};
+  for (auto &channel : channels_) {
+    oversized += (*channel).oversized();
+  }
+  if (oversized == oversized_) [[likely]] {
+    return;
+  }
+  log::warn(
+      "Journal dropped {} message(s) larger than half the ring buffer (max_length={}, please increase --journal_buffer_size)"sv,
+      oversized - oversized_,
+      (*channels_[0]).max_length());
+  oversized_ = oversized;
+}
+
+// note! a record is never split between segments
+void JournalWriter::append(std::span<std::byte const> const &record) {
+  if (!segment_empty_ && (segment_bytes_ + std::size(write_buffer_) + std::size(record)) > segment_size_) {
+    flush();
+    close();
+    ++index_;
+    open();
+  }
+  if ((std::size(write_buffer_) + std::size(record)) > WRITE_BUFFER_SIZE) {
+    flush();
+  }
+  write_buffer_.insert(std::end(write_buffer_), std::begin(record), std::end(record));
+  segment_empty_ = false;
+}
+
+void JournalWriter::flush() {
+  if (std::empty(write_buffer_)) {
+    return;
+  }
+  if (fd_ >= 0 && !write_all(fd_, write_buffer_)) [[unlikely]] {
+    log::error(R"(Unable to write journal (path="{}", index={}, errno={}))"sv, path_, index_, errno);
+    close();  // note! records are discarded until the next segment
+  }
+  segment_bytes_ += std::size(write_buffer_);
+  write_buffer_.clear();
+}
+
+bool JournalWriter::open() {
+  auto path = fmt::format("{}/{:%Y%m%dT%H%M%S}-{:06}.journal"sv, path_, start_time_, index_);
+  segment_bytes_ = 0;
+  segment_empty_ = true;
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd_ < 0) [[unlikely]] {
+    log::error(R"(Unable to create journal segment (path="{}", errno={}))"sv, path, errno);
+    return false;
+  }
+  auto file_header = Journal::FileHeader{
+      .magic = Journal::MAGIC,
+      .version = Journal::VERSION,
+      .reserved = {},
+      .system_origin = clock::get_system().count(),
+      .realtime_origin = clock::get_realtime().count(),
+  };
+  write_buffer_.insert(
+      std::end(write_buffer_),
+      reinterpret_cast<std::byte const *>(&file_header),
+      reinterpret_cast<std::byte const *>(&file_header) + sizeof(file_header));
+  log::info(R"(Journal segment "{}")"sv, path);
+  return true;
+}
+
+void JournalWriter::close() {
+  if (fd_ < 0) {
+    return;
+  }
+  ::close(fd_);
+  fd_ = -1;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,158 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "roq/fix_proxy/tools/journal.hpp"
+#include "roq/fix_proxy/tools/spsc_buffer.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// producers copy raw frames into their own lock-free ring (one channel per thread), nothing else is done on the hot path
+// a background thread drains all channels and appends the records to segment files ("<path>/<start time>-<index>.journal")
+// a new segment is started when the current one would exceed segment_size
+// records are dropped (and counted) if a ring is full, producers never block
+
+struct JournalWriter final {
+  struct Config final {
+    std::string_view path;  // note! directory, must exist
+    size_t segment_size = {};
+    size_t buffer_size = {};  // note! per channel
+    size_t channels = {};
+  };
+
+  struct Channel final {
+    explicit Channel(size_t buffer_size) : buffer_{buffer_size} {}
+
+    Channel(Channel &&) = delete;
+    Channel(Channel const &) = delete;
+
+    // note! producer
+    bool write(
+        Journal::Peer peer,
+        Journal::Direction direction,
+        uint64_t session_id,
+        std::chrono::nanoseconds timestamp,
+        std::span<std::byte const> const &message) {
+      if (!prepare(peer, direction, session_id, timestamp, message)) {
+        return false;
+      }
+      commit();
+      return true;
+    }
+
+    // note! producer: the record is only written if committed (e.g. once a message has been sent), commit must directly follow prepare
+    bool prepare(
+        Journal::Peer peer,
+        Journal::Direction direction,
+        uint64_t session_id,
+        std::chrono::nanoseconds timestamp,
+        std::span<std::byte const> const &message) {
+      auto header = Journal::RecordHeader{
+          .length = static_cast<uint32_t>(std::size(message)),
+          .peer = peer,
+          .direction = direction,
+          .reserved = {},
+          .session_id = session_id,
+          .timestamp = timestamp.count(),
+      };
+      auto length = sizeof(header) + std::size(message);
+      auto success = buffer_.prepare(length, [&](auto data) {
+        std::memcpy(std::data(data), &header, sizeof(header));
+        std::memcpy(std::data(data) + sizeof(header), std::data(message), std::size(message));
+      });
+      if (!success) [[unlikely]] {
+        increment(dropped_);
+        if (length > buffer_.max_length()) {
+          increment(oversized_);  // note! can never be written (reported by the background thread)
+        }
+      }
+      return success;
+    }
+
+    void commit() { buffer_.commit(); }
+
+    // note! any thread may observe a stale value
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t oversized() const { return oversized_.load(std::memory_order_relaxed); }
+
+    // note! largest message which can be written
+    size_t max_length() const { return buffer_.max_length() - sizeof(Journal::RecordHeader); }
+
+    // note! smallest buffer_size allowing messages of max_length bytes
+    static size_t get_buffer_size(size_t max_length) { return SPSCBuffer::get_capacity(sizeof(Journal::RecordHeader) + max_length); }
+
+   protected:
+    // note! single writer
+    static void increment(std::atomic<uint64_t> &value) { value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+   private:
+    friend struct JournalWriter;
+
+    SPSCBuffer buffer_;
+    std::atomic<uint64_t> dropped_ = {};
+    std::atomic<uint64_t> oversized_ = {};  // note! larger than half the ring
+  };
+
+  explicit JournalWriter(Config const &);
+
+  JournalWriter(JournalWriter &&) = delete;
+  JournalWriter(JournalWriter const &) = delete;
+
+  // note! remaining records are written before returning
+  ~JournalWriter();
+
+  size_t size() const { return std::size(channels_); }
+
+  Channel &operator[](size_t index) { return *channels_[index]; }
+
+  uint64_t dropped() const;
+
+ protected:
+  // note! warns if messages have been dropped because they were larger than half the ring
+  void check();
+
+  void run();
+
+  size_t drain();
+
+  void append(std::span<std::byte const> const &record);
+
+  void flush();
+
+  bool open();
+  void close();
+
+ private:
+  std::string const path_;
+  size_t const segment_size_;
+  std::vector<std::unique_ptr<Channel>> const channels_;
+  std::chrono::sys_seconds const start_time_;
+  // note! background thread
+  std::vector<std::byte> write_buffer_;
+  int fd_ = -1;
+  uint32_t index_ = {};
+  size_t segment_bytes_ = {};
+  bool segment_empty_ = true;
+  uint64_t oversized_ = {};  // note! last reported
+  std::atomic<bool> stop_ = {};
+  std::thread thread_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
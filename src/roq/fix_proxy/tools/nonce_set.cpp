@@ -0,0 +1,62 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/nonce_set.hpp"
+
+#include <algorithm>
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === CONSTANTS ===
+
+namespace {
+auto const BUCKETS_PER_TOLERANCE = 4;
+auto const MIN_BUCKET_WIDTH = 1ms;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_width(auto tolerance) {
+  return std::max<std::chrono::nanoseconds>(tolerance / BUCKETS_PER_TOLERANCE, MIN_BUCKET_WIDTH);
+}
+
+// note! an accepted timestamp is within [now - tolerance, now + tolerance], i.e. a window of 2 * tolerance
+// buckets must span the window plus one bucket for an epoch to never be recycled while it can still be replayed
+template <typename R>
+auto create_buckets(auto tolerance, auto width) {
+  using result_type = std::remove_cvref_t<R>;
+  auto count = static_cast<size_t>(((2 * tolerance) + width - std::chrono::nanoseconds{1}) / width) + 2;
+  return result_type(count);
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+NonceSet::NonceSet(std::chrono::nanoseconds tolerance) : width_{create_width(tolerance)}, buckets_{create_buckets<decltype(buckets_)>(tolerance, width_)} {
+}
+
+bool NonceSet::insert(std::chrono::nanoseconds timestamp, uint64_t fingerprint) {
+  auto epoch = static_cast<int64_t>(timestamp / width_);
+  auto &bucket = buckets_[static_cast<size_t>(epoch) % std::size(buckets_)];
+  if (bucket.epoch != epoch) [[unlikely]] {
+    bucket.fingerprints.clear();  // note! capacity is retained
+    bucket.epoch = epoch;
+  }
+  return bucket.fingerprints.emplace(fingerprint).second;
+}
+
+size_t NonceSet::size() const {
+  size_t result = {};
+  for (auto &bucket : buckets_) {
+    result += std::size(bucket.fingerprints);
+  }
+  return result;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,45 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "roq/utils/container.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// remembers nonces (fingerprints) for as long as their timestamp could be accepted (now +/- tolerance)
+// nonces are bucketed by their own timestamp and a bucket is recycled (cleared) when a newer epoch maps to the same slot
+// the number of buckets guarantees that a recycled epoch can never again pass the timestamp validation
+// memory is therefore bounded by the logon rate over the tolerance window
+
+struct NonceSet final {
+  explicit NonceSet(std::chrono::nanoseconds tolerance);
+
+  NonceSet(NonceSet &&) = delete;
+  NonceSet(NonceSet const &) = delete;
+
+  // note! returns false if the nonce has already been seen
+  bool insert(std::chrono::nanoseconds timestamp, uint64_t fingerprint);
+
+  size_t size() const;
+
+ protected:
+  struct Bucket final {
+    int64_t epoch = -1;
+    utils::unordered_set<uint64_t> fingerprints;
+  };
+
+ private:
+  std::chrono::nanoseconds const width_;
+  std::vector<Bucket> buckets_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
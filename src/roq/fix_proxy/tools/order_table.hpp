@@ -0,0 +1,152 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// open addressing hash table keyed by ClOrdID (linear probing, backward shift deletion, i.e. no tombstones)
+// keys are stored inline (up to MAX_KEY_LENGTH bytes) and the hash is compared before the key
+// slots are preallocated (twice the capacity, rounded up to a power of two), inserting is allocation free
+// insert fails when the table holds capacity values or when the key is too long
+
+template <typename T>
+struct OrderTable final {
+  static constexpr size_t MAX_KEY_LENGTH = 46;
+
+  explicit OrderTable(size_t capacity) : capacity_{capacity}, mask_{get_slots(capacity) - 1}, slots_(get_slots(capacity)) {}
+
+  OrderTable(OrderTable &&) = default;
+  OrderTable(OrderTable const &) = delete;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+
+  // note! excludes sizeof(OrderTable)
+  size_t memory_usage() const { return std::size(slots_) * sizeof(Slot); }
+
+  // note! an existing value is replaced
+  bool insert(std::string_view const &key, T const &value) {
+    if (std::size(key) > MAX_KEY_LENGTH) [[unlikely]] {
+      return false;
+    }
+    auto hash = get_hash(key);
+    auto index = hash & mask_;
+    for (;; index = (index + 1) & mask_) {
+      auto &slot = slots_[index];
+      if (!slot.used) {
+        if (size_ == capacity_) [[unlikely]] {
+          return false;
+        }
+        slot.used = true;
+        slot.length = static_cast<uint8_t>(std::size(key));
+        slot.hash = hash;
+        std::copy(std::begin(key), std::end(key), std::begin(slot.key));
+        slot.value = value;
+        ++size_;
+        return true;
+      }
+      if (slot.hash == hash && get_key(slot) == key) {
+        slot.value = value;
+        return true;
+      }
+    }
+  }
+
+  // note! the value is removed
+  bool extract(std::string_view const &key, T &result) {
+    if (std::size(key) > MAX_KEY_LENGTH || size_ == 0) {
+      return false;
+    }
+    auto hash = get_hash(key);
+    for (auto index = hash & mask_;; index = (index + 1) & mask_) {
+      auto &slot = slots_[index];
+      if (!slot.used) {
+        return false;
+      }
+      if (slot.hash == hash && get_key(slot) == key) {
+        result = slot.value;
+        erase(index);
+        return true;
+      }
+    }
+  }
+
+  // note! callback(key, value) returns true if the value should be removed (it may be called more than once for a value which is kept)
+  template <typename Callback>
+  void erase_if(Callback callback) {
+    for (size_t index = 0; index < std::size(slots_) && size_ > 0;) {
+      auto &slot = slots_[index];
+      auto const &value = slot.value;
+      if (slot.used && callback(get_key(slot), value)) {
+        erase(index);  // note! a later value may have been shifted into this slot
+      } else {
+        ++index;
+      }
+    }
+  }
+
+  void clear() {
+    for (auto &slot : slots_) {
+      slot.used = false;
+    }
+    size_ = {};
+  }
+
+ protected:
+  struct Slot final {
+    uint64_t hash = {};
+    bool used = {};
+    uint8_t length = {};
+    std::array<char, MAX_KEY_LENGTH> key;
+    T value = {};
+  };
+
+  static size_t get_slots(size_t capacity) { return std::bit_ceil(std::max<size_t>(2 * capacity, 2)); }
+
+  // note! FNV-1a
+  static uint64_t get_hash(std::string_view const &key) {
+    uint64_t result = 0xcbf29ce484222325;
+    for (auto item : key) {
+      result = (result ^ static_cast<uint8_t>(item)) * 0x100000001b3;
+    }
+    return result;
+  }
+
+  static std::string_view get_key(Slot const &slot) { return {std::data(slot.key), slot.length}; }
+
+  // note! values following the removed slot are moved back unless already at (or before) their preferred slot
+  void erase(size_t index) {
+    auto next = (index + 1) & mask_;
+    for (; slots_[next].used; next = (next + 1) & mask_) {
+      auto preferred = slots_[next].hash & mask_;
+      if (((next - preferred) & mask_) >= ((next - index) & mask_)) {
+        slots_[index] = slots_[next];
+        index = next;
+      }
+    }
+    slots_[index].used = false;
+    --size_;
+  }
+
+ private:
+  size_t const capacity_;
+  size_t const mask_;
+  std::vector<Slot> slots_;
+  size_t size_ = {};
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
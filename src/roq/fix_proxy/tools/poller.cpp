@@ -0,0 +1,81 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/poller.hpp"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === HELPERS ===
+
+namespace {
+auto create_epoll() {
+  auto result = ::epoll_create1(EPOLL_CLOEXEC);
+  if (result < 0) {
+    log::fatal("Unexpected: epoll_create1 failed (error={})"sv, std::strerror(errno));
+  }
+  return result;
+}
+
+auto create_event(auto &handler, auto write, auto read) {
+  return epoll_event{
+      .events = (read ? (EPOLLIN | EPOLLRDHUP) : 0u) | (write ? EPOLLOUT : 0u),
+      .data = {.ptr = &handler},
+  };
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Poller::Poller() : fd_{create_epoll()} {
+}
+
+Poller::~Poller() {
+  ::close(fd_);
+}
+
+void Poller::add(int fd, Handler &handler, bool write) {
+  auto event = create_event(handler, write, true);
+  if (::epoll_ctl(fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    log::fatal("Unexpected: epoll_ctl failed (error={})"sv, std::strerror(errno));
+  }
+}
+
+void Poller::modify(int fd, Handler &handler, bool write, bool read) {
+  auto event = create_event(handler, write, read);
+  if (::epoll_ctl(fd_, EPOLL_CTL_MOD, fd, &event) < 0) {
+    log::fatal("Unexpected: epoll_ctl failed (error={})"sv, std::strerror(errno));
+  }
+}
+
+void Poller::remove(int fd) {
+  ::epoll_ctl(fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+size_t Poller::dispatch(std::chrono::milliseconds timeout) {
+  auto count = ::epoll_wait(fd_, std::data(events_), std::size(events_), static_cast<int>(timeout.count()));
+  if (count < 0) {
+    if (errno == EINTR) {
+      return {};
+    }
+    log::fatal("Unexpected: epoll_wait failed (error={})"sv, std::strerror(errno));
+  }
+  for (int i = 0; i < count; ++i) {
+    auto &event = events_[i];
+    (*static_cast<Handler *>(event.data.ptr))(event.events);
+  }
+  return count;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
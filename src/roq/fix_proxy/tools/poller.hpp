@@ -0,0 +1,44 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <sys/epoll.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note! level-triggered epoll, each file descriptor is associated with a handler
+
+struct Poller final {
+  struct Handler {
+    virtual void operator()(uint32_t events) = 0;
+  };
+
+  Poller();
+
+  Poller(Poller &&) = delete;
+  Poller(Poller const &) = delete;
+
+  ~Poller();
+
+  void add(int fd, Handler &, bool write = false);
+  void modify(int fd, Handler &, bool write, bool read = true);  // note! read interest can be dropped (backpressure)
+  void remove(int fd);
+
+  // note! timeout of zero means busy polling
+  // returns the number of events dispatched
+  size_t dispatch(std::chrono::milliseconds timeout);
+
+ private:
+  int const fd_;
+  std::array<struct epoll_event, 64> events_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
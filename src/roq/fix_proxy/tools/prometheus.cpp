@@ -0,0 +1,141 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/prometheus.hpp"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === HELPERS ===
+
+namespace {
+auto get_type_name(Prometheus::Type type) {
+  switch (type) {
+    using enum Prometheus::Type;
+    case COUNTER:
+      return "counter"sv;
+    case GAUGE:
+      return "gauge"sv;
+    case SUMMARY:
+      return "summary"sv;
+    case HISTOGRAM:
+      return "histogram"sv;
+  }
+  assert(false);
+  return "untyped"sv;
+}
+
+// note! help text only escapes backslash and newline, label values also escape double-quote
+void append_escaped(std::string &buffer, std::string_view const &value, bool quote) {
+  for (auto c : value) {
+    switch (c) {
+      case '\\':
+        buffer.append("\\\\"sv);
+        break;
+      case '\n':
+        buffer.append("\\n"sv);
+        break;
+      case '"':
+        if (quote) {
+          buffer.append("\\\""sv);
+        } else {
+          buffer.push_back(c);
+        }
+        break;
+      default:
+        buffer.push_back(c);
+    }
+  }
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+void Prometheus::describe(std::string_view const &name, Type type, std::string_view const &help) {
+  fmt::format_to(std::back_inserter(buffer_), "# HELP {} "sv, name);
+  append_escaped(buffer_, help, false);
+  fmt::format_to(std::back_inserter(buffer_), "\n# TYPE {} {}\n"sv, name, get_type_name(type));
+}
+
+void Prometheus::sample(std::string_view const &name, std::initializer_list<Label> labels, uint64_t value) {
+  buffer_.append(name);
+  write_labels(labels);
+  fmt::format_to(std::back_inserter(buffer_), " {}\n"sv, value);
+}
+
+void Prometheus::sample(std::string_view const &name, std::initializer_list<Label> labels, double value) {
+  buffer_.append(name);
+  write_labels(labels);
+  if (std::isnan(value)) {
+    buffer_.append(" NaN\n"sv);
+  } else if (std::isinf(value)) {
+    buffer_.append(value > 0.0 ? " +Inf\n"sv : " -Inf\n"sv);
+  } else {
+    fmt::format_to(std::back_inserter(buffer_), " {}\n"sv, value);
+  }
+}
+
+void Prometheus::histogram(std::string_view const &name, std::initializer_list<Label> labels, Buckets const &buckets) {
+  std::array<char, 32> le;
+  auto helper = [&](auto const &bound, auto count) {
+    buffer_.append(name);
+    buffer_.append("_bucket"sv);
+    auto label = Label{
+        .name = "le"sv,
+        .value = bound,
+    };
+    write_labels(labels, &label);
+    fmt::format_to(std::back_inserter(buffer_), " {}\n"sv, count);
+  };
+  buckets.for_each([&](auto bound, auto count) {
+    auto result = fmt::format_to_n(std::data(le), std::size(le), "{}"sv, bound);
+    helper(std::string_view{std::data(le), result.out}, count);
+  });
+  helper("+Inf"sv, buckets.count());
+  buffer_.append(name);
+  buffer_.append("_sum"sv);
+  write_labels(labels);
+  fmt::format_to(std::back_inserter(buffer_), " {}\n"sv, buckets.sum());
+  buffer_.append(name);
+  buffer_.append("_count"sv);
+  write_labels(labels);
+  fmt::format_to(std::back_inserter(buffer_), " {}\n"sv, buckets.count());
+}
+
+void Prometheus::write_labels(std::initializer_list<Label> labels, Label const *extra) {
+  if (std::empty(labels) && extra == nullptr) {
+    return;
+  }
+  buffer_.push_back('{');
+  auto first = true;
+  auto helper = [&](auto &label) {
+    if (!first) {
+      buffer_.push_back(',');
+    }
+    first = false;
+    buffer_.append(label.name);
+    buffer_.append("=\""sv);
+    append_escaped(buffer_, label.value, true);
+    buffer_.push_back('"');
+  };
+  for (auto &label : labels) {
+    helper(label);
+  }
+  if (extra != nullptr) {
+    helper(*extra);
+  }
+  buffer_.push_back('}');
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
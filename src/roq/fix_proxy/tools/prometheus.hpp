@@ -0,0 +1,57 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+#include "roq/fix_proxy/tools/buckets.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// appends metrics to a buffer using the prometheus text exposition format (version 0.0.4)
+// the caller is responsible for describing each metric (once) before its samples
+
+struct Prometheus final {
+  static constexpr std::string_view const CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+  enum class Type {
+    COUNTER,
+    GAUGE,
+    SUMMARY,
+    HISTOGRAM,
+  };
+
+  struct Label final {
+    std::string_view name;
+    std::string_view value;  // note! escaped when written
+  };
+
+  explicit Prometheus(std::string &buffer) : buffer_{buffer} {}
+
+  Prometheus(Prometheus &&) = delete;
+  Prometheus(Prometheus const &) = delete;
+
+  void describe(std::string_view const &name, Type, std::string_view const &help);
+
+  void sample(std::string_view const &name, std::initializer_list<Label> labels, uint64_t value);
+  void sample(std::string_view const &name, std::initializer_list<Label> labels, double value);
+
+  // note! writes the name_bucket (cumulative, le="+Inf" is the count), name_sum and name_count samples
+  void histogram(std::string_view const &name, std::initializer_list<Label> labels, Buckets const &);
+
+ protected:
+  void write_labels(std::initializer_list<Label> labels, Label const *extra = nullptr);
+
+ private:
+  std::string &buffer_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
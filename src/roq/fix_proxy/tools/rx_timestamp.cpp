@@ -0,0 +1,63 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/rx_timestamp.hpp"
+
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <sys/socket.h>
+
+#include <cstring>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === CONSTANTS ===
+
+namespace {
+int const FLAGS = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto get_receive_time(struct msghdr &message) -> std::chrono::nanoseconds {
+  for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+      continue;
+    }
+    struct scm_timestamping timestamping;
+    std::memcpy(&timestamping, CMSG_DATA(cmsg), sizeof(timestamping));
+    auto &software = timestamping.ts[0];  // note! ts[1] is deprecated, ts[2] is hardware
+    return std::chrono::seconds{software.tv_sec} + std::chrono::nanoseconds{software.tv_nsec};
+  }
+  return {};
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+bool RxTimestamp::enable(int fd) {
+  auto flags = FLAGS;
+  return ::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0;
+}
+
+ssize_t RxTimestamp::receive(int fd, std::span<std::byte> const &buffer, std::chrono::nanoseconds &receive_time) {
+  struct iovec iov = {
+      .iov_base = std::data(buffer),
+      .iov_len = std::size(buffer),
+  };
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+  struct msghdr message = {};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  auto result = ::recvmsg(fd, &message, 0);
+  receive_time = result > 0 ? get_receive_time(message) : std::chrono::nanoseconds{};
+  return result;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,30 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// software receive timestamps (SO_TIMESTAMPING), i.e. when the kernel received the packet (before socket queueing)
+// no hardware support is required, loopback is timestamped by the kernel
+// timestamps are realtime and, for stream sockets, belong to the last segment consumed by the read
+
+struct RxTimestamp final {
+  // note! returns false if not supported
+  static bool enable(int fd);
+
+  // note! same semantics as recv, receive_time is zero if no timestamp was provided
+  static ssize_t receive(int fd, std::span<std::byte> const &buffer, std::chrono::nanoseconds &receive_time);
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
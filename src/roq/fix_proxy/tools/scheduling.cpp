@@ -0,0 +1,47 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/scheduling.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === IMPLEMENTATION ===
+
+void Scheduling::set_affinity([[maybe_unused]] uint32_t cpu) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  auto result = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (result != 0) {
+    log::fatal(R"(Unable to pin thread to cpu={} (error="{}"))"sv, cpu, std::strerror(result));
+  }
+  log::info("Thread has been pinned to cpu={}"sv, cpu);
+#else
+  log::fatal("Unexpected: thread affinity is only supported on Linux"sv);
+#endif
+}
+
+void Scheduling::set_fifo_priority(uint32_t priority) {
+  struct sched_param param = {};
+  param.sched_priority = static_cast<int>(priority);
+  auto result = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param);
+  if (result != 0) {
+    log::fatal(R"(Unable to use SCHED_FIFO with priority={} (error="{}"))"sv, priority, std::strerror(result));
+  }
+  log::info("Thread is now using SCHED_FIFO with priority={}"sv, priority);
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
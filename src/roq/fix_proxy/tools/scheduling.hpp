@@ -0,0 +1,20 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cstdint>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note! applies to the calling thread
+
+struct Scheduling final {
+  static void set_affinity(uint32_t cpu);
+  static void set_fifo_priority(uint32_t priority);
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,145 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// generational slot map: a key combines the slot index (low 32 bits) with the generation of the slot (high 32 bits)
+// the generation is incremented when a value is erased, a stale key can therefore never alias a newer value
+// values are constructed in place within fixed size chunks (addresses are stable, values don't have to be movable)
+// live slots are tracked densely (iteration doesn't visit free slots)
+// values can't be erased while iterating
+
+template <typename T, size_t chunk_size = 256>
+struct SlotMap final {
+  SlotMap() = default;
+
+  SlotMap(SlotMap &&) = delete;
+  SlotMap(SlotMap const &) = delete;
+
+  ~SlotMap() { clear(); }
+
+  static uint64_t make_key(uint32_t generation, uint32_t index) { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+  static uint32_t get_generation(uint64_t key) { return static_cast<uint32_t>(key >> 32); }
+  static uint32_t get_index(uint64_t key) { return static_cast<uint32_t>(key); }
+
+  bool empty() const { return std::empty(dense_); }
+  size_t size() const { return std::size(dense_); }
+
+  // note! factory is called with the key and must return the value (guaranteed copy elision)
+  template <typename Factory>
+  T &emplace(Factory factory) {
+    auto index = acquire();
+    auto &slot = slots_[index];
+    auto key = make_key(slot.generation, index);
+    T *result;
+    try {
+      result = ::new (get_storage(index)) T(factory(key));
+    } catch (...) {
+      free_.emplace_back(index);
+      throw;
+    }
+    slot.occupied = true;
+    slot.dense = static_cast<uint32_t>(std::size(dense_));
+    dense_.emplace_back(index);
+    return *result;
+  }
+
+  T *find(uint64_t key) {
+    auto index = get_index(key);
+    if (index >= std::size(slots_)) [[unlikely]] {
+      return nullptr;
+    }
+    auto &slot = slots_[index];
+    if (!slot.occupied || slot.generation != get_generation(key)) [[unlikely]] {
+      return nullptr;
+    }
+    return get_value(index);
+  }
+
+  // note! the value is destroyed immediately and the key will never again be valid
+  bool erase(uint64_t key) {
+    auto value = find(key);
+    if (value == nullptr) {
+      return false;
+    }
+    auto index = get_index(key);
+    auto &slot = slots_[index];
+    (*value).~T();
+    // note! swap with last
+    auto last = dense_.back();
+    dense_[slot.dense] = last;
+    slots_[last].dense = slot.dense;
+    dense_.pop_back();
+    slot.occupied = false;
+    if (++slot.generation == 0) [[unlikely]] {
+      slot.generation = 1;  // note! zero is never a valid key
+    }
+    free_.emplace_back(index);
+    return true;
+  }
+
+  void clear() {
+    while (!std::empty(dense_)) {
+      auto index = dense_.back();
+      erase(make_key(slots_[index].generation, index));
+    }
+  }
+
+  template <typename Callback>
+  void for_each(Callback callback) {
+    for (auto index : dense_) {
+      callback(*get_value(index));
+    }
+  }
+
+ protected:
+  struct Slot final {
+    uint32_t generation = 1;
+    uint32_t dense = {};  // note! position in dense_
+    bool occupied = {};
+  };
+
+  struct Chunk final {
+    alignas(T) std::byte storage[chunk_size * sizeof(T)];
+  };
+
+  uint32_t acquire() {
+    if (!std::empty(free_)) {
+      auto index = free_.back();
+      free_.pop_back();
+      return index;
+    }
+    auto index = static_cast<uint32_t>(std::size(slots_));
+    if ((index % chunk_size) == 0) {
+      chunks_.emplace_back(std::make_unique_for_overwrite<Chunk>());
+    }
+    slots_.emplace_back();
+    return index;
+  }
+
+  void *get_storage(uint32_t index) { return &(*chunks_[index / chunk_size]).storage[(index % chunk_size) * sizeof(T)]; }
+
+  T *get_value(uint32_t index) { return std::launder(static_cast<T *>(get_storage(index))); }
+
+ private:
+  std::vector<Slot> slots_;
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+  std::vector<uint32_t> dense_;  // note! indices of live slots
+  std::vector<uint32_t> free_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,175 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// lock-free single-producer single-consumer ring of variable length records (capacity is rounded up to a power of two)
+// records are contiguous: a padding record is inserted when a record would otherwise wrap around the end of the ring
+
+struct SPSCBuffer final {
+  explicit SPSCBuffer(size_t capacity) : mask_{std::bit_ceil(capacity) - 1}, buffer_(mask_ + 1) { assert(capacity >= (2 * HEADER_SIZE)); }
+
+  SPSCBuffer(SPSCBuffer &&) = delete;
+  SPSCBuffer(SPSCBuffer const &) = delete;
+
+  size_t capacity() const { return mask_ + 1; }
+
+  // note! largest record which can ever be written
+  size_t max_length() const { return (capacity() / 2) - HEADER_SIZE; }
+
+  // note! smallest capacity allowing records of max_length bytes
+  static constexpr size_t get_capacity(size_t max_length) { return std::bit_ceil(2 * (max_length + HEADER_SIZE)); }
+
+  // note! bytes in use (including headers and padding), any thread may observe a stale value
+  size_t size() const { return tail_.value.load(std::memory_order_relaxed) - head_.value.load(std::memory_order_relaxed); }
+
+  // producer
+
+  // note! callback must fill exactly length bytes
+  template <typename Callback>
+  bool write(size_t length, Callback callback) {
+    if (!prepare(length, callback)) {
+      return false;
+    }
+    commit();
+    return true;
+  }
+
+  // note! the record is not visible to the consumer until committed
+  // an uncommitted record is discarded by the next prepare, write or emplace (commit must directly follow prepare)
+  template <typename Callback>
+  bool prepare(size_t length, Callback callback) {
+    auto size = align(HEADER_SIZE + length);
+    if (length > max_length()) [[unlikely]] {
+      return false;
+    }
+    auto tail = tail_.value.load(std::memory_order_relaxed);
+    auto offset = tail & mask_;
+    auto padding = (offset + size) > capacity() ? (capacity() - offset) : size_t{0};
+    if (!reserve(tail, padding + size)) {
+      return false;
+    }
+    if (padding != 0) {
+      store_header(offset, PADDING);
+      tail += padding;
+      offset = 0;
+    }
+    store_header(offset, static_cast<uint32_t>(length));
+    auto data = std::span{&buffer_[offset + HEADER_SIZE], length};
+    callback(data);
+    prepared_ = tail + size;
+    return true;
+  }
+
+  void commit() {
+    assert(prepared_ != 0);
+    tail_.value.store(prepared_, std::memory_order_release);
+    prepared_ = 0;
+  }
+
+  // note! reserves up to length bytes, callback returns the number of bytes used (the rest is released)
+  // nothing is written if the callback throws
+  template <typename Callback>
+  bool emplace(size_t length, Callback callback) {
+    if (length > max_length()) [[unlikely]] {
+      return false;
+    }
+    auto tail = tail_.value.load(std::memory_order_relaxed);
+    auto offset = tail & mask_;
+    auto size = align(HEADER_SIZE + length);
+    auto padding = (offset + size) > capacity() ? (capacity() - offset) : size_t{0};
+    if (!reserve(tail, padding + size)) {
+      return false;
+    }
+    auto data = std::span{&buffer_[(padding != 0 ? 0 : offset) + HEADER_SIZE], length};
+    size_t used = callback(data);
+    assert(used <= length);
+    if (padding != 0) {
+      store_header(offset, PADDING);
+      tail += padding;
+      offset = 0;
+    }
+    store_header(offset, static_cast<uint32_t>(used));
+    tail_.value.store(tail + align(HEADER_SIZE + used), std::memory_order_release);
+    return true;
+  }
+
+  // consumer
+
+  // note! callback receives one record, returns false if empty
+  template <typename Callback>
+  bool read(Callback callback) {
+    auto head = head_.value.load(std::memory_order_relaxed);
+    if (head == head_.cached) {
+      head_.cached = tail_.value.load(std::memory_order_acquire);
+      if (head == head_.cached) {
+        return false;
+      }
+    }
+    auto offset = head & mask_;
+    auto length = load_header(offset);
+    if (length == PADDING) {
+      head += capacity() - offset;
+      offset = 0;
+      length = load_header(offset);
+    }
+    auto data = std::span<std::byte const>{&buffer_[offset + HEADER_SIZE], length};
+    callback(data);
+    head_.value.store(head + align(HEADER_SIZE + length), std::memory_order_release);
+    return true;
+  }
+
+ protected:
+  static constexpr size_t const CACHE_LINE_SIZE = 64;
+  static constexpr size_t const HEADER_SIZE = 8;
+  static constexpr uint32_t const PADDING = UINT32_MAX;
+
+  static constexpr size_t align(size_t size) { return (size + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1); }
+
+  bool reserve(size_t tail, size_t size) {
+    if ((tail + size - tail_.cached) > capacity()) {
+      tail_.cached = head_.value.load(std::memory_order_acquire);
+      if ((tail + size - tail_.cached) > capacity()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void store_header(size_t offset, uint32_t length) { std::memcpy(&buffer_[offset], &length, sizeof(length)); }
+
+  uint32_t load_header(size_t offset) const {
+    uint32_t result;
+    std::memcpy(&result, &buffer_[offset], sizeof(result));
+    return result;
+  }
+
+ private:
+  struct alignas(CACHE_LINE_SIZE) Index final {
+    std::atomic<size_t> value = {};
+    size_t cached = {};  // note! the other side's index, only accessed by the owner
+  };
+
+  Index head_;            // consumer
+  Index tail_;            // producer
+  size_t prepared_ = {};  // note! producer: tail after the prepared record
+  size_t const mask_;
+  std::vector<std::byte> buffer_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,85 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// lock-free single-producer single-consumer queue (bounded, capacity is rounded up to a power of two)
+// head and tail live on separate cache lines and each side caches the other side's index
+
+template <typename T>
+struct SPSCQueue final {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  explicit SPSCQueue(size_t capacity) : mask_{std::bit_ceil(capacity) - 1}, buffer_(mask_ + 1) { assert(capacity > 0); }
+
+  SPSCQueue(SPSCQueue &&) = delete;
+  SPSCQueue(SPSCQueue const &) = delete;
+
+  size_t capacity() const { return mask_ + 1; }
+
+  // note! consumer side may observe a stale value
+  bool empty() const { return head_.value.load(std::memory_order_acquire) == tail_.value.load(std::memory_order_acquire); }
+
+  // note! any thread may observe a stale value
+  size_t size() const { return tail_.value.load(std::memory_order_relaxed) - head_.value.load(std::memory_order_relaxed); }
+
+  // producer
+
+  bool try_push(T const &value) {
+    auto tail = tail_.value.load(std::memory_order_relaxed);
+    if ((tail - tail_.cached) > mask_) {
+      tail_.cached = head_.value.load(std::memory_order_acquire);
+      if ((tail - tail_.cached) > mask_) {
+        return false;
+      }
+    }
+    buffer_[tail & mask_] = value;
+    tail_.value.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer
+
+  template <typename Callback>
+  bool try_pop(Callback callback) {
+    auto head = head_.value.load(std::memory_order_relaxed);
+    if (head == head_.cached) {
+      head_.cached = tail_.value.load(std::memory_order_acquire);
+      if (head == head_.cached) {
+        return false;
+      }
+    }
+    callback(buffer_[head & mask_]);
+    head_.value.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  static constexpr size_t const CACHE_LINE_SIZE = 64;
+
+  struct alignas(CACHE_LINE_SIZE) Index final {
+    std::atomic<size_t> value = {};
+    size_t cached = {};  // note! the other side's index, only accessed by the owner
+  };
+
+  Index head_;  // consumer
+  Index tail_;  // producer
+  size_t const mask_;
+  std::vector<T> buffer_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,25 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/tsc.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === IMPLEMENTATION ===
+
+double TSC::calibrate(std::chrono::nanoseconds duration) {
+  auto start = std::chrono::steady_clock::now();
+  auto start_cycles = now();
+  auto end = start;
+  while ((end - start) < duration) {
+    end = std::chrono::steady_clock::now();
+  }
+  auto cycles = now() - start_cycles;
+  auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  return nanoseconds > 0 ? static_cast<double>(cycles) / static_cast<double>(nanoseconds) : 1.0;
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
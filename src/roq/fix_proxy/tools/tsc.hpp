@@ -0,0 +1,35 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// time-stamp counter (cycles), falls back to the monotonic clock (nanoseconds) when not on x86-64
+// the counter is assumed to be invariant (constant rate and synchronized across cores)
+
+struct TSC final {
+  static uint64_t now() {
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  // note! measured against the monotonic clock (spins for the duration)
+  static double calibrate(std::chrono::nanoseconds duration);
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,149 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/verifier.hpp"
+
+#include "roq/exceptions.hpp"
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === HELPERS ===
+
+namespace {
+template <typename R>
+auto create_workers(auto &crypto, auto threads) {
+  using result_type = std::remove_cvref_t<R>;
+  using value_type = typename result_type::value_type::element_type;
+  result_type result;
+  for (uint32_t i = 0; i < threads; ++i) {
+    result.emplace_back(std::make_unique<value_type>(crypto));
+  }
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Verifier::Verifier(Handler &handler, Crypto const &crypto, io::Context &context, uint32_t threads, std::chrono::nanoseconds poll_freq)
+    : handler_{handler}, workers_{create_workers<decltype(workers_)>(crypto, threads)}, timer_{context.create_timer(*this, poll_freq)} {
+  log::info("Using {} thread(s) to verify logon credentials"sv, threads);
+}
+
+Verifier::~Verifier() = default;
+
+bool Verifier::submit(uint64_t session_id, std::string_view const &password, Crypto::Key const &key, std::string_view const &raw_data) {
+  if (std::size(password) > MAX_LENGTH || std::size(raw_data) > MAX_LENGTH) [[unlikely]] {
+    return false;
+  }
+  Request request{
+      .session_id = session_id,
+      .key = key,
+      .password_length = static_cast<uint16_t>(std::size(password)),
+      .raw_data_length = static_cast<uint16_t>(std::size(raw_data)),
+      .password = {},
+      .raw_data = {},
+  };
+  password.copy(std::data(request.password), std::size(password));
+  raw_data.copy(std::data(request.raw_data), std::size(raw_data));
+  // note! round-robin, skipping workers with a full queue
+  for (size_t i = 0; i < std::size(workers_); ++i) {
+    auto &worker = *workers_[next_];
+    next_ = (next_ + 1) % std::size(workers_);
+    if (worker.submit(request)) {
+      if (pending_++ == 0) {
+        (*timer_).resume();  // note! only armed while requests are outstanding
+      }
+      return true;
+    }
+  }
+  log::warn("Unable to queue verification request (session_id={})"sv, session_id);
+  return false;
+}
+
+size_t Verifier::poll() {
+  if (pending_ == 0) [[likely]] {
+    return 0;
+  }
+  size_t result = {};
+  auto helper = [&](auto &value) {
+    --pending_;
+    ++result;
+    handler_(value);
+  };
+  for (auto &worker : workers_) {
+    while ((*worker).results.try_pop(helper)) {
+    }
+  }
+  if (pending_ == 0) {
+    (*timer_).suspend();
+  }
+  return result;
+}
+
+// io::sys::Timer::Handler
+
+void Verifier::operator()(io::sys::Timer::Event const &) {
+  poll();
+}
+
+// worker
+
+Verifier::Worker::Worker(Crypto const &crypto) : results{QUEUE_SIZE}, crypto_{crypto}, requests_{QUEUE_SIZE}, thread_{[this]() { run(); }} {
+}
+
+Verifier::Worker::~Worker() {
+  stop_.store(true, std::memory_order_release);
+  sequence_.fetch_add(1, std::memory_order_release);
+  sequence_.notify_one();
+  thread_.join();
+}
+
+bool Verifier::Worker::submit(Request const &request) {
+  if (!requests_.try_push(request)) {
+    return false;
+  }
+  sequence_.fetch_add(1, std::memory_order_release);
+  sequence_.notify_one();
+  return true;
+}
+
+void Verifier::Worker::run() {
+  auto process = [&](auto &request) {
+    auto password = std::string_view{std::data(request.password), request.password_length};
+    auto raw_data = std::string_view{std::data(request.raw_data), request.raw_data_length};
+    auto result = Result{
+        .session_id = request.session_id,
+        .success = false,
+    };
+    // note! the input is client controlled (e.g. the timestamp prefix of raw_data) and an exception must not escape the thread
+    try {
+      result.success = crypto_.validate(password, {}, request.key, raw_data);
+    } catch (Exception &e) {
+      log::warn("Exception: {} (session_id={})"sv, e, request.session_id);
+    } catch (std::exception &e) {
+      log::warn("Exception: {} (session_id={})"sv, e.what(), request.session_id);
+    }
+    while (!results.try_push(result)) {
+      if (stop_.load(std::memory_order_acquire)) {
+        return;
+      }
+      std::this_thread::yield();  // note! event loop is draining
+    }
+  };
+  while (!stop_.load(std::memory_order_acquire)) {
+    auto sequence = sequence_.load(std::memory_order_acquire);
+    if (requests_.try_pop(process)) {
+      continue;
+    }
+    sequence_.wait(sequence, std::memory_order_acquire);
+  }
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
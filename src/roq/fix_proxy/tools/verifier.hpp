@@ -0,0 +1,102 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "roq/io/context.hpp"
+
+#include "roq/io/sys/timer.hpp"
+
+#include "roq/fix_proxy/tools/crypto.hpp"
+#include "roq/fix_proxy/tools/spsc_queue.hpp"
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// verifies logon credentials on a pool of worker threads
+// requests are copied (fixed size) into a per-worker queue, results are posted back through a per-worker queue
+// and drained by the event loop thread, either from poll() (busy polling) or from a timer which is only armed while
+// requests are outstanding
+
+struct Verifier final : public io::sys::Timer::Handler {
+  struct Result final {
+    uint64_t session_id = {};
+    bool success = {};
+  };
+
+  struct Handler {
+    virtual void operator()(Result const &) = 0;
+  };
+
+  Verifier(Handler &, Crypto const &, io::Context &, uint32_t threads, std::chrono::nanoseconds poll_freq);
+
+  Verifier(Verifier &&) = delete;
+  Verifier(Verifier const &) = delete;
+
+  ~Verifier();
+
+  // note! returns false if the request could not be queued (caller must then validate synchronously)
+  bool submit(uint64_t session_id, std::string_view const &password, Crypto::Key const &, std::string_view const &raw_data);
+
+  // note! returns the number of results delivered
+  size_t poll();
+
+ protected:
+  // io::sys::Timer::Handler
+  void operator()(io::sys::Timer::Event const &) override;
+
+  static constexpr size_t const MAX_LENGTH = 256;
+  static constexpr size_t const QUEUE_SIZE = 1024;
+
+  struct Request final {
+    uint64_t session_id = {};
+    Crypto::Key key;
+    uint16_t password_length = {};
+    uint16_t raw_data_length = {};
+    std::array<char, MAX_LENGTH> password;
+    std::array<char, MAX_LENGTH> raw_data;
+  };
+
+  struct Worker final {
+    explicit Worker(Crypto const &);
+
+    Worker(Worker &&) = delete;
+    Worker(Worker const &) = delete;
+
+    ~Worker();
+
+    bool submit(Request const &);
+
+    SPSCQueue<Result> results;
+
+   protected:
+    void run();
+
+   private:
+    Crypto const &crypto_;
+    SPSCQueue<Request> requests_;
+    std::atomic<uint32_t> sequence_;
+    std::atomic<bool> stop_;
+    std::thread thread_;
+  };
+
+ private:
+  Handler &handler_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  size_t next_ = {};
+  size_t pending_ = {};  // note! requests queued but not yet delivered
+  std::unique_ptr<io::sys::Timer> const timer_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
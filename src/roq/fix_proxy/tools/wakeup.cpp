@@ -0,0 +1,83 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tools/wakeup.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// === HELPERS ===
+
+namespace {
+auto create_eventfd() {
+  auto result = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (result < 0) {
+    log::fatal("Unexpected: eventfd failed (error={})"sv, std::strerror(errno));
+  }
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Wakeup::Wakeup() : fd_{create_eventfd()} {
+}
+
+Wakeup::~Wakeup() {
+  ::close(fd_);
+}
+
+void Wakeup::signal() {
+  uint64_t value = 1;
+  [[maybe_unused]] auto result = ::write(fd_, &value, sizeof(value));
+}
+
+bool Wakeup::wait(std::chrono::nanoseconds timeout) {
+  struct pollfd poll_fd = {
+      .fd = fd_,
+      .events = POLLIN,
+      .revents = {},
+  };
+  auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  struct timespec timespec = {
+      .tv_sec = seconds.count(),
+      .tv_nsec = (timeout - seconds).count(),
+  };
+  auto result = ::ppoll(&poll_fd, 1, &timespec, nullptr);
+  cancel();
+  if (result <= 0) {
+    return false;  // note! timeout (or interrupted)
+  }
+  clear();
+  return true;
+}
+
+void Wakeup::clear() {
+  cancel();
+  uint64_t value;
+  [[maybe_unused]] auto result = ::read(fd_, &value, sizeof(value));
+}
+
+void Wakeup::redirect(int fd) {
+  if (::dup3(fd, fd_, O_CLOEXEC) < 0) {
+    log::fatal("Unexpected: dup3 failed (error={})"sv, std::strerror(errno));
+  }
+  ::close(fd);
+}
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,66 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace roq {
+namespace fix_proxy {
+namespace tools {
+
+// note!
+// wakes up a consumer thread blocked in the kernel (eventfd, may also be registered with a poller)
+// producers only make a system call if the consumer has announced that it is about to block
+// the consumer must check for work after prepare() and before blocking (a notification could otherwise be missed)
+
+struct Wakeup final {
+  Wakeup();
+
+  Wakeup(Wakeup &&) = delete;
+  Wakeup(Wakeup const &) = delete;
+
+  ~Wakeup();
+
+  int fd() const { return fd_; }
+
+  // producer (any thread)
+
+  // note! must be called after the work has been published
+  void notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(false, std::memory_order_relaxed)) [[unlikely]] {
+      signal();
+    }
+  }
+
+  // note! unconditional
+  void signal();
+
+  // consumer
+
+  void prepare() {
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  void cancel() { sleeping_.store(false, std::memory_order_relaxed); }
+
+  // note! returns false if the timeout expired
+  bool wait(std::chrono::nanoseconds timeout);
+
+  // note! when registered with a poller, must be called when the file descriptor is readable
+  void clear();
+
+  // note! producers will write to fd instead (e.g. a socket observed by an io::Context), ownership is transferred
+  // the file descriptor is replaced atomically (producers may be running), wait() and clear() can no longer be used
+  void redirect(int fd);
+
+ private:
+  int const fd_;
+  std::atomic<bool> sleeping_;
+};
+
+}  // namespace tools
+}  // namespace fix_proxy
+}  // namespace roq
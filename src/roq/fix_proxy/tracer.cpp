@@ -0,0 +1,250 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/tracer.hpp"
+
+#include <magic_enum/magic_enum_format.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <string>
+#include <type_traits>
+
+#include "roq/clock.hpp"
+#include "roq/logging.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+
+// === CONSTANTS ===
+
+namespace {
+auto const STATISTICS_FREQUENCY = 60s;
+
+uint64_t const HIGHEST_TRACKABLE_LATENCY = std::chrono::nanoseconds{1s}.count();
+uint32_t const SIGNIFICANT_FIGURES = 2;
+
+// note! upper bounds of the prometheus histogram buckets
+std::array<uint64_t, 18> const BUCKETS{
+    250,
+    500,
+    1000,
+    2500,
+    5000,
+    10000,
+    25000,
+    50000,
+    100000,
+    250000,
+    500000,
+    1000000,
+    2500000,
+    5000000,
+    10000000,
+    25000000,
+    50000000,
+    100000000,
+};
+
+size_t const MAX_MSG_TYPES = 24;  // note! per direction (an additional entry is shared by all other message types)
+}  // namespace
+
+// === HELPERS ===
+
+namespace {
+auto create_histogram() {
+  return tools::Histogram{HIGHEST_TRACKABLE_LATENCY, SIGNIFICANT_FIGURES};
+}
+
+auto create_buckets() {
+  return tools::Buckets{BUCKETS};
+}
+
+template <typename R>
+auto create_entries() {
+  using result_type = std::remove_cvref_t<R>;
+  result_type result;
+  for (auto &item : result) {
+    item.msg_types.reserve(MAX_MSG_TYPES);
+    for (size_t i = 0; i <= MAX_MSG_TYPES; ++i) {
+      item.entries.push_back({
+          .stages = {create_histogram(), create_histogram(), create_histogram(), create_histogram(), create_histogram()},
+          .buckets = {create_buckets(), create_buckets(), create_buckets(), create_buckets(), create_buckets()},
+      });
+    }
+  }
+  return result;
+}
+
+auto get_name(Tracer::Direction direction) {
+  switch (direction) {
+    using enum Tracer::Direction;
+    case UPSTREAM:
+      return "upstream"sv;
+    case DOWNSTREAM:
+      return "downstream"sv;
+  }
+  assert(false);
+  return std::string_view{};
+}
+
+auto get_name(Tracer::Stage stage) {
+  switch (stage) {
+    using enum Tracer::Stage;
+    case DECODE:
+      return "decode"sv;
+    case QUEUE:
+      return "queue"sv;
+    case ROUTE:
+      return "route"sv;
+    case ENCODE:
+      return "encode"sv;
+    case TOTAL:
+      return "total"sv;
+  }
+  assert(false);
+  return std::string_view{};
+}
+
+auto summary(auto &histogram) {
+  return fmt::format(
+      "{{p50={}ns, p99={}ns, max={}ns}}"sv, histogram.value_at_percentile(50.0), histogram.value_at_percentile(99.0), histogram.max());
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+Tracer::Tracer() : entries_{create_entries<decltype(entries_)>()} {
+  log::info("Memory usage: tracer={}"sv, memory_usage());
+}
+
+TraceInfo Tracer::route(
+    Direction direction, fix::MsgType msg_type, TraceInfo const &trace_info, std::chrono::nanoseconds decode_start, std::chrono::nanoseconds decode_end) {
+  auto result = trace_info;
+  if (trace_info.source_receive_time.count() == 0) [[unlikely]] {
+    return result;
+  }
+  auto now = clock::get_system();
+  if (decode_end.count() == 0) {
+    decode_end = now;
+  }
+  auto &entry = get_entry(direction, msg_type);
+  auto decode = decode_end - decode_start;
+  record(entry, Stage::DECODE, decode);
+  record(entry, Stage::QUEUE, (now - trace_info.source_receive_time) - decode);
+  result.origin_create_time = now;
+  return result;
+}
+
+void Tracer::send(
+    Direction direction, fix::MsgType msg_type, TraceInfo const &trace_info, std::chrono::nanoseconds encode_start, std::chrono::nanoseconds encode_end) {
+  if (trace_info.source_receive_time.count() == 0 || trace_info.origin_create_time.count() == 0) [[unlikely]] {
+    return;
+  }
+  auto now = clock::get_system();
+  auto &entry = get_entry(direction, msg_type);
+  record(entry, Stage::ROUTE, encode_start - trace_info.origin_create_time);
+  record(entry, Stage::ENCODE, encode_end - encode_start);
+  record(entry, Stage::TOTAL, now - trace_info.source_receive_time);
+}
+
+void Tracer::refresh(std::chrono::nanoseconds now) {
+  if (now < next_statistics_) {
+    return;
+  }
+  next_statistics_ = now + STATISTICS_FREQUENCY;
+  statistics(Direction::UPSTREAM);
+  statistics(Direction::DOWNSTREAM);
+}
+
+size_t Tracer::memory_usage() const {
+  size_t result = sizeof(*this);
+  for (auto &[msg_types, entries] : entries_) {
+    result += msg_types.capacity() * sizeof(fix::MsgType) + entries.capacity() * sizeof(Entry);
+    for (auto &entry : entries) {
+      for (auto &histogram : entry.stages) {
+        result += histogram.memory_usage();
+      }
+      for (auto &buckets : entry.buckets) {
+        result += buckets.memory_usage();
+      }
+    }
+  }
+  return result;
+}
+
+void Tracer::write(tools::Prometheus &prometheus) const {
+  prometheus.describe("roq_fix_proxy_latency_nanoseconds"sv, tools::Prometheus::Type::HISTOGRAM, "Hop-by-hop latency"sv);
+  for (auto direction : {Direction::UPSTREAM, Direction::DOWNSTREAM}) {
+    auto &[msg_types, entries] = entries_[static_cast<size_t>(direction)];
+    auto helper = [&](auto &entry, auto const &msg_type) {
+      for (auto stage : {Stage::DECODE, Stage::QUEUE, Stage::ROUTE, Stage::ENCODE, Stage::TOTAL}) {
+        auto &buckets = entry.buckets[static_cast<size_t>(stage)];
+        if (buckets.count() == 0) {
+          continue;
+        }
+        prometheus.histogram(
+            "roq_fix_proxy_latency_nanoseconds"sv, {{"direction"sv, get_name(direction)}, {"msg_type"sv, msg_type}, {"stage"sv, get_name(stage)}}, buckets);
+      }
+    };
+    for (size_t i = 0; i < std::size(msg_types); ++i) {
+      helper(entries[i], fmt::format("{}"sv, msg_types[i]));
+    }
+    helper(entries.back(), "OTHER"sv);
+  }
+}
+
+Tracer::Entry &Tracer::get_entry(Direction direction, fix::MsgType msg_type) {
+  auto &[msg_types, entries] = entries_[static_cast<size_t>(direction)];
+  for (size_t i = 0; i < std::size(msg_types); ++i) {
+    if (msg_types[i] == msg_type) [[likely]] {
+      return entries[i];
+    }
+  }
+  if (std::size(msg_types) < MAX_MSG_TYPES) {
+    msg_types.emplace_back(msg_type);  // note! capacity has been reserved
+    return entries[std::size(msg_types) - 1];
+  }
+  return entries.back();
+}
+
+void Tracer::record(Entry &entry, Stage stage, std::chrono::nanoseconds value) {
+  auto value_2 = static_cast<uint64_t>(std::max<int64_t>(value.count(), 0));  // note! clamped (clock resolution)
+  entry.stages[static_cast<size_t>(stage)].record(value_2);
+  entry.buckets[static_cast<size_t>(stage)].record(value_2);
+}
+
+void Tracer::statistics(Direction direction) {
+  auto &[msg_types, entries] = entries_[static_cast<size_t>(direction)];
+  auto helper = [&](auto &entry, auto const &name) {
+    auto &stages = entry.stages;
+    auto &decode = stages[static_cast<size_t>(Stage::DECODE)];
+    auto &total = stages[static_cast<size_t>(Stage::TOTAL)];
+    if (decode.count() == 0 && total.count() == 0) {
+      return;
+    }
+    log::info(
+        "Latency: direction={}, msg_type={}, received={}, sent={}, decode={}, queue={}, route={}, encode={}, total={}"sv,
+        direction,
+        name,
+        decode.count(),
+        total.count(),
+        summary(decode),
+        summary(stages[static_cast<size_t>(Stage::QUEUE)]),
+        summary(stages[static_cast<size_t>(Stage::ROUTE)]),
+        summary(stages[static_cast<size_t>(Stage::ENCODE)]),
+        summary(total));
+    for (auto &histogram : stages) {
+      histogram.reset();
+    }
+  };
+  for (size_t i = 0; i < std::size(msg_types); ++i) {
+    helper(entries[i], fmt::format("{}"sv, msg_types[i]));
+  }
+  helper(entries.back(), "OTHER"sv);
+}
+
+}  // namespace fix_proxy
+}  // namespace roq
@@ -0,0 +1,89 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "roq/trace.hpp"
+
+#include "roq/fix/message.hpp"
+
+#include "roq/fix_proxy/tools/buckets.hpp"
+#include "roq/fix_proxy/tools/histogram.hpp"
+#include "roq/fix_proxy/tools/prometheus.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// hop-by-hop latency of messages passing through the proxy (per direction and message type)
+// source_receive_time is captured when the bytes were read from the socket (by whichever thread owns the socket), or by the kernel (client shards)
+// decode and queue are recorded before routing (by the message received), origin_create_time is then set to the start of routing
+// route, encode and total are recorded after sending (by the message sent)
+// messages created by the proxy itself (e.g. heartbeats) are not traced
+// histograms are logged (and reset) periodically, prometheus is given cumulative buckets (never reset)
+// only used by the event loop thread, all histograms are preallocated (recording is allocation free)
+
+struct Tracer final {
+  enum class Direction : uint8_t {
+    UPSTREAM,    // note! client => server
+    DOWNSTREAM,  // note! server => client
+  };
+
+  enum class Stage : uint8_t {
+    DECODE,
+    QUEUE,  // note! waiting for earlier messages and for the hand-over from another thread
+    ROUTE,
+    ENCODE,
+    TOTAL,  // note! from receive until the message has been sent (or handed over to another thread)
+  };
+
+  Tracer();
+
+  Tracer(Tracer &&) = delete;
+  Tracer(Tracer const &) = delete;
+
+  // note! decode_end is zero when decoded by the event loop thread (i.e. now)
+  // returns the trace info to be routed
+  TraceInfo route(
+      Direction, fix::MsgType, TraceInfo const &, std::chrono::nanoseconds decode_start, std::chrono::nanoseconds decode_end = {});
+
+  void send(Direction, fix::MsgType, TraceInfo const &, std::chrono::nanoseconds encode_start, std::chrono::nanoseconds encode_end);
+
+  // note! periodically logs and resets the histograms
+  void refresh(std::chrono::nanoseconds now);
+
+  size_t memory_usage() const;
+
+  // note! cumulative since start
+  void write(tools::Prometheus &) const;
+
+ protected:
+  static constexpr size_t STAGES = 5;
+
+  struct Entry final {
+    std::array<tools::Histogram, STAGES> stages;
+    std::array<tools::Buckets, STAGES> buckets;
+  };
+
+  struct Entries final {
+    std::vector<fix::MsgType> msg_types;  // note! searched linearly (few message types)
+    std::vector<Entry> entries;           // note! preallocated, assigned on first use (the last entry is shared when exhausted)
+  };
+
+  Entry &get_entry(Direction, fix::MsgType);
+
+  void record(Entry &, Stage, std::chrono::nanoseconds value);
+
+  void statistics(Direction);
+
+ private:
+  std::array<Entries, 2> entries_;
+  std::chrono::nanoseconds next_statistics_ = {};
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
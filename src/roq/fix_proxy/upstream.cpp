@@ -0,0 +1,95 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include "roq/fix_proxy/upstream.hpp"
+
+#include <magic_enum/magic_enum_format.hpp>
+
+#include "roq/fix/codec/error.hpp"
+
+using namespace std::literals;
+
+namespace roq {
+namespace fix_proxy {
+
+// === IMPLEMENTATION ===
+
+Upstream::Upstream(
+    server::Session::Handler &handler,
+    Settings const &settings,
+    io::Context &context,
+    io::web::URI const &uri,
+    TrafficClass traffic_class,
+    fix::proxy::Manager &proxy,
+    Shared &shared)
+    : metrics_{shared.metrics}, client_proxy_{proxy}, proxy_{Shared::create_proxy(*this, settings)},
+      session_{
+          handler, settings, context, uri, traffic_class, proxy, *proxy_, shared.tracer, shared.metrics, shared.journal, shared.orders, shared.profiler} {
+  log::info(R"(Upstream (traffic_class={}, uri="{}"))"sv, traffic_class, uri);
+}
+
+// fix::proxy::Manager::Handler
+
+// authentication:
+
+std::pair<fix::codec::Error, uint32_t> Upstream::operator()(fix::proxy::Manager::Credentials const &, uint64_t) {
+  log::warn("Unexpected"sv);  // note! no client sessions
+  return {fix::codec::Error::INVALID_USERNAME, {}};
+}
+
+// server:
+
+// - connection
+
+void Upstream::operator()(Trace<fix::proxy::Manager::Disconnected> const &event) {
+  ready_ = false;
+  reject_subscriptions(event.trace_info);
+}
+
+void Upstream::operator()(Trace<fix::proxy::Manager::Ready> const &) {
+  log::info("Ready (traffic_class={})"sv, traffic_class());
+  ready_ = true;
+  metrics_.upstream(traffic_class(), Metrics::UpstreamState::READY);
+}
+
+// client:
+
+// - connection
+
+void Upstream::operator()(Trace<fix::proxy::Manager::Disconnect> const &, uint64_t) {
+}
+
+// utilities
+
+bool Upstream::track(fix::codec::MarketDataRequest const &market_data_request) {
+  auto &md_req_id = market_data_request.md_req_id;
+  switch (market_data_request.subscription_request_type) {
+    using enum fix::SubscriptionRequestType;
+    case SNAPSHOT_UPDATES:
+      subscriptions_.emplace(md_req_id);
+      return true;
+    case UNSUBSCRIBE:
+      return subscriptions_.erase(md_req_id) > 0;
+    default:
+      return true;  // note! snapshots are not tracked
+  }
+}
+
+// note! the subscriptions are lost, the proxy manager is given the reject the upstream would have sent (it will then notify the clients)
+void Upstream::reject_subscriptions(TraceInfo const &trace_info) {
+  if (std::empty(subscriptions_)) {
+    return;
+  }
+  log::warn("Rejecting subscriptions (traffic_class={}, count={})"sv, traffic_class(), std::size(subscriptions_));
+  auto subscriptions = std::move(subscriptions_);  // note! the proxy manager may dispatch requests
+  subscriptions_.clear();
+  for (auto &md_req_id : subscriptions) {
+    auto market_data_request_reject = fix::codec::MarketDataRequestReject{
+        .md_req_id = md_req_id,
+        .text = "upstream disconnected"sv,
+    };
+    create_trace_and_dispatch(client_proxy_, trace_info, market_data_request_reject);
+  }
+}
+
+}  // namespace fix_proxy
+}  // namespace roq
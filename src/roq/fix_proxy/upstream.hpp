@@ -0,0 +1,114 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "roq/logging.hpp"
+
+#include "roq/utils/container.hpp"
+
+#include "roq/io/context.hpp"
+
+#include "roq/io/web/uri.hpp"
+
+#include "roq/fix/proxy/manager.hpp"
+
+#include "roq/fix_proxy/messages.hpp"
+#include "roq/fix_proxy/router.hpp"
+#include "roq/fix_proxy/settings.hpp"
+#include "roq/fix_proxy/shared.hpp"
+
+#include "roq/fix_proxy/server/session.hpp"
+
+namespace roq {
+namespace fix_proxy {
+
+// note!
+// a dedicated upstream session used for a traffic class other than order entry
+// owns a proxy manager only used for the session-level protocol (logon, heartbeats, etc.) of this connection
+// requests are routed here (by traffic class) and all other messages received are dispatched to the proxy manager used by the clients
+// each upstream session has its own decode buffers and optionally its own pipeline (reader thread)
+// market data subscriptions are tracked (by upstream MDReqID), they are rejected towards the clients if the connection is lost
+
+struct Upstream final : public Router<Upstream> {
+  Upstream(server::Session::Handler &, Settings const &, io::Context &, io::web::URI const &, TrafficClass, fix::proxy::Manager &proxy, Shared &);
+
+  Upstream(Upstream &&) = delete;
+  Upstream(Upstream const &) = delete;
+
+  TrafficClass traffic_class() const { return session_.traffic_class(); }
+
+  bool ready() const { return ready_; }
+
+  server::Session &session() { return session_; }
+
+  // note! returns false if the request is not owned by this session (the caller should use the order entry session)
+  template <typename T>
+  bool send(Trace<T> const &event) {
+    if constexpr (std::is_same_v<T, fix::codec::MarketDataRequest>) {
+      auto &[trace_info, market_data_request] = event;
+      if (!track(market_data_request)) {
+        return false;
+      }
+    }
+    session_(event);
+    return true;
+  }
+
+ protected:
+  template <typename, typename, typename...>
+  friend struct ServerRoute;
+  template <typename, typename, typename...>
+  friend struct ClientRoute;
+
+  // fix::proxy::Manager::Handler
+
+  using Router<Upstream>::operator();
+
+  // authentication:
+  std::pair<fix::codec::Error, uint32_t> operator()(fix::proxy::Manager::Credentials const &, uint64_t session_id) override;
+
+  // server:
+  // - connection
+  void operator()(Trace<fix::proxy::Manager::Disconnected> const &) override;
+  void operator()(Trace<fix::proxy::Manager::Ready> const &) override;
+  // - messages (see Router)
+
+  // client:
+  // - connection
+  void operator()(Trace<fix::proxy::Manager::Disconnect> const &, uint64_t session_id) override;
+  // - messages (see Router)
+
+  // note! defined here (the overrides generated by Router may be instantiated by any translation unit)
+  template <typename T>
+  void dispatch_to_server(Trace<T> const &event) {
+    session_(event);
+  }
+
+  template <typename T>
+  bool dispatch_to_client(Trace<T> const &, uint64_t session_id) {
+    using namespace std::literals;
+    log::warn<0>("Undeliverable: session_id={}"sv, session_id);  // note! never used by clients
+    return false;
+  }
+
+  // note! returns false if unsubscribing something not subscribed through this session
+  bool track(fix::codec::MarketDataRequest const &);
+
+  void reject_subscriptions(TraceInfo const &);
+
+ private:
+  Metrics &metrics_;
+  fix::proxy::Manager &client_proxy_;                 // note! shared with the clients
+  std::unique_ptr<fix::proxy::Manager> const proxy_;  // note! session-level only
+  server::Session session_;
+  bool ready_ = {};
+  utils::unordered_set<std::string> subscriptions_;  // note! upstream md_req_id
+};
+
+}  // namespace fix_proxy
+}  // namespace roq
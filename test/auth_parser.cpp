@@ -0,0 +1,97 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include "roq/fix_proxy/auth/parser.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+namespace {
+struct Handler final {
+  void operator()(auth::Parser::Insert const &insert) {
+    inserts.emplace_back(fmt_insert(insert));  // note! views are only valid during the callback
+  }
+  void operator()(auth::Parser::Remove const &remove) { removes.emplace_back(std::string{remove.component} + "/" + std::string{remove.username}); }
+  void operator()(auth::Parser::Error const &) { ++errors; }
+
+  static std::string fmt_insert(auth::Parser::Insert const &insert) {
+    return std::string{insert.component} + "/" + std::string{insert.username} + "/" + std::string{insert.password} + "/" +
+           std::to_string(insert.strategy_id);
+  }
+
+  std::vector<std::string> inserts;
+  std::vector<std::string> removes;
+  size_t errors = {};
+};
+}  // namespace
+
+TEST_CASE("auth_parser_simple", "[auth_parser]") {
+  auto payload = R"({"jsonrpc":"2.0","id":"test","result":[)"
+                 R"({"action":"insert","component":"test","username":"c1","password":"p1","strategy_id":1},)"
+                 R"({"action":"remove","component":"test","username":"c2"})"
+                 R"(]})"sv;
+  auth::Parser parser;
+  Handler handler;
+  CHECK(parser.dispatch(payload, handler) == true);
+  REQUIRE(std::size(handler.inserts) == 1);
+  CHECK(handler.inserts[0] == "test/c1/p1/1"sv);
+  REQUIRE(std::size(handler.removes) == 1);
+  CHECK(handler.removes[0] == "test/c2"sv);
+  CHECK(handler.errors == 0);
+}
+
+TEST_CASE("auth_parser_skip_unknown", "[auth_parser]") {
+  auto payload = R"( { "id" : 123, "extra" : {"a":[1,2,{"b":"]"}],"c":null} , "result" : [ )"
+                 R"( { "strategy_id" : 7 , "ignore" : [true,false], "password":"x", "username":"u", "action":"insert", "component":"c" } )"
+                 R"( ] , "tail" : "}" } )"sv;
+  auth::Parser parser;
+  Handler handler;
+  CHECK(parser.dispatch(payload, handler) == true);
+  REQUIRE(std::size(handler.inserts) == 1);
+  CHECK(handler.inserts[0] == "c/u/x/7"sv);
+}
+
+TEST_CASE("auth_parser_escape", "[auth_parser]") {
+  auto payload = R"({"result":[{"action":"insert","component":"c","username":"a\"b","password":"æ\\😀","strategy_id":1}]})"sv;
+  auth::Parser parser;
+  Handler handler;
+  CHECK(parser.dispatch(payload, handler) == true);
+  REQUIRE(std::size(handler.inserts) == 1);
+  CHECK(handler.inserts[0] == "c/a\"b/\xc3\xa6\\\xf0\x9f\x98\x80/1"sv);
+}
+
+TEST_CASE("auth_parser_not_an_array", "[auth_parser]") {
+  auth::Parser parser;
+  Handler handler;
+  CHECK(parser.dispatch(R"({"jsonrpc":"2.0","id":"test","result":"ok"})"sv, handler) == true);
+  CHECK(std::empty(handler.inserts));
+  CHECK(std::empty(handler.removes));
+}
+
+TEST_CASE("auth_parser_invalid", "[auth_parser]") {
+  auth::Parser parser;
+  Handler handler;
+  CHECK(parser.dispatch(R"({"result":[{"action":"insert","component":"c","username":"u"}]})"sv, handler) == true);
+  CHECK(handler.errors == 1);  // missing password and strategy_id
+  CHECK(parser.dispatch(R"({"result":[{"action":"insert")"sv, handler) == false);
+  CHECK(parser.dispatch(R"({"result":[{"action":"ins)"sv, handler) == false);
+  CHECK(parser.dispatch(R"({"result":[{"strategy_id":-1}]})"sv, handler) == false);
+  CHECK(std::empty(handler.inserts));
+}
+
+TEST_CASE("auth_parser_scratch_reset", "[auth_parser]") {
+  // note! escaped keys outside the result array consume scratch, this must not accumulate across payloads
+  std::string key(1000, 'k');
+  auto payload = R"({"\u0069)" + key + R"(":1,"result":"ok"})";
+  auth::Parser parser;
+  Handler handler;
+  for (size_t i = 0; i < 10; ++i) {
+    CHECK(parser.dispatch(payload, handler) == true);
+  }
+  CHECK(handler.errors == 0);
+}
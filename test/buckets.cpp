@@ -0,0 +1,47 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "roq/fix_proxy/tools/buckets.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+// === HELPERS ===
+
+namespace {
+auto get_counts(tools::Buckets const &buckets) {
+  std::vector<std::pair<uint64_t, uint64_t>> result;
+  buckets.for_each([&](auto bound, auto count) { result.emplace_back(bound, count); });
+  return result;
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+TEST_CASE("tools_buckets_empty", "[tools_buckets]") {
+  std::array<uint64_t, 2> const bounds{1, 2};
+  tools::Buckets buckets{bounds};
+  CHECK(buckets.count() == 0);
+  CHECK(buckets.sum() == 0);
+  CHECK(get_counts(buckets) == std::vector<std::pair<uint64_t, uint64_t>>{{1, 0}, {2, 0}});
+}
+
+TEST_CASE("tools_buckets_cumulative", "[tools_buckets]") {
+  std::array<uint64_t, 3> const bounds{10, 100, 1000};
+  tools::Buckets buckets{bounds};
+  buckets.record(0);
+  buckets.record(10);  // note! bounds are inclusive
+  buckets.record(11);
+  buckets.record(1000);
+  buckets.record(1001);  // note! only included by the count (+Inf)
+  CHECK(buckets.count() == 5);
+  CHECK(buckets.sum() == 2022);
+  CHECK(get_counts(buckets) == std::vector<std::pair<uint64_t, uint64_t>>{{10, 2}, {100, 3}, {1000, 4}});
+}
@@ -0,0 +1,65 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "roq/fix_proxy/tools/counters.hpp"
+
+using namespace roq::fix_proxy;
+
+// === HELPERS ===
+
+namespace {
+enum class Key {
+  A,
+  B,
+};
+
+using Counters = tools::Counters<Key, 2>;
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+TEST_CASE("tools_counters_simple", "[tools_counters]") {
+  Counters counters{3};
+  CHECK(counters.size() == 3);
+  CHECK(counters.get(Key::A) == 0);
+  CHECK(counters.get(Key::B) == 0);
+  counters[0].add(Key::A);
+  counters[1].add(Key::A, 2);
+  counters[2].add(Key::B, 5);
+  CHECK(counters[0].get(Key::A) == 1);
+  CHECK(counters[1].get(Key::A) == 2);
+  CHECK(counters[2].get(Key::A) == 0);
+  CHECK(counters.get(Key::A) == 3);
+  CHECK(counters.get(Key::B) == 5);
+}
+
+TEST_CASE("tools_counters_padding", "[tools_counters]") {
+  Counters counters{2};
+  auto distance = reinterpret_cast<std::byte const *>(&counters[1]) - reinterpret_cast<std::byte const *>(&counters[0]);
+  CHECK(distance % Counters::CACHE_LINE_SIZE == 0);
+  CHECK(reinterpret_cast<uintptr_t>(&counters[0]) % Counters::CACHE_LINE_SIZE == 0);
+}
+
+TEST_CASE("tools_counters_threads", "[tools_counters]") {
+  constexpr uint64_t const COUNT = 1000000;
+  constexpr size_t const THREADS = 4;
+  Counters counters{THREADS};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < THREADS; ++i) {
+    threads.emplace_back([&, i]() {
+      auto &slot = counters[i];
+      for (uint64_t j = 0; j < COUNT; ++j) {
+        slot.add(Key::A);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  CHECK(counters.get(Key::A) == THREADS * COUNT);
+  CHECK(counters.get(Key::B) == 0);
+}
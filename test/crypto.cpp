@@ -2,6 +2,8 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <string>
+
 #include "roq/fix_proxy/tools/crypto.hpp"
 
 using namespace std::literals;
@@ -24,3 +26,32 @@ TEST_CASE("proxy_tools_crypto_hmac_sha256", "[fix_proxy_tools_crypto]") {
   auto res_2 = crypto.validate("qEBeeU/7jdamNNZI+b4LBGRrX39qVIc20pPcZY8m5Zg="sv, "foobar"sv, "1234567890"sv);
   CHECK(res_2 == true);
 }
+
+TEST_CASE("proxy_tools_crypto_hmac_sha256_key", "[fix_proxy_tools_crypto]") {
+  tools::Crypto crypto{"hmac_sha256"sv, 5s};
+  auto key = tools::Crypto::create_key("foobar"sv);
+  auto res_1 = crypto.validate("qEBeeU/7jdamNNZI+b4LBGRrX39qVIc20pPcZY8m5Zg="sv, "foobar"sv, key, "1234567890"sv);
+  CHECK(res_1 == true);
+  auto res_2 = crypto.validate("qEBeeU/7jdamNNZI+b4LBGRrX39qVIc20pPcZY8m5Zg"sv, "foobar"sv, key, "1234567890"sv);  // no padding
+  CHECK(res_2 == true);
+  auto res_3 = crypto.validate("qEBeeU/7jdamNNZI+b4LBGRrX39qVIc20pPcZY8m5Zh="sv, "foobar"sv, key, "1234567890"sv);
+  CHECK(res_3 == false);
+  auto res_4 = crypto.validate("qEBeeU/7jdamNNZI+b4LBGRrX39qVIc20pPcZY8m5Zg="sv, "foobar"sv, key, "1234567891"sv);
+  CHECK(res_4 == false);
+  auto res_5 = crypto.validate("qEBeeU/7jdamNNZI"sv, "foobar"sv, key, "1234567890"sv);
+  CHECK(res_5 == false);
+}
+
+// note! rfc 4231 (test case 6), the key is longer than the block length and is therefore hashed
+TEST_CASE("proxy_tools_crypto_hmac_sha256_long_key", "[fix_proxy_tools_crypto]") {
+  tools::Crypto crypto{"hmac_sha256"sv, 5s};
+  std::string secret(131, '\xaa');
+  auto key = tools::Crypto::create_key(secret);
+  auto raw_data = "Test Using Larger Than Block-Size Key - Hash Key First"sv;
+  auto res_1 = crypto.validate("YOQxWR7gtn8Niiaqy/W3f44LxiE3KMUUBUYEDw7jf1Q="sv, secret, key, raw_data);  // 60e43159...0ee37f54
+  CHECK(res_1 == true);
+  auto res_2 = crypto.validate("YOQxWR7gtn8Niiaqy/W3f44LxiE3KMUUBUYEDw7jf1Q="sv, secret, raw_data);
+  CHECK(res_2 == true);
+  auto res_3 = crypto.validate("YOQxWR7gtn8Niiaqy/W3f44LxiE3KMUUBUYEDw7jf1Q="sv, secret.substr(1), raw_data);
+  CHECK(res_3 == false);
+}
@@ -0,0 +1,88 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <type_traits>
+#include <vector>
+
+#include "roq/fix/reader.hpp"
+
+#include "roq/fix_proxy/client/decoder.hpp"
+#include "roq/fix_proxy/server/decoder.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+namespace {
+auto const FIX_VERSION = fix::Version::FIX_44;
+
+template <typename Decoder>
+auto decode(auto &message, auto callback) {
+  std::vector<std::byte> decode_buffer(4096), decode_buffer_2(4096);
+  auto success = false;
+  auto parser = [&](auto &message_2) { success = Decoder::dispatch(message_2, decode_buffer, decode_buffer_2, callback); };
+  auto logger = []([[maybe_unused]] auto &message_2) {};
+  auto bytes = fix::Reader<FIX_VERSION>::dispatch(message, parser, logger);
+  REQUIRE(bytes == std::size(message));
+  return success;
+}
+}  // namespace
+
+static_assert(Messages::FromClient::contains<fix::codec::NewOrderSingle>());
+static_assert(!Messages::FromServer::contains<fix::codec::NewOrderSingle>());
+static_assert(Messages::ToServer::contains<fix::codec::UserRequest>());
+static_assert(!Messages::ToClient::contains<fix::codec::UserRequest>());
+static_assert(Messages::get_traffic_class<fix::codec::NewOrderSingle>() == TrafficClass::ORDER_ENTRY);
+static_assert(Messages::get_traffic_class<fix::codec::MarketDataRequest>() == TrafficClass::MARKET_DATA);
+static_assert(Messages::get_traffic_class<fix::codec::SecurityListRequest>() == TrafficClass::REFERENCE_DATA);
+static_assert(Messages::get_traffic_class<fix::codec::Logon>() == TrafficClass::ORDER_ENTRY);
+
+TEST_CASE("decoder_simple", "[decoder]") {
+  std::vector<std::byte> buffer(4096);
+  auto new_order_single = fix::codec::NewOrderSingle{
+      .cl_ord_id = "123"sv,
+      .secondary_cl_ord_id = {},
+      .no_party_ids = {},
+      .account = "A1",
+      .handl_inst = {},
+      .exec_inst = {},
+      .no_trading_sessions = {},
+      .symbol = "BTC-PERPETUAL"sv,
+      .security_exchange = "deribit"sv,
+      .side = fix::Side::BUY,
+      .transact_time = 1685248384123ms,
+      .order_qty = {1.0, Precision::_0},
+      .ord_type = fix::OrdType::LIMIT,
+      .price = {27193.0, Precision::_1},
+      .stop_px = {},
+      .time_in_force = fix::TimeInForce::GTC,
+      .text = {},
+      .position_effect = {},
+      .max_show = {},
+  };
+  auto header = fix::Header{
+      .version = FIX_VERSION,
+      .msg_type = fix::codec::NewOrderSingle::MSG_TYPE,
+      .sender_comp_id = "sender"sv,
+      .target_comp_id = "target"sv,
+      .msg_seq_num = 1,
+      .sending_time = 1685248384123ms,
+  };
+  auto message = new_order_single.encode(header, buffer);
+  auto count = 0;
+  auto success = decode<client::Decoder>(message, [&]<typename T>(T const &value) {
+    if constexpr (std::is_same_v<T, fix::codec::NewOrderSingle>) {
+      CHECK(value.cl_ord_id == "123"sv);
+      CHECK(value.symbol == "BTC-PERPETUAL"sv);
+      ++count;
+    }
+  });
+  CHECK(success);
+  CHECK(count == 1);
+  // note! not supported in this direction
+  success = decode<server::Decoder>(message, []([[maybe_unused]] auto &value) { FAIL(); });
+  CHECK(!success);
+}
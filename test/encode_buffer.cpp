@@ -0,0 +1,81 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+#include "roq/fix_proxy/tools/encode_buffer.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq::fix_proxy;
+
+namespace {
+// note! behaves like an encoder, i.e. throws if the message doesn't fit
+auto create_encoder(size_t length) {
+  return [length](auto &buffer) {
+    if (std::size(buffer) < length) {
+      throw roq::OverflowError{"buffer overflow"sv};
+    }
+    std::memset(std::data(buffer), 'x', length);
+    return length;
+  };
+}
+}  // namespace
+
+TEST_CASE("tools_encode_buffer_simple", "[tools_encode_buffer]") {
+  tools::EncodeBuffer encode_buffer{1024 * 1024, 1min};
+  CHECK(encode_buffer.size() == tools::EncodeBuffer::INITIAL_SIZE);
+  auto message = encode_buffer.encode(create_encoder(100));
+  CHECK(std::size(message) == 100);
+  CHECK(encode_buffer.size() == tools::EncodeBuffer::INITIAL_SIZE);
+  CHECK(encode_buffer.growth_count() == 0);
+}
+
+TEST_CASE("tools_encode_buffer_grow", "[tools_encode_buffer]") {
+  tools::EncodeBuffer encode_buffer{1024 * 1024, 1min};
+  auto message = encode_buffer.encode(create_encoder(10000));
+  CHECK(std::size(message) == 10000);
+  CHECK(encode_buffer.size() == 16384);
+  CHECK(encode_buffer.growth_count() == 2);
+  // note! no further growth
+  encode_buffer.encode(create_encoder(10000));
+  CHECK(encode_buffer.growth_count() == 2);
+}
+
+TEST_CASE("tools_encode_buffer_max_size", "[tools_encode_buffer]") {
+  tools::EncodeBuffer encode_buffer{10000, 1min};
+  CHECK(std::size(encode_buffer.encode(create_encoder(10000))) == 10000);
+  CHECK(encode_buffer.size() == 10000);
+  CHECK_THROWS_AS(encode_buffer.encode(create_encoder(10001)), roq::OverflowError);
+}
+
+TEST_CASE("tools_encode_buffer_error", "[tools_encode_buffer]") {
+  tools::EncodeBuffer encode_buffer{1024 * 1024, 1min};
+  // note! not an overflow, i.e. the buffer must not grow
+  auto encoder = []([[maybe_unused]] auto &buffer) -> size_t { throw std::runtime_error{"unexpected"}; };
+  CHECK_THROWS_AS(encode_buffer.encode(encoder), std::runtime_error);
+  CHECK(encode_buffer.size() == tools::EncodeBuffer::INITIAL_SIZE);
+  CHECK(encode_buffer.growth_count() == 0);
+}
+
+TEST_CASE("tools_encode_buffer_shrink", "[tools_encode_buffer]") {
+  tools::EncodeBuffer encode_buffer{1024 * 1024, 1min};
+  auto now = 1700000000000ms;
+  encode_buffer.encode(create_encoder(100000));
+  CHECK(encode_buffer.size() == 131072);
+  encode_buffer.refresh(now);
+  encode_buffer.encode(create_encoder(100));
+  encode_buffer.refresh(now + 30s);
+  CHECK(encode_buffer.size() == 131072);
+  // note! large message postpones shrinking
+  encode_buffer.encode(create_encoder(100000));
+  encode_buffer.refresh(now + 45s);
+  encode_buffer.refresh(now + 90s);
+  CHECK(encode_buffer.size() == 131072);
+  encode_buffer.refresh(now + 105s);
+  CHECK(encode_buffer.size() == tools::EncodeBuffer::INITIAL_SIZE);
+  CHECK(encode_buffer.growth_count() == 5);
+}
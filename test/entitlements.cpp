@@ -0,0 +1,83 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "roq/fix_proxy/entitlements.hpp"
+
+using namespace std::literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+using Entitlements_ = Entitlements<Messages::FromClient>;
+
+TEST_CASE("entitlements_default", "[entitlements]") {
+  Entitlements_ entitlements;
+  CHECK(entitlements.contains<fix::codec::Logon>());
+  CHECK(entitlements.contains<fix::codec::NewOrderSingle>());
+  CHECK(entitlements.contains<fix::codec::MassQuote>());
+}
+
+TEST_CASE("entitlements_empty", "[entitlements]") {
+  auto entitlements = Entitlements_::create(std::vector<std::string>{});
+  CHECK(entitlements.contains<fix::codec::NewOrderSingle>());
+  CHECK(entitlements.contains<fix::codec::MarketDataRequest>());
+}
+
+TEST_CASE("entitlements_simple", "[entitlements]") {
+  auto entitlements = Entitlements_::create(std::vector{"NewOrderSingle"sv, "OrderCancelRequest"sv});
+  // note! session-level messages are always allowed
+  CHECK(entitlements.contains<fix::codec::Logon>());
+  CHECK(entitlements.contains<fix::codec::Logout>());
+  CHECK(entitlements.contains<fix::codec::Heartbeat>());
+  CHECK(entitlements.contains<fix::codec::TestRequest>());
+  CHECK(entitlements.contains<fix::codec::ResendRequest>());
+  CHECK(entitlements.contains<fix::codec::Reject>());
+  CHECK(entitlements.contains<fix::codec::NewOrderSingle>());
+  CHECK(entitlements.contains<fix::codec::OrderCancelRequest>());
+  CHECK(!entitlements.contains<fix::codec::OrderCancelReplaceRequest>());
+  CHECK(!entitlements.contains<fix::codec::MarketDataRequest>());
+  CHECK(!entitlements.contains<fix::codec::MassQuote>());
+  // note! not in the type list (left to the decoder)
+  CHECK(entitlements.contains<fix::codec::ExecutionReport>());
+}
+
+TEST_CASE("entitlements_none", "[entitlements]") {
+  auto entitlements = Entitlements_::none();
+  CHECK(entitlements.contains<fix::codec::Logon>());
+  CHECK(entitlements.contains<fix::codec::Logout>());
+  CHECK(entitlements.contains<fix::codec::Heartbeat>());
+  CHECK(!entitlements.contains<fix::codec::NewOrderSingle>());
+  CHECK(!entitlements.contains<fix::codec::MarketDataRequest>());
+  CHECK(!entitlements.contains<fix::codec::MassQuote>());
+}
+
+TEST_CASE("entitlements_msg_type", "[entitlements]") {
+  auto entitlements = Entitlements_::create(std::vector{"NewOrderSingle"sv});
+  CHECK(entitlements(fix::codec::Logon::MSG_TYPE));
+  CHECK(entitlements(fix::codec::NewOrderSingle::MSG_TYPE));
+  CHECK(!entitlements(fix::codec::OrderCancelRequest::MSG_TYPE));
+  CHECK(!entitlements(fix::codec::MassQuote::MSG_TYPE));
+  // note! not in the type list (left to the decoder)
+  CHECK(entitlements(fix::codec::ExecutionReport::MSG_TYPE));
+  // note! beyond the lookup table (left to the decoder)
+  auto out_of_range = static_cast<fix::MsgType>(std::numeric_limits<std::underlying_type_t<fix::MsgType>>::max());
+  CHECK(entitlements(out_of_range));
+  CHECK(Entitlements_::none()(out_of_range));
+}
+
+// note! create() terminates (log::fatal) for the names rejected here
+TEST_CASE("entitlements_is_valid", "[entitlements]") {
+  CHECK(Entitlements_::is_valid("NewOrderSingle"sv));
+  CHECK(Entitlements_::is_valid("MassQuote"sv));
+  CHECK(Entitlements_::is_valid("Logon"sv));
+  CHECK(!Entitlements_::is_valid(""sv));
+  CHECK(!Entitlements_::is_valid("newordersingle"sv));
+  CHECK(!Entitlements_::is_valid("NewOrderSingleX"sv));
+  CHECK(!Entitlements_::is_valid("ExecutionReport"sv));  // note! not sent by clients
+}
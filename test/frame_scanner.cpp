@@ -0,0 +1,128 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmt/format.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "roq/fix_proxy/tools/frame_scanner.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+// === HELPERS ===
+
+namespace {
+auto create_message(std::string_view const &body) {
+  auto result = fmt::format("8=FIX.4.4\x01"
+                            "9={}\x01"
+                            "{}"sv,
+                            std::size(body),
+                            body);
+  uint32_t sum = {};
+  for (auto c : result) {
+    sum += static_cast<uint8_t>(c);
+  }
+  return fmt::format("{}10={:03}\x01"sv, result, sum % 256);
+}
+
+auto const BODY =
+    "35=8\x01"
+    "49=server\x01"
+    "56=proxy\x01"
+    "34=123\x01"
+    "52=20260101-00:00:00.000\x01"
+    "11=123456789\x01"
+    "55=BTC-PERPETUAL\x01"
+    "207=deribit\x01"
+    "150=0\x01"
+    "39=0\x01"sv;
+
+auto to_span(std::string const &value) {
+  return std::span{reinterpret_cast<std::byte const *>(std::data(value)), std::size(value)};
+}
+}  // namespace
+
+// === IMPLEMENTATION ===
+
+TEST_CASE("tools_frame_scanner_simple", "[tools_frame_scanner]") {
+  tools::FrameScanner scanner{true};
+  auto message = create_message(BODY);
+  auto buffer = message + message + message;
+  std::vector<std::span<std::byte const>> frames;
+  auto result = scanner.scan(to_span(buffer), frames);
+  CHECK(result.status == tools::FrameScanner::Status::OK);
+  CHECK(result.bytes == std::size(buffer));
+  REQUIRE(std::size(frames) == 3);
+  for (size_t i = 0; i < std::size(frames); ++i) {
+    CHECK(std::data(frames[i]) == std::data(to_span(buffer)) + (i * std::size(message)));
+    CHECK(std::size(frames[i]) == std::size(message));
+  }
+}
+
+TEST_CASE("tools_frame_scanner_incomplete", "[tools_frame_scanner]") {
+  tools::FrameScanner scanner{true};
+  auto message = create_message(BODY);
+  auto buffer = message + message;
+  // note! every partial second message
+  for (size_t length = std::size(message); length < std::size(buffer); ++length) {
+    std::vector<std::span<std::byte const>> frames;
+    auto result = scanner.scan(to_span(buffer).subspan(0, length), frames);
+    CHECK(result.status == tools::FrameScanner::Status::OK);
+    CHECK(result.bytes == std::size(message));
+    CHECK(std::size(frames) == 1);
+  }
+}
+
+TEST_CASE("tools_frame_scanner_invalid", "[tools_frame_scanner]") {
+  tools::FrameScanner scanner{true};
+  auto message = create_message(BODY);
+  auto scan = [&](auto &buffer) {
+    std::vector<std::span<std::byte const>> frames;
+    return scanner.scan(to_span(buffer), frames).status;
+  };
+  auto begin_string = "X"s + message;
+  CHECK(scan(begin_string) == tools::FrameScanner::Status::INVALID_BEGIN_STRING);
+  auto body_length = message;
+  body_length.replace(body_length.find("\x01"
+                                       "9="sv) + 3,
+                      1,
+                      "X"sv);
+  CHECK(scan(body_length) == tools::FrameScanner::Status::INVALID_BODY_LENGTH);
+  auto body = message;
+  body.insert(body.find("35="sv), "1=2\x01"sv);  // note! checksum tag is no longer where expected
+  CHECK(scan(body) == tools::FrameScanner::Status::INVALID_BODY_LENGTH);
+  auto checksum = message;
+  checksum[checksum.find("55="sv) + 3] = 'E';  // note! same length, different content
+  CHECK(scan(checksum) == tools::FrameScanner::Status::INVALID_CHECKSUM);
+}
+
+TEST_CASE("tools_frame_scanner_no_validation", "[tools_frame_scanner]") {
+  tools::FrameScanner scanner{false};
+  auto message = create_message(BODY);
+  message[message.find("55="sv) + 3] = 'E';
+  std::vector<std::span<std::byte const>> frames;
+  auto result = scanner.scan(to_span(message), frames);
+  CHECK(result.status == tools::FrameScanner::Status::OK);
+  CHECK(std::size(frames) == 1);
+}
+
+TEST_CASE("tools_frame_scanner_checksum", "[tools_frame_scanner]") {
+  std::mt19937 engine{42};
+  std::vector<std::byte> buffer(1024);
+  for (auto &item : buffer) {
+    item = static_cast<std::byte>(engine());
+  }
+  for (size_t length = 0; length < std::size(buffer); ++length) {
+    auto data = std::span<std::byte const>{buffer}.subspan(0, length);
+    auto expected = tools::FrameScanner::checksum_scalar(data);
+    CHECK(tools::FrameScanner::checksum(data) == expected);
+    if (tools::FrameScanner::has_avx2()) {
+      CHECK(tools::FrameScanner::checksum_avx2(data) == expected);
+    }
+  }
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "roq/fix_proxy/tools/histogram.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+// === IMPLEMENTATION ===
+
+TEST_CASE("tools_histogram_empty", "[tools_histogram]") {
+  tools::Histogram histogram{3600000000000, 3};
+  CHECK(histogram.count() == 0);
+  CHECK(histogram.min() == 0);
+  CHECK(histogram.max() == 0);
+  CHECK(histogram.value_at_percentile(50.0) == 0);
+}
+
+TEST_CASE("tools_histogram_exact", "[tools_histogram]") {
+  tools::Histogram histogram{3600000000000, 3};
+  // note! values below 2048 have single unit resolution when using 3 significant figures
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    histogram.record(i);
+  }
+  CHECK(histogram.count() == 1000);
+  CHECK(histogram.min() == 1);
+  CHECK(histogram.max() == 1000);
+  CHECK(histogram.mean() == 500.5);
+  CHECK(histogram.value_at_percentile(0.0) == 1);
+  CHECK(histogram.value_at_percentile(50.0) == 500);
+  CHECK(histogram.value_at_percentile(99.0) == 990);
+  CHECK(histogram.value_at_percentile(100.0) == 1000);
+}
+
+TEST_CASE("tools_histogram_precision", "[tools_histogram]") {
+  tools::Histogram histogram{3600000000000, 3};
+  std::mt19937_64 generator{42};
+  std::lognormal_distribution<double> distribution{10.0, 2.0};
+  std::vector<uint64_t> values;
+  for (size_t i = 0; i < 100000; ++i) {
+    auto value = static_cast<uint64_t>(distribution(generator)) + 1;
+    values.emplace_back(value);
+    histogram.record(value);
+  }
+  std::sort(std::begin(values), std::end(values));
+  for (auto percentile : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+    auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(std::size(values))));
+    auto expected = values[rank - 1];
+    auto actual = histogram.value_at_percentile(percentile);
+    // note! relative error is bounded by the number of significant figures
+    CHECK(static_cast<double>(actual) >= static_cast<double>(expected) * 0.999);
+    CHECK(static_cast<double>(actual) <= static_cast<double>(expected) * 1.001);
+  }
+  CHECK(histogram.min() == values.front());
+  CHECK(histogram.max() == values.back());
+}
+
+TEST_CASE("tools_histogram_clamp", "[tools_histogram]") {
+  tools::Histogram histogram{1000000, 3};
+  histogram.record(10000000);
+  CHECK(histogram.count() == 1);
+  CHECK(histogram.max() == 1000000);
+}
+
+TEST_CASE("tools_histogram_merge_and_reset", "[tools_histogram]") {
+  tools::Histogram histogram_1{1000000, 3}, histogram_2{1000000, 3};
+  histogram_1.record(100, 3);
+  histogram_2.record(200);
+  histogram_2.record(300);
+  histogram_1.merge(histogram_2);
+  CHECK(histogram_1.count() == 5);
+  CHECK(histogram_1.min() == 100);
+  CHECK(histogram_1.max() == 300);
+  size_t buckets = {};
+  uint64_t total = {};
+  histogram_1.for_each([&](auto value, auto count) {
+    ++buckets;
+    total += count;
+    CHECK(value >= 100);
+  });
+  CHECK(buckets == 3);
+  CHECK(total == 5);
+  histogram_1.reset();
+  CHECK(histogram_1.count() == 0);
+  CHECK(histogram_1.value_at_percentile(100.0) == 0);
+}
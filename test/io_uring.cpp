@@ -0,0 +1,150 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "roq/fix_proxy/tools/io_uring.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+namespace {
+auto to_span(std::string_view const &value) {
+  return std::span{reinterpret_cast<std::byte const *>(std::data(value)), std::size(value)};
+}
+
+auto to_string_view(std::span<std::byte const> const &value) {
+  return std::string_view{reinterpret_cast<char const *>(std::data(value)), std::size(value)};
+}
+
+// note! returns all completions dispatched until the predicate is satisfied (or the timeout expired)
+template <typename Predicate>
+auto wait_for(tools::IoUring &io_uring, Predicate predicate) {
+  std::vector<tools::IoUring::Completion> result;
+  auto deadline = std::chrono::steady_clock::now() + 1s;
+  while (!predicate(result) && std::chrono::steady_clock::now() < deadline) {
+    io_uring.enter(10ms);
+    io_uring.dispatch([&](auto &completion) { result.emplace_back(completion); });
+  }
+  return result;
+}
+}  // namespace
+
+TEST_CASE("tools_io_uring_multishot", "[tools_io_uring]") {
+  tools::IoUring io_uring{8, 4, 16};
+  auto listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  REQUIRE(listener >= 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  REQUIRE(::bind(listener, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) == 0);
+  REQUIRE(::listen(listener, 4) == 0);
+  REQUIRE(::getsockname(listener, reinterpret_cast<struct sockaddr *>(&address), &length) == 0);
+  // accept
+  io_uring.accept(listener, 1);
+  CHECK(io_uring.enter(0ns) == true);
+  CHECK(io_uring.enter(0ns) == false);  // note! nothing to submit
+  std::vector<int> clients;
+  for (size_t i = 0; i < 2; ++i) {
+    clients.emplace_back(::socket(AF_INET, SOCK_STREAM, 0));
+    REQUIRE(::connect(clients.back(), reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) == 0);
+  }
+  auto accepted = wait_for(io_uring, [](auto &completions) { return std::size(completions) >= 2; });
+  REQUIRE(std::size(accepted) == 2);
+  for (auto &completion : accepted) {
+    CHECK(completion.user_data == 1);
+    CHECK(completion.result >= 0);
+    CHECK(completion.more() == true);  // note! still armed
+  }
+  auto server = accepted[0].result;
+  // receive (the message is larger than a buffer)
+  io_uring.receive(server, 2);
+  auto message = "8=FIX.4.4|9=5|35=0|10=123|"sv;
+  REQUIRE(::send(clients[0], std::data(message), std::size(message), 0) == static_cast<ssize_t>(std::size(message)));
+  std::string received;
+  auto helper = [&](auto &completions) {
+    for (auto &completion : completions) {
+      if (completion.has_buffer()) {
+        received.append(to_string_view(io_uring.buffer(completion.buffer_id(), completion.result)));
+        io_uring.release(completion.buffer_id());
+      }
+    }
+    completions.clear();
+    return std::size(received) >= std::size(message);
+  };
+  wait_for(io_uring, helper);
+  CHECK(received == message);
+  // send
+  io_uring.send(server, to_span(message), 3);
+  auto sent = wait_for(io_uring, [](auto &completions) { return !std::empty(completions); });
+  REQUIRE(std::size(sent) == 1);
+  CHECK(sent[0].user_data == 3);
+  CHECK(sent[0].result == static_cast<int32_t>(std::size(message)));
+  std::vector<char> buffer(64);
+  CHECK(::recv(clients[0], std::data(buffer), std::size(buffer), 0) == static_cast<ssize_t>(std::size(message)));
+  // cancel
+  io_uring.cancel(2, 4);
+  auto cancelled = wait_for(io_uring, [](auto &completions) { return std::size(completions) >= 2; });
+  REQUIRE(std::size(cancelled) == 2);
+  for (auto &completion : cancelled) {
+    if (completion.user_data == 2) {
+      CHECK(completion.result == -ECANCELED);
+      CHECK(completion.more() == false);  // note! terminated
+    } else {
+      CHECK(completion.user_data == 4);
+      CHECK(completion.result == 0);
+    }
+  }
+  // cancel all
+  io_uring.cancel_all(5);
+  cancelled = wait_for(io_uring, [](auto &completions) { return std::size(completions) >= 2; });
+  REQUIRE(std::size(cancelled) == 2);
+  for (auto &completion : cancelled) {
+    if (completion.user_data == 1) {
+      CHECK(completion.result == -ECANCELED);
+      CHECK(completion.more() == false);
+    } else {
+      CHECK(completion.user_data == 5);
+      CHECK(completion.result == 1);  // note! the multishot accept
+    }
+  }
+  for (auto &completion : accepted) {
+    ::close(completion.result);
+  }
+  for (auto fd : clients) {
+    ::close(fd);
+  }
+  ::close(listener);
+}
+
+TEST_CASE("tools_io_uring_read", "[tools_io_uring]") {
+  tools::IoUring io_uring{8, 4, 16};
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+  std::vector<std::byte> buffer(8);
+  io_uring.read(fds[0], buffer, 1);
+  CHECK(io_uring.enter(0ns) == true);
+  auto message = "abc"sv;
+  REQUIRE(::write(fds[1], std::data(message), std::size(message)) == static_cast<ssize_t>(std::size(message)));
+  auto completions = wait_for(io_uring, [](auto &completions) { return !std::empty(completions); });
+  REQUIRE(std::size(completions) == 1);
+  CHECK(completions[0].user_data == 1);
+  CHECK(completions[0].result == static_cast<int32_t>(std::size(message)));
+  CHECK(completions[0].more() == false);
+  CHECK(to_string_view(std::span{buffer}.subspan(0, std::size(message))) == message);
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
@@ -0,0 +1,212 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "roq/fix_proxy/tools/journal_reader.hpp"
+#include "roq/fix_proxy/tools/journal_writer.hpp"
+
+using namespace roq::fix_proxy;
+
+using namespace std::literals;
+
+namespace {
+struct TemporaryDirectory final {
+  TemporaryDirectory() {
+    std::string tmp = std::filesystem::temp_directory_path() / "roq-fix-proxy-journal-XXXXXX";
+    path = ::mkdtemp(std::data(tmp));
+    REQUIRE(!std::empty(path));
+  }
+
+  ~TemporaryDirectory() { std::filesystem::remove_all(path); }
+
+  auto segments() const {
+    std::vector<std::filesystem::path> result;
+    for (auto &entry : std::filesystem::directory_iterator{path}) {
+      result.emplace_back(entry.path());
+    }
+    std::sort(std::begin(result), std::end(result));
+    return result;
+  }
+
+  std::string path;
+};
+
+auto load(auto &path) {
+  std::ifstream file{path, std::ios::binary};
+  std::vector<char> tmp{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  std::vector<std::byte> result(std::size(tmp));
+  std::transform(std::begin(tmp), std::end(tmp), std::begin(result), [](auto value) { return static_cast<std::byte>(value); });
+  return result;
+}
+
+auto as_bytes(std::string_view const &value) {
+  return std::span{reinterpret_cast<std::byte const *>(std::data(value)), std::size(value)};
+}
+
+auto as_string(std::span<std::byte const> const &value) {
+  return std::string_view{reinterpret_cast<char const *>(std::data(value)), std::size(value)};
+}
+}  // namespace
+
+TEST_CASE("tools_journal_simple", "[tools_journal]") {
+  TemporaryDirectory directory;
+  {
+    auto config = tools::JournalWriter::Config{
+        .path = directory.path,
+        .segment_size = 1048576,
+        .buffer_size = 4096,
+        .channels = 2,
+    };
+    tools::JournalWriter writer{config};
+    CHECK(std::size(writer) == 2);
+    using enum tools::Journal::Peer;
+    using enum tools::Journal::Direction;
+    CHECK(writer[0].write(CLIENT, INBOUND, 1, 100ns, as_bytes("8=FIX.4.4|35=A|"sv)) == true);
+    CHECK(writer[0].write(SERVER, OUTBOUND, 0, 200ns, as_bytes("8=FIX.4.4|35=D|"sv)) == true);
+    CHECK(writer[1].write(SERVER, INBOUND, 0, 300ns, as_bytes("8=FIX.4.4|35=8|"sv)) == true);
+    CHECK(writer[1].write(CLIENT, OUTBOUND, 2, 400ns, {}) == true);
+    CHECK(writer[0].write(CLIENT, INBOUND, 1, 500ns, std::vector<std::byte>(4096)) == false);  // note! larger than the ring
+    CHECK(writer[0].dropped() == 1);
+    CHECK(writer.dropped() == 1);
+  }
+  auto segments = directory.segments();
+  REQUIRE(std::size(segments) == 1);
+  CHECK(segments[0].extension() == ".journal"sv);
+  auto data = load(segments[0]);
+  std::vector<tools::JournalReader::Record> records;
+  std::vector<std::string> messages;
+  auto status = tools::JournalReader{data}.dispatch([&](auto &record) {
+    records.emplace_back(record);
+    messages.emplace_back(as_string(record.message));
+  });
+  CHECK(status == tools::JournalReader::Status::OK);
+  REQUIRE(std::size(records) == 4);
+  // note! order is only guaranteed within a channel
+  std::vector<int64_t> timestamps;
+  for (auto &record : records) {
+    timestamps.emplace_back(record.timestamp.count());
+    CHECK((record.realtime - record.timestamp) == (records[0].realtime - records[0].timestamp));
+  }
+  std::sort(std::begin(timestamps), std::end(timestamps));
+  CHECK(timestamps == std::vector<int64_t>{100, 200, 300, 400});
+  for (size_t i = 0; i < std::size(records); ++i) {
+    auto &record = records[i];
+    switch (record.timestamp.count()) {
+      case 100:
+        CHECK(record.peer == tools::Journal::Peer::CLIENT);
+        CHECK(record.direction == tools::Journal::Direction::INBOUND);
+        CHECK(record.session_id == 1);
+        CHECK(messages[i] == "8=FIX.4.4|35=A|"sv);
+        break;
+      case 200:
+        CHECK(record.peer == tools::Journal::Peer::SERVER);
+        CHECK(record.direction == tools::Journal::Direction::OUTBOUND);
+        CHECK(record.session_id == 0);
+        CHECK(messages[i] == "8=FIX.4.4|35=D|"sv);
+        break;
+      case 300:
+        CHECK(messages[i] == "8=FIX.4.4|35=8|"sv);
+        break;
+      case 400:
+        CHECK(record.session_id == 2);
+        CHECK(std::empty(messages[i]));
+        break;
+    }
+  }
+}
+
+TEST_CASE("tools_journal_prepare", "[tools_journal]") {
+  TemporaryDirectory directory;
+  {
+    auto config = tools::JournalWriter::Config{
+        .path = directory.path,
+        .segment_size = 1048576,
+        .buffer_size = 4096,
+        .channels = 1,
+    };
+    tools::JournalWriter writer{config};
+    auto &channel = writer[0];
+    using enum tools::Journal::Peer;
+    using enum tools::Journal::Direction;
+    CHECK(channel.prepare(CLIENT, OUTBOUND, 1, 100ns, as_bytes("8=FIX.4.4|35=8|"sv)) == true);  // note! not sent
+    CHECK(channel.prepare(CLIENT, OUTBOUND, 1, 200ns, as_bytes("8=FIX.4.4|35=9|"sv)) == true);
+    channel.commit();
+    CHECK(channel.max_length() == 2016);
+    CHECK(tools::JournalWriter::Channel::get_buffer_size(channel.max_length()) == 4096);
+    CHECK(channel.prepare(CLIENT, OUTBOUND, 1, 300ns, std::vector<std::byte>(channel.max_length() + 1)) == false);
+    CHECK(channel.dropped() == 1);
+    CHECK(channel.oversized() == 1);
+  }
+  auto segments = directory.segments();
+  REQUIRE(std::size(segments) == 1);
+  auto data = load(segments[0]);
+  std::vector<int64_t> timestamps;
+  auto status = tools::JournalReader{data}.dispatch([&](auto &record) { timestamps.emplace_back(record.timestamp.count()); });
+  CHECK(status == tools::JournalReader::Status::OK);
+  CHECK(timestamps == std::vector<int64_t>{200});
+}
+
+TEST_CASE("tools_journal_segments", "[tools_journal]") {
+  constexpr size_t const SEGMENT_SIZE = 256;
+  constexpr size_t const COUNT = 20;
+  TemporaryDirectory directory;
+  {
+    auto config = tools::JournalWriter::Config{
+        .path = directory.path,
+        .segment_size = SEGMENT_SIZE,
+        .buffer_size = 4096,
+        .channels = 1,
+    };
+    tools::JournalWriter writer{config};
+    std::string message(40, 'x');  // note! 64 bytes including the record header
+    for (size_t i = 0; i < COUNT; ++i) {
+      while (!writer[0].write(tools::Journal::Peer::CLIENT, tools::Journal::Direction::INBOUND, i, std::chrono::nanoseconds{i}, as_bytes(message))) {
+      }
+    }
+  }
+  auto segments = directory.segments();
+  CHECK(std::size(segments) == 7);  // note! 32 bytes file header + 3 records
+  std::vector<uint64_t> session_ids;
+  for (auto &segment : segments) {
+    CHECK(std::filesystem::file_size(segment) <= SEGMENT_SIZE);
+    auto data = load(segment);
+    auto status = tools::JournalReader{data}.dispatch([&](auto &record) { session_ids.emplace_back(record.session_id); });
+    CHECK(status == tools::JournalReader::Status::OK);
+  }
+  REQUIRE(std::size(session_ids) == COUNT);
+  for (size_t i = 0; i < COUNT; ++i) {
+    CHECK(session_ids[i] == i);
+  }
+}
+
+TEST_CASE("tools_journal_reader_invalid", "[tools_journal]") {
+  size_t count = {};
+  auto callback = [&]([[maybe_unused]] auto &record) { ++count; };
+  std::vector<std::byte> data(sizeof(tools::Journal::FileHeader));
+  CHECK(tools::JournalReader{data}.dispatch(callback) == tools::JournalReader::Status::INVALID_HEADER);
+  auto file_header = tools::Journal::FileHeader{
+      .magic = tools::Journal::MAGIC,
+      .version = tools::Journal::VERSION,
+  };
+  std::memcpy(std::data(data), &file_header, sizeof(file_header));
+  CHECK(tools::JournalReader{data}.dispatch(callback) == tools::JournalReader::Status::OK);
+  auto record_header = tools::Journal::RecordHeader{
+      .length = 10,
+  };
+  data.resize(sizeof(file_header) + sizeof(record_header) + 5);
+  std::memcpy(std::data(data) + sizeof(file_header), &record_header, sizeof(record_header));
+  CHECK(tools::JournalReader{data}.dispatch(callback) == tools::JournalReader::Status::TRUNCATED);
+  CHECK(count == 0);
+  file_header.version = tools::Journal::VERSION + 1;
+  std::memcpy(std::data(data), &file_header, sizeof(file_header));
+  CHECK(tools::JournalReader{data}.dispatch(callback) == tools::JournalReader::Status::UNSUPPORTED_VERSION);
+}
@@ -0,0 +1,44 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "roq/fix_proxy/tools/nonce_set.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq::fix_proxy;
+
+TEST_CASE("tools_nonce_set_simple", "[tools_nonce_set]") {
+  tools::NonceSet nonce_set{5s};
+  auto now = 1700000000000ms;
+  CHECK(nonce_set.insert(now, 1) == true);
+  CHECK(nonce_set.insert(now, 1) == false);
+  CHECK(nonce_set.insert(now, 2) == true);
+  CHECK(nonce_set.size() == 2);
+}
+
+TEST_CASE("tools_nonce_set_window", "[tools_nonce_set]") {
+  auto tolerance = 5s;
+  tools::NonceSet nonce_set{tolerance};
+  auto start = 1700000000000ms;
+  // note! nonce must be remembered while it can still be accepted, i.e. while now - tolerance <= timestamp
+  CHECK(nonce_set.insert(start, 42) == true);
+  for (auto now = start; now <= (start + tolerance); now += 10ms) {
+    // every accepted timestamp within [now - tolerance, now + tolerance]
+    CHECK(nonce_set.insert(now + tolerance, static_cast<uint64_t>(now.count())) == true);
+    CHECK(nonce_set.insert(start, 42) == false);
+  }
+}
+
+TEST_CASE("tools_nonce_set_bounded", "[tools_nonce_set]") {
+  auto tolerance = 1s;
+  tools::NonceSet nonce_set{tolerance};
+  auto start = 1700000000000ms;
+  uint64_t fingerprint = {};
+  for (auto now = start; now < (start + 60s); now += 1ms) {
+    CHECK(nonce_set.insert(now, ++fingerprint) == true);
+  }
+  // note! 2 * tolerance + 2 buckets (of tolerance / 4)
+  CHECK(nonce_set.size() <= 2500);
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmt/format.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+#include "roq/fix_proxy/tools/order_table.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+TEST_CASE("tools_order_table_simple", "[tools_order_table]") {
+  tools::OrderTable<int> table{4};
+  CHECK(table.empty());
+  CHECK(table.capacity() == 4);
+  CHECK(table.insert("a1"sv, 1) == true);
+  CHECK(table.insert("a2"sv, 2) == true);
+  CHECK(table.insert("a1"sv, 3) == true);  // note! replaced
+  CHECK(table.size() == 2);
+  CHECK(table.insert("a3"sv, 4) == true);
+  CHECK(table.insert("a4"sv, 5) == true);
+  CHECK(table.insert("a5"sv, 6) == false);  // note! full
+  CHECK(table.insert(std::string(tools::OrderTable<int>::MAX_KEY_LENGTH + 1, 'x'), 7) == false);
+  int value = {};
+  CHECK(table.extract("a1"sv, value) == true);
+  CHECK(value == 3);
+  CHECK(table.extract("a1"sv, value) == false);
+  CHECK(table.extract("b1"sv, value) == false);
+  CHECK(table.insert("a5"sv, 6) == true);
+  CHECK(table.size() == 4);
+  table.erase_if([](auto const &key, auto const &value) { return key == "a2"sv || value == 6; });
+  CHECK(table.size() == 2);
+  CHECK(table.extract("a3"sv, value) == true);
+  CHECK(value == 4);
+  table.clear();
+  CHECK(table.empty());
+  CHECK(table.extract("a4"sv, value) == false);
+}
+
+// note! compared with std::map (collisions, backward shift deletion and wrap-around are exercised by the small table)
+TEST_CASE("tools_order_table_random", "[tools_order_table]") {
+  size_t const CAPACITY = 64;
+  tools::OrderTable<uint64_t> table{CAPACITY};
+  std::map<std::string, uint64_t> reference;
+  std::mt19937_64 generator{42};
+  std::uniform_int_distribution<uint64_t> distribution{0, 255};
+  for (uint64_t i = 0; i < 100000; ++i) {
+    auto key = fmt::format("order-{}"sv, distribution(generator));
+    switch (i % 5) {
+      case 0:
+      case 1: {
+        auto success = table.insert(key, i);
+        if (std::size(reference) < CAPACITY || reference.contains(key)) {
+          REQUIRE(success);
+          reference[key] = i;
+        } else {
+          REQUIRE(!success);
+        }
+        break;
+      }
+      case 2:
+      case 3: {
+        uint64_t value = {};
+        auto iter = reference.find(key);
+        REQUIRE(table.extract(key, value) == (iter != std::end(reference)));
+        if (iter != std::end(reference)) {
+          REQUIRE(value == (*iter).second);
+          reference.erase(iter);
+        }
+        break;
+      }
+      case 4: {
+        auto threshold = i > 1000 ? i - 1000 : 0;
+        table.erase_if([&](auto const &, auto const &value) { return value < threshold; });
+        std::erase_if(reference, [&](auto &item) { return item.second < threshold; });
+        break;
+      }
+    }
+    REQUIRE(table.size() == std::size(reference));
+  }
+  for (auto &[key, expected] : reference) {
+    uint64_t value = {};
+    CHECK(table.extract(key, value) == true);
+    CHECK(value == expected);
+  }
+  CHECK(table.empty());
+}
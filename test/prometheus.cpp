@@ -0,0 +1,70 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "roq/fix_proxy/tools/prometheus.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+// === IMPLEMENTATION ===
+
+TEST_CASE("tools_prometheus_simple", "[tools_prometheus]") {
+  std::string buffer;
+  tools::Prometheus prometheus{buffer};
+  prometheus.describe("test_total"sv, tools::Prometheus::Type::COUNTER, "Some test"sv);
+  prometheus.sample("test_total"sv, {}, uint64_t{123});
+  prometheus.sample("test_total"sv, {{"peer"sv, "client"sv}, {"direction"sv, "sent"sv}}, uint64_t{0});
+  CHECK(
+      buffer == "# HELP test_total Some test\n"
+                "# TYPE test_total counter\n"
+                "test_total 123\n"
+                "test_total{peer=\"client\",direction=\"sent\"} 0\n"sv);
+}
+
+TEST_CASE("tools_prometheus_escape", "[tools_prometheus]") {
+  std::string buffer;
+  tools::Prometheus prometheus{buffer};
+  prometheus.describe("test"sv, tools::Prometheus::Type::GAUGE, "a \"b\"\\c\nd"sv);
+  prometheus.sample("test"sv, {{"name"sv, "a \"b\"\\c\nd"sv}}, 1.5);
+  CHECK(
+      buffer == "# HELP test a \"b\"\\\\c\\nd\n"
+                "# TYPE test gauge\n"
+                "test{name=\"a \\\"b\\\"\\\\c\\nd\"} 1.5\n"sv);
+}
+
+TEST_CASE("tools_prometheus_special", "[tools_prometheus]") {
+  std::string buffer;
+  tools::Prometheus prometheus{buffer};
+  prometheus.sample("test"sv, {}, std::numeric_limits<double>::quiet_NaN());
+  prometheus.sample("test"sv, {}, std::numeric_limits<double>::infinity());
+  prometheus.sample("test"sv, {}, -std::numeric_limits<double>::infinity());
+  CHECK(buffer == "test NaN\ntest +Inf\ntest -Inf\n"sv);
+}
+
+TEST_CASE("tools_prometheus_histogram", "[tools_prometheus]") {
+  std::array<uint64_t, 3> const bounds{10, 100, 1000};
+  tools::Buckets buckets{bounds};
+  for (auto value : {5, 10, 50, 5000}) {
+    buckets.record(value);
+  }
+  std::string buffer;
+  tools::Prometheus prometheus{buffer};
+  prometheus.describe("test"sv, tools::Prometheus::Type::HISTOGRAM, "Some test"sv);
+  prometheus.histogram("test"sv, {{"stage"sv, "total"sv}}, buckets);
+  CHECK(
+      buffer == "# HELP test Some test\n"
+                "# TYPE test histogram\n"
+                "test_bucket{stage=\"total\",le=\"10\"} 2\n"
+                "test_bucket{stage=\"total\",le=\"100\"} 3\n"
+                "test_bucket{stage=\"total\",le=\"1000\"} 3\n"
+                "test_bucket{stage=\"total\",le=\"+Inf\"} 4\n"
+                "test_sum{stage=\"total\"} 5065\n"
+                "test_count{stage=\"total\"} 4\n"sv);
+}
@@ -0,0 +1,63 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include "roq/fix_proxy/tools/rx_timestamp.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+namespace {
+auto now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+}
+}  // namespace
+
+TEST_CASE("tools_rx_timestamp_loopback", "[tools_rx_timestamp]") {
+  auto listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  REQUIRE(listener >= 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  REQUIRE(::bind(listener, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) == 0);
+  REQUIRE(::listen(listener, 1) == 0);
+  REQUIRE(::getsockname(listener, reinterpret_cast<struct sockaddr *>(&address), &length) == 0);
+  auto client = ::socket(AF_INET, SOCK_STREAM, 0);
+  REQUIRE(::connect(client, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) == 0);
+  auto server = ::accept(listener, nullptr, nullptr);
+  REQUIRE(server >= 0);
+  REQUIRE(tools::RxTimestamp::enable(server));
+  std::array<std::byte, 64> buffer;
+  auto before = now();
+  REQUIRE(::send(client, "8=FIX.4.4\x01", 10, 0) == 10);
+  struct pollfd pfd = {
+      .fd = server,
+      .events = POLLIN,
+      .revents = {},
+  };
+  REQUIRE(::poll(&pfd, 1, 1000) == 1);
+  auto receive_time = std::chrono::nanoseconds{};
+  auto result = tools::RxTimestamp::receive(server, buffer, receive_time);
+  auto after = now();
+  CHECK(result == 10);
+  CHECK(before <= receive_time);
+  CHECK(receive_time <= after);
+  ::close(client);
+  result = tools::RxTimestamp::receive(server, buffer, receive_time);
+  CHECK(result == 0);  // note! closed by peer
+  CHECK(receive_time.count() == 0);
+  ::close(server);
+  ::close(listener);
+}
@@ -0,0 +1,103 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "roq/fix_proxy/tools/slot_map.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+namespace {
+// note! not movable (same as sessions)
+struct Value final {
+  Value(uint64_t key, int &count) : key{key}, count_{count} { ++count_; }
+
+  Value(Value const &) = delete;
+
+  ~Value() { --count_; }
+
+  uint64_t const key;
+
+ private:
+  int &count_;
+};
+}  // namespace
+
+TEST_CASE("tools_slot_map_simple", "[tools_slot_map]") {
+  int count = 0;
+  {
+    tools::SlotMap<Value, 4> slot_map;
+    auto &value = slot_map.emplace([&](auto key) { return Value{key, count}; });
+    CHECK(count == 1);
+    CHECK(value.key != 0);
+    CHECK(slot_map.size() == 1);
+    CHECK(slot_map.find(value.key) == &value);
+    CHECK(slot_map.find(0) == nullptr);
+    CHECK(slot_map.find(value.key + 1) == nullptr);
+    auto key = value.key;
+    CHECK(slot_map.erase(key) == true);
+    CHECK(count == 0);
+    CHECK(slot_map.erase(key) == false);
+    CHECK(slot_map.find(key) == nullptr);
+    CHECK(slot_map.empty());
+    slot_map.emplace([&](auto key) { return Value{key, count}; });
+  }
+  CHECK(count == 0);
+}
+
+TEST_CASE("tools_slot_map_generation", "[tools_slot_map]") {
+  int count = 0;
+  tools::SlotMap<Value, 4> slot_map;
+  auto key_1 = slot_map.emplace([&](auto key) { return Value{key, count}; }).key;
+  slot_map.erase(key_1);
+  auto key_2 = slot_map.emplace([&](auto key) { return Value{key, count}; }).key;
+  // note! same slot, different generation
+  CHECK(tools::SlotMap<Value>::get_index(key_1) == tools::SlotMap<Value>::get_index(key_2));
+  CHECK(key_1 != key_2);
+  CHECK(slot_map.find(key_1) == nullptr);
+  CHECK(slot_map.find(key_2) != nullptr);
+}
+
+TEST_CASE("tools_slot_map_stable", "[tools_slot_map]") {
+  int count = 0;
+  tools::SlotMap<Value, 4> slot_map;
+  std::vector<Value *> values;
+  for (size_t i = 0; i < 100; ++i) {
+    values.emplace_back(&slot_map.emplace([&](auto key) { return Value{key, count}; }));
+  }
+  CHECK(count == 100);
+  // note! addresses must not change when chunks are added
+  for (auto value : values) {
+    CHECK(slot_map.find((*value).key) == value);
+  }
+  // note! erase every other value and check dense iteration
+  std::set<uint64_t> expected;
+  for (size_t i = 0; i < std::size(values); ++i) {
+    if (i % 2) {
+      slot_map.erase((*values[i]).key);
+    } else {
+      expected.emplace((*values[i]).key);
+    }
+  }
+  CHECK(count == 50);
+  std::set<uint64_t> actual;
+  slot_map.for_each([&](auto &value) { actual.emplace(value.key); });
+  CHECK(actual == expected);
+  slot_map.clear();
+  CHECK(count == 0);
+  CHECK(slot_map.empty());
+}
+
+TEST_CASE("tools_slot_map_exception", "[tools_slot_map]") {
+  int count = 0;
+  tools::SlotMap<Value, 4> slot_map;
+  CHECK_THROWS(slot_map.emplace([&](auto key) -> Value { throw std::runtime_error{"failed"}; }));
+  CHECK(slot_map.empty());
+  auto &value = slot_map.emplace([&](auto key) { return Value{key, count}; });
+  CHECK(slot_map.find(value.key) == &value);
+}
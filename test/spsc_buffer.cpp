@@ -0,0 +1,136 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <exception>
+#include <thread>
+
+#include "roq/fix_proxy/tools/spsc_buffer.hpp"
+
+using namespace roq::fix_proxy;
+
+namespace {
+auto fill(auto &buffer, uint64_t sequence) {
+  for (size_t i = 0; i < std::size(buffer); ++i) {
+    buffer[i] = static_cast<std::byte>(sequence + i);
+  }
+}
+
+auto verify(auto &buffer, uint64_t sequence) {
+  for (size_t i = 0; i < std::size(buffer); ++i) {
+    if (buffer[i] != static_cast<std::byte>(sequence + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+TEST_CASE("tools_spsc_buffer_simple", "[tools_spsc_buffer]") {
+  tools::SPSCBuffer buffer{100};
+  CHECK(buffer.capacity() == 128);
+  CHECK(buffer.max_length() == 56);
+  CHECK(buffer.write(57, [](auto) {}) == false);
+  CHECK(buffer.write(3, [](auto data) { fill(data, 1); }) == true);   // 16 bytes
+  CHECK(buffer.write(20, [](auto data) { fill(data, 2); }) == true);  // 32 bytes
+  CHECK(buffer.write(56, [](auto) {}) == true);                        // 64 bytes
+  CHECK(buffer.write(9, [](auto) {}) == false);                        // note! 24 bytes, only 16 left
+  CHECK(buffer.size() == 112);
+  size_t length = {};
+  auto success = false;
+  CHECK(buffer.read([&](auto data) {
+    length = std::size(data);
+    success = verify(data, 1);
+  }) == true);
+  CHECK(length == 3);
+  CHECK(success == true);
+  // note! wrapping requires 16 bytes padding
+  CHECK(buffer.write(20, [](auto) {}) == false);
+  CHECK(buffer.read([&](auto data) { success = std::size(data) == 20 && verify(data, 2); }) == true);
+  CHECK(success == true);
+  CHECK(buffer.write(20, [](auto data) { fill(data, 3); }) == true);
+  CHECK(buffer.read([&](auto data) { length = std::size(data); }) == true);
+  CHECK(length == 56);
+  CHECK(buffer.read([&](auto data) { success = std::size(data) == 20 && verify(data, 3); }) == true);
+  CHECK(success == true);
+  CHECK(buffer.read([](auto) {}) == false);
+  CHECK(buffer.size() == 0);
+}
+
+TEST_CASE("tools_spsc_buffer_prepare", "[tools_spsc_buffer]") {
+  tools::SPSCBuffer buffer{128};
+  CHECK(tools::SPSCBuffer::get_capacity(buffer.max_length()) == buffer.capacity());
+  CHECK(tools::SPSCBuffer::get_capacity(buffer.max_length() + 1) == 2 * buffer.capacity());
+  CHECK(buffer.prepare(57, [](auto) {}) == false);
+  CHECK(buffer.prepare(3, [](auto data) { fill(data, 1); }) == true);
+  CHECK(buffer.size() == 0);  // note! not yet committed
+  CHECK(buffer.read([](auto) {}) == false);
+  CHECK(buffer.prepare(4, [](auto data) { fill(data, 2); }) == true);  // note! discards the previous record
+  buffer.commit();
+  CHECK(buffer.size() == 16);
+  auto success = false;
+  CHECK(buffer.read([&](auto data) { success = std::size(data) == 4 && verify(data, 2); }) == true);
+  CHECK(success == true);
+  CHECK(buffer.read([](auto) {}) == false);
+}
+
+TEST_CASE("tools_spsc_buffer_emplace", "[tools_spsc_buffer]") {
+  tools::SPSCBuffer buffer{128};
+  CHECK(buffer.emplace(57, [](auto) { return size_t{0}; }) == false);
+  CHECK(buffer.emplace(56, [](auto data) {
+    auto message = data.subspan(0, 3);
+    fill(message, 1);
+    return std::size(message);
+  }) == true);  // note! 16 bytes used
+  CHECK(buffer.size() == 16);
+  CHECK(buffer.write(40, [](auto) {}) == true);  // 48 bytes
+  CHECK_THROWS(buffer.emplace(56, [](auto) -> size_t { throw std::exception{}; }));  // note! nothing written
+  CHECK(buffer.size() == 64);
+  size_t length = {};
+  auto success = false;
+  CHECK(buffer.read([&](auto data) {
+    length = std::size(data);
+    success = verify(data, 1);
+  }) == true);
+  CHECK(length == 3);
+  CHECK(success == true);
+  CHECK(buffer.read([](auto) {}) == true);
+  CHECK(buffer.write(40, [](auto) {}) == true);
+  CHECK(buffer.read([](auto) {}) == true);
+  // note! wrapping requires 16 bytes padding
+  CHECK(buffer.emplace(56, [](auto data) {
+    auto message = data.subspan(0, 20);
+    fill(message, 2);
+    return std::size(message);
+  }) == true);
+  CHECK(buffer.size() == 48);
+  CHECK(buffer.read([&](auto data) { success = std::size(data) == 20 && verify(data, 2); }) == true);
+  CHECK(success == true);
+  CHECK(buffer.read([](auto) {}) == false);
+  CHECK(buffer.size() == 0);
+}
+
+TEST_CASE("tools_spsc_buffer_threads", "[tools_spsc_buffer]") {
+  constexpr uint64_t const COUNT = 200000;
+  tools::SPSCBuffer buffer{4096};
+  std::thread producer{[&]() {
+    for (uint64_t i = 0; i < COUNT; ++i) {
+      auto length = 1 + ((i * 7) % 300);
+      while (!buffer.write(length, [&](auto data) { fill(data, i); })) {
+        std::this_thread::yield();
+      }
+    }
+  }};
+  uint64_t sequence = 0;
+  auto success = true;
+  while (sequence < COUNT) {
+    buffer.read([&](auto data) {
+      success = success && std::size(data) == (1 + ((sequence * 7) % 300)) && verify(data, sequence);
+      ++sequence;
+    });
+  }
+  producer.join();
+  CHECK(success == true);
+  CHECK(buffer.read([](auto) {}) == false);
+}
@@ -0,0 +1,52 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+#include "roq/fix_proxy/tools/spsc_queue.hpp"
+
+using namespace roq::fix_proxy;
+
+TEST_CASE("tools_spsc_queue_simple", "[tools_spsc_queue]") {
+  tools::SPSCQueue<int> queue{3};
+  CHECK(queue.capacity() == 4);
+  CHECK(queue.empty() == true);
+  for (int i = 0; i < 4; ++i) {
+    CHECK(queue.try_push(i) == true);
+  }
+  CHECK(queue.try_push(4) == false);
+  CHECK(queue.empty() == false);
+  CHECK(queue.size() == 4);
+  for (int i = 0; i < 4; ++i) {
+    int value = -1;
+    CHECK(queue.try_pop([&](auto item) { value = item; }) == true);
+    CHECK(value == i);
+  }
+  CHECK(queue.try_pop([](auto) {}) == false);
+  CHECK(queue.empty() == true);
+  CHECK(queue.size() == 0);
+}
+
+TEST_CASE("tools_spsc_queue_threads", "[tools_spsc_queue]") {
+  constexpr uint64_t const COUNT = 1000000;
+  tools::SPSCQueue<uint64_t> queue{64};
+  std::thread producer{[&]() {
+    for (uint64_t i = 0; i < COUNT; ++i) {
+      while (!queue.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  }};
+  uint64_t expected = 0;
+  auto ordered = true;
+  while (expected < COUNT) {
+    queue.try_pop([&](auto value) {
+      ordered = ordered && (value == expected);
+      ++expected;
+    });
+  }
+  producer.join();
+  CHECK(ordered == true);
+  CHECK(queue.empty() == true);
+}
@@ -0,0 +1,23 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include "roq/fix_proxy/tools/tsc.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+TEST_CASE("tools_tsc_simple", "[tools_tsc]") {
+  auto cycles_per_nanosecond = tools::TSC::calibrate(10ms);
+  CHECK(cycles_per_nanosecond > 0.0);
+  auto start = tools::TSC::now();
+  std::this_thread::sleep_for(20ms);
+  auto cycles = tools::TSC::now() - start;
+  auto nanoseconds = static_cast<double>(cycles) / cycles_per_nanosecond;
+  CHECK(nanoseconds >= 15.0e6);  // note! allow for calibration error
+  CHECK(nanoseconds < 1.0e9);
+}
@@ -0,0 +1,60 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "roq/io/engine/context_factory.hpp"
+
+#include "roq/fix_proxy/tools/verifier.hpp"
+
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+using namespace roq;
+using namespace roq::fix_proxy;
+
+namespace {
+struct Handler final : public tools::Verifier::Handler {
+  void operator()(tools::Verifier::Result const &result) override { results.emplace_back(result); }
+
+  std::vector<tools::Verifier::Result> results;
+};
+
+void wait_for(auto &verifier, auto &handler, size_t count) {
+  auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (std::size(handler.results) < count && std::chrono::steady_clock::now() < deadline) {
+    if (verifier.poll() == 0) {
+      std::this_thread::sleep_for(100us);
+    }
+  }
+}
+}  // namespace
+
+TEST_CASE("proxy_tools_verifier_malformed_raw_data", "[fix_proxy_tools_verifier]") {
+  auto context = io::engine::ContextFactory::create();
+  tools::Crypto crypto{"hmac_sha256_ts"sv, 5s};
+  Handler handler;
+  tools::Verifier verifier{handler, crypto, *context, 1, 1ms};
+  auto key = tools::Crypto::create_key("foobar"sv);
+  auto password = "qEBeeU/7jdamNNZI+b4LBGRrX39qVIc20pPcZY8m5Zg="sv;
+  // note! the timestamp prefix is client controlled
+  CHECK(verifier.submit(1, password, key, "abc.123"sv) == true);
+  CHECK(verifier.submit(2, password, key, "99999999999999999999999999.123"sv) == true);
+  CHECK(verifier.submit(3, password, key, ".123"sv) == true);
+  CHECK(verifier.submit(4, password, key, "no-period"sv) == true);
+  wait_for(verifier, handler, 4);
+  REQUIRE(std::size(handler.results) == 4);
+  for (size_t i = 0; i < std::size(handler.results); ++i) {
+    CHECK(handler.results[i].session_id == (i + 1));
+    CHECK(handler.results[i].success == false);
+  }
+  // note! the worker must still be running
+  CHECK(verifier.submit(5, password, key, "1234567890.123"sv) == true);
+  wait_for(verifier, handler, 5);
+  REQUIRE(std::size(handler.results) == 5);
+  CHECK(handler.results[4].session_id == 5);
+  CHECK(handler.results[4].success == false);
+}
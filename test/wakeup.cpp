@@ -0,0 +1,91 @@
+/* Copyright (c) 2017-2026, Hans Erik Thrane */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "roq/fix_proxy/tools/wakeup.hpp"
+
+using namespace std::literals;
+
+using namespace roq::fix_proxy;
+
+TEST_CASE("tools_wakeup_simple", "[tools_wakeup]") {
+  tools::Wakeup wakeup;
+  wakeup.notify();  // note! not sleeping, nothing is signalled
+  wakeup.prepare();
+  CHECK(wakeup.wait(1ms) == false);
+  wakeup.prepare();
+  wakeup.notify();
+  CHECK(wakeup.wait(1s) == true);
+  wakeup.notify();  // note! only the first notification signals
+  wakeup.prepare();
+  CHECK(wakeup.wait(1ms) == false);
+}
+
+TEST_CASE("tools_wakeup_threads", "[tools_wakeup]") {
+  constexpr uint64_t const COUNT = 1000;
+  tools::Wakeup wakeup;
+  std::atomic<uint64_t> published;
+  std::thread producer{[&]() {
+    for (uint64_t i = 1; i <= COUNT; ++i) {
+      published.store(i, std::memory_order_release);
+      wakeup.notify();
+      if ((i % 10) == 0) {
+        std::this_thread::sleep_for(10us);
+      }
+    }
+  }};
+  uint64_t consumed = 0, timeouts = 0;
+  while (consumed < COUNT) {
+    wakeup.prepare();
+    auto value = published.load(std::memory_order_acquire);
+    if (value != consumed) {
+      wakeup.cancel();
+      consumed = value;
+      continue;
+    }
+    if (!wakeup.wait(1s)) {
+      ++timeouts;  // note! a missed notification
+    }
+  }
+  producer.join();
+  CHECK(timeouts == 0);
+}
+
+TEST_CASE("tools_wakeup_redirect", "[tools_wakeup]") {
+  int fds[2];
+  REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) == 0);
+  tools::Wakeup wakeup;
+  auto fd = wakeup.fd();
+  wakeup.redirect(fds[0]);
+  CHECK(wakeup.fd() == fd);  // note! same file descriptor
+  auto readable = [&]() {
+    struct pollfd poll_fd = {
+        .fd = fds[1],
+        .events = POLLIN,
+        .revents = {},
+    };
+    return ::poll(&poll_fd, 1, 0) == 1;
+  };
+  auto drain = [&]() {
+    char buffer[64];
+    while (::read(fds[1], buffer, sizeof(buffer)) > 0) {
+    }
+  };
+  wakeup.notify();  // note! not sleeping, nothing is written
+  CHECK(readable() == false);
+  wakeup.prepare();
+  wakeup.notify();
+  CHECK(readable() == true);
+  drain();
+  wakeup.notify();  // note! only the first notification writes
+  CHECK(readable() == false);
+  ::close(fds[1]);
+}